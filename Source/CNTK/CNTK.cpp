@@ -23,6 +23,7 @@
 #include "NDLNetworkBuilder.h"
 #include "ModelEditLanguage.h"
 #include "CPUMatrix.h" // used for SetNumThreads()
+#include "GPUMatrix.h" // used for SyncGuard::EnableSync()
 #include "CommonMatrix.h"
 #include "SGD.h"
 #include "MPIWrapper.h"
@@ -37,6 +38,7 @@
 #include "BrainScriptEvaluator.h"
 #include "BrainScriptParser.h"
 #include "PerformanceProfiler.h"
+#include "NodeProfiler.h"
 #include "CNTKLibrary.h"
 
 #include <string>
@@ -73,15 +75,24 @@ void TestCn(const ConfigParameters& config);
 
 // Setup profiling
 template <typename ConfigParamType>
-void SetupProfiling(ProfilerContext& profilerContext, const ConfigParamType& config, int nodeRank)
+void SetupProfiling(ProfilerContext& profilerContext, NodeProfilerContext& nodeProfilerContext, const ConfigParamType& config, int nodeRank)
 {
     if (config(L"profilerEnabled", false))
     {
         wstring workDir = config(L"WorkDir", L".");
+        bool syncGpu = config(L"profilerSyncGpu", true);
         profilerContext.Init(workDir + L"/profiler",
                              config(L"profilerBufferSize", static_cast<uint64_t>(32 * 1024 * 1024)),
                              std::to_wstring(nodeRank),
-                             config(L"profilerSyncGpu", true));
+                             syncGpu);
+
+        // per-node forward/backward times; they are only meaningful for the GPU if every kernel is synchronized
+        if (config(L"profilerNodeDetails", false))
+        {
+            nodeProfilerContext.Init(workDir + L"/profiler", std::to_wstring(nodeRank));
+            if (syncGpu)
+                SyncGuard::EnableSync();
+        }
     }
 }
 
@@ -512,6 +523,8 @@ int wmainWithBS(int argc, wchar_t* argv[]) // called from wmain which is a wrapp
 
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
+    Globals::SetMinibatchSizeAwareMemorySharing(config(L"minibatchSizeAwareMemorySharing", false));
+    Globals::SetFuseElementwiseChains(config(L"fuseElementwiseChains", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
@@ -534,7 +547,8 @@ int wmainWithBS(int argc, wchar_t* argv[]) // called from wmain which is a wrapp
 
     // Setup profiling
     ProfilerContext profilerContext;
-    SetupProfiling(profilerContext, config, paralleltrain ? (int)mpi->CurrentNodeRank() : 0);
+    NodeProfilerContext nodeProfilerContext;
+    SetupProfiling(profilerContext, nodeProfilerContext, config, paralleltrain ? (int)mpi->CurrentNodeRank() : 0);
 
     // execute the actions
     // std::string type = config(L"precision", "float");
@@ -581,6 +595,9 @@ int wmainWithBS(int argc, wchar_t* argv[]) // called from wmain which is a wrapp
         fprintf(fp, "successfully finished at %s on %s\n", TimeDateStamp().c_str(), GetHostName().c_str());
         fcloseOrDie(fp);
     }
+    if (config(L"traceCPUMemoryAllocations", false))
+        CPUArenaAllocator::Instance().PrintStats(stderr);
+
     // TODO: change this back to COMPLETED, double underscores don't look good in output
     LOGPRINTF(stderr, "__COMPLETED__\n");
     fflush(stderr);
@@ -660,6 +677,8 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
 
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
+    Globals::SetMinibatchSizeAwareMemorySharing(config(L"minibatchSizeAwareMemorySharing", false));
+    Globals::SetFuseElementwiseChains(config(L"fuseElementwiseChains", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
@@ -731,7 +750,8 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
 
     // Setup profiling
     ProfilerContext profilerContext;
-    SetupProfiling(profilerContext, config, paralleltrain ? (int)mpi->CurrentNodeRank() : 0);
+    NodeProfilerContext nodeProfilerContext;
+    SetupProfiling(profilerContext, nodeProfilerContext, config, paralleltrain ? (int)mpi->CurrentNodeRank() : 0);
 
     // run commands
     std::string type = config(L"precision", "float");
@@ -758,6 +778,9 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
         fprintf(fp, "Successfully finished at %s on %s\n", TimeDateStamp().c_str(), GetHostName().c_str());
         fcloseOrDie(fp);
     }
+    if (config(L"traceCPUMemoryAllocations", false))
+        CPUArenaAllocator::Instance().PrintStats(stderr);
+
     if (ProgressTracing::GetTimestampingFlag())
     {
         LOGPRINTF(stderr, "__COMPLETED__\n"); // running in server environment which expects this string
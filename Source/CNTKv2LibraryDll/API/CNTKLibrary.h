@@ -22,6 +22,7 @@
 #include <mutex>
 #include <future>
 #include <cstddef>
+#include <cstdint>
 
 #ifdef SWIG
 #define final
@@ -46,6 +47,7 @@ namespace CNTK
         Float = 1,
         Double = 2,
         UChar = 3, // So far only used internally in deserializers.
+        BFloat16 = 4, // Storage only: NDArrayViews on the CPU, and Constants whose values are widened for computation.
 
         /* TODO:
         Bit,
@@ -63,6 +65,36 @@ namespace CNTK
         */
     };
 
+    ///
+    /// 16-bit brain floating point number, the element type of DataType::BFloat16.
+    /// It is the upper half of an IEEE float, i.e. it has the range of a float at about 3 significant digits.
+    ///
+    struct bfloat16
+    {
+        uint16_t bits;
+
+        bfloat16() : bits(0) {}
+
+        // round to nearest even; NaNs stay (quiet) NaNs instead of being rounded to infinity
+        explicit bfloat16(float value)
+        {
+            uint32_t floatBits;
+            memcpy(&floatBits, &value, sizeof(floatBits));
+            if ((floatBits & 0x7fffffff) > 0x7f800000)
+                bits = (uint16_t)((floatBits >> 16) | 0x0040);
+            else
+                bits = (uint16_t)((floatBits + 0x7fff + ((floatBits >> 16) & 1)) >> 16);
+        }
+
+        operator float() const
+        {
+            uint32_t floatBits = (uint32_t)bits << 16;
+            float value;
+            memcpy(&value, &floatBits, sizeof(value));
+            return value;
+        }
+    };
+
     ///
     /// Get the 'DataType' corresponding to the ElementType template type argument.
     ///
@@ -73,6 +105,8 @@ namespace CNTK
             return DataType::Float;
         else if (std::is_same<ElementType, double>())
             return DataType::Double;
+        else if (std::is_same<ElementType, bfloat16>())
+            return DataType::BFloat16;
         else
             NOT_IMPLEMENTED;
     }
@@ -83,6 +117,8 @@ namespace CNTK
             return "Float";
         else if (dataType == DataType::Double)
             return "Double";
+        else if (dataType == DataType::BFloat16)
+            return "BFloat16";
         else
             LogicError("Unknown DataType.");
     }
@@ -93,6 +129,8 @@ namespace CNTK
             return sizeof(float);
         else if (dataType == DataType::Double)
             return sizeof(double);
+        else if (dataType == DataType::BFloat16)
+            return sizeof(bfloat16);
         else
             LogicError("Unknown DataType.");
     }
@@ -595,6 +633,9 @@ namespace CNTK
         friend class Internal::VariableResolver;
         friend class Trainer;
 
+        template <typename ElementType>
+        friend class BeamSearchDecoderImpl;
+
         template <typename T, typename ...CtorArgTypes>
         friend inline std::shared_ptr<T> MakeSharedObject(CtorArgTypes&& ...ctorArgs);
 
@@ -705,6 +746,9 @@ namespace CNTK
             case DataType::Double:
                 SetValue(value);
                 break;
+            case DataType::BFloat16:
+                SetValue((float)value);
+                break;
             default:
                 LogicError("Unsupported DataType %s.", DataTypeName(m_dataType));
                 break;
@@ -772,7 +816,7 @@ namespace CNTK
 
         // TODO: The set methods should be offered in template from
         ///
-        /// Fill 'this' NDArrayView with the specified value. The underlying DataType of 'this' view should be DataType::Float.
+        /// Fill 'this' NDArrayView with the specified value. The underlying DataType of 'this' view should be DataType::Float or DataType::BFloat16.
         ///
         CNTK_API void SetValue(float value);
 
@@ -821,6 +865,7 @@ namespace CNTK
         ///
         /// Copies the contents of the 'source' NDArrayView to 'this' view.
         /// The shapes of the 'source' view and 'this' view must be identical.
+        /// Values are converted between DataType::BFloat16 and DataType::Float or DataType::Double.
         ///
         CNTK_API void CopyFrom(const NDArrayView& source);
 
@@ -877,6 +922,10 @@ namespace CNTK
         template <typename ElementType>
         Microsoft::MSR::CNTK::TensorView<ElementType>* GetWritableTensorView();
 
+        // the storage of a view of DataType::BFloat16, which is a CPU matrix with the dimensions of GetMatrixDimensions(Shape())
+        const Microsoft::MSR::CNTK::CPUMatrix<Microsoft::MSR::CNTK::bfloat16>* GetBFloat16Matrix() const;
+        Microsoft::MSR::CNTK::CPUMatrix<Microsoft::MSR::CNTK::bfloat16>* GetWritableBFloat16Matrix();
+
     private:
         ::CNTK::DataType m_dataType;
         DeviceDescriptor m_device;
@@ -884,9 +933,13 @@ namespace CNTK
         NDShape m_viewShape;
         bool m_isReadOnly;
 
-        std::shared_ptr<void> m_tensorView; // Microsoft::MSR::CNTK::TensorView<ElemType>*
+        std::shared_ptr<void> m_tensorView; // Microsoft::MSR::CNTK::TensorView<ElemType>*, or CPUMatrix<bfloat16>* for DataType::BFloat16
     };
 
+    // The values of DataType::BFloat16 are not held in a TensorView (see GetBFloat16Matrix()).
+    template <>
+    CNTK_API const bfloat16* NDArrayView::DataBuffer<bfloat16>() const;
+
     enum class MaskKind : char
     {
         Invalid = 0,
@@ -2200,7 +2253,7 @@ private:
 
         ///
         /// Create a clone of 'this' constant with the specified DataType. 
-        /// This only supports converting from a lower precision type to a higher precision type (e.g. DataType::Float to DataType::Double)
+        /// This only supports converting from a lower precision type to a higher precision type (e.g. DataType::Float to DataType::Double, or DataType::BFloat16 to DataType::Float)
         ///
         CNTK_API Constant CloneAs(DataType dataType) const;
 
@@ -2620,6 +2673,54 @@ namespace CNTK
             return CreateSequence(sampleShape, sequenceLength, colStarts, rowIndices, nonZeroValues, numNonZeroValues, true, device, readOnly);
         }
 
+        ///
+        /// Creates a new Value object over caller-owned dense data of a batch of variable length sequences, without copying it.
+        /// The 'dataBuffer' holds the sequences one after the other, each padded to the length of the longest sequence,
+        /// i.e. it has the layout of a tensor with shape [sampleShape x maxSequenceLength x numSequences].
+        /// The buffer must have been allocated on the specified 'device' and must outlive the created Value object.
+        /// When the Value is an argument of an inference-only Forward or Evaluate call, the network reads it in place during that call
+        /// if it is on the compute device and holds a single sequence or sequences of one sample each; when the Value is a requested output,
+        /// the results are written into its buffer directly.
+        /// Parameters:
+        ///     sampleShape: the shape of each sample.
+        ///     sequenceLengths: the number of samples of each sequence.
+        ///     sequenceStartFlags: whether each sequence is a new sequence; an empty vector means that they all are.
+        ///     dataBuffer: the data of the sequences.
+        ///     numBufferElements: the number of elements in 'dataBuffer'.
+        ///     device: the device that 'dataBuffer' is located on.
+        ///     readOnly: the Value is read-only if this flag is true.
+        ///
+        template <typename ElementType>
+        CNTK_API static ValuePtr CreateFromBuffer(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, ElementType* dataBuffer, size_t numBufferElements, const DeviceDescriptor& device, bool readOnly = false);
+
+        ///
+        /// Creates a new read-only Value object over caller-owned dense data of a batch of variable length sequences, without copying it.
+        /// All parameters are the same as the method above.
+        ///
+        template <typename ElementType>
+        static ValuePtr CreateFromBuffer(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, const ElementType* dataBuffer, size_t numBufferElements, const DeviceDescriptor& device)
+        {
+            return CreateFromBuffer(sampleShape, sequenceLengths, sequenceStartFlags, const_cast<ElementType*>(dataBuffer), numBufferElements, device, /*readOnly =*/ true);
+        }
+
+        ///
+        /// Creates a new read-only Value object over caller-owned data of a batch of variable length sequences in CSC sparse format
+        /// (http://docs.nvidia.com/cuda/cusparse/#compressed-sparse-column-format-csc), without copying it.
+        /// The sparse matrix has sampleShape[0] rows, and a column for each remaining sample element of each step of the sequences,
+        /// which are padded to the length of the longest sequence with empty columns.
+        /// The buffers must be located on the CPU and must outlive the created Value object.
+        /// Parameters:
+        ///     sampleShape: the shape of each sample.
+        ///     sequenceLengths: the number of samples of each sequence.
+        ///     sequenceStartFlags: whether each sequence is a new sequence; an empty vector means that they all are.
+        ///     colStarts: the index of the first non-zero value of each column, followed by the number of non-zero values.
+        ///     rowIndices: the row index of each non-zero value.
+        ///     nonZeroValues: the non-zero values.
+        ///     numNonZeroValues: the number of non-zero values.
+        ///
+        template <typename ElementType>
+        CNTK_API static ValuePtr CreateFromBuffer(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, const SparseIndexType* colStarts, const SparseIndexType* rowIndices, const ElementType* nonZeroValues, size_t numNonZeroValues);
+
         ///
         /// Destruct 'this' Value object.
         ///
@@ -3360,25 +3461,34 @@ namespace CNTK
         ///
         CNTK_API void Save(const std::wstring& filepath);
 
+        ///
+        /// Save this Function graph into a model file in which the values of the dense Parameters and Constants follow the graph,
+        /// each at a page boundary. Function::Load maps these values into memory instead of reading them: on the CPU, the values of
+        /// the loaded Function are backed by the pages of the file, which are read in on first access and shared by all processes
+        /// that load the model, until a process writes to a page and gets its own copy of it. The file is never written to.
+        /// Models whose values exceed the 2 GB limit of a serialized Dictionary can be saved this way.
+        ///
+        CNTK_API void SaveMappable(const std::wstring& filepath);
+
         ///
         /// Restore the models parameters (in-place) from a model file
         ///
         CNTK_API void Restore(const std::wstring& filepath);
 
         ///
-        /// Load a Function from a model file
+        /// Load a Function from a model file. The values of a model saved by SaveMappable are mapped into memory.
         ///
         CNTK_API static FunctionPtr Load(const std::wstring& filepath, 
                                          const DeviceDescriptor& computeDevice = DeviceDescriptor::UseDefaultDevice());
 
         ///
-        /// Load a Function from a memory buffer
+        /// Load a Function from a memory buffer. The values of a model saved by SaveMappable are copied from the buffer.
         ///
         CNTK_API static FunctionPtr Load(const char* buffer, size_t length,
                                          const DeviceDescriptor& computeDevice = DeviceDescriptor::UseDefaultDevice());
 
         ///
-        /// Load a Function from an istream. The legacy V1 model is not supported.
+        /// Load a Function from an istream. Neither the legacy V1 model nor a model saved by SaveMappable is supported.
         ///
         CNTK_API static FunctionPtr Load(std::istream& inputStream, 
                                          const DeviceDescriptor& computeDevice = DeviceDescriptor::UseDefaultDevice());
@@ -4593,6 +4703,12 @@ namespace CNTK
         // This option results in the mean value of the gradients across the samples in the minibatch to be used by the learner.
         // The mean gradient is computed by dividing the gradient values accumulated across all samples by the actual number of samples (labels) in the minibatch.
         bool useMeanGradient = false;
+
+        // This option makes the SGD, momentum SGD, Nesterov, AdaGrad, FSAdaGrad, Adam and RMSProp learners update all their dense parameters on the CPU
+        // in one parallel sweep, instead of one parameter at a time. Only the smoothed gradients of these parameters are packed into one buffer;
+        // the gradients stay in their own buffers, and how they are aggregated across workers is not affected.
+        // It reduces the per-parameter overhead of the updates of models with many small parameters.
+        bool multiTensorUpdate = false;
     };
 
     ///  
@@ -4895,7 +5011,12 @@ namespace CNTK
         DistributedLearner(const DistributedLearner&) = delete; DistributedLearner& operator=(const DistributedLearner&) = delete; DistributedLearner& operator=(DistributedLearner&&) = delete; DistributedLearner(DistributedLearner&&) = delete;
     };
 
-    CNTK_API DistributedLearnerPtr CreateDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, bool useAsyncBufferedParameterUpdate = false);
+    ///
+    /// Creates a data parallel distributed learner. With a positive gradientBucketSizeInBytes and an MPICommunicator, the gradients of the
+    /// parameters on the CPU are aggregated in buckets of about that size, each of which starts to aggregate during backprop once its gradients are complete.
+    /// The buckets are created by the Trainer, and leave out the parameters with sparse gradients (the left operands of Times with a sparse right operand).
+    ///
+    CNTK_API DistributedLearnerPtr CreateDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, bool useAsyncBufferedParameterUpdate = false, size_t gradientBucketSizeInBytes = 0);
 
     CNTK_API DistributedLearnerPtr CreateQuantizedDataParallelDistributedLearner(QuantizedDistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributeAfterSamples, bool useAsyncBufferedParameterUpdate = false);
 
@@ -5016,6 +5137,137 @@ namespace CNTK
     ///
     CNTK_API EvaluatorPtr CreateEvaluator(const FunctionPtr& evaluationFunction, const std::vector<ProgressWriterPtr>& progressWriters = {});
 
+    ///
+    /// Latency and batch size statistics of a BatchingEvaluator, since its creation or the last ResetStatistics().
+    ///
+    struct BatchingEvaluatorStatistics
+    {
+        size_t numRequests;    // number of requests that were evaluated
+        size_t numBatches;     // number of batches (i.e. calls to Function::Evaluate()) they were coalesced into
+        size_t numSequences;   // number of sequences in those batches
+        double p50LatencyInMs; // median latency of the most recent requests, from the call to BatchingEvaluator::Evaluate() to its return
+        double p99LatencyInMs; // 99th percentile of the same
+
+        double AverageBatchSize() const { return numBatches ? (double)numSequences / numBatches : 0; }
+    };
+
+    ///
+    /// BatchingEvaluator evaluates a Function for requests of concurrent callers, e.g. the threads of an online service
+    /// that receive one sample each. Requests that arrive while a batch is evaluated are queued, and coalesced into a
+    /// single batch (one Value per argument, with the sequences of all requests) once the queue holds the maximum
+    /// batch size of sequences or the oldest request waited for the maximum latency. The outputs of the batch are
+    /// scattered back to the requests. Function::Evaluate() is called from a single thread of the BatchingEvaluator.
+    ///
+    class BatchingEvaluator : public std::enable_shared_from_this<BatchingEvaluator>
+    {
+    public:
+        ///
+        /// Evaluates the outputs of the Function for the sequences in 'arguments' and returns when they are done.
+        /// 'arguments' must have a Value for every argument of the Function, each with the same number of sequences.
+        /// 'outputs' names outputs of the Function; null Values are allocated, others are overwritten.
+        /// This method can be called from any number of threads at once.
+        ///
+        CNTK_API virtual void Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputs) = 0;
+
+        ///
+        /// Returns the latency and batch size statistics.
+        ///
+        CNTK_API virtual BatchingEvaluatorStatistics Statistics() const = 0;
+
+        ///
+        /// Resets the statistics, e.g. after warming up.
+        ///
+        CNTK_API virtual void ResetStatistics() = 0;
+
+        ///
+        /// Function that is evaluated.
+        ///
+        FunctionPtr EvaluationFunction() const { return m_evaluationFunction; }
+
+        ///
+        /// Evaluates the requests that are still queued and stops.
+        ///
+        CNTK_API virtual ~BatchingEvaluator() {}
+
+    protected:
+        BatchingEvaluator(const FunctionPtr& evaluationFunction) : m_evaluationFunction(evaluationFunction) {}
+
+        const FunctionPtr m_evaluationFunction;
+    };
+
+    ///
+    /// Construct a BatchingEvaluator for the specified Function, whose arguments and outputs must all have a batch axis.
+    /// Batches contain up to maxBatchSize sequences (or a single request with more), and a request waits at most
+    /// maxLatencyInMicroseconds for other requests to join its batch.
+    ///
+    CNTK_API BatchingEvaluatorPtr CreateBatchingEvaluator(const FunctionPtr& evaluationFunction, size_t maxBatchSize, size_t maxLatencyInMicroseconds,
+                                                          const DeviceDescriptor& computeDevice = DeviceDescriptor::UseDefaultDevice());
+
+    ///
+    /// A sequence of tokens found by a BeamSearchDecoder.
+    ///
+    struct BeamSearchHypothesis
+    {
+        std::vector<size_t> tokens; // decoded tokens, excluding the start token; finished hypotheses end with the end token
+        double score;               // sum of the log-probabilities of the tokens
+        double normalizedScore;     // score divided by the number of tokens raised to the length normalization exponent
+    };
+
+    ///
+    /// BeamSearchDecoder decodes token sequences with a step Function that computes the log-probabilities of the next
+    /// token from the previous token and a recurrent state, which takes the place of PastValue() in the step Function:
+    /// each state is an input of the step Function whose value in a step is the value of the paired state output in the
+    /// previous step. All hypotheses of all sources are evaluated in a single Function::Evaluate() per step, into Values
+    /// on the compute device that are allocated once per batch size and reused across the steps; the states of the
+    /// surviving hypotheses are gathered on the device from the outputs into the state inputs in place.
+    ///
+    class BeamSearchDecoder : public std::enable_shared_from_this<BeamSearchDecoder>
+    {
+    public:
+        ///
+        /// Decodes a batch of sources and returns, for each source, up to the beam width hypotheses with the highest
+        /// normalized scores, best first. 'arguments' must have a Value for every argument of the step Function other than
+        /// the token input and the state inputs (e.g. the encoding of the source), each with one sample per source; it may
+        /// also have a Value with the initial state of state inputs, which start at zero otherwise.
+        /// Without any Values, a single source is decoded.
+        ///
+        CNTK_API virtual std::vector<std::vector<BeamSearchHypothesis>> Decode(const std::unordered_map<Variable, ValuePtr>& arguments) = 0;
+
+        ///
+        /// Function that computes a step of the decoding.
+        ///
+        FunctionPtr StepFunction() const { return m_stepFunction; }
+
+        CNTK_API virtual ~BeamSearchDecoder() {}
+
+    protected:
+        BeamSearchDecoder(const FunctionPtr& stepFunction) : m_stepFunction(stepFunction) {}
+
+        const FunctionPtr m_stepFunction;
+    };
+
+    ///
+    /// Construct a BeamSearchDecoder for the specified step Function, whose arguments and outputs must have the batch axis as
+    /// their only dynamic axis.
+    ///     tokenInput: argument that receives the previous token as a one-hot vector (dense or sparse).
+    ///     scoresOutput: output with the log-probability of each token, e.g. the difference of the logits and their ReduceLogSum().
+    ///     recurrentStates: pairs of a state input and the state output that feeds it in the next step, with equal shapes.
+    ///     startToken, endToken: the token that all hypotheses start with, and the token that finishes a hypothesis.
+    ///     beamWidth: number of hypotheses that are kept for each source.
+    ///     maxLength: number of tokens after which unfinished hypotheses are returned as they are.
+    ///     lengthNormalizationExponent: the exponent of the hypothesis length that scores are divided by to rank hypotheses
+    ///         of different lengths; 0 ranks them by their scores.
+    ///     pruningThreshold: hypotheses whose score is lower than that of the best hypothesis of the same source by more than
+    ///         this are dropped, even if the beam is not full.
+    /// A source is done once it has beamWidth finished hypotheses.
+    ///
+    CNTK_API BeamSearchDecoderPtr CreateBeamSearchDecoder(const FunctionPtr& stepFunction, const Variable& tokenInput, const Variable& scoresOutput,
+                                                          const std::vector<std::pair<Variable, Variable>>& recurrentStates,
+                                                          size_t startToken, size_t endToken, size_t beamWidth, size_t maxLength,
+                                                          double lengthNormalizationExponent = 0,
+                                                          double pruningThreshold = std::numeric_limits<double>::infinity(),
+                                                          const DeviceDescriptor& computeDevice = DeviceDescriptor::UseDefaultDevice());
+
     ///
     /// Trainer is the top-level abstraction responsible for the orchestration of the training of a model
     /// using the specified learners and training data either explicitly supplied as Value objects or from
@@ -5054,6 +5306,24 @@ namespace CNTK
         ///
         CNTK_API void SaveCheckpoint(const std::wstring& filePath, Dictionary externalState = Dictionary());
 
+        ///
+        /// Checkpoint the model and other Trainer state at the specified file location, without waiting for the files to be written.
+        /// The state is copied into host memory before returning, and the files are written and renamed into place by a background thread,
+        /// in the order of the calls. If maxPendingCheckpoints earlier checkpoints are still being written, this waits for the oldest one.
+        /// A failed write is reported by an exception from the next call that saves, restores or waits for checkpoints.
+        ///
+        CNTK_API void SaveCheckpointAsync(const std::wstring& filePath, Dictionary externalState = Dictionary(), size_t maxPendingCheckpoints = 1);
+
+        ///
+        /// Wait until the checkpoints saved by SaveCheckpointAsync have been written.
+        ///
+        CNTK_API void WaitForPendingCheckpoints();
+
+        ///
+        /// Total time in seconds that saving checkpoints and waiting for them blocked the calling thread.
+        ///
+        double CheckpointBlockingTimeInSeconds() const { return m_checkpointBlockingTimeInSeconds; }
+
         ///
         /// Restore the model and trainer state from a previously saved model and checkpoint from the specified file location
         ///
@@ -5119,8 +5389,10 @@ namespace CNTK
         bool TrainLocalMinibatch(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputsToFetch, bool sweepEnd, const DeviceDescriptor& computeDevice);
         bool TrainDistributedMinibatch(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputsToFetch, bool sweepEnd, const DeviceDescriptor& computeDevice);
 
+        void SaveCheckpoint(const std::wstring& modelFilePath, const Dictionary& externalState, size_t maxPendingCheckpoints);
+
         void Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, 
-            const Dictionary& externalState, const Dictionary& distributedState = {});
+            const Dictionary& externalState, const Dictionary& distributedState, size_t maxPendingCheckpoints);
 
         void UpdateTrainingProgress(size_t numSamples, const ValuePtr& loss, const ValuePtr& evalCriterion, const DeviceDescriptor& computeDevice);
         void AddProgressWriters(const std::vector<ProgressWriterPtr>& progressWriters);
@@ -5144,6 +5416,10 @@ namespace CNTK
         AccumulatorPtr m_aggregatedTrainingEvalCriterionValue;
 
         size_t m_prevDistributedTotalNumSamples;
+
+        std::shared_ptr<CheckpointWriter> m_checkpointWriter; // created by the first SaveCheckpointAsync
+        double m_checkpointBlockingTimeInSeconds;
+        bool m_distributedCheckpointMayBePending; // the main worker may still be writing a checkpoint that all workers saved asynchronously
     };
 
     ///
@@ -5368,6 +5644,13 @@ namespace CNTK
         ///
         bool isFrameModeEnabled{ false };
 
+        ///
+        /// Number of minibatches to read ahead and regroup by sequence length, so that sequences of similar
+        /// lengths end up in the same minibatch and less padding is needed. Zero (default) disables bucketing
+        /// (cannot be used in frame mode or with truncation, an exception will be raised otherwise).
+        ///
+        size_t bucketingWindowInMinibatches{ 0 };
+
         ///
         /// Specifies if the deserialization should be done on a single or multiple threads. 
         /// Defaults to 'auto' (multhithreading is disabled unless ImageDeserializer is present 
@@ -5676,12 +5959,14 @@ namespace CNTK
         /// checkpointFrequencyInSamples: frequency in samples when to perform checkpointing.
         /// restoreFromCheckpointIfExists: if flag is set, the training session will try to restore before training.
         /// preserveAllCheckpoints: if flag is set, all checkpoints will be preserved.
+        /// writeAsynchronously: if flag is set, checkpoints taken during training are written by a background thread (see Trainer::SaveCheckpointAsync).
         ///
         CNTK_API CheckpointConfig(
             const std::wstring& checkPointFileName,
             size_t checkpointFrequencyInSamples = std::numeric_limits<size_t>::max(),
             bool restoreFromCheckpointIfExists = true,
-            bool preserveAllCheckpoints = false);
+            bool preserveAllCheckpoints = false,
+            bool writeAsynchronously = false);
 
     private:
         friend class TrainingSession;
@@ -5689,6 +5974,7 @@ namespace CNTK
         const bool m_restore;
         const bool m_preserveAll;
         const size_t m_frequency;
+        const bool m_async;
     };
 
     ///
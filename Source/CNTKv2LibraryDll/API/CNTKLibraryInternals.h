@@ -47,6 +47,11 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     template <typename ElemType>
     class TensorView;
 
+    template <typename ElemType>
+    class CPUMatrix;
+
+    struct bfloat16;
+
     class ComputationNetwork;
     typedef std::shared_ptr<ComputationNetwork> ComputationNetworkPtr;
 
@@ -159,6 +164,7 @@ namespace CNTK
     struct MinibatchData;
 
     class Serializer;
+    class CheckpointWriter;
 
     // Similar to make_shared except that it associates a custom deleter with the shared_ptr to ensure
     // that objects are deleted on the same side of the library DLL where they are allocated
@@ -212,6 +218,14 @@ namespace CNTK
     class Evaluator;
     typedef std::shared_ptr<Evaluator> EvaluatorPtr;
 
+    class BatchingEvaluator;
+    typedef std::shared_ptr<BatchingEvaluator> BatchingEvaluatorPtr;
+
+    class BeamSearchDecoder;
+    typedef std::shared_ptr<BeamSearchDecoder> BeamSearchDecoderPtr;
+    template <typename ElementType>
+    class BeamSearchDecoderImpl;
+
     class Trainer;
     typedef std::shared_ptr<Trainer> TrainerPtr;
 
@@ -299,8 +313,21 @@ namespace CNTK
         CNTK_API void EnableGradientAccumulationOptimization();
         CNTK_API void DisableGradientAccumulationOptimization();
 
+        // Storage type of the weights of Times operations for inference on the CPU, in networks that are built after this call:
+        // Float (the default) keeps the element type of the network, BFloat16 and Int8 store the weights as bfloat16 or as int8
+        // with one scale per output row, respectively. These are not DataTypes, since no NDArrayView can hold such values.
+        enum class TimesWeightStorageType : unsigned int
+        {
+            Float,
+            BFloat16,
+            Int8
+        };
+        CNTK_API void SetTimesWeightStorageType(TimesWeightStorageType storageType);
+        CNTK_API TimesWeightStorageType GetTimesWeightStorageType();
+
         static const uint64_t DefaultProfilerBufferSize = 32 * 1024 * 1024;
-        CNTK_API void StartProfiler(const std::wstring& profilerDir = L"profiler", bool profilerSyncGpu = false, size_t profilerBufferSize = DefaultProfilerBufferSize);
+        // 'profileNodes' additionally records the forward and backward time of each node of the networks.
+        CNTK_API void StartProfiler(const std::wstring& profilerDir = L"profiler", bool profilerSyncGpu = false, size_t profilerBufferSize = DefaultProfilerBufferSize, bool profileNodes = false);
         CNTK_API void EnableProfiler();
         CNTK_API void DisableProfiler();
         CNTK_API void StopProfiler();
@@ -0,0 +1,315 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace CNTK
+{
+    // number of most recent requests whose latencies make up the percentiles
+    static const size_t latencyWindowSize = 4096;
+
+    template <typename ElementType>
+    class BatchingEvaluatorImpl final : public BatchingEvaluator
+    {
+        typedef std::vector<std::vector<ElementType>> Sequences;
+        typedef std::chrono::steady_clock Clock;
+
+        // The sequences of a request are unpacked and packed by the calling thread, so that the evaluating thread
+        // only concatenates them and splits the outputs.
+        struct Request
+        {
+            std::unordered_map<Variable, Sequences> m_arguments;
+            std::unordered_map<Variable, std::vector<bool>> m_sequenceStartFlags;
+            size_t m_numSequences;
+            Clock::time_point m_submitTime;
+
+            std::unordered_map<Variable, Sequences> m_outputs;
+            std::promise<void> m_done;
+        };
+        typedef std::shared_ptr<Request> RequestPtr;
+
+    public:
+        BatchingEvaluatorImpl(const FunctionPtr& evaluationFunction, size_t maxBatchSize, size_t maxLatencyInMicroseconds, const DeviceDescriptor& computeDevice)
+            : BatchingEvaluator(evaluationFunction),
+              m_arguments(evaluationFunction->Arguments()),
+              m_outputs(evaluationFunction->Outputs()),
+              m_maxBatchSize(maxBatchSize),
+              m_maxLatency(std::chrono::microseconds(maxLatencyInMicroseconds)),
+              m_computeDevice(computeDevice),
+              m_numQueuedSequences(0),
+              m_stopping(false)
+        {
+            if (maxBatchSize == 0)
+                InvalidArgument("BatchingEvaluator: the maximum batch size must be positive.");
+
+            if (m_arguments.empty())
+                InvalidArgument("BatchingEvaluator: the Function '%S' has no arguments.", evaluationFunction->AsString().c_str());
+            for (const auto& argument : m_arguments)
+            {
+                if (argument.DynamicAxes().empty())
+                    InvalidArgument("BatchingEvaluator: argument '%S' has no batch axis.", argument.AsString().c_str());
+            }
+            for (const auto& output : m_outputs)
+            {
+                if (output.DynamicAxes().empty())
+                    InvalidArgument("BatchingEvaluator: output '%S' has no batch axis.", output.AsString().c_str());
+            }
+
+            ResetStatistics();
+            m_evaluationThread = std::thread([this]() { EvaluateRequests(); });
+        }
+
+        ~BatchingEvaluatorImpl()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                m_stopping = true;
+            }
+            m_requestQueued.notify_one();
+            m_evaluationThread.join();
+        }
+
+        void Evaluate(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputs) override
+        {
+            auto submitTime = Clock::now();
+
+            auto request = std::make_shared<Request>();
+            request->m_numSequences = UnpackArguments(arguments, *request);
+            for (const auto& output : outputs)
+            {
+                if (std::find(m_outputs.begin(), m_outputs.end(), output.first) == m_outputs.end())
+                    InvalidArgument("BatchingEvaluator: '%S' is not an output of the Function '%S'.", output.first.AsString().c_str(), m_evaluationFunction->AsString().c_str());
+            }
+            request->m_submitTime = submitTime;
+
+            auto done = request->m_done.get_future();
+            {
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                m_queue.push_back(request);
+                m_numQueuedSequences += request->m_numSequences;
+            }
+            m_requestQueued.notify_one();
+            done.get(); // rethrows the error of the batch, if any
+
+            for (auto& output : outputs)
+            {
+                // the outputs of a single request all start a sequence
+                auto value = Value::Create(output.first.Shape(), request->m_outputs.at(output.first), m_computeDevice, /*readOnly =*/ false);
+                if (output.second)
+                    output.second->CopyFrom(*value);
+                else
+                    output.second = value;
+            }
+
+            RecordLatency(std::chrono::duration<double, std::milli>(Clock::now() - submitTime).count());
+        }
+
+        BatchingEvaluatorStatistics Statistics() const override
+        {
+            std::lock_guard<std::mutex> lock(m_statisticsMutex);
+            auto statistics = m_statistics;
+            statistics.p50LatencyInMs = LatencyPercentile(0.5);
+            statistics.p99LatencyInMs = LatencyPercentile(0.99);
+            return statistics;
+        }
+
+        void ResetStatistics() override
+        {
+            std::lock_guard<std::mutex> lock(m_statisticsMutex);
+            m_statistics = BatchingEvaluatorStatistics{ 0, 0, 0, 0, 0 };
+            m_latencies.clear();
+            m_nextLatency = 0;
+        }
+
+    private:
+        // Unpacks the Values of the arguments into the request, and returns the number of sequences.
+        size_t UnpackArguments(const std::unordered_map<Variable, ValuePtr>& arguments, Request& request) const
+        {
+            if (arguments.size() != m_arguments.size())
+                InvalidArgument("BatchingEvaluator: %zu arguments were given, but the Function '%S' has %zu.",
+                                arguments.size(), m_evaluationFunction->AsString().c_str(), m_arguments.size());
+
+            size_t numSequences = 0;
+            for (const auto& argument : m_arguments)
+            {
+                auto iter = arguments.find(argument);
+                if (iter == arguments.end() || !iter->second)
+                    InvalidArgument("BatchingEvaluator: no Value was given for argument '%S'.", argument.AsString().c_str());
+                const auto& value = iter->second;
+
+                auto& sequences = request.m_arguments[argument];
+                value->CopyVariableValueTo(argument, sequences);
+                if (sequences.empty())
+                    InvalidArgument("BatchingEvaluator: the Value of argument '%S' has no sequences.", argument.AsString().c_str());
+                if (argument == m_arguments.front())
+                    numSequences = sequences.size();
+                else if (sequences.size() != numSequences)
+                    InvalidArgument("BatchingEvaluator: the Value of argument '%S' has %zu sequences, but others have %zu.",
+                                    argument.AsString().c_str(), sequences.size(), numSequences);
+
+                // without a mask, every sequence starts in the Value
+                auto& startFlags = request.m_sequenceStartFlags[argument];
+                startFlags.assign(numSequences, true);
+                auto mask = value->Mask();
+                if (mask)
+                {
+                    if (mask->Device() != DeviceDescriptor::CPUDevice())
+                        mask = mask->DeepClone(DeviceDescriptor::CPUDevice());
+                    const MaskKind* maskData = mask->DataBuffer();
+                    size_t maxSequenceLength = mask->Shape().TotalSize() / numSequences;
+                    for (size_t i = 0; i < numSequences; i++)
+                        startFlags[i] = maskData[i * maxSequenceLength] == MaskKind::SequenceBegin;
+                }
+            }
+            return numSequences;
+        }
+
+        void EvaluateRequests()
+        {
+            for (;;)
+            {
+                std::vector<RequestPtr> batch;
+                {
+                    std::unique_lock<std::mutex> lock(m_queueMutex);
+                    m_requestQueued.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+                    if (m_queue.empty())
+                        return; // stopping, and nothing is left to evaluate
+
+                    // give other requests until the deadline of the oldest one to fill the batch
+                    auto deadline = m_queue.front()->m_submitTime + m_maxLatency;
+                    m_requestQueued.wait_until(lock, deadline, [this]() { return m_stopping || m_numQueuedSequences >= m_maxBatchSize; });
+
+                    size_t numSequences = 0;
+                    while (!m_queue.empty() && (batch.empty() || numSequences + m_queue.front()->m_numSequences <= m_maxBatchSize))
+                    {
+                        numSequences += m_queue.front()->m_numSequences;
+                        batch.push_back(m_queue.front());
+                        m_queue.pop_front();
+                    }
+                    m_numQueuedSequences -= numSequences;
+                }
+
+                try
+                {
+                    EvaluateBatch(batch);
+                }
+                catch (...)
+                {
+                    for (const auto& request : batch)
+                        request->m_done.set_exception(std::current_exception());
+                    continue;
+                }
+                for (const auto& request : batch)
+                    request->m_done.set_value();
+            }
+        }
+
+        void EvaluateBatch(const std::vector<RequestPtr>& batch)
+        {
+            std::unordered_map<Variable, ValuePtr> arguments;
+            for (const auto& argument : m_arguments)
+            {
+                Sequences sequences;
+                std::vector<bool> startFlags;
+                for (const auto& request : batch)
+                {
+                    auto& requestSequences = request->m_arguments.at(argument);
+                    std::move(requestSequences.begin(), requestSequences.end(), std::back_inserter(sequences));
+                    const auto& requestStartFlags = request->m_sequenceStartFlags.at(argument);
+                    startFlags.insert(startFlags.end(), requestStartFlags.begin(), requestStartFlags.end());
+                }
+                arguments[argument] = Value::Create(argument.Shape(), sequences, startFlags, m_computeDevice, /*readOnly =*/ true);
+            }
+
+            std::unordered_map<Variable, ValuePtr> outputs;
+            for (const auto& output : m_outputs)
+                outputs[output] = nullptr;
+            m_evaluationFunction->Evaluate(arguments, outputs, m_computeDevice);
+
+            size_t numSequences = 0;
+            for (const auto& output : m_outputs)
+            {
+                Sequences sequences;
+                outputs.at(output)->CopyVariableValueTo(output, sequences);
+
+                size_t first = 0;
+                for (const auto& request : batch)
+                {
+                    auto& requestSequences = request->m_outputs[output];
+                    requestSequences.assign(std::make_move_iterator(sequences.begin() + first),
+                                            std::make_move_iterator(sequences.begin() + first + request->m_numSequences));
+                    first += request->m_numSequences;
+                }
+                numSequences = first;
+            }
+
+            std::lock_guard<std::mutex> lock(m_statisticsMutex);
+            m_statistics.numRequests += batch.size();
+            m_statistics.numBatches++;
+            m_statistics.numSequences += numSequences;
+        }
+
+        void RecordLatency(double latencyInMs)
+        {
+            std::lock_guard<std::mutex> lock(m_statisticsMutex);
+            if (m_latencies.size() < latencyWindowSize)
+                m_latencies.push_back(latencyInMs);
+            else
+                m_latencies[m_nextLatency] = latencyInMs;
+            m_nextLatency = (m_nextLatency + 1) % latencyWindowSize;
+        }
+
+        // call with m_statisticsMutex held
+        double LatencyPercentile(double fraction) const
+        {
+            if (m_latencies.empty())
+                return 0;
+            std::vector<double> latencies(m_latencies);
+            auto nth = latencies.begin() + (size_t)(fraction * (latencies.size() - 1) + 0.5);
+            std::nth_element(latencies.begin(), nth, latencies.end());
+            return *nth;
+        }
+
+        const std::vector<Variable> m_arguments;
+        const std::vector<Variable> m_outputs;
+        const size_t m_maxBatchSize;
+        const Clock::duration m_maxLatency;
+        const DeviceDescriptor m_computeDevice;
+
+        std::mutex m_queueMutex;
+        std::condition_variable m_requestQueued;
+        std::deque<RequestPtr> m_queue;
+        size_t m_numQueuedSequences;
+        bool m_stopping;
+        std::thread m_evaluationThread;
+
+        mutable std::mutex m_statisticsMutex;
+        BatchingEvaluatorStatistics m_statistics;
+        std::vector<double> m_latencies; // ring buffer of the most recent latencies
+        size_t m_nextLatency;
+    };
+
+    BatchingEvaluatorPtr CreateBatchingEvaluator(const FunctionPtr& evaluationFunction, size_t maxBatchSize, size_t maxLatencyInMicroseconds, const DeviceDescriptor& computeDevice)
+    {
+        if (!evaluationFunction)
+            InvalidArgument("BatchingEvaluator: the Function is not allowed to be null.");
+
+        auto dataType = evaluationFunction->Outputs().front().GetDataType();
+        if (dataType == DataType::Float)
+            return MakeSharedObject<BatchingEvaluatorImpl<float>>(evaluationFunction, maxBatchSize, maxLatencyInMicroseconds, computeDevice);
+        else if (dataType == DataType::Double)
+            return MakeSharedObject<BatchingEvaluatorImpl<double>>(evaluationFunction, maxBatchSize, maxLatencyInMicroseconds, computeDevice);
+        else
+            InvalidArgument("BatchingEvaluator: unsupported DataType %s.", DataTypeName(dataType));
+    }
+}
@@ -0,0 +1,512 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Microsoft::MSR::CNTK;
+
+namespace CNTK
+{
+    template <typename ElementType>
+    class BeamSearchDecoderImpl final : public BeamSearchDecoder
+    {
+        // The hypotheses of source b occupy the slots [b * beamWidth, (b + 1) * beamWidth) of the batch that the step Function
+        // is evaluated for. Slots without a hypothesis (e.g. all but the first in the first step) have a score of -infinity;
+        // they are evaluated along with the others, so that the shapes of the Values stay the same across the steps.
+        // The Values stay on the compute device: per step, only the best scores of each slot are copied to the host, and only
+        // the chosen tokens and the parent slots of the hypotheses are copied back, to gather the states on the device.
+        // The host keeps tokens and slots as integers; the matrix operations on the device take them as ElementType values,
+        // so they are only converted when they are copied to or from the device, and must be represented exactly there.
+        struct Candidate
+        {
+            double score;
+            size_t slot;
+            size_t token;
+        };
+
+        // A state input and its state output, each backed by a Value on the compute device that the step Function reads or writes in place.
+        struct RecurrentState
+        {
+            Variable input;
+            Variable output;
+            std::shared_ptr<Matrix<ElementType>> inputMatrix;  // views of the Values, with a column per slot
+            std::shared_ptr<Matrix<ElementType>> outputMatrix;
+        };
+
+    public:
+        BeamSearchDecoderImpl(const FunctionPtr& stepFunction, const Variable& tokenInput, const Variable& scoresOutput,
+                              const std::vector<std::pair<Variable, Variable>>& recurrentStates,
+                              size_t startToken, size_t endToken, size_t beamWidth, size_t maxLength,
+                              double lengthNormalizationExponent, double pruningThreshold, const DeviceDescriptor& computeDevice)
+            : BeamSearchDecoder(stepFunction),
+              m_tokenInput(tokenInput),
+              m_scoresOutput(scoresOutput),
+              m_vocabularySize(tokenInput.Shape().HasUnboundDimension() ? 0 : tokenInput.Shape().TotalSize()),
+              m_startToken(startToken),
+              m_endToken(endToken),
+              m_beamWidth(beamWidth),
+              m_maxLength(maxLength),
+              m_lengthNormalizationExponent(lengthNormalizationExponent),
+              m_pruningThreshold(pruningThreshold),
+              m_computeDevice(computeDevice),
+              m_numCandidatesPerSlot(std::min(2 * beamWidth, tokenInput.Shape().HasUnboundDimension() ? 0 : tokenInput.Shape().TotalSize())),
+              m_numSources(0),
+              m_numSlots(0)
+        {
+            if (beamWidth == 0)
+                InvalidArgument("BeamSearchDecoder: the beam width must be positive.");
+            if (maxLength == 0)
+                InvalidArgument("BeamSearchDecoder: the maximum length must be positive.");
+            if (!(lengthNormalizationExponent >= 0))
+                InvalidArgument("BeamSearchDecoder: the length normalization exponent must not be negative.");
+            if (!(pruningThreshold >= 0))
+                InvalidArgument("BeamSearchDecoder: the pruning threshold must not be negative.");
+
+            auto arguments = stepFunction->Arguments();
+            auto outputs = stepFunction->Outputs();
+            auto isArgument = [&arguments](const Variable& var) { return std::find(arguments.begin(), arguments.end(), var) != arguments.end(); };
+            auto isOutput = [&outputs](const Variable& var) { return std::find(outputs.begin(), outputs.end(), var) != outputs.end(); };
+
+            for (const auto& var : arguments)
+                VerifyBatchAxisOnly(var);
+            for (const auto& var : outputs)
+                VerifyBatchAxisOnly(var);
+
+            if (!isArgument(tokenInput))
+                InvalidArgument("BeamSearchDecoder: the token input '%S' is not an argument of the step Function '%S'.", tokenInput.AsString().c_str(), stepFunction->AsString().c_str());
+            if (m_vocabularySize == 0)
+                InvalidArgument("BeamSearchDecoder: the token input '%S' has an unknown dimension.", tokenInput.AsString().c_str());
+            if (m_vocabularySize > MaxExactIndex())
+                InvalidArgument("BeamSearchDecoder: the vocabulary size %zu exceeds %zu, the number of token indices that %s represents exactly.",
+                                m_vocabularySize, MaxExactIndex(), DataTypeName(AsDataType<ElementType>()));
+            if (startToken >= m_vocabularySize || endToken >= m_vocabularySize)
+                InvalidArgument("BeamSearchDecoder: the start token %zu and the end token %zu must be less than the vocabulary size %zu.", startToken, endToken, m_vocabularySize);
+
+            if (!isOutput(scoresOutput))
+                InvalidArgument("BeamSearchDecoder: the scores output '%S' is not an output of the step Function '%S'.", scoresOutput.AsString().c_str(), stepFunction->AsString().c_str());
+            if (scoresOutput.Shape().HasUnboundDimension() || scoresOutput.Shape().TotalSize() != m_vocabularySize)
+                InvalidArgument("BeamSearchDecoder: the scores output '%S' must have one element for each of the %zu tokens.", scoresOutput.AsString().c_str(), m_vocabularySize);
+
+            for (const auto& state : recurrentStates)
+            {
+                if (!isArgument(state.first) || state.first == tokenInput)
+                    InvalidArgument("BeamSearchDecoder: the state input '%S' is not an argument of the step Function '%S'.", state.first.AsString().c_str(), stepFunction->AsString().c_str());
+                if (!isOutput(state.second))
+                    InvalidArgument("BeamSearchDecoder: the state output '%S' is not an output of the step Function '%S'.", state.second.AsString().c_str(), stepFunction->AsString().c_str());
+                if (state.first.Shape().HasUnboundDimension() || state.first.Shape() != state.second.Shape())
+                    InvalidArgument("BeamSearchDecoder: the state input '%S' and the state output '%S' must have the same known shape.", state.first.AsString().c_str(), state.second.AsString().c_str());
+                if (std::any_of(m_states.begin(), m_states.end(), [&state](const RecurrentState& other) { return other.input == state.first; }))
+                    InvalidArgument("BeamSearchDecoder: the state input '%S' is fed by more than one state output.", state.first.AsString().c_str());
+
+                m_states.push_back(RecurrentState{ state.first, state.second });
+            }
+
+            for (const auto& argument : arguments)
+            {
+                if (argument != tokenInput && !IsStateInput(argument))
+                {
+                    if (argument.Shape().HasUnboundDimension())
+                        InvalidArgument("BeamSearchDecoder: argument '%S' has an unknown dimension.", argument.AsString().c_str());
+                    m_sourceArguments.push_back(argument);
+                }
+            }
+        }
+
+        std::vector<std::vector<BeamSearchHypothesis>> Decode(const std::unordered_map<Variable, ValuePtr>& arguments) override
+        {
+            auto initialValues = UnpackArguments(arguments);
+            Allocate(m_numSources);
+
+            // replicate the sample of each source into the slots of its hypotheses
+            for (size_t i = 0; i < m_sourceArguments.size(); i++)
+                ReplicateSources(initialValues.at(m_sourceArguments[i]), *m_sourceMatrices[i]);
+            for (auto& state : m_states)
+            {
+                auto iter = initialValues.find(state.input);
+                if (iter != initialValues.end())
+                    ReplicateSources(iter->second, *state.inputMatrix);
+                else
+                    state.inputMatrix->SetValue(0);
+            }
+
+            const size_t numSlots = m_numSlots;
+            std::fill(m_slotTokens.begin(), m_slotTokens.end(), m_startToken);
+            SetTokenInput();
+            for (size_t slot = 0; slot < numSlots; slot++)
+                m_slotScores[slot] = (slot % m_beamWidth == 0) ? 0 : -std::numeric_limits<double>::infinity();
+
+            std::vector<std::vector<BeamSearchHypothesis>> finished(m_numSources);
+            std::vector<bool> done(m_numSources, false);
+            size_t numDone = 0;
+            size_t length = 0;
+            while (length < m_maxLength && numDone < m_numSources)
+            {
+                m_stepFunction->Evaluate(m_arguments, m_outputs, m_computeDevice);
+                CopyBestScoresToHost();
+
+                // the hypotheses of the slots after this step, each a token and a back-pointer to the slot of its parent in the previous step
+                length++;
+                if (m_stepTokens.size() < length)
+                {
+                    m_stepTokens.emplace_back();
+                    m_stepParents.emplace_back();
+                }
+                m_stepTokens[length - 1].assign(numSlots, SIZE_MAX);
+                m_stepParents[length - 1].assign(numSlots, SIZE_MAX);
+
+                std::fill(m_nextSlotScores.begin(), m_nextSlotScores.end(), -std::numeric_limits<double>::infinity());
+                for (size_t source = 0; source < m_numSources; source++)
+                {
+                    if (done[source])
+                        continue;
+
+                    const auto& candidates = SelectCandidates(source);
+                    size_t numLive = 0;
+                    for (size_t rank = 0; rank < candidates.size(); rank++)
+                    {
+                        const auto& candidate = candidates[rank];
+                        if (candidate.score < candidates.front().score - m_pruningThreshold)
+                            break;
+
+                        // Like the other hypotheses, a finished one must rank within the beam; the candidates after the
+                        // first beamWidth only stand in for those that finished.
+                        if (candidate.token == m_endToken)
+                        {
+                            if (rank < m_beamWidth && finished[source].size() < m_beamWidth)
+                                finished[source].push_back(MakeHypothesis(length - 1, candidate.slot, candidate.token, candidate.score));
+                        }
+                        else if (numLive < m_beamWidth)
+                        {
+                            size_t slot = source * m_beamWidth + numLive++;
+                            m_stepTokens[length - 1][slot] = candidate.token;
+                            m_stepParents[length - 1][slot] = candidate.slot;
+                            m_nextSlotScores[slot] = candidate.score;
+                        }
+                    }
+
+                    if (finished[source].size() >= m_beamWidth || numLive == 0)
+                    {
+                        done[source] = true;
+                        numDone++;
+                    }
+                }
+
+                // gather the states of the parents of the surviving hypotheses into the state inputs of the next step
+                for (size_t slot = 0; slot < numSlots; slot++)
+                {
+                    bool isLive = m_stepParents[length - 1][slot] != SIZE_MAX;
+                    m_hostIndices[slot] = isLive ? (ElementType)m_stepParents[length - 1][slot] : (ElementType)-1; // a negative index leaves the column as it is
+                    if (isLive)
+                        m_slotTokens[slot] = m_stepTokens[length - 1][slot];
+                }
+                if (!m_states.empty())
+                {
+                    m_parentSlots->SetValue(1, numSlots, m_parentSlots->GetDeviceId(), m_hostIndices.data());
+                    for (auto& state : m_states)
+                        state.inputMatrix->DoGatherColumnsOf(0, *m_parentSlots, *state.outputMatrix, 1);
+                }
+                SetTokenInput();
+                m_slotScores.swap(m_nextSlotScores);
+            }
+
+            // sources that ran out of steps return their unfinished hypotheses
+            for (size_t source = 0; source < m_numSources; source++)
+            {
+                if (done[source])
+                    continue;
+                for (size_t slot = source * m_beamWidth; slot < (source + 1) * m_beamWidth; slot++)
+                {
+                    if (m_slotScores[slot] > -std::numeric_limits<double>::infinity())
+                        finished[source].push_back(MakeHypothesis(length, slot, SIZE_MAX, m_slotScores[slot]));
+                }
+            }
+
+            for (auto& hypotheses : finished)
+            {
+                std::stable_sort(hypotheses.begin(), hypotheses.end(), [](const BeamSearchHypothesis& a, const BeamSearchHypothesis& b) { return a.normalizedScore > b.normalizedScore; });
+                if (hypotheses.size() > m_beamWidth)
+                    hypotheses.resize(m_beamWidth);
+            }
+            return finished;
+        }
+
+    private:
+        static void VerifyBatchAxisOnly(const Variable& var)
+        {
+            if (var.DynamicAxes().size() != 1 || var.DynamicAxes().front() != Axis::DefaultBatchAxis())
+                InvalidArgument("BeamSearchDecoder: '%S' of the step Function must have the batch axis as its only dynamic axis.", var.AsString().c_str());
+        }
+
+        // the number of indices from 0 that ElementType represents exactly, i.e. 2^24 for float
+        static size_t MaxExactIndex()
+        {
+            return (size_t)1 << std::numeric_limits<ElementType>::digits;
+        }
+
+        bool IsStateInput(const Variable& var) const
+        {
+            return std::any_of(m_states.begin(), m_states.end(), [&var](const RecurrentState& state) { return state.input == var; });
+        }
+
+        // Returns the Values of the arguments as dense matrices on the compute device, with a column per source, and sets the number of sources.
+        std::unordered_map<Variable, std::shared_ptr<const Matrix<ElementType>>> UnpackArguments(const std::unordered_map<Variable, ValuePtr>& arguments)
+        {
+            std::unordered_map<Variable, std::shared_ptr<const Matrix<ElementType>>> samples;
+            size_t numSources = 0;
+            for (const auto& argument : arguments)
+            {
+                if (std::find(m_sourceArguments.begin(), m_sourceArguments.end(), argument.first) == m_sourceArguments.end() && !IsStateInput(argument.first))
+                    InvalidArgument("BeamSearchDecoder: '%S' is neither an argument nor a state input of the step Function '%S'; the token input is set by the decoder.",
+                                    argument.first.AsString().c_str(), m_stepFunction->AsString().c_str());
+                if (!argument.second)
+                    InvalidArgument("BeamSearchDecoder: the Value of '%S' is null.", argument.first.AsString().c_str());
+                if (argument.second->GetDataType() != AsDataType<ElementType>())
+                    InvalidArgument("BeamSearchDecoder: the Value of '%S' has DataType %s, but the step Function computes in %s.",
+                                    argument.first.AsString().c_str(), DataTypeName(argument.second->GetDataType()), DataTypeName(AsDataType<ElementType>()));
+                if (argument.second->MaskedCount() != 0)
+                    InvalidArgument("BeamSearchDecoder: the Value of '%S' has masked samples.", argument.first.AsString().c_str());
+
+                auto data = argument.second->Data();
+                if (data->IsSparse() || data->Device() != m_computeDevice)
+                {
+                    auto denseData = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), StorageFormat::Dense, data->Shape(), m_computeDevice);
+                    denseData->CopyFrom(*data);
+                    data = denseData;
+                }
+
+                size_t sampleSize = argument.first.Shape().TotalSize();
+                size_t numSamples = data->Shape().TotalSize() / sampleSize;
+                if (numSources == 0)
+                    numSources = numSamples;
+                if (numSamples == 0 || numSamples * sampleSize != data->Shape().TotalSize() || numSamples != numSources)
+                    InvalidArgument("BeamSearchDecoder: the Value of '%S' has %zu samples, but others have %zu.", argument.first.AsString().c_str(), numSamples, numSources);
+
+                samples[argument.first] = data->AsShape({ sampleSize, numSamples })->template GetMatrix<ElementType>(1);
+            }
+
+            for (const auto& argument : m_sourceArguments)
+            {
+                if (samples.find(argument) == samples.end())
+                    InvalidArgument("BeamSearchDecoder: no Value was given for argument '%S'.", argument.AsString().c_str());
+            }
+
+            m_numSources = std::max<size_t>(numSources, 1);
+            return samples;
+        }
+
+        void ReplicateSources(const std::shared_ptr<const Matrix<ElementType>>& samples, Matrix<ElementType>& slots) const
+        {
+            slots.DoGatherColumnsOf(0, *m_slotSources, *samples, 1);
+        }
+
+        // Creates a Value of a batch of samples of 'var' on the compute device, without a mask, and a view of it with a column per slot.
+        ValuePtr CreateBatchValue(const Variable& var, std::shared_ptr<Matrix<ElementType>>& slots) const
+        {
+            auto data = MakeSharedObject<NDArrayView>(0, AsDataType<ElementType>(), var.Shape().AppendShape({ m_numSlots }), m_computeDevice);
+            slots = data->AsShape({ var.Shape().TotalSize(), m_numSlots })->template GetWritableMatrix<ElementType>(1);
+            return MakeSharedObject<Value>(data);
+        }
+
+        // (Re)allocates the Values of the step and the buffers for a batch size; they are kept for as long as it does not change.
+        void Allocate(size_t numSources)
+        {
+            size_t numSlots = numSources * m_beamWidth;
+            if (m_numSlots == numSlots)
+                return;
+            if (numSlots > MaxExactIndex())
+                InvalidArgument("BeamSearchDecoder: %zu sources with a beam width of %zu exceed %zu hypotheses, the number of slot indices that %s represents exactly.",
+                                numSources, m_beamWidth, MaxExactIndex(), DataTypeName(AsDataType<ElementType>()));
+
+            m_numSlots = numSlots;
+            auto deviceId = AsCNTKImplDeviceId(m_computeDevice);
+
+            m_arguments.clear();
+            m_outputs.clear();
+            m_sourceMatrices.resize(m_sourceArguments.size());
+            for (size_t i = 0; i < m_sourceArguments.size(); i++)
+                m_arguments[m_sourceArguments[i]] = CreateBatchValue(m_sourceArguments[i], m_sourceMatrices[i]);
+            for (auto& state : m_states)
+            {
+                m_arguments[state.input] = CreateBatchValue(state.input, state.inputMatrix);
+                m_outputs[state.output] = CreateBatchValue(state.output, state.outputMatrix);
+            }
+            m_outputs[m_scoresOutput] = CreateBatchValue(m_scoresOutput, m_scoresMatrix);
+
+            if (m_tokenInput.IsSparse())
+            {
+                m_tokenColStarts.resize(numSlots + 1);
+                for (size_t slot = 0; slot <= numSlots; slot++)
+                    m_tokenColStarts[slot] = (SparseIndexType)slot;
+                m_tokenRowIndices.resize(numSlots);
+                m_tokenValues.assign(numSlots, (ElementType)1);
+            }
+            else
+            {
+                m_arguments[m_tokenInput] = CreateBatchValue(m_tokenInput, m_tokenMatrix);
+                m_slotTokenIndices = std::make_shared<Matrix<ElementType>>(1, numSlots, deviceId);
+            }
+
+            std::vector<ElementType> slotSources(numSlots);
+            for (size_t slot = 0; slot < numSlots; slot++)
+                slotSources[slot] = (ElementType)(slot / m_beamWidth);
+            m_slotSources = std::make_shared<Matrix<ElementType>>(1, numSlots, slotSources.data(), deviceId);
+            m_parentSlots = std::make_shared<Matrix<ElementType>>(1, numSlots, deviceId);
+            m_bestScores = std::make_shared<Matrix<ElementType>>(m_numCandidatesPerSlot, numSlots, deviceId);
+            m_bestTokens = std::make_shared<Matrix<ElementType>>(m_numCandidatesPerSlot, numSlots, deviceId);
+            m_hostIndices.resize(numSlots);
+            m_hostBestScores.resize(m_numCandidatesPerSlot * numSlots);
+            m_hostBestTokens.resize(m_numCandidatesPerSlot * numSlots);
+
+            m_slotTokens.assign(numSlots, m_startToken);
+            m_slotScores.resize(numSlots);
+            m_nextSlotScores.resize(numSlots);
+        }
+
+        // Sets the token input to the one-hot vectors of m_slotTokens.
+        void SetTokenInput()
+        {
+            if (m_tokenInput.IsSparse())
+            {
+                // a sparse token input is only a token index per slot, which the step Function copies to the compute device
+                for (size_t slot = 0; slot < m_numSlots; slot++)
+                    m_tokenRowIndices[slot] = (SparseIndexType)m_slotTokens[slot];
+                auto data = MakeSharedObject<NDArrayView>(m_tokenInput.Shape().AppendShape({ m_numSlots }), m_tokenColStarts.data(), m_tokenRowIndices.data(), m_tokenValues.data(),
+                                                          m_numSlots, DeviceDescriptor::CPUDevice(), /*readOnly =*/ true);
+                m_arguments[m_tokenInput] = MakeSharedObject<Value>(data);
+            }
+            else
+            {
+                std::vector<size_t> shape = { m_vocabularySize };
+                for (size_t slot = 0; slot < m_numSlots; slot++)
+                    m_hostIndices[slot] = (ElementType)m_slotTokens[slot];
+                m_slotTokenIndices->SetValue(1, m_numSlots, m_slotTokenIndices->GetDeviceId(), m_hostIndices.data());
+                m_tokenMatrix->AssignOneHot(*m_slotTokenIndices, shape, 0, /*is_sparse =*/ false);
+            }
+        }
+
+        // Copies the m_numCandidatesPerSlot best scores of each slot, in no particular order, and their tokens to the host.
+        void CopyBestScoresToHost()
+        {
+            m_scoresMatrix->VectorMax(*m_bestTokens, *m_bestScores, /*isColWise =*/ true, (int)m_numCandidatesPerSlot);
+            m_bestScores->CopySection(m_numCandidatesPerSlot, m_numSlots, m_hostBestScores.data(), m_numCandidatesPerSlot);
+            m_bestTokens->CopySection(m_numCandidatesPerSlot, m_numSlots, m_hostBestTokens.data(), m_numCandidatesPerSlot);
+        }
+
+        // Returns the 2 * beamWidth best extensions of the hypotheses of a source, best first, so that there are enough of them
+        // to fill the beam even if up to beamWidth of them end with the end token. Each of them is among the best of its slot.
+        const std::vector<Candidate>& SelectCandidates(size_t source)
+        {
+            // a min-heap of the best candidates; ties are broken by the slot and the token, so that the order does not depend on the device
+            auto better = [](const Candidate& a, const Candidate& b) { return a.score != b.score ? a.score > b.score : (a.slot != b.slot ? a.slot < b.slot : a.token < b.token); };
+            size_t maxNumCandidates = 2 * m_beamWidth;
+            m_candidates.clear();
+            for (size_t slot = source * m_beamWidth; slot < (source + 1) * m_beamWidth; slot++)
+            {
+                double slotScore = m_slotScores[slot];
+                if (slotScore == -std::numeric_limits<double>::infinity())
+                    continue;
+
+                const ElementType* logProbabilities = m_hostBestScores.data() + slot * m_numCandidatesPerSlot;
+                const ElementType* tokens = m_hostBestTokens.data() + slot * m_numCandidatesPerSlot;
+                for (size_t i = 0; i < m_numCandidatesPerSlot; i++)
+                {
+                    Candidate candidate{ slotScore + logProbabilities[i], slot, (size_t)tokens[i] };
+                    if (m_candidates.size() < maxNumCandidates)
+                    {
+                        m_candidates.push_back(candidate);
+                        std::push_heap(m_candidates.begin(), m_candidates.end(), better);
+                    }
+                    else if (better(candidate, m_candidates.front()))
+                    {
+                        std::pop_heap(m_candidates.begin(), m_candidates.end(), better);
+                        m_candidates.back() = candidate;
+                        std::push_heap(m_candidates.begin(), m_candidates.end(), better);
+                    }
+                }
+            }
+            std::sort_heap(m_candidates.begin(), m_candidates.end(), better);
+            return m_candidates;
+        }
+
+        // Returns the hypothesis of 'slot' after 'numSteps' steps, whose tokens are found by following the back-pointers to the
+        // parent slots; 'lastToken' is appended to it unless it is SIZE_MAX.
+        BeamSearchHypothesis MakeHypothesis(size_t numSteps, size_t slot, size_t lastToken, double score) const
+        {
+            BeamSearchHypothesis hypothesis{ std::vector<size_t>(numSteps), score, score };
+            for (size_t step = numSteps; step > 0; step--)
+            {
+                hypothesis.tokens[step - 1] = m_stepTokens[step - 1][slot];
+                slot = m_stepParents[step - 1][slot];
+            }
+            if (lastToken != SIZE_MAX)
+                hypothesis.tokens.push_back(lastToken);
+            if (m_lengthNormalizationExponent != 0)
+                hypothesis.normalizedScore = score / std::pow((double)hypothesis.tokens.size(), m_lengthNormalizationExponent);
+            return hypothesis;
+        }
+
+        const Variable m_tokenInput;
+        const Variable m_scoresOutput;
+        const size_t m_vocabularySize;
+        const size_t m_startToken;
+        const size_t m_endToken;
+        const size_t m_beamWidth;
+        const size_t m_maxLength;
+        const double m_lengthNormalizationExponent;
+        const double m_pruningThreshold;
+        const DeviceDescriptor m_computeDevice;
+        const size_t m_numCandidatesPerSlot; // the best extensions of each hypothesis that are copied to the host, enough to fill the beam
+
+        std::vector<Variable> m_sourceArguments; // arguments other than the token and state inputs
+        std::vector<RecurrentState> m_states;
+
+        // the Values that the step Function is evaluated with, on the compute device, for m_numSlots = m_numSources * m_beamWidth slots
+        size_t m_numSources;
+        size_t m_numSlots;
+        std::vector<std::shared_ptr<Matrix<ElementType>>> m_sourceMatrices;
+        std::shared_ptr<Matrix<ElementType>> m_scoresMatrix;
+        std::shared_ptr<Matrix<ElementType>> m_tokenMatrix; // dense token input
+        std::vector<SparseIndexType> m_tokenColStarts, m_tokenRowIndices; // sparse token input, on the CPU
+        std::vector<ElementType> m_tokenValues;
+        std::unordered_map<Variable, ValuePtr> m_arguments;
+        std::unordered_map<Variable, ValuePtr> m_outputs;
+
+        // row vectors on the compute device with the source, the parent slot and the token of each slot, and the best scores of each slot
+        std::shared_ptr<Matrix<ElementType>> m_slotSources, m_parentSlots, m_slotTokenIndices;
+        std::shared_ptr<Matrix<ElementType>> m_bestScores, m_bestTokens;
+        std::vector<ElementType> m_hostIndices; // the parent slots or the tokens of the slots, on their way to the compute device
+        std::vector<ElementType> m_hostBestScores, m_hostBestTokens;
+
+        // the hypotheses in the slots
+        std::vector<size_t> m_slotTokens; // the last token of each slot
+        std::vector<double> m_slotScores, m_nextSlotScores;
+        std::vector<std::vector<size_t>> m_stepTokens, m_stepParents; // for each step and slot, the token and the slot of its parent in the previous step
+        std::vector<Candidate> m_candidates;
+    };
+
+    BeamSearchDecoderPtr CreateBeamSearchDecoder(const FunctionPtr& stepFunction, const Variable& tokenInput, const Variable& scoresOutput,
+                                                 const std::vector<std::pair<Variable, Variable>>& recurrentStates,
+                                                 size_t startToken, size_t endToken, size_t beamWidth, size_t maxLength,
+                                                 double lengthNormalizationExponent, double pruningThreshold, const DeviceDescriptor& computeDevice)
+    {
+        if (!stepFunction)
+            InvalidArgument("BeamSearchDecoder: the step Function is not allowed to be null.");
+
+        auto dataType = scoresOutput.GetDataType();
+        if (dataType == DataType::Float)
+            return MakeSharedObject<BeamSearchDecoderImpl<float>>(stepFunction, tokenInput, scoresOutput, recurrentStates, startToken, endToken, beamWidth, maxLength,
+                                                                  lengthNormalizationExponent, pruningThreshold, computeDevice);
+        else if (dataType == DataType::Double)
+            return MakeSharedObject<BeamSearchDecoderImpl<double>>(stepFunction, tokenInput, scoresOutput, recurrentStates, startToken, endToken, beamWidth, maxLength,
+                                                                   lengthNormalizationExponent, pruningThreshold, computeDevice);
+        else
+            InvalidArgument("BeamSearchDecoder: unsupported DataType %s.", DataTypeName(dataType));
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "CheckpointWriter.h"
+
+namespace CNTK
+{
+    CheckpointWriter::CheckpointWriter()
+        : m_numPendingWrites(0), m_stopping(false)
+    {
+        m_thread = std::thread([this]() { WriteQueued(); });
+    }
+
+    CheckpointWriter::~CheckpointWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_writeQueued.notify_one();
+        m_thread.join();
+
+        if (m_error)
+        {
+            try
+            {
+                std::rethrow_exception(m_error);
+            }
+            catch (const std::exception& e)
+            {
+                fprintf(stderr, "WARNING: Writing a checkpoint failed: %s\n", e.what());
+            }
+            catch (...)
+            {
+                fprintf(stderr, "WARNING: Writing a checkpoint failed.\n");
+            }
+        }
+    }
+
+    void CheckpointWriter::Enqueue(std::function<void()>&& write, size_t maxPendingWrites)
+    {
+        if (maxPendingWrites == 0)
+            LogicError("CheckpointWriter: the maximum number of pending writes must be positive.");
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_writeDone.wait(lock, [this, maxPendingWrites]() { return m_error || m_numPendingWrites < maxPendingWrites; });
+            ThrowIfFailed();
+
+            m_queue.push_back(std::move(write));
+            m_numPendingWrites++;
+        }
+        m_writeQueued.notify_one();
+    }
+
+    void CheckpointWriter::Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_writeDone.wait(lock, [this]() { return m_numPendingWrites == 0; });
+        ThrowIfFailed();
+    }
+
+    void CheckpointWriter::ThrowIfFailed()
+    {
+        if (m_error)
+        {
+            // the error is reported once; the writes that follow it are attempted anyway
+            auto error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    void CheckpointWriter::WriteQueued()
+    {
+        for (;;)
+        {
+            std::function<void()> write;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_writeQueued.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty())
+                    return; // stopping, and nothing is left to write
+
+                write = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+
+            std::exception_ptr error;
+            try
+            {
+                write();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (error && !m_error)
+                    m_error = error;
+                m_numPendingWrites--;
+            }
+            m_writeDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include "stdafx.h"
+#include "CNTKLibraryInternals.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace CNTK
+{
+    ///
+    /// Runs the writes of checkpoints on a background thread, one at a time and in the order in which they were queued,
+    /// so that the training thread only waits for taking the snapshot that a write serializes.
+    /// Used by the Trainer and by the SGD of the CNTK executable.
+    ///
+    class CNTK_API CheckpointWriter final
+    {
+    public:
+        CheckpointWriter();
+
+        // Completes the queued writes.
+        ~CheckpointWriter();
+
+        // Queues a write once fewer than maxPendingWrites writes are queued or in progress.
+        // Throws the error of an earlier write that failed instead of queueing it.
+        void Enqueue(std::function<void()>&& write, size_t maxPendingWrites);
+
+        // Waits until the queued writes are done, and throws the error of a write that failed.
+        void Wait();
+
+    private:
+        void WriteQueued();
+
+        // call with m_mutex held
+        void ThrowIfFailed();
+
+        std::mutex m_mutex;
+        std::condition_variable m_writeQueued;
+        std::condition_variable m_writeDone;
+        std::deque<std::function<void()>> m_queue;
+        size_t m_numPendingWrites; // queued or in progress
+        std::exception_ptr m_error;
+        bool m_stopping;
+        std::thread m_thread;
+    };
+}
@@ -15,6 +15,7 @@
 #include "GPUMatrix.h"
 #include "Globals.h"
 #include "PerformanceProfiler.h"
+#include "NodeProfiler.h"
 #include "MPIWrapper.h"
 #include "EnvironmentUtil.h"
 #include "Basics.h"
@@ -171,7 +172,20 @@ namespace CNTK
             Microsoft::MSR::CNTK::Globals::SetGradientAccumulationOptimization(/* enable = */ false);
         }
 
-        void StartProfiler(const wstring& profilerDir, bool profilerSyncGpu, size_t profilerBufferSize)
+        std::atomic<unsigned int> s_timesWeightStorageType((unsigned int)TimesWeightStorageType::Float);
+        void SetTimesWeightStorageType(TimesWeightStorageType storageType)
+        {
+            if (storageType != TimesWeightStorageType::Float && storageType != TimesWeightStorageType::BFloat16 && storageType != TimesWeightStorageType::Int8)
+                InvalidArgument("SetTimesWeightStorageType: Unknown storage type %u.", (unsigned int)storageType);
+            s_timesWeightStorageType.store((unsigned int)storageType);
+        }
+
+        TimesWeightStorageType GetTimesWeightStorageType()
+        {
+            return (TimesWeightStorageType)s_timesWeightStorageType.load();
+        }
+
+        void StartProfiler(const wstring& profilerDir, bool profilerSyncGpu, size_t profilerBufferSize, bool profileNodes)
         {
 #ifndef CNTK_UWP
             std::wstring logSuffix = L"";
@@ -186,6 +200,13 @@ namespace CNTK
                 profilerBufferSize,
                 logSuffix,
                 profilerSyncGpu);
+
+            if (profileNodes)
+            {
+                Microsoft::MSR::CNTK::NodeProfilerInit(profilerDir, logSuffix);
+                if (profilerSyncGpu)
+                    SyncGuard::EnableSync();
+            }
 #endif
         }
 
@@ -193,6 +214,7 @@ namespace CNTK
         {
 #ifndef CNTK_UWP
             Microsoft::MSR::CNTK::ProfilerEnable(true);
+            Microsoft::MSR::CNTK::NodeProfilerEnable(true);
 #endif
         }
 
@@ -200,6 +222,7 @@ namespace CNTK
         {
 #ifndef CNTK_UWP
             Microsoft::MSR::CNTK::ProfilerEnable(false);
+            Microsoft::MSR::CNTK::NodeProfilerEnable(false);
 #endif
         }
 
@@ -207,6 +230,7 @@ namespace CNTK
         {
 #ifndef CNTK_UWP
             Microsoft::MSR::CNTK::ProfilerClose();
+            Microsoft::MSR::CNTK::NodeProfilerClose();
 #endif
         }
 
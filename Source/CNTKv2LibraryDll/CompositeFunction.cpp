@@ -453,21 +453,31 @@ namespace CNTK
             if (!variable.NeedsGradient() || (inputsToExcludeGradientsFor.find(variable) != inputsToExcludeGradientsFor.end()))
                 computationNodePtr->SetLearningRateMultiplier(0.0);
 
-            NDArrayViewPtr value = variable.IsConstant() ? Constant(variable).Value() : Parameter(variable).Value();
-            std::shared_ptr<const Matrix<ElementType>> valueMatrix = variable.IsConstant() ? value->GetMatrix<ElementType>() : value->GetWritableMatrix<ElementType>();
+            if (variable.GetDataType() == DataType::BFloat16)
+            {
+                if (variable.IsParameter())
+                    InvalidArgument("Parameter '%S' has DataType BFloat16, which is only supported for Constants.", variable.AsString().c_str());
 
-            if (variable.IsParameter() || (valueMatrix->GetDeviceId() == network->GetDeviceId()))
-                computationNodePtr->Value() = valueMatrix->AsReference();
-            else // Constant: if initialized data lives on wrong device, make a copy to the right one (copy is OK since it's constant)
+                AssignWidenedBFloat16Value(Constant(variable).Value(), *computationNodePtr);
+            }
+            else
             {
-                // TODO: the following two lines are a workaround for a bug in the Math library
-                // (AssignValuesOf throws when source and destination matrices reside on different GPU devices).
-                // Once this bug is fixed, change to 
-                // Matrix<ElementType> clonedMatrix(valueMatrix->GetNumRows(), valueMatrix->GetNumCols(), network->GetDeviceId(), valueMatrix->GetMatrixType(), valueMatrix->GetFormat());
-                Matrix<ElementType> clonedMatrix(network->GetDeviceId());
-                clonedMatrix.SwitchToMatrixType(valueMatrix->GetMatrixType(), valueMatrix->GetFormat(), false);
-                clonedMatrix.AssignValuesOf(*valueMatrix);
-                computationNodePtr->Value() = std::move(clonedMatrix);
+                NDArrayViewPtr value = variable.IsConstant() ? Constant(variable).Value() : Parameter(variable).Value();
+                std::shared_ptr<const Matrix<ElementType>> valueMatrix = variable.IsConstant() ? value->GetMatrix<ElementType>() : value->GetWritableMatrix<ElementType>();
+
+                if (variable.IsParameter() || (valueMatrix->GetDeviceId() == network->GetDeviceId()))
+                    computationNodePtr->Value() = valueMatrix->AsReference();
+                else // Constant: if initialized data lives on wrong device, make a copy to the right one (copy is OK since it's constant)
+                {
+                    // TODO: the following two lines are a workaround for a bug in the Math library
+                    // (AssignValuesOf throws when source and destination matrices reside on different GPU devices).
+                    // Once this bug is fixed, change to 
+                    // Matrix<ElementType> clonedMatrix(valueMatrix->GetNumRows(), valueMatrix->GetNumCols(), network->GetDeviceId(), valueMatrix->GetMatrixType(), valueMatrix->GetFormat());
+                    Matrix<ElementType> clonedMatrix(network->GetDeviceId());
+                    clonedMatrix.SwitchToMatrixType(valueMatrix->GetMatrixType(), valueMatrix->GetFormat(), false);
+                    clonedMatrix.AssignValuesOf(*valueMatrix);
+                    computationNodePtr->Value() = std::move(clonedMatrix);
+                }
             }
         }
         else if (variable.IsInput())
@@ -1190,8 +1200,9 @@ namespace CNTK
         std::vector<std::shared_ptr<ComputationNode<ElementType>>> inputNodes;
         for (auto& inputVar : functionInputs)
         {
-            // If the inputVar is a constant and not the right DataType let's coerce it to the right type
-            if (inputVar.IsConstant() && (nonConstInputDataType != DataType::Unknown) && (inputVar.GetDataType() != nonConstInputDataType))
+            // If the inputVar is a constant and not the right DataType let's coerce it to the right type.
+            // BFloat16 Constants are kept, so that they are stored in 16 bits; GetNode() widens their values for the network.
+            if (inputVar.IsConstant() && (nonConstInputDataType != DataType::Unknown) && (inputVar.GetDataType() != nonConstInputDataType) && (inputVar.GetDataType() != DataType::BFloat16))
                 inputVar = Constant(inputVar).CloneAs(nonConstInputDataType);
 
             auto baseNodePtr = GetNode(inputVar, network, builder, fullyDefinedArgumentsMap, variableToNodeMap, isVariableRootMap, inputsToExcludeGradientsFor, useMangledNamesForComputationNodes);
@@ -1377,6 +1388,14 @@ namespace CNTK
         // This could lead to incorrect results or crash, because the matrix of the input nodes might never be initialized for ForwardProp().
         computationNetwork->SetEvalTimeStampsOutdatedWithRegardToAll();
 
+        // The weights are converted after the timestamps were reset, since the converted weights remember the timestamp of the
+        // parameter they were converted from, and would otherwise be converted a second time in the first evaluation.
+        // The float weights are kept, since the values of the Parameters are views of them.
+        if (Internal::GetTimesWeightStorageType() == Internal::TimesWeightStorageType::BFloat16)
+            ComputationNetwork::SetTimesWeightStorage(computationNetwork, nullptr, TimesWeightStorage::BFloat16);
+        else if (Internal::GetTimesWeightStorageType() == Internal::TimesWeightStorageType::Int8)
+            ComputationNetwork::SetTimesWeightStorage(computationNetwork, nullptr, TimesWeightStorage::Int8);
+
         // Verify that the shapes of the output Variables that we computed match the corresponding nodes in the ComputationNetwork
         for (auto varNodePair : variableToNodeMap)
         {
@@ -1397,6 +1416,52 @@ namespace CNTK
         return { computationNetwork, variableToNodeMap };
     }
 
+    template <typename ElementType>
+    /*static*/ void CompositeFunction::AssignWidenedBFloat16Value(const NDArrayViewPtr& value, ComputationNode<ElementType>& node)
+    {
+        // values that were released by UseBFloat16ConstantsInTimes() stay released; the Times operations read the bfloat16 values
+        if (node.Value().IsEmpty())
+            return;
+
+        auto widenedValue = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), value->Shape(), AsDeviceDescriptor(node.GetDeviceId()));
+        widenedValue->CopyFrom(*value);
+        node.Value().AssignValuesOf(*widenedValue->template GetMatrix<ElementType>());
+    }
+
+    template <typename ElementType>
+    void CompositeFunction::UseBFloat16ConstantsInTimes(bool releaseWidenedValues)
+    {
+        std::unordered_map<ComputationNodeBasePtr, NDArrayViewPtr> bfloat16Values;
+        for (const auto& varNodePair : m_variableToNodeMap)
+        {
+            if (varNodePair.first.IsConstant() && (varNodePair.first.GetDataType() == DataType::BFloat16))
+                bfloat16Values[varNodePair.second] = Constant(varNodePair.first).Value();
+        }
+
+        if (bfloat16Values.empty())
+            return;
+
+        // the widened values can only be released if the Times operation is the only node that reads them
+        std::unordered_map<ComputationNodeBasePtr, size_t> numConsumers;
+        auto allNodes = m_computationNetwork->GetAllNodes();
+        for (const auto& node : allNodes)
+            for (const auto& input : node->GetInputs())
+                numConsumers[input]++;
+
+        for (const auto& node : allNodes)
+        {
+            auto timesNode = std::dynamic_pointer_cast<TimesNode<ElementType>>(node);
+            auto valueIter = timesNode ? bfloat16Values.find(timesNode->GetInputs()[0]) : bfloat16Values.end();
+            if (valueIter == bfloat16Values.end())
+                continue;
+
+            // the bfloat16 values are shared with the Constant, whose updates thus reach the product
+            const auto& value = valueIter->second;
+            timesNode->SetBFloat16Weights((const Microsoft::MSR::CNTK::bfloat16*)value->template DataBuffer<CNTK::bfloat16>(), value->Shape().TotalSize(), value,
+                                          releaseWidenedValues && (numConsumers[valueIter->first] == 1));
+        }
+    }
+
     template <typename ElementType>
     ComputationNetworkPtr CompositeFunction::GetComputationNetwork(const DeviceDescriptor& device,
                                                                    const std::unordered_set<Variable>& backpropRoots,
@@ -1490,6 +1555,9 @@ namespace CNTK
             for (auto constant : functionConstants)
                 m_lastRecordedTimeStamps.insert({ constant, constant.CurrentValueTimeStamp() });
 
+            // A network without backprop roots is only evaluated, so its Times operations need no more than the bfloat16 values.
+            UseBFloat16ConstantsInTimes<ElementType>(/*releaseWidenedValues =*/ backpropRoots.empty());
+
             // Collect parameters and constants being assigned to
             PreorderTraverseFunctions(RootFunction(), [this](const FunctionPtr& function) {
                 auto primitiveFunction = dynamic_cast<PrimitiveFunction*>(function.get());
@@ -1537,8 +1605,11 @@ namespace CNTK
         return m_computationNetwork;
     }
 
+    // Returns whether the value of the node now refers to the storage of the Value instead of to a copy of it, which is only done
+    // if 'aliasValueStorage' is specified. The caller then has to give the node its own value back once the Value may change.
     template <typename ElementType>
-    /*static*/ void CompositeFunction::PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, ComputationNodeBasePtr& computationNode, std::unordered_map<MBLayoutPtr, Variable>& layoutsPopulated)
+    /*static*/ bool CompositeFunction::PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, ComputationNodeBasePtr& computationNode, std::unordered_map<MBLayoutPtr, Variable>& layoutsPopulated,
+                                                                    bool aliasValueStorage/* = false*/)
     {
         NDShape inferredVariableShape;
         std::pair<std::shared_ptr<const Matrix<ElementType>>, MBLayoutPtr> CNTKMatrixAndMBLayout = Utils::GetCNTKImplMatrixAndMBLayoutFromValueObject<ElementType>(variableValue.first, variableValue.second, &inferredVariableShape);
@@ -1546,11 +1617,25 @@ namespace CNTK
             CNTK::LogicError("CompositeFunction::Forward: Inferred shape '%S' of Variable '%S' does not match the corresponding computation node shape '%s'.", 
                              inferredVariableShape.AsString().c_str(), variableValue.first.AsString().c_str(), ((std::string)computationNode->GetSampleLayout()).c_str());
 
-        // Switch the node matrix to the right matrix type
-        auto& nodeData = computationNode->As<ComputationNode<ElementType>>()->Value();
-        nodeData.AssignValuesOf(*CNTKMatrixAndMBLayout.first);
-
         auto layout = CNTKMatrixAndMBLayout.second;
+
+        // The storage of the Value is used in place if it is on the right device. Packed Values are excluded as they refer to
+        // network storage, which may be overwritten during the same Forward call. Some nodes mask the gaps of their
+        // inputs in place, which must never write into the caller's storage, so a Value with gaps is copied.
+        auto& nodeValuePtr = computationNode->As<ComputationNode<ElementType>>()->ValuePtrRef();
+        const auto& matrix = CNTKMatrixAndMBLayout.first;
+        bool alias = aliasValueStorage &&
+                     (dynamic_cast<const PackedValue*>(variableValue.second.get()) == nullptr) &&
+                     (matrix->GetDeviceId() == computationNode->GetDeviceId()) &&
+                     (!layout || !layout->HasGaps());
+        if (alias)
+            nodeValuePtr = std::const_pointer_cast<Matrix<ElementType>>(matrix);
+        else
+        {
+            // Switch the node matrix to the right matrix type
+            nodeValuePtr->AssignValuesOf(*matrix);
+        }
+
         auto& nodeLayout = computationNode->GetMBLayout();
         if ((layout == nullptr) != (nodeLayout == nullptr))
             InvalidArgument("The layout of the specified Value for Variable '%S' is incompatible with the layout of the corresponding ComputationNode.", variableValue.first.AsString().c_str());
@@ -1569,6 +1654,8 @@ namespace CNTK
                                      variableValue.first.AsString().c_str(), layoutsPopulated.at(nodeLayout).AsString().c_str(), DynamicAxesAsString(variableValue.first.DynamicAxes(), Internal::IsReversingTensorShapesInErrorMessagesEnabled()).c_str());
             }
         }
+
+        return alias;
     }
 
     std::unordered_map<Variable, NDShape> CompositeFunction::InferFreeDimensionsOfArguments(const std::unordered_map<Variable, ValuePtr>& arguments)
@@ -1616,7 +1703,7 @@ namespace CNTK
         return inferredArgumentDimensions;
     }
 
-    void CompositeFunction::PopulateNetworkInputs(const std::unordered_map<Variable, ValuePtr>& arguments)
+    void CompositeFunction::PopulateNetworkInputs(const std::unordered_map<Variable, ValuePtr>& arguments, bool aliasValueStorage/* = false*/)
     {
         std::unordered_map<MBLayoutPtr, Variable> layoutsPopulated;
         std::vector<ComputationNodeBasePtr> inputNodes;
@@ -1628,23 +1715,43 @@ namespace CNTK
             inputNodes.push_back(argumentComputationNode);
 
             ValuePtr argumentValue = arguments.at(argument);
+            auto nodeValue = argumentComputationNode->ValuePtr();
+            bool nodeValueAliasesArgument = false;
             switch (argumentValue->GetDataType())
             {
             case DataType::Float:
-                PopulateComputationNodeValue<float>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated);
+                nodeValueAliasesArgument = PopulateComputationNodeValue<float>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated, aliasValueStorage);
                 break;
             case DataType::Double:
-                PopulateComputationNodeValue<double>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated);
+                nodeValueAliasesArgument = PopulateComputationNodeValue<double>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated, aliasValueStorage);
                 break;
             default:
                 LogicError("Function '%S' Forward: Unsupported DataType %s.", AsString().c_str(), DataTypeName(argumentValue->GetDataType()));
                 break;
             }
+
+            if (nodeValueAliasesArgument)
+                m_inputNodeValuesReplacedByArguments.insert({ argumentComputationNode, nodeValue });
         }
 
         m_computationNetwork->BumpEvalTimeStamp(inputNodes);
     }
 
+    // Give the input nodes whose value refers to the storage of an argument their own values back, so that the network
+    // holds no reference to the caller's storage after the Forward call that was given it.
+    void CompositeFunction::DetachInputNodeValuesFromArguments()
+    {
+        for (const auto& nodeValue : m_inputNodeValuesReplacedByArguments)
+        {
+            const auto& node = nodeValue.first;
+            if (node->Is<ComputationNode<float>>())
+                node->As<ComputationNode<float>>()->ValuePtrRef() = std::dynamic_pointer_cast<Matrix<float>>(nodeValue.second);
+            else
+                node->As<ComputationNode<double>>()->ValuePtrRef() = std::dynamic_pointer_cast<Matrix<double>>(nodeValue.second);
+        }
+        m_inputNodeValuesReplacedByArguments.clear();
+    }
+
     template <typename ElementType>
     /*static*/ void CompositeFunction::PopulateComputationNodeGradient(const std::pair<Variable, ValuePtr>& variableGradient, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode)
     {
@@ -1686,6 +1793,28 @@ namespace CNTK
         }
     }
 
+    // The data of a node is unpacked straight into the storage of the specified Value when it needs to be rearranged,
+    // and the Value is dense, writable and on the same device; 'unpackedIntoVarValue' tells whether this was done.
+    template <typename ElementType>
+    /*static*/ ValuePtr CompositeFunction::GetNodeOutputOrGradientValue(const Variable& var, const ValuePtr& varValue, ComputationNodeBasePtr& computationNode, bool getGradient, bool& unpackedIntoVarValue)
+    {
+        auto& matrix = getGradient ? computationNode->As<ComputationNode<ElementType>>()->Gradient() : computationNode->As<ComputationNode<ElementType>>()->Value();
+        auto layout = computationNode->GetMBLayout();
+        auto varShape = GetVariableShape(var.Shape(), computationNode->GetSampleLayout());
+        unpackedIntoVarValue = false;
+        if (varValue == nullptr)
+            return MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<ElementType>>(matrix.AsReference()), layout, /*readOnly =*/ false);
+
+        std::shared_ptr<Matrix<ElementType>> unpackedDataStorage;
+        if ((dynamic_cast<const PackedValue*>(varValue.get()) == nullptr) && !varValue->IsReadOnly() && !varValue->IsSparse() &&
+            (AsCNTKImplDeviceId(varValue->Device()) == matrix.GetDeviceId()))
+            unpackedDataStorage = varValue->Data()->template GetWritableMatrix<ElementType>(varShape.Rank());
+
+        auto nodeValue = Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout<ElementType>(var, computationNode, matrix, layout, /*readOnly =*/ true, unpackedDataStorage);
+        unpackedIntoVarValue = unpackedDataStorage && !nodeValue->IsSparse() && (nodeValue->Data()->template DataBuffer<ElementType>() == unpackedDataStorage->Data());
+        return nodeValue;
+    }
+
     /*static*/ void CompositeFunction::GetNodeOutputOrGradient(Variable var, ValuePtr& varValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, bool getGradient)
     {
         auto varShape = GetVariableShape(var.Shape(), computationNode->GetSampleLayout());
@@ -1699,27 +1828,15 @@ namespace CNTK
         }
 
         ValuePtr nodeValue;
-        auto layout = computationNode->GetMBLayout();
+        bool unpackedIntoVarValue = false;
         switch (var.GetDataType())
         {
         case DataType::Float:
-        {
-            auto& matrix = getGradient ? computationNode->As<ComputationNode<float>>()->Gradient() : computationNode->As<ComputationNode<float>>()->Value();
-            if (varValue == nullptr)
-                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<float>>(matrix.AsReference()), layout, /*readOnly =*/ false);
-            else
-                nodeValue = Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout<float>(var, computationNode, matrix, layout);
+            nodeValue = GetNodeOutputOrGradientValue<float>(var, varValue, computationNode, getGradient, unpackedIntoVarValue);
             break;
-        }
         case DataType::Double:
-        {
-            auto& matrix = getGradient ? computationNode->As<ComputationNode<double>>()->Gradient() : computationNode->As<ComputationNode<double>>()->Value();
-            if (varValue == nullptr)
-                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<double>>(matrix.AsReference()), layout, /*readOnly =*/ false);
-            else
-                nodeValue = Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout<double>(var, computationNode, matrix, layout);
+            nodeValue = GetNodeOutputOrGradientValue<double>(var, varValue, computationNode, getGradient, unpackedIntoVarValue);
             break;
-        }
         default:
             CNTK::LogicError("CompositeFunction::Forward/Backward: Unsupported DataType %s", DataTypeName(var.GetDataType()));
             break;
@@ -1727,8 +1844,19 @@ namespace CNTK
 
         if (varValue == nullptr)
             varValue = nodeValue;
-        else
+        else if (!unpackedIntoVarValue)
             varValue->CopyFrom(*nodeValue);
+        else
+        {
+            // Only the mask is left to update
+            if ((varValue->Mask() == nullptr) && (nodeValue->Mask() != nullptr))
+                InvalidArgument("The Value object specified for Variable '%S' does not have a mask, which the %s requires.", var.AsString().c_str(), getGradient ? "gradient" : "output");
+
+            if (nodeValue->Mask() != nullptr)
+                varValue->Mask()->CopyFrom(*nodeValue->Mask());
+            else if (varValue->Mask() != nullptr)
+                varValue->Mask()->Clear();
+        }
     }
 
     void CompositeFunction::GetNetworkOutputs(std::unordered_map<Variable, ValuePtr>& outputs)
@@ -1880,9 +2008,11 @@ namespace CNTK
         else
             InvalidArgument("Unsupported DataType %s", DataTypeName(dataType));
 
-        // Feed data into the arguments of the network
-        // TODO: Avoid copying the data when possible
-        PopulateNetworkInputs(requiredArgumentValues);
+        // Feed data into the arguments of the network. Without a subsequent Backward call, the network only needs the
+        // argument values during this call, so it can use their storage in place until the call returns. Backward
+        // therefore never sees such a reference.
+        auto detachArguments = MakeScopeExit([this]() { DetachInputNodeValuesFromArguments(); });
+        PopulateNetworkInputs(requiredArgumentValues, /*aliasValueStorage =*/ outputsToRetainBackwardStateFor.empty());
 
         // Copy all new values for 'dirty' attributes from functions into corresponding network nodes.
         ApplyAttributeUpdates();
@@ -1896,7 +2026,15 @@ namespace CNTK
             if (newTimeStamp > prevTimeStamp)
             {
                 timeStampRecord.second = newTimeStamp;
-                m_variableToNodeMap.at(variable)->BumpEvalTimeStamp();
+                auto& node = m_variableToNodeMap.at(variable);
+                if (variable.GetDataType() == DataType::BFloat16)
+                {
+                    if (dataType == DataType::Float)
+                        AssignWidenedBFloat16Value(Constant(variable).Value(), *node->As<ComputationNode<float>>());
+                    else
+                        AssignWidenedBFloat16Value(Constant(variable).Value(), *node->As<ComputationNode<double>>());
+                }
+                node->BumpEvalTimeStamp();
             }
         }
 
@@ -1984,6 +2122,32 @@ namespace CNTK
         ScopedNetworkOperationMode modeGuard(m_computationNetwork, NetworkOperationMode::training);
 
         auto rootComputationNodePtr = m_variableToNodeMap.at(rootGradientValues.begin()->first);
+
+        // the map from the nodes to their Parameters is only built once per network, not per Backward call
+        if (m_parameterGradientCompleted && !m_nodeParameterGradientCompleted)
+        {
+            std::unordered_map<ComputationNodeBase*, Parameter> nodeParameters;
+            for (const auto& varNodePair : m_variableToNodeMap)
+            {
+                if (varNodePair.first.IsParameter())
+                    nodeParameters.emplace(varNodePair.second.get(), Parameter(varNodePair.first));
+            }
+
+            auto callback = m_parameterGradientCompleted;
+            m_nodeParameterGradientCompleted = [nodeParameters, callback](const ComputationNodeBasePtr& node)
+            {
+                auto nodeParameter = nodeParameters.find(node.get());
+                if (nodeParameter == nodeParameters.end())
+                    return;
+
+                ValuePtr gradientValue;
+                auto computationNode = node;
+                GetNodeOutputOrGradient(nodeParameter->second, gradientValue, computationNode, /*getGradient =*/ true);
+                callback(nodeParameter->second, gradientValue->Data());
+            };
+        }
+
+        m_computationNetwork->SetParameterGradientCompletedCallback(rootComputationNodePtr, m_nodeParameterGradientCompleted);
         m_computationNetwork->GetNestedNetwork(rootComputationNodePtr)->Backprop(FrameRange(nullptr), true, true);
 
         GetNetworkGradients(backPropagatedGradientValuesForInputs);
@@ -1998,6 +2162,22 @@ namespace CNTK
         // TODO: How to deal with the specified 'computeDevice'
     }
 
+    std::unordered_set<Parameter> CompositeFunction::ParametersWithSparseGradients() const
+    {
+        std::unordered_set<Parameter> parameters;
+        PreorderTraverseFunctions(RootFunction(), [&parameters](const FunctionPtr& function) {
+            auto primitiveFunction = dynamic_cast<PrimitiveFunction*>(function.get());
+            if (!primitiveFunction || (primitiveFunction->OpType() != PrimitiveOpType::Times && primitiveFunction->OpType() != PrimitiveOpType::TransposeTimes))
+                return;
+
+            const auto& inputs = primitiveFunction->Inputs();
+            if (inputs[0].IsParameter() && inputs[1].IsSparse())
+                parameters.insert(Parameter(inputs[0]));
+        }, /*nestedSearchInsideBlockFunction =*/ true);
+
+        return parameters;
+    }
+
     void CompositeFunction::ApplyAttributeUpdates()
     {
         // Dropout nodes have an implicit input in the form of the random mask that is applied to its explicit input
@@ -108,6 +108,17 @@ namespace CNTK
                               const std::unordered_map<Variable, ValuePtr>& rootGradientValues,
                               std::unordered_map<Variable, ValuePtr>& backPropagatedGradientValuesForInputs) override;
 
+        // Makes Backward call 'callback' with each Parameter and its gradient as soon as the gradient is complete, while the rest of the network
+        // is still being backpropagated through (e.g. to start aggregating the gradient across workers). An empty callback removes it.
+        void SetParameterGradientCompletedCallback(const std::function<void(const Parameter&, const NDArrayViewPtr&)>& callback)
+        {
+            m_parameterGradientCompleted = callback;
+            m_nodeParameterGradientCompleted = nullptr;
+        }
+
+        // The Parameters that are the left operand of a Times or TransposeTimes with a sparse right operand, which backprop gives sparse gradients.
+        std::unordered_set<Parameter> ParametersWithSparseGradients() const;
+
         Dictionary SerializeBlockComposite() const;
 
         virtual Dictionary Serialize() const override;
@@ -310,14 +321,26 @@ namespace CNTK
                                                                     const std::unordered_set<Variable>& inputsToExcludeGradientsFor,
                                                                     bool useMangledNamesForComputationNodes);
 
+        // The network node of a Constant of DataType::BFloat16 holds its values widened to ElementType.
+        template <typename ElementType>
+        static void AssignWidenedBFloat16Value(const NDArrayViewPtr& value, Microsoft::MSR::CNTK::ComputationNode<ElementType>& node);
+
+        // Let the Times operations that read a Constant of DataType::BFloat16 multiply with its bfloat16 values directly.
         template <typename ElementType>
-        static void PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, std::unordered_map< Microsoft::MSR::CNTK::MBLayoutPtr, Variable>& layoutsPopulated);
-        void PopulateNetworkInputs(const std::unordered_map<Variable, ValuePtr>& arguments);
+        void UseBFloat16ConstantsInTimes(bool releaseWidenedValues);
+
+        template <typename ElementType>
+        static bool PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, std::unordered_map< Microsoft::MSR::CNTK::MBLayoutPtr, Variable>& layoutsPopulated,
+                                                 bool aliasValueStorage = false);
+        void PopulateNetworkInputs(const std::unordered_map<Variable, ValuePtr>& arguments, bool aliasValueStorage = false);
+        void DetachInputNodeValuesFromArguments();
 
         template <typename ElementType>
         static void PopulateComputationNodeGradient(const std::pair<Variable, ValuePtr>& variableGradient, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode);
         void PopulateNetworkGradients(const std::unordered_map<Variable, ValuePtr>& gradients);
 
+        template <typename ElementType>
+        static ValuePtr GetNodeOutputOrGradientValue(const Variable& var, const ValuePtr& varValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, bool getGradient, bool& unpackedIntoVarValue);
         static void GetNodeOutputOrGradient(Variable var, ValuePtr& varValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, bool getGradient);
         void GetNetworkOutputs(std::unordered_map<Variable, ValuePtr>& outputs);
         void GetNetworkGradients(std::unordered_map<Variable, ValuePtr>& gradients);
@@ -348,6 +371,8 @@ namespace CNTK
             m_variableToNodeMap.clear();
             m_currentOutputsToEvaluate.clear();
             m_lastRecordedTimeStamps.clear();
+            m_inputNodeValuesReplacedByArguments.clear();
+            m_nodeParameterGradientCompleted = nullptr;
 
             m_networkMatricesAllocated = false;
             m_computationNetwork = nullptr;
@@ -376,6 +401,10 @@ namespace CNTK
         // Map to keep track of any references to network output/gradient storage handed out so far
         std::vector<PackedValueWeakPtr> m_existingNetworkStorageReferences;
 
+        // Input nodes whose value refers to the storage of an argument Value during the current Forward call, with the
+        // values of their own that are restored at its end
+        std::unordered_map<Microsoft::MSR::CNTK::ComputationNodeBasePtr, Microsoft::MSR::CNTK::MatrixBasePtr> m_inputNodeValuesReplacedByArguments;
+
         // The backpropRoots specified in the most recent 'Forward' call on 'this' Function.
         // This indicates for which of its roots has 'this' Function retained required intermediate 
         // states from the previos Forward call to be able to backpropagate gradients backwards from in
@@ -399,6 +428,11 @@ namespace CNTK
 
         std::unordered_set<Variable> m_inputsExcludedFromGradientComputation;
 
+        std::function<void(const Parameter&, const NDArrayViewPtr&)> m_parameterGradientCompleted;
+
+        // m_parameterGradientCompleted wrapped for the nodes of the current network, built by the first Backward call that needs it
+        std::function<void(const Microsoft::MSR::CNTK::ComputationNodeBasePtr&)> m_nodeParameterGradientCompleted;
+
         // Version history:
         // 1 -- initial version.
         // 2 -- add support for stateful functions (with corresponding nodes inheriting from RngUser).
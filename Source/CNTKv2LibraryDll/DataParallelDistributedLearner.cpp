@@ -109,16 +109,124 @@ namespace CNTK
     }
 #endif
 
-    DistributedLearnerPtr CreateDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate)
+    DistributedLearnerPtr CreateDataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate, size_t gradientBucketSizeInBytes)
     {
-        return MakeSharedObject<DataParallelDistributedLearner>(communicator, learner, distributedAfterSamples, useAsyncBufferedParameterUpdate);
+        return MakeSharedObject<DataParallelDistributedLearner>(communicator, learner, distributedAfterSamples, useAsyncBufferedParameterUpdate, gradientBucketSizeInBytes);
     }
 
-    DataParallelDistributedLearner::DataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate)
-        : DistributedLearnerBase(communicator, learner, distributedAfterSamples)
+    DataParallelDistributedLearner::DataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate, size_t gradientBucketSizeInBytes)
+        : DistributedLearnerBase(communicator, learner, distributedAfterSamples),
+          m_gradientBucketSizeInBytes(gradientBucketSizeInBytes),
+          m_numStartedGradientBuckets(0)
     {
         if (useAsyncBufferedParameterUpdate)
             LogicError("Asynchronous parameter update is not yet supported for the DataParallelDistributedLearner.");
+
+        if (gradientBucketSizeInBytes > 0)
+        {
+            m_mpiCommunicator = std::dynamic_pointer_cast<MPICommunicatorImpl>(communicator);
+            if (!m_mpiCommunicator)
+                InvalidArgument("DataParallelDistributedLearner: gradient buckets require an MPI communicator.");
+        }
+    }
+
+    void DataParallelDistributedLearner::CreateGradientBuckets(const std::unordered_set<Parameter>& parametersWithSparseGradients)
+    {
+        // The parameters are bucketed in the order in which the learner lists them, which for the parameters of a model
+        // is roughly from its outputs to its inputs, the order in which backprop completes their gradients.
+        // Buckets hold float or double parameters on the CPU with dense gradients, each of a single data type, and are closed once they
+        // reach m_gradientBucketSizeInBytes; the gradients of the other parameters are aggregated in Update.
+        m_gradientBuckets.clear();
+        m_gradientBucketIndices.clear();
+        m_completedGradients.clear();
+        m_numStartedGradientBuckets = 0;
+
+        std::vector<std::vector<Parameter>> bucketParameters;
+        std::vector<size_t> bucketSizesInBytes;
+        std::map<DataType, size_t> openBuckets;
+        for (const auto& parameter : m_learner->Parameters())
+        {
+            auto value = parameter.Value();
+            if (value->Device().Type() != DeviceKind::CPU || (value->GetDataType() != DataType::Float && value->GetDataType() != DataType::Double) ||
+                parametersWithSparseGradients.find(parameter) != parametersWithSparseGradients.end())
+                continue;
+
+            auto openBucket = openBuckets.find(value->GetDataType());
+            if (openBucket == openBuckets.end() || bucketSizesInBytes[openBucket->second] >= m_gradientBucketSizeInBytes)
+            {
+                openBuckets[value->GetDataType()] = bucketParameters.size();
+                bucketParameters.push_back({});
+                bucketSizesInBytes.push_back(0);
+                openBucket = openBuckets.find(value->GetDataType());
+            }
+
+            bucketParameters[openBucket->second].push_back(parameter);
+            bucketSizesInBytes[openBucket->second] += value->Shape().TotalSize() * DataTypeSize(value->GetDataType());
+        }
+
+        for (size_t i = 0; i < bucketParameters.size(); i++)
+        {
+            auto dataType = bucketParameters[i].front().GetDataType();
+            auto device = DeviceDescriptor::CPUDevice();
+
+            GradientBucket bucket;
+            bucket.buffer = MakeSharedObject<NDArrayView>(0, dataType, NDShape{ bucketSizesInBytes[i] / DataTypeSize(dataType) }, device);
+            bucket.numCompleted = 0;
+
+            auto data = (dataType == DataType::Float) ? reinterpret_cast<char*>(bucket.buffer->WritableDataBuffer<float>()) : reinterpret_cast<char*>(bucket.buffer->WritableDataBuffer<double>());
+            size_t offsetInBytes = 0;
+            for (const auto& parameter : bucketParameters[i])
+            {
+                auto sizeInBytes = parameter.Shape().TotalSize() * DataTypeSize(dataType);
+                m_gradientBucketIndices[parameter] = std::make_pair(i, bucket.gradients.size());
+                bucket.gradients.push_back(MakeSharedObject<NDArrayView>(dataType, parameter.Shape(), data + offsetInBytes, sizeInBytes, device));
+                offsetInBytes += sizeInBytes;
+            }
+
+            m_gradientBuckets.push_back(std::move(bucket));
+        }
+
+        if (m_gradientBuckets.empty())
+            fprintf(stderr, "WARNING: DataParallelDistributedLearner: none of the parameters can be aggregated in gradient buckets, which only hold "
+                            "float or double parameters on the CPU with dense gradients; all gradients are aggregated after backprop.\n");
+    }
+
+    void DataParallelDistributedLearner::GradientCompleted(const Parameter& parameter, const NDArrayViewPtr& gradientValue)
+    {
+        // until the distributed training starts, the gradients are not aggregated
+        if (m_sampleCount < m_distributeAfterSamples)
+            return;
+
+        AddToGradientBucket(parameter, gradientValue);
+        StartCompletedGradientBuckets();
+
+        // without this, the started aggregations would mostly not progress before Update waits for them
+        m_mpiCommunicator->ProgressAggregations();
+    }
+
+    void DataParallelDistributedLearner::AddToGradientBucket(const Parameter& parameter, const NDArrayViewPtr& gradientValue)
+    {
+        auto index = m_gradientBucketIndices.find(parameter);
+        if (index == m_gradientBucketIndices.end() || !m_completedGradients.insert(parameter).second)
+            return;
+
+        // a gradient that turns out sparse after all is densified; the learner then updates the parameter from the dense aggregate
+        auto& bucket = m_gradientBuckets[index->second.first];
+        bucket.gradients[index->second.second]->CopyFrom(*gradientValue);
+        bucket.numCompleted++;
+    }
+
+    void DataParallelDistributedLearner::StartCompletedGradientBuckets()
+    {
+        while (m_numStartedGradientBuckets < m_gradientBuckets.size())
+        {
+            const auto& bucket = m_gradientBuckets[m_numStartedGradientBuckets];
+            if (bucket.numCompleted < bucket.gradients.size())
+                break;
+
+            m_mpiCommunicator->StartAggregateInPlace(bucket.buffer);
+            m_numStartedGradientBuckets++;
+        }
     }
 
     bool DataParallelDistributedLearner::Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& info)
@@ -130,11 +238,22 @@ namespace CNTK
 #endif
             if (info.IsEmpty())
                 PrepaireZeroGradients(gradientValues, info);
+
+            // the gradients that backprop did not report, e.g. all of them in an empty minibatch, complete their buckets here
+            for (const auto& gradientValue : gradientValues)
+                AddToGradientBucket(gradientValue.first, gradientValue.second);
+            StartCompletedGradientBuckets();
+            if (m_numStartedGradientBuckets < m_gradientBuckets.size())
+                LogicError("DataParallelDistributedLearner: the gradients of some of the bucketed parameters are missing.");
+
             ConvertToOrdered(gradientValues, m_gradientBuffer);
 
             std::vector<NDArrayViewPtr> valuesToAggregate;
             for (const auto& i : m_gradientBuffer)
-                valuesToAggregate.push_back(i.second);
+            {
+                if (m_gradientBucketIndices.find(i.first) == m_gradientBucketIndices.end())
+                    valuesToAggregate.push_back(i.second);
+            }
             valuesToAggregate.push_back(info.evalCriterionValue);
             valuesToAggregate.push_back(info.trainingLossValue);
 
@@ -143,6 +262,19 @@ namespace CNTK
 
             m_communicator->AggregateInPlace(valuesToAggregate, m_communicator->Workers());
             info.numberOfSamples = static_cast<size_t>(*valuesToAggregate.back()->WritableDataBuffer<double>());
+
+            if (!m_gradientBuckets.empty())
+            {
+                // the learner updates the parameters from the aggregated buckets
+                m_mpiCommunicator->WaitForAggregations();
+                for (const auto& index : m_gradientBucketIndices)
+                    gradientValues[index.first] = m_gradientBuckets[index.second.first].gradients[index.second.second];
+
+                for (auto& bucket : m_gradientBuckets)
+                    bucket.numCompleted = 0;
+                m_completedGradients.clear();
+                m_numStartedGradientBuckets = 0;
+            }
         }
 
 #ifndef  CNTK_UWP
@@ -7,18 +7,53 @@
 
 #include "CNTKLibrary.h"
 #include "DistributedLearnerBase.h"
+#include <unordered_set>
 
 namespace CNTK
 {
+    class MPICommunicatorImpl;
+
     ///
     /// Distributed Trainer.
     ///
     class DataParallelDistributedLearner : public DistributedLearnerBase
     {
     public:
-        DataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate);
+        DataParallelDistributedLearner(DistributedCommunicatorPtr communicator, LearnerPtr learner, size_t distributedAfterSamples, bool useAsyncBufferedParameterUpdate, size_t gradientBucketSizeInBytes = 0);
 
         // Optional override that gets called per minibatch after finishing gradient computation but before updating model parameters
         bool Update(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, MinibatchInfo& trainingSampleCount) override;
+
+        // Whether the learner was created with a gradient bucket size, i.e. wants CreateGradientBuckets to be called.
+        bool UsesGradientBuckets() const { return m_gradientBucketSizeInBytes > 0; }
+
+        // Groups the gradients of the parameters into buckets, leaving out 'parametersWithSparseGradients', which a dense bucket would densify.
+        void CreateGradientBuckets(const std::unordered_set<Parameter>& parametersWithSparseGradients);
+
+        // Whether some gradients are aggregated in buckets, which GradientCompleted starts to aggregate during backprop.
+        bool AggregatesGradientsDuringBackprop() const { return !m_gradientBuckets.empty(); }
+
+        // Called during backprop once the gradient of a parameter is complete; starts to aggregate the buckets that are then complete.
+        void GradientCompleted(const Parameter& parameter, const NDArrayViewPtr& gradientValue);
+
+    private:
+        void AddToGradientBucket(const Parameter& parameter, const NDArrayViewPtr& gradientValue);
+
+        // Buckets are started in the order in which they were created, which is the same on all workers.
+        void StartCompletedGradientBuckets();
+
+        struct GradientBucket
+        {
+            NDArrayViewPtr buffer;                 // the gradients of the bucket one after the other, aggregated in place
+            std::vector<NDArrayViewPtr> gradients; // views of the buffer, one per parameter
+            size_t numCompleted;                   // in the current minibatch
+        };
+
+        size_t m_gradientBucketSizeInBytes;
+        std::shared_ptr<MPICommunicatorImpl> m_mpiCommunicator;
+        std::vector<GradientBucket> m_gradientBuckets;
+        std::unordered_map<Parameter, std::pair<size_t, size_t>> m_gradientBucketIndices; // the bucket and the gradient in it of each bucketed parameter
+        std::unordered_set<Parameter> m_completedGradients;
+        size_t m_numStartedGradientBuckets;
     };
 }
\ No newline at end of file
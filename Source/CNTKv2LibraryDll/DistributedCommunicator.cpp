@@ -450,6 +450,45 @@ namespace CNTK
         m_mpi->WaitAll();
     }
 
+    void MPICommunicatorImpl::StartAggregateInPlace(const NDArrayViewPtr& value)
+    {
+        if (value->Device().Type() != DeviceKind::CPU || value->GetStorageFormat() != StorageFormat::Dense)
+            InvalidArgument("MPICommunicator: Only dense values on the CPU can be aggregated asynchronously.");
+
+        if (m_mpi->NumNodesInUse() == 1) // No need to aggregate anything.
+            return;
+
+        auto numElements = value->Shape().TotalSize();
+        m_pendingAggregations.push_back(MPI_Request());
+        if (value->GetDataType() == DataType::Float)
+            m_mpi->AllReduceAsync(value->WritableDataBuffer<float>(), numElements, &m_pendingAggregations.back());
+        else if (value->GetDataType() == DataType::Double)
+            m_mpi->AllReduceAsync(value->WritableDataBuffer<double>(), numElements, &m_pendingAggregations.back());
+        else
+        {
+            m_pendingAggregations.pop_back();
+            LogicError("MPICommunicator: Unknown DataType.");
+        }
+    }
+
+    void MPICommunicatorImpl::ProgressAggregations()
+    {
+        if (m_pendingAggregations.empty())
+            return;
+
+        if (m_mpi->TestAll(m_pendingAggregations))
+            m_pendingAggregations.clear();
+    }
+
+    void MPICommunicatorImpl::WaitForAggregations()
+    {
+        if (m_pendingAggregations.empty())
+            return;
+
+        m_mpi->WaitAll(m_pendingAggregations);
+        m_pendingAggregations.clear();
+    }
+
     bool MPICommunicatorImpl::ShouldCopyDataToCPU(NDArrayViewPtr inputValue)
     {
         if (inputValue->Device() == DeviceDescriptor::CPUDevice())
@@ -60,6 +60,17 @@ namespace CNTK
 
         virtual void Barrier() override;
 
+        // Starts aggregating a dense value on the CPU in place, across all workers, and returns without waiting for the aggregation to complete.
+        // The workers must start the aggregations of their values in the same order.
+        void StartAggregateInPlace(const NDArrayViewPtr& value);
+
+        // Tests without blocking whether the aggregations started by StartAggregateInPlace are complete.
+        // Most MPI implementations only progress nonblocking collectives inside MPI calls, so this is to be called while other work is done.
+        void ProgressAggregations();
+
+        // Waits for the aggregations started by StartAggregateInPlace to complete.
+        void WaitForAggregations();
+
         virtual ~MPICommunicatorImpl() {}
 
     private:
@@ -93,6 +104,9 @@ namespace CNTK
         // NcclComm
         std::unique_ptr<Microsoft::MSR::CNTK::NcclComm> m_nccl;
 
+        // Started by StartAggregateInPlace
+        std::vector<MPI_Request> m_pendingAggregations;
+
     protected:
         DeviceDescriptor GetNonCPUDevice(const std::vector<NDArrayViewPtr>& values)
         {
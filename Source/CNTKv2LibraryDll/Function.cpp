@@ -10,6 +10,7 @@
 #include "BlockFunction.h"
 #include "Utils.h"
 #include "UserFunctionFactory.h"
+#include "MappedModel.h"
 #include "TrainingNodes.h"
 
 using namespace Microsoft::MSR::CNTK;
@@ -463,9 +464,17 @@ namespace CNTK
         stream->flush();
     }
 
+    void Function::SaveMappable(const std::wstring& filepath)
+    {
+        MappedModel::Save(*this, filepath);
+    }
+
     /*static*/ FunctionPtr Function::Load(const std::wstring& filepath, const DeviceDescriptor& computeDevice)
     {
         auto stream = GetFstream(filepath, true);
+        if (MappedModel::IsMappedModel(*stream))
+            return MappedModel::Load(filepath, computeDevice);
+
         if (!Internal::IsLegacyModel(*stream))
         {
             Dictionary model;
@@ -492,6 +501,9 @@ namespace CNTK
             }
         };
 
+        if (MappedModel::IsMappedModel(buffer, length))
+            return MappedModel::Load(buffer, length, computeDevice);
+
         if (Internal::IsLegacyModel(buffer, length))
             InvalidArgument("Loading a legacy model from byte array is not supported.");
         else
@@ -513,6 +525,12 @@ namespace CNTK
     void Function::Restore(const std::wstring& filepath)
     {
         auto stream = GetFstream(filepath, true);
+        if (MappedModel::IsMappedModel(*stream))
+        {
+            RestoreFromCheckpoint(MappedModel::Load(filepath, DeviceDescriptor::CPUDevice())->Serialize());
+            return;
+        }
+
         if (!Internal::IsLegacyModel(*stream))
         {
             Dictionary model;
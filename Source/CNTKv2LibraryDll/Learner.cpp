@@ -22,6 +22,19 @@
         NOT_IMPLEMENTED;                                                                                      \
     }
 
+#define DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerType)                                          \
+    /*virtual*/ void LearnerType::MultiTensorUpdate(const MultiTensorSweep<float>& sweep,                      \
+                                                    size_t trainingSampleCount) const /*override*/            \
+    {                                                                                                         \
+        MultiTensorUpdate<float>(sweep, trainingSampleCount);                                                 \
+    }                                                                                                         \
+                                                                                                              \
+    /*virtual*/ void LearnerType::MultiTensorUpdate(const MultiTensorSweep<double>& sweep,                     \
+                                                    size_t trainingSampleCount) const /*override*/            \
+    {                                                                                                         \
+        MultiTensorUpdate<double>(sweep, trainingSampleCount);                                                \
+    }
+
 #define GET_WRITABLE_MATRICES                                                                                 \
     const auto& smoothedGradientMatrix = GetWritableMatrix<ElementType>(smoothedGradientValue);               \
     const auto& gradientMatrix = GetWritableMatrix<ElementType>(gradientValue);                               \
@@ -202,7 +215,8 @@ namespace CNTK
                              bool allocateSmoothGradients /* = true */)
                              : Learner(parameters, learningRateSchedule),
                              m_additionalOptions(additionalOptions), 
-                             m_noiseInjectionSeed(Internal::GenerateRandomSeed())
+                             m_noiseInjectionSeed(Internal::GenerateRandomSeed()),
+                             m_smoothedGradientsPacked(false)
     {
         if (parameters.empty())
             InvalidArgument("The parameters list specified to a Learner must not be empty.");
@@ -268,10 +282,26 @@ namespace CNTK
 
         UpdateOnMinibatch(trainingSampleCount);
 
+        const bool multiTensorUpdate = m_additionalOptions.multiTensorUpdate && SupportsMultiTensorUpdate();
+        if (multiTensorUpdate && !m_smoothedGradientsPacked)
+            PackSmoothedGradients();
+
+        // with multiTensorUpdate, the parameters that can be are updated in one sweep per DataType after the others
+        vector<Parameter> sweptFloatParameters, sweptDoubleParameters;
         for (const auto& parameter : Parameters())
         {
             const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
             const auto& gradientValue = gradientValues.at(parameter);
+
+            if (multiTensorUpdate && IsUpdatedInSweep(parameter, gradientValue, smoothedGradientValue))
+            {
+                if (parameter.GetDataType() == DataType::Float)
+                    sweptFloatParameters.push_back(parameter);
+                else
+                    sweptDoubleParameters.push_back(parameter);
+                continue;
+            }
+
             // TODO: make this a runtime parameter.
 #if DUMPOUTPUT
             LOGPRINTF(stderr, "Update_%ls\n", parameter.Uid().c_str());
@@ -304,6 +334,13 @@ namespace CNTK
                 LogicError("%ls has NaNs in parameter values after parameter update.", parameter.Uid().c_str());
 #endif
         }
+
+        if (!sweptFloatParameters.empty())
+            UpdateInOneSweep<float>(sweptFloatParameters, gradientValues, trainingSampleCount);
+
+        if (!sweptDoubleParameters.empty())
+            UpdateInOneSweep<double>(sweptDoubleParameters, gradientValues, trainingSampleCount);
+
         m_sampleCount += trainingSampleCount;
         m_minibatchCount++;
         if (sweepEnd)
@@ -327,6 +364,127 @@ namespace CNTK
         paramRef.RecordValueUpdate();
     }
 
+    /*static*/ bool LearnerBase::IsUpdatedInSweep(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue)
+    {
+        const auto& parameterValue = parameter.Value();
+        for (const auto& value : { parameterValue, gradientValue, smoothedGradientValue })
+        {
+            if (value->Device().Type() != DeviceKind::CPU || value->GetStorageFormat() != StorageFormat::Dense || value->GetDataType() != parameterValue->GetDataType())
+                return false;
+        }
+
+        return gradientValue->Shape().TotalSize() == parameterValue->Shape().TotalSize();
+    }
+
+    template <typename ElementType>
+    void LearnerBase::UpdateInOneSweep(const vector<Parameter>& parameters, const unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) const
+    {
+        typedef typename MultiTensorSweep<ElementType>::Tensor Tensor;
+
+        // the preprocessing of PreProcess, with the scaling of the gradients combined into one factor per parameter
+        const auto meanGradientScale = ElementType(m_additionalOptions.useMeanGradient ? 1.0 / trainingSampleCount : 1.0);
+        const auto actualMBSize = m_additionalOptions.useMeanGradient ? 1 : trainingSampleCount;
+        const bool clipGradients = m_additionalOptions.gradientClippingThresholdPerSample != numeric_limits<double>::infinity();
+        const bool truncateGradients = clipGradients && m_additionalOptions.gradientClippingWithTruncation;
+        const double maxGradientPerMB = m_additionalOptions.gradientClippingThresholdPerSample * actualMBSize;
+        const double l2RegularizationWeight = m_additionalOptions.l2RegularizationWeight > 0 ? m_additionalOptions.l2RegularizationWeight * actualMBSize : 0;
+
+        vector<Tensor> tensors;
+        tensors.reserve(parameters.size());
+        for (const auto& parameter : parameters)
+        {
+            tensors.push_back({ parameter.Value()->WritableDataBuffer<ElementType>(),
+                                gradientValues.at(parameter)->WritableDataBuffer<ElementType>(),
+                                m_smoothedGradientValues.at(parameter)->WritableDataBuffer<ElementType>(),
+                                parameter.Shape().TotalSize(), meanGradientScale });
+        }
+
+        MultiTensorSweep<ElementType> sweep(move(tensors), truncateGradients, ElementType(maxGradientPerMB), ElementType(l2RegularizationWeight));
+        if (clipGradients && !truncateGradients)
+        {
+            auto squaredNorms = sweep.Sum([&sweep](size_t t, size_t begin, size_t end)
+            {
+                const auto& tensor = sweep.Tensors()[t];
+                double sum = 0;
+                for (size_t i = begin; i < end; i++)
+                {
+                    const double gradient = tensor.gradient[i] * tensor.gradientScale;
+                    sum += gradient * gradient;
+                }
+                return sum;
+            });
+
+            for (size_t t = 0; t < squaredNorms.size(); t++)
+            {
+                const double gradientNorm = sqrt(squaredNorms[t]);
+                if (gradientNorm > maxGradientPerMB)
+                    sweep.ScaleGradient(t, ElementType(maxGradientPerMB / gradientNorm));
+            }
+        }
+
+        MultiTensorUpdate(sweep, trainingSampleCount);
+
+        const bool postProcess = m_additionalOptions.l1RegularizationWeight > 0 ||
+                                 GetCurrentTrainingParameterValue(m_additionalOptions.gaussianNoiseInjectionStdDev) > 0;
+        for (const auto& parameter : parameters)
+        {
+            if (postProcess)
+                PostProcess<ElementType>(parameter, gradientValues.at(parameter), trainingSampleCount);
+
+            auto paramRef = parameter;
+            paramRef.RecordValueUpdate();
+
+#ifdef _DEBUG
+            if (HasNan(parameter.Value(), "TrainOneEpoch/UpdateWeights/Learner::Update(): "))
+                LogicError("%ls has NaNs in parameter values after parameter update.", parameter.Uid().c_str());
+#endif
+        }
+    }
+
+    void LearnerBase::PackSmoothedGradients()
+    {
+        // each slice starts at a multiple of 16 elements, for the vectorization of the sweep
+        static const size_t alignment = 16;
+
+        for (auto dataType : { DataType::Float, DataType::Double })
+        {
+            vector<Parameter> parameters;
+            size_t packedSize = 0;
+            for (const auto& parameter : Parameters())
+            {
+                const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
+                if (smoothedGradientValue->Device().Type() != DeviceKind::CPU || smoothedGradientValue->GetDataType() != dataType ||
+                    smoothedGradientValue->GetStorageFormat() != StorageFormat::Dense)
+                    continue;
+
+                parameters.push_back(parameter);
+                packedSize += AsMultipleOf(smoothedGradientValue->Shape().TotalSize(), alignment);
+            }
+
+            if (parameters.empty())
+                continue;
+
+            auto packedValue = AllocateNDArrayView(parameters.front(), { packedSize });
+            auto elementSize = DataTypeSize(dataType);
+            auto packedData = (dataType == DataType::Float) ? (char*)packedValue->WritableDataBuffer<float>() : (char*)packedValue->WritableDataBuffer<double>();
+            size_t offset = 0;
+            for (const auto& parameter : parameters)
+            {
+                auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
+                const auto& shape = smoothedGradientValue->Shape();
+                auto slice = MakeSharedObject<NDArrayView>(dataType, shape, packedData + offset * elementSize, shape.TotalSize() * elementSize, smoothedGradientValue->Device());
+                slice->CopyFrom(*smoothedGradientValue);
+                smoothedGradientValue = slice;
+                offset += AsMultipleOf(shape.TotalSize(), alignment);
+            }
+
+            // the slices do not own their buffer
+            m_packedSmoothedGradientValues.push_back(packedValue);
+        }
+
+        m_smoothedGradientsPacked = true;
+    }
+
     string LearnerBase::LearnerType() const
     {
         return Typename(this);
@@ -485,6 +643,21 @@ namespace CNTK
         parameterMatrix->SGDUpdate(*gradientMatrix, learningRate);
     }
 
+    DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerSGD)
+
+    template <typename ElementType>
+    void LearnerSGD::MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const
+    {
+        const auto learningRate = ElementType(LearningRate(trainingSampleCount));
+
+        sweep.ForEach([&sweep, learningRate](size_t t, size_t begin, size_t end)
+        {
+            const auto& tensor = sweep.Tensors()[t];
+            for (size_t i = begin; i < end; i++)
+                tensor.parameter[i] -= learningRate * sweep.Gradient(tensor, i);
+        });
+    }
+
     double LearnerMomentumSGD::MomentumValueForMB(const MomentumSchedule& schedule, size_t minibatchSize) const
     {
         double currentMomentum = GetCurrentTrainingParameterValue(schedule);
@@ -520,6 +693,28 @@ namespace CNTK
                                            learningRate, momentum, UseUnitGainMomentum());
     }
 
+    DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerMomentumSGD)
+
+    template <typename ElementType>
+    void LearnerMomentumSGD::MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const
+    {
+        ReportTrainingParameterValue(m_momentumSchedule, L"Momentum");
+
+        const auto learningRate = ElementType(LearningRate(trainingSampleCount));
+        const auto momentum = ElementType(MomentumValueForMB(trainingSampleCount));
+        const auto gradientFactor = ElementType((UseUnitGainMomentum() ? (1.0 - momentum) : 1.0) * learningRate);
+
+        sweep.ForEach([&sweep, momentum, gradientFactor](size_t t, size_t begin, size_t end)
+        {
+            const auto& tensor = sweep.Tensors()[t];
+            for (size_t i = begin; i < end; i++)
+            {
+                tensor.smoothedGradient[i] = momentum * tensor.smoothedGradient[i] + gradientFactor * sweep.Gradient(tensor, i);
+                tensor.parameter[i] -= tensor.smoothedGradient[i];
+            }
+        });
+    }
+
     /*virtual*/ void LearnerNesterov::Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, 
                                              const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const /*override*/
     {
@@ -539,6 +734,27 @@ namespace CNTK
                                                               learningRate, momentum, UseUnitGainMomentum());
     }
 
+    DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerNesterov)
+
+    template <typename ElementType>
+    void LearnerNesterov::MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const
+    {
+        const auto learningRate = ElementType(LearningRate(trainingSampleCount));
+        const auto momentum = ElementType(MomentumValueForMB(trainingSampleCount));
+        const auto gradientFactor = ElementType((UseUnitGainMomentum() ? (1.0 - momentum) : 1.0) * learningRate);
+
+        sweep.ForEach([&sweep, momentum, gradientFactor](size_t t, size_t begin, size_t end)
+        {
+            const auto& tensor = sweep.Tensors()[t];
+            for (size_t i = begin; i < end; i++)
+            {
+                const auto gradient = gradientFactor * sweep.Gradient(tensor, i);
+                tensor.smoothedGradient[i] = momentum * tensor.smoothedGradient[i] + gradient;
+                tensor.parameter[i] -= momentum * tensor.smoothedGradient[i] + gradient;
+            }
+        });
+    }
+
     LearnerAdaGrad::LearnerAdaGrad(const std::vector<Parameter>& parameters,
                                    const LearningRateSchedule& learningRateSchedule,
                                    bool needAveMultiplier,
@@ -580,6 +796,56 @@ namespace CNTK
         Matrix<ElementType>::ScaleAndAdd(ElementType(-learningRate / aveMultiplier), *gradientMatrix, *parameterMatrix);
     }
 
+    DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerAdaGrad)
+
+    template <typename ElementType>
+    void LearnerAdaGrad::MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const
+    {
+        const auto learningRate = LearningRate(trainingSampleCount);
+        const ElementType floor = 1e-16f;
+
+        if (!m_needAveMultiplier)
+        {
+            const auto scaledLearningRate = ElementType(learningRate);
+            sweep.ForEach([&sweep, floor, scaledLearningRate](size_t t, size_t begin, size_t end)
+            {
+                const auto& tensor = sweep.Tensors()[t];
+                for (size_t i = begin; i < end; i++)
+                {
+                    const auto gradient = sweep.Gradient(tensor, i);
+                    tensor.smoothedGradient[i] += gradient * gradient;
+                    tensor.parameter[i] -= scaledLearningRate * gradient / sqrt(tensor.smoothedGradient[i] + floor);
+                }
+            });
+            return;
+        }
+
+        // the learning rate of a parameter is divided by the average of its multipliers, so the multipliers are applied to the gradients first
+        auto multiplierSums = sweep.Sum([&sweep, floor](size_t t, size_t begin, size_t end)
+        {
+            const auto& tensor = sweep.Tensors()[t];
+            double sum = 0;
+            for (size_t i = begin; i < end; i++)
+            {
+                const auto gradient = sweep.Gradient(tensor, i);
+                tensor.smoothedGradient[i] += gradient * gradient;
+                const auto multiplier = 1 / sqrt(tensor.smoothedGradient[i] + floor);
+                tensor.gradient[i] = gradient * multiplier;
+                sum += multiplier;
+            }
+            return sum;
+        });
+
+        sweep.ForEach([&sweep, &multiplierSums, learningRate](size_t t, size_t begin, size_t end)
+        {
+            const auto& tensor = sweep.Tensors()[t];
+            const auto aveMultiplier = (multiplierSums[t] > 0) ? multiplierSums[t] / tensor.size : 1;
+            const auto scaledLearningRate = ElementType(learningRate / ElementType(aveMultiplier));
+            for (size_t i = begin; i < end; i++)
+                tensor.parameter[i] -= scaledLearningRate * tensor.gradient[i];
+        });
+    }
+
     LearnerAdaDelta::LearnerAdaDelta(
         const std::vector<Parameter>& parameters,
         const LearningRateSchedule& learningRateSchedule,
@@ -687,6 +953,42 @@ namespace CNTK
                                                 momentum, varMomentum, UseUnitGainMomentum());
     }
 
+    DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerFSAdaGrad)
+
+    template <typename ElementType>
+    void LearnerFSAdaGrad::MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const
+    {
+        const auto learningRate = ElementType(LearningRate(trainingSampleCount));
+        const auto momentum = ElementType(MomentumValueForMB(trainingSampleCount));
+        const auto varMomentum = ElementType(VarianceMomentumValueForMB(trainingSampleCount));
+        const auto unitGainFactor = ElementType(UseUnitGainMomentum() ? (1.0 - momentum) : 1.0);
+        const auto adaMul = ElementType(m_targetAdagradAvDenom_x_sqrtAdagradSqrFrames);
+
+        sweep.ForEach([&](size_t t, size_t begin, size_t end)
+        {
+            // the smoothed gradient holds the averaged squared gradients, followed by the momenta
+            const auto& tensor = sweep.Tensors()[t];
+            auto smoothAda = tensor.smoothedGradient;
+            auto smoothMom = tensor.smoothedGradient + tensor.size;
+            for (size_t i = begin; i < end; i++)
+            {
+                auto gradient = sweep.Gradient(tensor, i);
+                const auto adaSqr = varMomentum * smoothAda[i] + (1 - varMomentum) * gradient * gradient;
+                smoothAda[i] = adaSqr;
+                if (adaSqr != 0)
+                    gradient *= std::min(adaMul / sqrt(adaSqr), ElementType(10));
+
+                if (momentum > 0)
+                {
+                    gradient = momentum * smoothMom[i] + unitGainFactor * gradient;
+                    smoothMom[i] = gradient;
+                }
+
+                tensor.parameter[i] -= learningRate * gradient;
+            }
+        });
+    }
+
     LearnerAdam::LearnerAdam(const vector<Parameter>& parameters,
         const LearningRateSchedule& learningRateSchedule,
         const MomentumSchedule& momentumSchedule,
@@ -760,6 +1062,49 @@ namespace CNTK
                                            momentum, varMomentum, (ElementType)m_epsilon, UseUnitGainMomentum(), m_adamax);
     }
 
+    DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerAdam)
+
+    template <typename ElementType>
+    void LearnerAdam::MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const
+    {
+        const auto learningRate = ElementType(LearningRate(trainingSampleCount));
+        const auto momentum = MomentumValueForMB(trainingSampleCount);
+        const auto varMomentum = VarianceMomentumValueForMB(trainingSampleCount);
+        const auto epsilon = ElementType(m_epsilon);
+        const bool adamax = m_adamax;
+        const auto unitGainFactor = ElementType(UseUnitGainMomentum() ? (1.0 - momentum) : 1.0);
+
+        // as in Matrix::AdamUpdate
+        const auto biasCorrection = adamax ? ElementType(1. / (1 - pow(momentum, m_smoothedCount)))
+                                           : ElementType(sqrt(1 - pow(varMomentum, m_smoothedCount)) / (1 - pow(momentum, m_smoothedCount)));
+        const auto meanMomentum = ElementType(momentum);
+        const auto adaWeight = ElementType(varMomentum);
+
+        sweep.ForEach([&](size_t t, size_t begin, size_t end)
+        {
+            // the smoothed gradient holds the second moments, followed by the first moments
+            const auto& tensor = sweep.Tensors()[t];
+            auto smoothAda = tensor.smoothedGradient;
+            auto smoothMom = tensor.smoothedGradient + tensor.size;
+            for (size_t i = begin; i < end; i++)
+            {
+                const auto gradient = sweep.Gradient(tensor, i);
+                ElementType ada;
+                if (!adamax)
+                {
+                    smoothAda[i] = adaWeight * smoothAda[i] + (1 - adaWeight) * gradient * gradient;
+                    ada = sqrt(smoothAda[i]);
+                }
+                else
+                    ada = smoothAda[i] = std::max(adaWeight * smoothAda[i], std::abs(gradient));
+
+                const auto weight = biasCorrection / (ada + epsilon);
+                smoothMom[i] = meanMomentum * smoothMom[i] + unitGainFactor * gradient;
+                tensor.parameter[i] -= smoothMom[i] * weight * learningRate;
+            }
+        });
+    }
+
     LearnerRMSProp::LearnerRMSProp(const vector<Parameter>& parameters,
                                    const LearningRateSchedule& learningRateSchedule,
                                    double gamma, double inc, double dec, double max, double min,
@@ -851,6 +1196,75 @@ namespace CNTK
         Matrix<ElementType>::ScaleAndAdd(ElementType(-learningRate / aveMultiplier), *gradientMatrix, *parameterMatrix);
     }
 
+    DISPATCH_TO_TYPED_MULTI_TENSOR_UPDATE_FUNCTIONS(LearnerRMSProp)
+
+    template <typename ElementType>
+    void LearnerRMSProp::MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const
+    {
+        const auto learningRate = LearningRate(trainingSampleCount);
+        const auto gamma = ElementType(m_gamma), inc = ElementType(m_inc), dec = ElementType(m_dec);
+        const auto maxStep = ElementType(m_max), minStep = ElementType(m_min);
+        const bool initialized = m_smoothedCount > 1;
+        const ElementType floor = 1e-6f;
+
+        // as in Matrix::RmsProp, with the multipliers applied to the gradients; returns the sum of the multipliers
+        auto applyMultipliers = [&](size_t t, size_t begin, size_t end)
+        {
+            // the smoothed gradient holds the averaged squared gradients, followed by the signs of the gradients and the step sizes
+            const auto& tensor = sweep.Tensors()[t];
+            auto avars = tensor.smoothedGradient;
+            auto signs = tensor.smoothedGradient + tensor.size;
+            auto steps = tensor.smoothedGradient + 2 * tensor.size;
+            double sum = 0;
+            for (size_t i = begin; i < end; i++)
+            {
+                const auto gradient = sweep.Gradient(tensor, i);
+                if (!initialized)
+                {
+                    avars[i] = gradient * gradient;
+                    signs[i] = 0;
+                    steps[i] = ElementType(0.02);
+                }
+
+                avars[i] = gamma * avars[i] + (1 - gamma) * gradient * gradient;
+                const auto sign = ElementType((0 < gradient) - (gradient < 0));
+                if (signs[i] * sign > 0)
+                    steps[i] = std::min(steps[i] * inc, maxStep);
+                else
+                    steps[i] = std::max(steps[i] * dec, minStep);
+
+                const auto multiplier = steps[i] / sqrt(avars[i] + floor);
+                tensor.gradient[i] = gradient * multiplier;
+                signs[i] = sign;
+                sum += multiplier;
+            }
+            return sum;
+        };
+
+        if (!m_needAveMultiplier)
+        {
+            const auto scaledLearningRate = ElementType(learningRate);
+            sweep.ForEach([&](size_t t, size_t begin, size_t end)
+            {
+                applyMultipliers(t, begin, end);
+                const auto& tensor = sweep.Tensors()[t];
+                for (size_t i = begin; i < end; i++)
+                    tensor.parameter[i] -= scaledLearningRate * tensor.gradient[i];
+            });
+            return;
+        }
+
+        auto multiplierSums = sweep.Sum(applyMultipliers);
+        sweep.ForEach([&sweep, &multiplierSums, learningRate](size_t t, size_t begin, size_t end)
+        {
+            const auto& tensor = sweep.Tensors()[t];
+            const auto aveMultiplier = (multiplierSums[t] > 0) ? multiplierSums[t] / tensor.size : 1;
+            const auto scaledLearningRate = ElementType(learningRate / ElementType(aveMultiplier));
+            for (size_t i = begin; i < end; i++)
+                tensor.parameter[i] -= scaledLearningRate * tensor.gradient[i];
+        });
+    }
+
     // Explicit template instantiations
     template shared_ptr<Matrix<float>> LearnerBase::GetWritableMatrix<float>(const NDArrayViewPtr& arrayView);
     template shared_ptr<Matrix<double>> LearnerBase::GetWritableMatrix<double>(const NDArrayViewPtr& arrayView);
@@ -12,6 +12,92 @@
 
 namespace CNTK 
 {
+    // The dense parameters on the CPU that a learner updates in one parallel sweep (see AdditionalLearningOptions::multiTensorUpdate).
+    // The sweep is split into chunks of at most s_chunkSize elements, so that the threads share the work of many small parameters
+    // as well as that of a large one. The gradients are preprocessed on the fly, in the same way as LearnerBase::PreProcess does.
+    template <typename ElementType>
+    class MultiTensorSweep final
+    {
+    public:
+        struct Tensor
+        {
+            ElementType* parameter;
+            ElementType* gradient;
+            ElementType* smoothedGradient; // the state of the learner for the parameter, a slice of its packed smoothed gradients
+            size_t size;                   // of the parameter; the smoothed gradient is a multiple of it
+            ElementType gradientScale;     // for the mean gradient and the clipping of the gradient norm
+        };
+
+        MultiTensorSweep(std::vector<Tensor>&& tensors, bool truncateGradients, ElementType truncationThreshold, ElementType l2RegularizationWeight)
+            : m_tensors(std::move(tensors)), m_truncateGradients(truncateGradients),
+              m_truncationThreshold(truncationThreshold), m_l2RegularizationWeight(l2RegularizationWeight)
+        {
+            for (size_t t = 0; t < m_tensors.size(); t++)
+            {
+                for (size_t begin = 0; begin < m_tensors[t].size; begin += s_chunkSize)
+                    m_chunks.push_back({ t, begin, std::min(begin + s_chunkSize, m_tensors[t].size) });
+            }
+        }
+
+        const std::vector<Tensor>& Tensors() const { return m_tensors; }
+
+        void ScaleGradient(size_t tensor, ElementType factor) { m_tensors[tensor].gradientScale *= factor; }
+
+        // Returns the i-th element of the gradient of the tensor, scaled, clipped and L2 regularized.
+        ElementType Gradient(const Tensor& tensor, size_t i) const
+        {
+            ElementType gradient = tensor.gradient[i] * tensor.gradientScale;
+            if (m_truncateGradients)
+                gradient = std::max(-m_truncationThreshold, std::min(m_truncationThreshold, gradient));
+            if (m_l2RegularizationWeight != 0)
+                gradient += m_l2RegularizationWeight * tensor.parameter[i];
+            return gradient;
+        }
+
+        // Calls kernel(tensor, begin, end) for the element ranges [begin, end) of the tensors, in parallel.
+        template <typename Kernel>
+        void ForEach(const Kernel& kernel) const
+        {
+            const long numChunks = (long)m_chunks.size();
+#pragma omp parallel for schedule(dynamic)
+            for (long c = 0; c < numChunks; c++)
+                kernel(m_chunks[c].tensor, m_chunks[c].begin, m_chunks[c].end);
+        }
+
+        // Like ForEach, and returns the sums per tensor of what the kernel returns for its element ranges.
+        template <typename Kernel>
+        std::vector<double> Sum(const Kernel& kernel) const
+        {
+            const long numChunks = (long)m_chunks.size();
+            std::vector<double> chunkSums(numChunks);
+#pragma omp parallel for schedule(dynamic)
+            for (long c = 0; c < numChunks; c++)
+                chunkSums[c] = kernel(m_chunks[c].tensor, m_chunks[c].begin, m_chunks[c].end);
+
+            // added up in a fixed order, so that the result does not depend on the scheduling
+            std::vector<double> sums(m_tensors.size(), 0);
+            for (long c = 0; c < numChunks; c++)
+                sums[m_chunks[c].tensor] += chunkSums[c];
+            return sums;
+        }
+
+    private:
+        static const size_t s_chunkSize = 16384;
+
+        struct Chunk
+        {
+            size_t tensor;
+            size_t begin;
+            size_t end;
+        };
+
+        std::vector<Tensor> m_tensors;
+        std::vector<Chunk> m_chunks;
+        bool m_truncateGradients;
+        ElementType m_truncationThreshold;
+        ElementType m_l2RegularizationWeight;
+    };
+
     // An abstract base class at the root of the standard learners hierarchy
     // It implements most of the learner functionality, except for the actual update function,
     // and adds a few pre-/postprocessing methods (which are invoked before and after the update).
@@ -43,6 +129,14 @@ namespace CNTK
         // Allows derived class may override this to perform per-minibatch update actions
         virtual void UpdateOnMinibatch(size_t /*trainingSampleCount*/) {}
 
+        // Learners that can update their dense parameters on the CPU in one sweep (see AdditionalLearningOptions::multiTensorUpdate)
+        // return true and override the MultiTensorUpdate methods, which are invoked instead of Update for these parameters.
+        virtual bool SupportsMultiTensorUpdate() const { return false; }
+
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& /*sweep*/, size_t /*trainingSampleCount*/) const { NOT_IMPLEMENTED; }
+
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& /*sweep*/, size_t /*trainingSampleCount*/) const { NOT_IMPLEMENTED; }
+
         std::string LearnerType() const;
 
         // Returns current (per-sample) learning rate.
@@ -110,6 +204,19 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        // Returns true if the parameter is updated in the sweep of its DataType: it is dense, on the CPU, and so are its gradient and smoothed gradient.
+        static bool IsUpdatedInSweep(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue);
+
+        // Updates the parameters, all of the same DataType, in one sweep, with the preprocessing and postprocessing of the Update method above.
+        template <typename ElementType>
+        void UpdateInOneSweep(const std::vector<Parameter>& parameters, const std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) const;
+
+        // Moves the smoothed gradients on the CPU into one buffer per DataType, of which they become views.
+        void PackSmoothedGradients();
+
+        std::vector<NDArrayViewPtr> m_packedSmoothedGradientValues;
+        bool m_smoothedGradientsPacked;
+
         // TODO: make these functions friends of NDViewArray and move to Utils?
         static bool HasNan(const NDArrayViewPtr& value, const char* name);
         static void Print(const NDArrayViewPtr& value, const char* msg);
@@ -136,6 +243,14 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual bool SupportsMultiTensorUpdate() const override { return true; }
+
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& sweep, size_t trainingSampleCount) const override;
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& sweep, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const;
     };
 
     // SGD optimization with momentum. 
@@ -165,6 +280,14 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        virtual bool SupportsMultiTensorUpdate() const override { return true; }
+
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& sweep, size_t trainingSampleCount) const override;
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& sweep, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const;
+
         // returns current per-minibatch momentum value from the provided schedule.
         double MomentumValueForMB(const MomentumSchedule& schedule, size_t minibatchSize) const;
 
@@ -198,6 +321,12 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& sweep, size_t trainingSampleCount) const override;
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& sweep, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const;
     };
 
     class LearnerAdaGrad : public LearnerBase
@@ -215,6 +344,14 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual bool SupportsMultiTensorUpdate() const override { return true; }
+
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& sweep, size_t trainingSampleCount) const override;
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& sweep, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const;
     };
 
     class LearnerAdaDelta : public LearnerBase
@@ -261,6 +398,12 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& sweep, size_t trainingSampleCount) const override;
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& sweep, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const;
+
     private:
         static const double s_targetAdagradAvDenom;
         double m_targetAdagradAvDenom_x_sqrtAdagradSqrFrames;
@@ -302,6 +445,12 @@ namespace CNTK
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
 
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& sweep, size_t trainingSampleCount) const override;
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& sweep, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const;
+
     private:
 
         // returns current per-minibatch variance momentum value.
@@ -347,6 +496,14 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        virtual bool SupportsMultiTensorUpdate() const override { return true; }
+
+        virtual void MultiTensorUpdate(const MultiTensorSweep<float>& sweep, size_t trainingSampleCount) const override;
+        virtual void MultiTensorUpdate(const MultiTensorSweep<double>& sweep, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void MultiTensorUpdate(const MultiTensorSweep<ElementType>& sweep, size_t trainingSampleCount) const;
     };
 
 
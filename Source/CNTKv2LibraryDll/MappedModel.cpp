@@ -0,0 +1,345 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include "MappedModel.h"
+#include "Serialization.h"
+#include "Utils.h"
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include "Windows.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace CNTK
+{
+    static const char mappedModelMarker[] = { 'C', 'N', 'T', 'K', 'M', 'A', 'P', 0 };
+    static const uint64_t mappedModelVersion = 1;
+
+    // Values start at page boundaries of the file, and hence of the mapping, so that no page holds parts of two values.
+    static const size_t valueAlignment = 4096;
+
+    static const std::wstring offsetKey = L"offset";
+
+    struct MappedModelHeader
+    {
+        char marker[sizeof(mappedModelMarker)];
+        uint64_t version;
+        uint64_t graphOffset;
+        uint64_t graphSize;
+        uint64_t valuesOffset;
+        uint64_t valuesSize;
+    };
+
+    static size_t AlignUp(size_t offset)
+    {
+        return (offset + valueAlignment - 1) / valueAlignment * valueAlignment;
+    }
+
+    static void WritePadding(std::ostream& stream, size_t size)
+    {
+        static const char zeros[4096] = {};
+        for (; size > sizeof(zeros); size -= sizeof(zeros))
+            stream.write(zeros, sizeof(zeros));
+        stream.write(zeros, size);
+    }
+
+    static const char* DataBytes(const NDArrayView& value)
+    {
+        switch (value.GetDataType())
+        {
+        case DataType::Float:
+            return reinterpret_cast<const char*>(value.DataBuffer<float>());
+        case DataType::Double:
+            return reinterpret_cast<const char*>(value.DataBuffer<double>());
+        default:
+            LogicError("Unsupported DataType %s", DataTypeName(value.GetDataType()));
+        }
+    }
+
+    // A private mapping of a whole file: its pages are read in by the OS on first access and shared with the other
+    // mappings of the file until they are written to, which gives the writer its own copy of the page.
+    class MappedFile final
+    {
+    public:
+        explicit MappedFile(const std::wstring& filePath)
+            : m_filePath(filePath), m_data(nullptr), m_size(0)
+        {
+#ifdef _WIN32
+            HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (file == INVALID_HANDLE_VALUE)
+                RuntimeError("Cannot open file '%S' for reading.", filePath.c_str());
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size))
+            {
+                CloseHandle(file);
+                RuntimeError("Unable to get the size of file '%S', error 0x%x.", filePath.c_str(), GetLastError());
+            }
+            m_size = (size_t)size.QuadPart;
+
+            m_mapping = nullptr;
+            if (m_size == 0) // empty files cannot be mapped
+            {
+                CloseHandle(file);
+                return;
+            }
+
+            m_mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+            CloseHandle(file); // the mapping object keeps the file open
+            if (m_mapping == NULL)
+                RuntimeError("Unable to map file '%S', error 0x%x.", filePath.c_str(), GetLastError());
+
+            m_data = (char*)MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0);
+            if (m_data == NULL)
+            {
+                CloseHandle(m_mapping);
+                RuntimeError("Unable to map a view of file '%S', error 0x%x.", filePath.c_str(), GetLastError());
+            }
+#else
+            int fd = GetFileDescriptor(filePath, true);
+            struct stat status;
+            if (fstat(fd, &status) != 0)
+            {
+                close(fd);
+                RuntimeError("Unable to get the size of file '%S': %s.", filePath.c_str(), strerror(errno));
+            }
+            m_size = (size_t)status.st_size;
+
+            void* data = nullptr;
+            if (m_size > 0)
+                data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            close(fd); // the mapping keeps the file open
+            if (data == MAP_FAILED)
+                RuntimeError("Unable to map file '%S': %s.", filePath.c_str(), strerror(errno));
+
+            m_data = (char*)data;
+#endif
+        }
+
+        ~MappedFile()
+        {
+            if (m_data == nullptr)
+                return;
+
+#ifdef _WIN32
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+#else
+            munmap(m_data, m_size);
+#endif
+        }
+
+        const char* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+
+    private:
+        std::wstring m_filePath;
+        char* m_data;
+        size_t m_size;
+#ifdef _WIN32
+        HANDLE m_mapping;
+#endif
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+    };
+
+    static THREAD_LOCAL MappedValueWriter* s_currentWriter = nullptr;
+    static THREAD_LOCAL MappedValueReader* s_currentReader = nullptr;
+
+    MappedValueWriter::MappedValueWriter()
+        : m_size(0), m_previous(s_currentWriter)
+    {
+        s_currentWriter = this;
+    }
+
+    MappedValueWriter::~MappedValueWriter()
+    {
+        s_currentWriter = m_previous;
+    }
+
+    /*static*/ MappedValueWriter* MappedValueWriter::Current()
+    {
+        return s_currentWriter;
+    }
+
+    DictionaryValue MappedValueWriter::Add(const NDArrayViewPtr& value)
+    {
+        if (value->GetStorageFormat() != StorageFormat::Dense)
+            return DictionaryValue(*value);
+
+        size_t offset = AlignUp(m_size);
+        m_size = offset + value->Shape().TotalSize() * DataTypeSize(value->GetDataType());
+        m_values.push_back(std::make_pair(value, offset));
+
+        Dictionary reference;
+        reference[offsetKey] = offset;
+        reference[dataTypeKey] = static_cast<size_t>(value->GetDataType());
+        reference[shapeKey] = value->Shape();
+        return reference;
+    }
+
+    void MappedValueWriter::Write(std::ostream& stream) const
+    {
+        size_t position = 0;
+        for (const auto& entry : m_values)
+        {
+            NDArrayViewPtr value = entry.first;
+            if (value->Device().Type() != DeviceKind::CPU)
+                value = value->DeepClone(DeviceDescriptor::CPUDevice(), /*readOnly =*/ true);
+
+            WritePadding(stream, entry.second - position);
+            size_t numBytes = value->Shape().TotalSize() * DataTypeSize(value->GetDataType());
+            stream.write(DataBytes(*value), numBytes);
+            position = entry.second + numBytes;
+        }
+    }
+
+    MappedValueReader::MappedValueReader(const char* values, size_t size, const std::shared_ptr<void>& mapping)
+        : m_values(values), m_size(size), m_mapping(mapping), m_previous(s_currentReader)
+    {
+        s_currentReader = this;
+    }
+
+    MappedValueReader::~MappedValueReader()
+    {
+        s_currentReader = m_previous;
+    }
+
+    /*static*/ MappedValueReader* MappedValueReader::Current()
+    {
+        return s_currentReader;
+    }
+
+    NDArrayViewPtr MappedValueReader::Value(const Dictionary& reference, ::CNTK::DataType dataType, const DeviceDescriptor& device) const
+    {
+        if (!reference.Contains(offsetKey) || !reference.Contains(dataTypeKey) || !reference.Contains(shapeKey))
+            LogicError("The reference to a mapped value lacks its '%ls', '%ls' or '%ls'.", offsetKey.c_str(), dataTypeKey.c_str(), shapeKey.c_str());
+
+        size_t offset = reference[offsetKey].Value<size_t>();
+        auto valueDataType = DataType(reference[dataTypeKey].Value<size_t>());
+        const auto& shape = reference[shapeKey].Value<NDShape>();
+        if (valueDataType != dataType)
+            LogicError("The mapped value has DataType %s, while its Variable has DataType %s.", DataTypeName(valueDataType), DataTypeName(dataType));
+
+        size_t numBytes = shape.TotalSize() * DataTypeSize(dataType);
+        if ((offset % valueAlignment != 0) || (offset > m_size) || (numBytes > m_size - offset))
+            RuntimeError("The mapped value at offset %zu (%zu bytes) lies outside of the %zu bytes of values in the model file.", offset, numBytes, m_size);
+
+        auto data = const_cast<char*>(m_values + offset);
+        if (m_mapping && (device.Type() == DeviceKind::CPU))
+        {
+            // The value keeps the mapping alive; so do the aliases that the Function graph creates of it while it holds on to it.
+            auto mapping = m_mapping;
+            return NDArrayViewPtr(new NDArrayView(dataType, shape, data, numBytes, device), [mapping](NDArrayView* ptr) { delete ptr; });
+        }
+
+        NDArrayView value(dataType, shape, data, numBytes, DeviceDescriptor::CPUDevice(), /*readOnly =*/ true);
+        return value.DeepClone(device, /*readOnly =*/ false);
+    }
+
+    namespace MappedModel
+    {
+        bool IsMappedModel(std::istream& stream)
+        {
+            char buffer[sizeof(mappedModelMarker)];
+            const auto position = stream.tellg();
+            stream.read(buffer, sizeof(buffer));
+            const auto count = stream.gcount();
+            stream.clear(); // a file shorter than the marker
+            stream.seekg(position);
+            return IsMappedModel(buffer, (size_t)count);
+        }
+
+        bool IsMappedModel(const char* buffer, size_t bufferSize)
+        {
+            if (bufferSize < sizeof(mappedModelMarker))
+                return false;
+            return memcmp(mappedModelMarker, buffer, sizeof(mappedModelMarker)) == 0;
+        }
+
+        void Save(const Function& function, const std::wstring& filePath)
+        {
+            MappedValueWriter values;
+            Dictionary model = function.Serialize();
+
+            std::ostringstream graphStream;
+            graphStream << model;
+            const std::string graph = graphStream.str();
+
+            MappedModelHeader header = {};
+            memcpy(header.marker, mappedModelMarker, sizeof(mappedModelMarker));
+            header.version = mappedModelVersion;
+            header.graphOffset = sizeof(header);
+            header.graphSize = graph.size();
+            header.valuesOffset = AlignUp(sizeof(header) + graph.size());
+            header.valuesSize = values.Size();
+
+            auto stream = GetFstream(filePath, false);
+            stream->write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream->write(graph.data(), graph.size());
+            WritePadding(*stream, header.valuesOffset - (sizeof(header) + graph.size()));
+            values.Write(*stream);
+            stream->flush();
+            if (stream->fail())
+                RuntimeError("Error writing model file '%S'.", filePath.c_str());
+        }
+
+        static FunctionPtr Load(const char* data, size_t size, const std::shared_ptr<void>& mapping, const DeviceDescriptor& computeDevice)
+        {
+            MappedModelHeader header;
+            if (!IsMappedModel(data, size) || (size < sizeof(header)))
+                InvalidArgument("The model is not in the mapped format.");
+
+            memcpy(&header, data, sizeof(header));
+            if (header.version > mappedModelVersion)
+                RuntimeError("The model is in version %d of the mapped format, later than the supported version %d.", (int)header.version, (int)mappedModelVersion);
+
+            if ((header.graphOffset > size) || (header.graphSize > size - header.graphOffset) ||
+                (header.valuesOffset > size) || (header.valuesSize > size - header.valuesOffset))
+                RuntimeError("The model is truncated: its sections extend beyond its %zu bytes.", size);
+
+            struct GraphStreamBuffer : std::streambuf
+            {
+                GraphStreamBuffer(const char* start, size_t size)
+                {
+                    // std::streambuf::setg() requires char *
+                    char* first = const_cast<char*>(start);
+                    this->setg(first, first, first + size);
+                }
+            };
+
+            GraphStreamBuffer buffer(data + header.graphOffset, header.graphSize);
+            std::istream graphStream(&buffer);
+            Dictionary model;
+            graphStream >> model;
+
+            MappedValueReader values(data + header.valuesOffset, header.valuesSize, mapping);
+            return Function::Deserialize(model, computeDevice);
+        }
+
+        FunctionPtr Load(const std::wstring& filePath, const DeviceDescriptor& computeDevice)
+        {
+            auto file = std::make_shared<MappedFile>(filePath);
+            return Load(file->Data(), file->Size(), file, computeDevice);
+        }
+
+        FunctionPtr Load(const char* buffer, size_t length, const DeviceDescriptor& computeDevice)
+        {
+            return Load(buffer, length, nullptr, computeDevice);
+        }
+    }
+}
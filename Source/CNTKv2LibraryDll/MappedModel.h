@@ -0,0 +1,86 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include <istream>
+
+namespace CNTK
+{
+    ///
+    /// A model file in the mapped format starts with a header, followed by the serialized Dictionary of the Function graph and then
+    /// by the values of its dense Parameters and Constants, each aligned to a page. The Dictionary refers to these values by their
+    /// offsets, so that the loader maps them into memory instead of reading them, and the graph alone is subject to the protobuf limits.
+    ///
+    namespace MappedModel
+    {
+        bool IsMappedModel(std::istream& stream);
+        bool IsMappedModel(const char* buffer, size_t bufferSize);
+
+        void Save(const Function& function, const std::wstring& filePath);
+
+        // On the CPU, the values of the loaded Function use the private (copy-on-write) pages of the mapped file, which
+        // stays mapped for as long as any of these values exists. On other devices, the values are copied from the mapping.
+        FunctionPtr Load(const std::wstring& filePath, const DeviceDescriptor& computeDevice);
+
+        // Copies the values from the buffer, which need not outlive the loaded Function.
+        FunctionPtr Load(const char* buffer, size_t length, const DeviceDescriptor& computeDevice);
+    }
+
+    ///
+    /// Collects the values of the Parameters and Constants of a Function that is saved in the mapped format.
+    /// While an instance exists, Variable::Serialize on the same thread stores references to values in place of the values.
+    ///
+    class MappedValueWriter final
+    {
+    public:
+        MappedValueWriter();
+        ~MappedValueWriter();
+
+        // Returns the writer that Variable::Serialize stores values with, or null if no model is being saved in the mapped format on this thread.
+        static MappedValueWriter* Current();
+
+        // Returns what Variable::Serialize stores in place of the value: a reference for a dense value, or the value itself otherwise.
+        DictionaryValue Add(const NDArrayViewPtr& value);
+
+        // Size of the values section, including the padding of its values.
+        size_t Size() const { return m_size; }
+
+        // Writes the values section, starting at a page boundary of the stream.
+        void Write(std::ostream& stream) const;
+
+    private:
+        std::vector<std::pair<NDArrayViewPtr, size_t>> m_values; // with their offsets
+        size_t m_size;
+        MappedValueWriter* m_previous;
+    };
+
+    ///
+    /// Resolves the references to values in the Dictionary of a Function that is loaded from the mapped format.
+    /// While an instance exists, Variable::Deserialize on the same thread looks up the values that it finds references to.
+    ///
+    class MappedValueReader final
+    {
+    public:
+        // 'mapping' keeps 'values' alive; without one, the values are copied.
+        MappedValueReader(const char* values, size_t size, const std::shared_ptr<void>& mapping);
+        ~MappedValueReader();
+
+        // Returns the reader that Variable::Deserialize looks values up with, or null if no model is being loaded from the mapped format on this thread.
+        static MappedValueReader* Current();
+
+        // Returns the value that 'reference' refers to, on 'device'. Like the values that are read from a Dictionary, it is writable;
+        // writes to a mapped value go to private copies of its pages and never to the file.
+        NDArrayViewPtr Value(const Dictionary& reference, ::CNTK::DataType dataType, const DeviceDescriptor& device) const;
+
+    private:
+        const char* m_values;
+        size_t m_size;
+        std::shared_ptr<void> m_mapping;
+        MappedValueReader* m_previous;
+    };
+}
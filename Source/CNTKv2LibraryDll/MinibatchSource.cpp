@@ -524,6 +524,9 @@ namespace CNTK
 
             if (configuration.isFrameModeEnabled && configuration.truncationLength != 0)
                 LogicError("MinibatchSourceConfig: truncation and frame mode are mutually exclusive options.");
+
+            if (configuration.bucketingWindowInMinibatches != 0 && (configuration.isFrameModeEnabled || configuration.truncationLength != 0))
+                LogicError("MinibatchSourceConfig: bucketing can only be used with full sequences, not in frame mode or with truncation.");
         }
 
         Dictionary ToDictionary(const ::CNTK::MinibatchSourceConfig& configuration)
@@ -557,6 +560,9 @@ namespace CNTK
                 augmentedConfiguration[L"truncationLength"] = configuration.truncationLength;
             }
 
+            if (configuration.bucketingWindowInMinibatches != 0)
+                augmentedConfiguration[L"bucketingWindow"] = configuration.bucketingWindowInMinibatches;
+
             augmentedConfiguration[L"frameMode"] = configuration.isFrameModeEnabled;
             augmentedConfiguration[L"traceLevel"] = static_cast<size_t>(configuration.traceLevel);
 
@@ -10,6 +10,7 @@
 #include "Matrix.h"
 #include "CPUSparseMatrix.h"
 #include "GPUSparseMatrix.h"
+#include "BFloat16.h"
 #include <algorithm>
 #include "TensorShape.h"
 
@@ -17,6 +18,20 @@ using namespace Microsoft::MSR::CNTK;
 
 namespace CNTK
 {
+    // Views of DataType::BFloat16 are held as a CPUMatrix<bfloat16>, since there is no TensorView or Matrix of bfloat16.
+    // They only store values, which are widened to float or double by CopyFrom() for any computation.
+    typedef CPUMatrix<Microsoft::MSR::CNTK::bfloat16> BFloat16Matrix;
+    static_assert(sizeof(bfloat16) == sizeof(Microsoft::MSR::CNTK::bfloat16), "the public and the internal bfloat16 must have the same layout");
+
+    static void VerifyBFloat16Storage(const DeviceDescriptor& device, CNTK::StorageFormat storageType)
+    {
+        if (device.Type() != DeviceKind::CPU)
+            InvalidArgument("NDArrayView: DataType BFloat16 is only supported on the CPU, not on device '%S'.", device.AsString().c_str());
+
+        if (IsSparseStorageFormat(storageType))
+            InvalidArgument("NDArrayView: DataType BFloat16 is only supported for dense storage.");
+    }
+
     template <typename ElementType>
     static TensorView<ElementType>* AllocateTensorView(const NDShape& viewShape,
                                                        const DeviceDescriptor& device,
@@ -47,6 +62,19 @@ namespace CNTK
             return AllocateTensorView<float>(viewShape, device, dataBuffer, bufferSizeInBytes);
         case DataType::Double:
             return AllocateTensorView<double>(viewShape, device, dataBuffer, bufferSizeInBytes);
+        case DataType::BFloat16:
+        {
+            VerifyBFloat16Storage(device, StorageFormat::Dense);
+            if (dataBuffer == nullptr)
+                InvalidArgument("Cannot create a NDArrayView over a null data buffer.");
+
+            if (bufferSizeInBytes < (viewShape.TotalSize() * sizeof(bfloat16)))
+                InvalidArgument("Size (%d) of the specified buffer for creating the NDArrayView is smaller than the specified view shape '%S'.",
+                                (int)bufferSizeInBytes, viewShape.AsString().c_str());
+
+            auto matrixDims = GetMatrixDimensions(viewShape);
+            return new BFloat16Matrix(matrixDims.first, matrixDims.second, (Microsoft::MSR::CNTK::bfloat16*)dataBuffer, matrixFlagDontOwnBuffer);
+        }
         default:
             LogicError("Unsupported DataType %s", DataTypeName(dataType));
             break;
@@ -81,6 +109,12 @@ namespace CNTK
             return AllocateTensorView<float>(viewShape, storageType, device, numNonZeroValues);
         case DataType::Double:
             return AllocateTensorView<double>(viewShape, storageType, device, numNonZeroValues);
+        case DataType::BFloat16:
+        {
+            VerifyBFloat16Storage(device, storageType);
+            auto matrixDims = GetMatrixDimensions(viewShape);
+            return new BFloat16Matrix(matrixDims.first, matrixDims.second);
+        }
         default:
             LogicError("Unsupported DataType %s", DataTypeName(dataType));
             break;
@@ -118,6 +152,9 @@ namespace CNTK
             case DataType::Double:
                 delete GetTensorView<double>();
                 break;
+            case DataType::BFloat16:
+                delete GetBFloat16Matrix();
+                break;
             default:
                 LogicError("Unsupported DataType %s", DataTypeName(m_dataType));
                 break;
@@ -136,6 +173,8 @@ namespace CNTK
     {
         if (GetDataType() == DataType::Double)
             SetValue((double)value);
+        else if (GetDataType() == DataType::BFloat16)
+            GetWritableBFloat16Matrix()->SetValue(Microsoft::MSR::CNTK::bfloat16(value));
         else
         {
             if (IsSparse())
@@ -147,6 +186,9 @@ namespace CNTK
 
     void NDArrayView::SetValue(double value)
     {
+        if (GetDataType() == DataType::BFloat16)
+            return SetValue((float)value);
+
         if (IsSparse())
             LogicError("NDArrayView::SetValue: Setting a NDArrayView contents to a scalar is only allowed for objects with dense storage format.");
 
@@ -225,6 +267,55 @@ namespace CNTK
         return const_cast<TensorView<ElementType>*>(GetTensorView<ElementType>());
     }
 
+    const BFloat16Matrix* NDArrayView::GetBFloat16Matrix() const
+    {
+        if (m_dataType != DataType::BFloat16)
+            LogicError("NDArrayView::GetBFloat16Matrix: The DataType %s of this NDArrayView is not BFloat16", DataTypeName(m_dataType));
+
+        return (const BFloat16Matrix*)(m_tensorView.get());
+    }
+
+    BFloat16Matrix* NDArrayView::GetWritableBFloat16Matrix()
+    {
+        if (IsReadOnly())
+            InvalidArgument("NDArrayView::GetWritableBFloat16Matrix: Cannot get a writable matrix from a read-only NDArrayView.");
+
+        return const_cast<BFloat16Matrix*>(GetBFloat16Matrix());
+    }
+
+    // a view of the storage of a BFloat16 NDArrayView with the given matrix dimensions
+    static BFloat16Matrix* BFloat16MatrixView(const BFloat16Matrix& matrix, size_t numRows, size_t numCols)
+    {
+        auto view = new BFloat16Matrix(matrix.ColumnSlice(0, matrix.GetNumCols()));
+        view->Reshape(numRows, numCols);
+        return view;
+    }
+
+    // Copy the values of source to dest, where one of them has DataType::BFloat16. The bfloat16 values are on the CPU,
+    // and the others are copied through the CPU if they reside on another device.
+    template <typename ElementType>
+    static void CopyConvertingBFloat16(const NDArrayView& source, NDArrayView& dest)
+    {
+        size_t numElements = source.Shape().TotalSize();
+        if (source.GetDataType() == DataType::BFloat16)
+        {
+            if (dest.Device() == DeviceDescriptor::CPUDevice())
+                return ConvertFromBFloat16((const Microsoft::MSR::CNTK::bfloat16*)source.DataBuffer<bfloat16>(), dest.WritableDataBuffer<ElementType>(), numElements);
+
+            auto cpuDest = MakeSharedObject<NDArrayView>(dest.GetDataType(), dest.Shape(), DeviceDescriptor::CPUDevice());
+            ConvertFromBFloat16((const Microsoft::MSR::CNTK::bfloat16*)source.DataBuffer<bfloat16>(), cpuDest->WritableDataBuffer<ElementType>(), numElements);
+            dest.CopyFrom(*cpuDest);
+        }
+        else
+        {
+            NDArrayViewPtr cpuSource;
+            if (source.Device() != DeviceDescriptor::CPUDevice())
+                cpuSource = source.DeepClone(DeviceDescriptor::CPUDevice(), /*readOnly =*/ true);
+            const ElementType* sourceBuffer = cpuSource ? cpuSource->DataBuffer<ElementType>() : source.DataBuffer<ElementType>();
+            ConvertToBFloat16(sourceBuffer, (Microsoft::MSR::CNTK::bfloat16*)dest.WritableDataBuffer<bfloat16>(), numElements);
+        }
+    }
+
     NDArrayViewPtr NDArrayView::DeepClone(const DeviceDescriptor& device, bool readOnly/* = false*/) const
     {
         NDArrayViewPtr newView = MakeSharedObject<NDArrayView>(this->GetDataType(), this->GetStorageFormat(), this->Shape(), device);
@@ -244,6 +335,9 @@ namespace CNTK
             newMatrix->AssignValuesOf(*thisMatrix);
             break;
         }
+        case DataType::BFloat16:
+            newView->GetWritableBFloat16Matrix()->SetValue(*GetBFloat16Matrix());
+            break;
         default:
             LogicError("NDArrayView::DeepClone: Unsupported DataType %s", DataTypeName(m_dataType));
             break;
@@ -262,6 +356,21 @@ namespace CNTK
         if (IsReadOnly())
             RuntimeError("NDArrayView::CopyFrom: Cannot modify contents of a readonly NDArrayView.");
 
+        if ((m_dataType == DataType::BFloat16) != (source.GetDataType() == DataType::BFloat16))
+        {
+            if (IsSparse() || source.IsSparse())
+                InvalidArgument("NDArrayView::CopyFrom: Values can only be converted to or from DataType BFloat16 in dense storage.");
+
+            DataType otherDataType = (m_dataType == DataType::BFloat16) ? source.GetDataType() : m_dataType;
+            if (otherDataType == DataType::Float)
+                CopyConvertingBFloat16<float>(source, *this);
+            else if (otherDataType == DataType::Double)
+                CopyConvertingBFloat16<double>(source, *this);
+            else
+                LogicError("NDArrayView::CopyFrom: Unsupported DataType %s", DataTypeName(otherDataType));
+            return;
+        }
+
         switch (m_dataType)
         {
         case DataType::Float:
@@ -278,6 +387,13 @@ namespace CNTK
             destMatrix->AssignValuesOf(*sourceMatrix);
             break;
         }
+        case DataType::BFloat16:
+        {
+            auto destMatrix = GetWritableBFloat16Matrix();
+            std::unique_ptr<BFloat16Matrix> sourceMatrix(BFloat16MatrixView(*source.GetBFloat16Matrix(), destMatrix->GetNumRows(), destMatrix->GetNumCols()));
+            destMatrix->SetValue(*sourceMatrix);
+            break;
+        }
         default:
             LogicError("NDArrayView::CopyFrom: Unsupported DataType %s", DataTypeName(m_dataType));
             break;
@@ -295,6 +411,9 @@ namespace CNTK
         case DataType::Double:
             tensorView = new TensorView<double>(*(GetTensorView<double>()));
             break;
+        case DataType::BFloat16:
+            tensorView = BFloat16MatrixView(*GetBFloat16Matrix(), GetBFloat16Matrix()->GetNumRows(), GetBFloat16Matrix()->GetNumCols());
+            break;
         default:
             LogicError("NDArrayView::Alias: Unsupported DataType %s", DataTypeName(m_dataType));
             break;
@@ -367,6 +486,13 @@ namespace CNTK
             tensorView = new TensorView<double>(slicedMatrixView, AsTensorViewShape(sliceViewShape));
             break;
         }
+        case DataType::BFloat16:
+        {
+            // the slice is contiguous, so it is a column slice of the values as a single row
+            std::unique_ptr<BFloat16Matrix> rowView(BFloat16MatrixView(*GetBFloat16Matrix(), 1, Shape().TotalSize()));
+            tensorView = BFloat16MatrixView(rowView->ColumnSlice(flatBufferOffset, sliceViewShape.TotalSize()), sliceViewMatrixDims.first, sliceViewMatrixDims.second);
+            break;
+        }
         default:
             LogicError("NDArrayView::SliceView: Unsupported DataType %s", DataTypeName(m_dataType));
             break;
@@ -394,6 +520,12 @@ namespace CNTK
         case DataType::Double:
             tensorView = new TensorView<double>(*(GetTensorView<double>()), newTensorShape);
             break;
+        case DataType::BFloat16:
+        {
+            auto newMatrixDims = GetMatrixDimensions(newShape);
+            tensorView = BFloat16MatrixView(*GetBFloat16Matrix(), newMatrixDims.first, newMatrixDims.second);
+            break;
+        }
         default:
             LogicError("NDArrayView::AsShape: Unsupported DataType %s", DataTypeName(m_dataType));
             break;
@@ -428,6 +560,15 @@ namespace CNTK
         return matrix->Data();
     }
 
+    template <>
+    const bfloat16* NDArrayView::DataBuffer<bfloat16>() const
+    {
+        if (m_dataType != DataType::BFloat16)
+            InvalidArgument("NDArrayView::DataBuffer: The specified ElementType '%s' does not match this NDArrayView's DataType '%s'.", typeid(bfloat16).name(), DataTypeName(m_dataType));
+
+        return (const bfloat16*)GetBFloat16Matrix()->Data();
+    }
+
     template <typename ElementType>
     std::tuple<const ElementType *, const SparseIndexType*, const SparseIndexType*, size_t> NDArrayView::SparseCSCDataBuffers() const
     {
@@ -504,6 +645,9 @@ namespace CNTK
             matrix->CollapseDataLocation();
             break;
         }
+        case DataType::BFloat16:
+            VerifyBFloat16Storage(device, m_storageFormat);
+            break;
         default:
             LogicError("NDArrayView::ChangeDevice: Unsupported DataType %s", DataTypeName(m_dataType));
             break;
@@ -554,6 +698,8 @@ namespace CNTK
             scalar = *(cpuData->DataBuffer<float>());
         else if (scalarData->GetDataType() == DataType::Double)
             scalar = static_cast<ElementType>(*(cpuData->DataBuffer<double>()));
+        else if (scalarData->GetDataType() == DataType::BFloat16)
+            scalar = static_cast<ElementType>((float)*(cpuData->DataBuffer<bfloat16>()));
         else
             LogicError("NDArrayView::AsScalar: Unsupported DataType");
 
@@ -586,6 +732,7 @@ namespace CNTK
 
     template CNTK_API float* NDArrayView::WritableDataBuffer<float>();
     template CNTK_API double* NDArrayView::WritableDataBuffer<double>();
+    template CNTK_API bfloat16* NDArrayView::WritableDataBuffer<bfloat16>();
 
     template std::shared_ptr<const Matrix<float>> NDArrayView::GetMatrix(size_t rowColSplitPoint/* = AutoSelectRowColSplitPoint*/) const;
     template std::shared_ptr<const Matrix<double>> NDArrayView::GetMatrix(size_t rowColSplitPoint/* = AutoSelectRowColSplitPoint*/) const;
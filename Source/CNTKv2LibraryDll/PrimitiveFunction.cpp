@@ -147,6 +147,10 @@ namespace CNTK
         if (outputDataType == DataType::Unknown)
             outputDataType = firstKnownInputDataType;
 
+        // BFloat16 is a storage type only; the values of BFloat16 Constants are computed with as Float
+        if (outputDataType == DataType::BFloat16)
+            outputDataType = DataType::Float;
+
         // Propagate the data type to any input Parameters/Constants with unknown data type
         if (inferDimensions && (outputDataType != DataType::Unknown))
         {
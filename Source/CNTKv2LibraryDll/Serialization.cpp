@@ -278,6 +278,47 @@ namespace CNTK
             memcpy(buffer, src.data(), size * sizeof(T));
         }
 
+        // bfloat16 values are stored as their bits, one value per uint32
+        static void CopyBFloat16Data(const NDArrayView& src, RepeatedField<uint32>* dst)
+        {
+            auto size = src.Shape().TotalSize();
+            dst->Resize((int)size, 0);
+            const bfloat16* buffer = src.DataBuffer<bfloat16>();
+            for (auto i = 0; i < size; i++)
+                dst->Set(i, buffer[i].bits);
+        }
+
+        static void WriteBFloat16Data(const NDArrayView& src, io::CodedOutputStream& output)
+        {
+            auto size = src.Shape().TotalSize();
+            const bfloat16* buffer = src.DataBuffer<bfloat16>();
+            for (auto i = 0; i < size; i++)
+                output.WriteLittleEndian32(buffer[i].bits);
+        }
+
+        static bool ReadBFloat16Data(RenewableCodedStream& input, NDArrayView& dst)
+        {
+            auto size = dst.Shape().TotalSize();
+            bfloat16* buffer = dst.WritableDataBuffer<bfloat16>();
+            for (auto i = 0; i < size; i++)
+            {
+                uint32 bits;
+                if (!input.Read<uint32>(&bits))
+                    return false;
+                buffer[i].bits = (uint16_t)bits;
+            }
+            return true;
+        }
+
+        static void CopyBFloat16Data(const RepeatedField<uint32>& src, NDArrayView* dst)
+        {
+            auto size = src.size();
+            assert(size == dst->Shape().TotalSize());
+            bfloat16* buffer = dst->WritableDataBuffer<bfloat16>();
+            for (auto i = 0; i < size; i++)
+                buffer[i].bits = (uint16_t)src.Get(i);
+        }
+
         
 
         UsingUTF8 m_locale;
@@ -312,6 +353,10 @@ namespace CNTK
             {
                 CopyData<double>(src, dst->mutable_double_values()->mutable_value());
             }
+            else if (src.GetDataType() == DataType::BFloat16)
+            {
+                CopyBFloat16Data(src, dst->mutable_bfloat16_values()->mutable_value());
+            }
         }
     }
 
@@ -328,6 +373,10 @@ namespace CNTK
             {
                 WriteData<double>(src, output);
             }
+            else if (src.GetDataType() == DataType::BFloat16)
+            {
+                WriteBFloat16Data(src, output);
+            }
         }
     }
 
@@ -350,6 +399,11 @@ namespace CNTK
                 if (!ReadData<double>(wrapper, dst))
                     return false;                
             }
+            else if (dst.GetDataType() == DataType::BFloat16)
+            {
+                if (!ReadBFloat16Data(wrapper, dst))
+                    return false;
+            }
         }
         return true;
     }
@@ -411,7 +465,8 @@ namespace CNTK
         m_arrayViews.push_back({const_cast<NDArrayView*>(&src), dst });
         
         auto numElements = src.Shape().TotalSize();
-        auto dataSize = DataTypeSize(src.GetDataType());
+        // bfloat16 values are written as 32 bits (see WriteBFloat16Data())
+        auto dataSize = (src.GetDataType() == DataType::BFloat16) ? sizeof(uint32) : DataTypeSize(src.GetDataType());
         if (numElements > SIZE_MAX / dataSize) 
             RuntimeError("Bytes size of NDArrayView exceeds %zu.", SIZE_MAX);
         m_byteSize += numElements * dataSize;
@@ -446,6 +501,13 @@ namespace CNTK
             else
                 m_arrayViews.push_back({ dst, nullptr });
         }
+        else if (dataType == DataType::BFloat16)
+        {
+            if (src.bfloat16_values().value().size() == shape->TotalSize())
+                CopyBFloat16Data(src.bfloat16_values().value(), dst);
+            else
+                m_arrayViews.push_back({ dst, nullptr });
+        }
         return dst;
     }
 
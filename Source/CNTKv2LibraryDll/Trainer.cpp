@@ -10,6 +10,9 @@
 #include "PerformanceProfiler.h"
 #include "CompositeFunction.h"
 #include "Serialization.h"
+#include "CheckpointWriter.h"
+#include "DataParallelDistributedLearner.h"
+#include <chrono>
 
 namespace
 {
@@ -44,7 +47,9 @@ namespace CNTK
           m_distributed(false),
           m_aggregatedTrainingLossValue(std::make_shared<Accumulator>()),
           m_aggregatedTrainingEvalCriterionValue(),
-          m_prevDistributedTotalNumSamples(0)
+          m_prevDistributedTotalNumSamples(0),
+          m_checkpointBlockingTimeInSeconds(0),
+          m_distributedCheckpointMayBePending(false)
     {
         std::vector<Variable> combinedFunctionArgs;
         if (m_model) // model is optional, since it may not be adding any information on top of lossFunction
@@ -136,6 +141,35 @@ namespace CNTK
             fprintf(stderr, "[Note:] Trainer ctor: %d of the model parameters are not covered by any of the specified Learners; these parameters will not be learned\n", (int)m_modelParametersNotCoveredByLearners.size());
 
         m_distributed = m_parameterLearners->IsDistributed();
+        if (m_distributed)
+        {
+            // data parallel learners with gradient buckets start to aggregate them during backprop
+            auto compositeFunction = std::dynamic_pointer_cast<CompositeFunction>(m_combinedTrainingFunction);
+            auto parametersWithSparseGradients = compositeFunction->ParametersWithSparseGradients();
+            std::unordered_map<Parameter, std::shared_ptr<DataParallelDistributedLearner>> bucketingLearners;
+            for (const auto& learner : m_parameterLearners->ParameterLearners())
+            {
+                auto dataParallelLearner = std::dynamic_pointer_cast<DataParallelDistributedLearner>(learner);
+                if (!dataParallelLearner || !dataParallelLearner->UsesGradientBuckets())
+                    continue;
+
+                dataParallelLearner->CreateGradientBuckets(parametersWithSparseGradients);
+                if (dataParallelLearner->AggregatesGradientsDuringBackprop())
+                {
+                    for (const auto& parameter : learner->Parameters())
+                        bucketingLearners[parameter] = dataParallelLearner;
+                }
+            }
+
+            if (!bucketingLearners.empty())
+            {
+                compositeFunction->SetParameterGradientCompletedCallback([bucketingLearners](const Parameter& parameter, const NDArrayViewPtr& gradientValue) {
+                    auto learner = bucketingLearners.find(parameter);
+                    if (learner != bucketingLearners.end())
+                        learner->second->GradientCompleted(parameter, gradientValue);
+                });
+            }
+        }
 
         for (auto& learner : m_parameterLearners->ParameterLearners())
         {
@@ -368,11 +402,39 @@ namespace CNTK
     }
 
     void Trainer::SaveCheckpoint(const std::wstring& modelFilePath, Dictionary externalState)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SaveCheckpoint(modelFilePath, externalState, /*maxPendingCheckpoints =*/ 0);
+        m_checkpointBlockingTimeInSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Trainer::SaveCheckpointAsync(const std::wstring& modelFilePath, Dictionary externalState, size_t maxPendingCheckpoints)
+    {
+        if (maxPendingCheckpoints == 0)
+            InvalidArgument("Trainer::SaveCheckpointAsync: the maximum number of pending checkpoints must be positive.");
+
+        auto start = std::chrono::steady_clock::now();
+        SaveCheckpoint(modelFilePath, externalState, maxPendingCheckpoints);
+        m_checkpointBlockingTimeInSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Trainer::WaitForPendingCheckpoints()
+    {
+        if (!m_checkpointWriter)
+            return;
+
+        auto start = std::chrono::steady_clock::now();
+        m_checkpointWriter->Wait();
+        m_checkpointBlockingTimeInSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // The checkpoint is written before returning if maxPendingCheckpoints is 0, and by the checkpoint writer otherwise.
+    void Trainer::SaveCheckpoint(const std::wstring& modelFilePath, const Dictionary& externalState, size_t maxPendingCheckpoints)
     {
         auto learnersState = m_parameterLearners->CreateCheckpoint();
 
         if (!m_distributed)
-            return Save(modelFilePath, learnersState, externalState);
+            return Save(modelFilePath, learnersState, externalState, Dictionary(), maxPendingCheckpoints);
 
         auto compositeFunction = dynamic_cast<CompositeFunction*>(m_combinedTrainingFunction.get());
 
@@ -394,26 +456,25 @@ namespace CNTK
         }
 
         if (communicator->CurrentWorker().IsMain())
-            Save(modelFilePath, learnersState, externalState, aggregatedState);
+            Save(modelFilePath, learnersState, externalState, aggregatedState, maxPendingCheckpoints);
 
         // all workers need to sync up after saving model to avoid read-after-write hazard
-        // i.e. one worker is in the middle of write while another tries to read
+        // i.e. one worker is in the middle of write while another tries to read;
+        // asynchronous writes are waited for in RestoreFromCheckpoint instead
         communicator->Barrier();
+        m_distributedCheckpointMayBePending = maxPendingCheckpoints != 0;
     }
 
-    void Trainer::Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState, const Dictionary& distributedState)
+    static void WriteCheckpoint(const std::wstring& modelFilePath, const Dictionary& model, const std::wstring& trainerStateCheckpointFilePath, Dictionary& state)
     {
         std::wstring tempModelFile = modelFilePath + L".tmp";
-        Dictionary state;
-        state[versionPropertyName] = trainerCheckpointVersion;
-        state[learnersPropertyName] = learnerState;
-        state[externalStatePropertyName] = externalState;
-        state[distributedStatePropertyName] = distributedState;
+        {
+            auto stream = GetFstream(tempModelFile, false);
+            *stream << model;
+            stream->flush();
+        }
 
-        m_combinedTrainingFunction->Save(tempModelFile);
-        std::wstring trainerStateCheckpointFilePath = GetTrainerStateCheckpointFilePath(modelFilePath);
         std::wstring tempCheckpointFile = trainerStateCheckpointFilePath + L".tmp";
-
         state.Save(tempCheckpointFile);
 
         // The return value is ignored here.
@@ -424,8 +485,47 @@ namespace CNTK
         renameOrDie(tempCheckpointFile, trainerStateCheckpointFilePath);
     }
 
+    void Trainer::Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState, const Dictionary& distributedState, size_t maxPendingCheckpoints)
+    {
+        auto state = std::make_shared<Dictionary>();
+        (*state)[versionPropertyName] = trainerCheckpointVersion;
+        (*state)[learnersPropertyName] = learnerState;
+        (*state)[externalStatePropertyName] = externalState;
+        (*state)[distributedStatePropertyName] = distributedState;
+
+        // The tensors of the serialized model and of the learner state are copies in host memory,
+        // which is the snapshot that an asynchronous write works on while training continues.
+        auto model = std::make_shared<Dictionary>(m_combinedTrainingFunction->Serialize());
+        std::wstring trainerStateCheckpointFilePath = GetTrainerStateCheckpointFilePath(modelFilePath);
+
+        if (maxPendingCheckpoints == 0)
+        {
+            // the earlier asynchronous writes may be to the same files
+            WaitForPendingCheckpoints();
+            WriteCheckpoint(modelFilePath, *model, trainerStateCheckpointFilePath, *state);
+        }
+        else
+        {
+            if (!m_checkpointWriter)
+                m_checkpointWriter = std::make_shared<CheckpointWriter>();
+            m_checkpointWriter->Enqueue([modelFilePath, model, trainerStateCheckpointFilePath, state]()
+            {
+                WriteCheckpoint(modelFilePath, *model, trainerStateCheckpointFilePath, *state);
+            }, maxPendingCheckpoints);
+        }
+    }
+
     Dictionary Trainer::RestoreFromCheckpoint(const std::wstring& modelFilePath)
     {
+        // the checkpoint may still be written asynchronously, by this worker or by the main one; since all workers
+        // save checkpoints together, they agree on whether they have to wait for the main one
+        WaitForPendingCheckpoints();
+        if (m_distributed && m_distributedCheckpointMayBePending)
+        {
+            MPICommunicator()->Barrier();
+            m_distributedCheckpointMayBePending = false;
+        }
+
         // Restore the model's parameters
         m_combinedTrainingFunction->Restore(modelFilePath);
 
@@ -377,6 +377,14 @@ namespace CNTK
         if (sourceDataType == targetDataType)
             LogicError("CloneAsDataType: Source and target DataTypes are same");
 
+        // bfloat16 values are widened by NDArrayView::CopyFrom()
+        if ((sourceDataType == DataType::BFloat16) && ((targetDataType == DataType::Float) || (targetDataType == DataType::Double)))
+        {
+            auto clone = MakeSharedObject<NDArrayView>(targetDataType, source->Shape(), DeviceDescriptor::CPUDevice());
+            clone->CopyFrom(*source);
+            return readOnly ? clone->Alias(/*readOnly =*/ true) : clone;
+        }
+
         if (targetDataType != DataType::Double)
             LogicError("CloneAsDataType: Only Double target DataType is supported");
 
@@ -686,11 +694,14 @@ namespace CNTK
             return GetCNTKImplMatrixAndMBLayoutFromValueObject(var, value, inferredVarShape, nullSharedPtr, nullSharedPtr);
         }
 
+        // If 'unpackedDataStorage' is specified, the data is unpacked into it when it needs to be rearranged
         template <typename ElementType>
-        static ValuePtr GetValueObjectFromCNTKImplMatrixAndMBLayout(const NDShape& sampleShape, const std::vector<Axis>& sampleDynamicAxes, const Microsoft::MSR::CNTK::Matrix<ElementType>& matrix, const Microsoft::MSR::CNTK::MBLayoutPtr& layout, bool readOnly = true);
+        static ValuePtr GetValueObjectFromCNTKImplMatrixAndMBLayout(const NDShape& sampleShape, const std::vector<Axis>& sampleDynamicAxes, const Microsoft::MSR::CNTK::Matrix<ElementType>& matrix, const Microsoft::MSR::CNTK::MBLayoutPtr& layout, bool readOnly = true,
+                                                            const std::shared_ptr<Microsoft::MSR::CNTK::Matrix<ElementType>>& unpackedDataStorage = nullptr);
 
         template <typename ElementType>
-        static ValuePtr GetValueObjectFromCNTKImplMatrixAndMBLayout(const Variable& var, const Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, const Microsoft::MSR::CNTK::Matrix<ElementType>& matrix, const Microsoft::MSR::CNTK::MBLayoutPtr& layout, bool readOnly = true);
+        static ValuePtr GetValueObjectFromCNTKImplMatrixAndMBLayout(const Variable& var, const Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, const Microsoft::MSR::CNTK::Matrix<ElementType>& matrix, const Microsoft::MSR::CNTK::MBLayoutPtr& layout, bool readOnly = true,
+                                                            const std::shared_ptr<Microsoft::MSR::CNTK::Matrix<ElementType>>& unpackedDataStorage = nullptr);
     };
 
     template <typename Container>
@@ -376,6 +376,42 @@ namespace CNTK
         return Create(sampleShape, {sequenceData}, {sequenceStartFlag}, device, readOnly, false);
     }
 
+    template <typename ElementType>
+    /*static*/ ValuePtr Value::CreateFromBuffer(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, ElementType* dataBuffer, size_t numBufferElements, const DeviceDescriptor& device, bool readOnly/* = false*/)
+    {
+        if (sequenceLengths.empty())
+            InvalidArgument("Value::CreateFromBuffer: The number of sequences must be > 0");
+
+        auto maxSequenceLength = *std::max_element(sequenceLengths.begin(), sequenceLengths.end());
+        auto valueDataShape = sampleShape.AppendShape({ maxSequenceLength, sequenceLengths.size() });
+        auto valueData = MakeSharedObject<NDArrayView>(valueDataShape, dataBuffer, numBufferElements, device, readOnly);
+        return MakeSharedObject<Value>(valueData, CreateMask(sequenceLengths, sequenceStartFlags, device));
+    }
+
+    template <typename ElementType>
+    /*static*/ ValuePtr Value::CreateFromBuffer(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, const SparseIndexType* colStarts, const SparseIndexType* rowIndices, const ElementType* nonZeroValues, size_t numNonZeroValues)
+    {
+        if (sequenceLengths.empty())
+            InvalidArgument("Value::CreateFromBuffer: The number of sequences must be > 0");
+
+        if ((colStarts == nullptr) || (rowIndices == nullptr) || (nonZeroValues == nullptr))
+            InvalidArgument("Value::CreateFromBuffer: None of the sparse CSC format buffers is allowed to be null.");
+
+        auto maxSequenceLength = *std::max_element(sequenceLengths.begin(), sequenceLengths.end());
+        auto valueDataShape = sampleShape.AppendShape({ maxSequenceLength, sequenceLengths.size() });
+        auto matrixDims = GetMatrixDimensions(valueDataShape);
+        if (numNonZeroValues > valueDataShape.TotalSize())
+            InvalidArgument("Value::CreateFromBuffer: The number (%zu) of non-zero values exceeds the size of the Value with shape '%S'.", numNonZeroValues, valueDataShape.AsString().c_str());
+
+        // The matrix only reads the buffers, as the NDArrayView over it is read-only.
+        auto matrix = std::make_shared<Microsoft::MSR::CNTK::Matrix<ElementType>>(matrixDims.first, matrixDims.second, CPUDEVICE, Microsoft::MSR::CNTK::MatrixType::SPARSE, Microsoft::MSR::CNTK::MatrixFormat::matrixFormatSparseCSC);
+        matrix->SetMatrixFromExternalCSCFormat(const_cast<SparseIndexType*>(colStarts), const_cast<SparseIndexType*>(rowIndices), const_cast<ElementType*>(nonZeroValues), numNonZeroValues, matrixDims.first, matrixDims.second);
+
+        auto tensorView = new Microsoft::MSR::CNTK::TensorView<ElementType>(matrix, AsTensorViewShape(valueDataShape));
+        auto valueData = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), DeviceDescriptor::CPUDevice(), StorageFormat::SparseCSC, valueDataShape, /*readOnly =*/ true, tensorView);
+        return MakeSharedObject<Value>(valueData, CreateMask(sequenceLengths, sequenceStartFlags, DeviceDescriptor::CPUDevice()));
+    }
+
     /*virtual*/ Value::~Value()
     {
     }
@@ -763,6 +799,10 @@ namespace CNTK
     template /*static*/ CNTK_API ValuePtr Value::CreateSequence<double>(size_t dimension, const std::vector<size_t>& sequenceData, bool sequenceStartFlag, const DeviceDescriptor& device, bool readOnly/* = false*/);
     template /*static*/ CNTK_API ValuePtr Value::CreateSequence<float>(const NDShape& sampleShape, size_t sequenceLength, const SparseIndexType* colStarts, const SparseIndexType* rowIndices, const float* nonZeroValues, size_t numNonZeroValues, bool sequenceStartFlag, const DeviceDescriptor& device, bool readOnly/* = false*/);
     template /*static*/ CNTK_API ValuePtr Value::CreateSequence<double>(const NDShape& sampleShape, size_t sequenceLength, const SparseIndexType* colStarts, const SparseIndexType* rowIndices, const double* nonZeroValues, size_t numNonZeroValues, bool sequenceStartFlag, const DeviceDescriptor& device, bool readOnly/* = false*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateFromBuffer<float>(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, float* dataBuffer, size_t numBufferElements, const DeviceDescriptor& device, bool readOnly/* = false*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateFromBuffer<double>(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, double* dataBuffer, size_t numBufferElements, const DeviceDescriptor& device, bool readOnly/* = false*/);
+    template /*static*/ CNTK_API ValuePtr Value::CreateFromBuffer<float>(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, const SparseIndexType* colStarts, const SparseIndexType* rowIndices, const float* nonZeroValues, size_t numNonZeroValues);
+    template /*static*/ CNTK_API ValuePtr Value::CreateFromBuffer<double>(const NDShape& sampleShape, const std::vector<size_t>& sequenceLengths, const std::vector<bool>& sequenceStartFlags, const SparseIndexType* colStarts, const SparseIndexType* rowIndices, const double* nonZeroValues, size_t numNonZeroValues);
     template CNTK_API void Value::CopyVariableValueToVector<float>(const Variable& outputVariable, std::vector<std::vector<float>>& sequences);
     template CNTK_API void Value::CopyVariableValueToVector<double>(const Variable& outputVariable, std::vector<std::vector<double>>& sequences);
     template CNTK_API void Value::CopyVariableValueToVector<float>(const Variable& outputVariable, std::vector<std::vector<size_t>>& sequences);
@@ -8,6 +8,7 @@
 #include "Variable.h"
 #include "CompositeFunction.h"
 #include "Serialization.h"
+#include "MappedModel.h"
 #include "InputAndParamNodes.h"
 
 namespace CNTK
@@ -467,7 +468,10 @@ namespace CNTK
                 LogicError("Uninitialized Parameter variable '%S' cannot be saved.", AsString().c_str());
 
             // TODO: add a dictionary value constructor with an rvalue parameter.
-            dict[valueKey] = DictionaryValue(*value);
+            if (auto mappedValues = MappedValueWriter::Current())
+                dict[valueKey] = mappedValues->Add(Value());
+            else
+                dict[valueKey] = DictionaryValue(*value);
         }
         
         return dict;
@@ -521,11 +525,26 @@ namespace CNTK
 
         if (kind == VariableKind::Constant || kind == VariableKind::Parameter)
         {
-            auto& value = dict[valueKey].Value<NDArrayView>();
+            NDArrayViewPtr value;
+            if (dict[valueKey].ValueType() == DictionaryValue::Type::Dictionary)
+            {
+                // the value is stored apart from the Dictionary, in a model file in the mapped format
+                auto mappedValues = MappedValueReader::Current();
+                if (mappedValues == nullptr)
+                    LogicError("The value of Variable '%S' refers to a model file in the mapped format, which is not being loaded.", name.c_str());
+
+                value = mappedValues->Value(dict[valueKey].Value<Dictionary>(), dataType, device);
+            }
+            else
+            {
+                auto& serializedValue = dict[valueKey].Value<NDArrayView>();
+
+                // TODO: this copying here is redundant, value should be moved from the dictionary to the variable.
+                // Also, the correct device should be used upfront when deserializing NDArrayView.
+                value = serializedValue.DeepClone(device, serializedValue.IsReadOnly());
+            }
 
-            // TODO: this copying here is redundant, value should be moved from the dictionary to the variable.
-            // Also, the correct device should be used upfront when deserializing NDArrayView.
-            Variable var(shape, kind, dataType, value.DeepClone(device, value.IsReadOnly()), needsGradient, dynamicAxis, isSparse, name, uid);
+            Variable var(shape, kind, dataType, value, needsGradient, dynamicAxis, isSparse, name, uid);
             if (var.IsParameter())
                 return Parameter(var);
             else
@@ -563,7 +582,7 @@ namespace CNTK
 
     Constant Constant::CloneAs(DataType dataType) const
     {
-        if (dataType != DataType::Double)
+        if ((dataType != DataType::Double) && !((GetDataType() == DataType::BFloat16) && (dataType == DataType::Float)))
             InvalidArgument("Constant::Clone: Cannot clone Constant '%S' with DataType '%s' to DataType '%s'.", AsString().c_str(), DataTypeName(GetDataType()), DataTypeName(dataType));
 
         auto originalConstantValue = Value();
@@ -31,7 +31,7 @@ int EnvironmentUtil::GetTotalNumberOfMPINodes()
     return (!p) ? 1 : stoi(string(p));
 }
 
-int EnvironmentUtil::GetLocalMPINodeRank()
+int EnvironmentUtil::GetGlobalMPINodeRank()
 {
 #if !HAS_MPI
     const char* p = nullptr;
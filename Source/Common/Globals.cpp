@@ -14,5 +14,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     std::atomic<bool> Globals::m_forceConstantRandomSeed(false);
 
     std::atomic<bool> Globals::m_enableShareNodeValueMatrices(true);
+    std::atomic<bool> Globals::m_enableMinibatchSizeAwareMemorySharing(false);
+    std::atomic<bool> Globals::m_fuseElementwiseChains(false);
     std::atomic<bool> Globals::m_optimizeGradientAccumulation(true);
 }}}
@@ -16,9 +16,10 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static int GetTotalNumberOfMPINodes();
 
         // Reads and returns an integer value of an environment variable 
-        // corresponging to the rank of the local MPI node.
+        // corresponging to the rank of the calling MPI node among all nodes of the MPI job
+        // (not within its host), i.e. between 0 and GetTotalNumberOfMPINodes() - 1.
         // This function returns 0 if the variable is not present.
-        static int GetLocalMPINodeRank();
+        static int GetGlobalMPINodeRank();
     };
     
 }}}
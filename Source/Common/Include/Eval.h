@@ -42,6 +42,8 @@ public:
 
     //
     // Create a network based on an (NDL) network description.
+    // timesWeightStorage=bf16 or timesWeightStorage=int8 stores the weights of Times operations as bfloat16 or int8
+    // for evaluation on the CPU; timesWeightStorageNodes=W1:W2 limits this to the Times operations with these names.
     //
     virtual void CreateNetwork(const std::string& networkDescription) = 0;
 
@@ -362,4 +364,18 @@ void EVAL_API GetEvalExtended(IEvaluateModelExtended<ElemType>** peval);
 extern "C" EVAL_API void GetEvalExtendedF(IEvaluateModelExtended<float>** peval);
 extern "C" EVAL_API void GetEvalExtendedD(IEvaluateModelExtended<double>** peval);
 
+//
+// GetEvalExtendedSharingParameters - create an evaluator for the network of model (after its CreateNetwork()) that
+// shares the model's parameters, and only has its own node values and working memory. StartForwardEvaluation() must be
+// called on the new evaluator as usual. The parameters are released when the last evaluator sharing them is destroyed.
+// While ForwardPass() of a single evaluator is not reentrant, evaluators that share parameters can run ForwardPass()
+// concurrently, one thread each, as long as none of them modifies the parameters. This serves concurrent requests
+// while the model is held in memory once. The new evaluator is created under the model's evaluation lock, so it may be
+// requested while the model is in ForwardPass() on another thread; it then waits for that call to return.
+//
+template <typename ElemType>
+void EVAL_API GetEvalExtendedSharingParameters(IEvaluateModelExtended<ElemType>* model, IEvaluateModelExtended<ElemType>** peval);
+extern "C" EVAL_API void GetEvalExtendedSharingParametersF(IEvaluateModelExtended<float>* model, IEvaluateModelExtended<float>** peval);
+extern "C" EVAL_API void GetEvalExtendedSharingParametersD(IEvaluateModelExtended<double>* model, IEvaluateModelExtended<double>** peval);
+
 } } }
@@ -28,10 +28,20 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static void SetShareNodeValueMatrices(bool enable) { m_enableShareNodeValueMatrices = enable; }
         static bool ShouldEnableShareNodeValueMatrices() { return m_enableShareNodeValueMatrices; }
 
+        // re-plan memory sharing when the actual minibatch size changes (see MatrixPool::OptimizedMemoryAllocationForMinibatchSize())
+        static void SetMinibatchSizeAwareMemorySharing(bool enable) { m_enableMinibatchSizeAwareMemorySharing = enable; }
+        static bool ShouldEnableMinibatchSizeAwareMemorySharing() { return m_enableMinibatchSizeAwareMemorySharing; }
+
+        // compute chains of elementwise nodes in one pass when evaluating without gradients (see ComputationNetwork::FuseElementwiseChains())
+        static void SetFuseElementwiseChains(bool enable) { m_fuseElementwiseChains = enable; }
+        static bool ShouldFuseElementwiseChains() { return m_fuseElementwiseChains; }
+
     private:
         static std::atomic<bool> m_forceDeterministicAlgorithms;
         // The global flag to enable matrices values in forward and backward prop
         static std::atomic<bool> m_enableShareNodeValueMatrices;
+        static std::atomic<bool> m_enableMinibatchSizeAwareMemorySharing;
+        static std::atomic<bool> m_fuseElementwiseChains;
         static std::atomic<bool> m_forceConstantRandomSeed;
         static std::atomic<bool> m_optimizeGradientAccumulation;
     };
@@ -174,6 +174,9 @@ public:
     virtual void WaitAny(MPI_Request* requests, int numRequests, int* index) = 0;
     virtual void Wait(MPI_Request* request) = 0;
     virtual int WaitAll(std::vector<MPI_Request>& requests) = 0;
+
+    // tests without blocking whether all requests are complete; this also lets MPI progress them
+    virtual bool TestAll(std::vector<MPI_Request>& requests) = 0;
 };
 
 }}}
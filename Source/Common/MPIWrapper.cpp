@@ -149,6 +149,7 @@ public:
     virtual void WaitAny(MPI_Request* requests, int numRequests, int* index);
     virtual void Wait(MPI_Request* request);
     virtual int WaitAll(std::vector<MPI_Request>& requests);
+    virtual bool TestAll(std::vector<MPI_Request>& requests);
 };
 #endif
 
@@ -246,6 +247,7 @@ public:
     virtual void WaitAny(MPI_Request* requests, int numRequests, int* index);
     virtual void Wait(MPI_Request* request);
     virtual int WaitAll(std::vector<MPI_Request>& requests);
+    virtual bool TestAll(std::vector<MPI_Request>& requests);
 };
 
 
@@ -616,6 +618,13 @@ int MPIWrapperMpi::WaitAll(std::vector<MPI_Request>& requests)
     return MPI_Waitall((int)requests.size(), &requests[0], MPI_STATUSES_IGNORE) || MpiFail("waitall: MPI_Waitall");
 }
 
+bool MPIWrapperMpi::TestAll(std::vector<MPI_Request>& requests)
+{
+    int flag = 0;
+    MPI_Testall((int)requests.size(), &requests[0], &flag, MPI_STATUSES_IGNORE) || MpiFail("testall: MPI_Testall");
+    return flag != 0;
+}
+
 int MPIWrapperMpi::Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status)
 {
     return MPI_Waitany(count, array_of_requests, index, status);
@@ -998,6 +1007,11 @@ int MPIWrapperEmpty::WaitAll(std::vector<MPI_Request>& requests)
     return MPI_UNDEFINED;
 }
 
+bool MPIWrapperEmpty::TestAll(std::vector<MPI_Request>& requests)
+{
+    return true;
+}
+
 
 int MPIWrapperEmpty::Waitany(int count, MPI_Request array_of_requests[], int* index, MPI_Status* status)
 {
@@ -669,6 +669,60 @@ void ComputationNetwork::SetSeqParam(ComputationNetworkPtr net,
     }
 }
 
+// select the storage type of the weights of Times operations for inference on the CPU (cf. TimesNodeBase::SetWeightStorage())
+// If nodeNames is not empty, only the Times operations that match one of the names (which may contain a '*' wildcard) are changed.
+// The weights are converted right away, so that the first evaluation does not pay for it.
+/*static*/ void ComputationNetwork::SetTimesWeightStorage(ComputationNetworkPtr net, const ComputationNodeBasePtr& criterionNode, TimesWeightStorage storage,
+                                                        const vector<wstring>& nodeNames, bool releaseFloatWeights)
+{
+    list<ComputationNodeBasePtr> timesNodes = net->GetNodesWithType(OperationNameOf(TimesNode), criterionNode);
+    if (!nodeNames.empty())
+    {
+        set<ComputationNodeBasePtr> selectedNodes;
+        for (const auto& name : nodeNames)
+        {
+            auto nodes = net->GetNodesFromName(name);
+            if (none_of(nodes.begin(), nodes.end(), [&](const ComputationNodeBasePtr& node) { return find(timesNodes.begin(), timesNodes.end(), node) != timesNodes.end(); }))
+                InvalidArgument("SetTimesWeightStorage: No Times operation matches the name '%ls'.", name.c_str());
+            selectedNodes.insert(nodes.begin(), nodes.end());
+        }
+        timesNodes.remove_if([&](const ComputationNodeBasePtr& node) { return selectedNodes.find(node) == selectedNodes.end(); });
+    }
+
+    // the float weights can only be released if the Times operation is the only node that reads them
+    map<ComputationNodeBasePtr, size_t> numConsumers;
+    if (releaseFloatWeights && storage != TimesWeightStorage::Float)
+    {
+        for (const auto& node : net->GetAllNodes())
+            for (const auto& input : node->GetInputs())
+                numConsumers[input]++;
+    }
+
+    if (storage != TimesWeightStorage::Float)
+        fprintf(stderr, "Setting weight storage of %d Times operations to %s.\n", (int)timesNodes.size(), storage == TimesWeightStorage::Int8 ? "int8" : "bfloat16");
+    int numReleased = 0;
+    for (auto nodeIter = timesNodes.begin(); nodeIter != timesNodes.end(); nodeIter++)
+    {
+        bool release = numConsumers[(*nodeIter)->Input(0)] == 1;
+        auto nodef = dynamic_pointer_cast<TimesNode<float>>(*nodeIter);
+        if (nodef)
+        {
+            nodef->SetWeightStorage(storage);
+            nodef->PrepareWeightStorage(release);
+            numReleased += nodef->FloatWeightsReleased();
+        }
+        auto noded = dynamic_pointer_cast<TimesNode<double>>(*nodeIter);
+        if (noded)
+        {
+            noded->SetWeightStorage(storage);
+            noded->PrepareWeightStorage(release);
+            numReleased += noded->FloatWeightsReleased();
+        }
+    }
+    if (numReleased > 0)
+        fprintf(stderr, "Released the float weights of %d Times operations.\n", numReleased);
+}
+
 // -----------------------------------------------------------------------
 // unit test
 // -----------------------------------------------------------------------
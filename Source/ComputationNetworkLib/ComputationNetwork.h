@@ -275,6 +275,15 @@ public:
     void FormNestedNetwork(const ComputationNodeBasePtr& rootNode);
     ComputationNodeBasePtr GetNestedNetwork(const ComputationNodeBasePtr& rootNode);
 
+    // Find chains of elementwise nodes that are evaluated without gradient, and let the nested networks compute each in one pass.
+    // Must be called before the matrices are planned: the returned nodes inside the chains, whose values are never computed,
+    // are kept out of memory sharing, and the planning keeps the operands of a chain alive until its last node.
+    std::set<ComputationNodeBasePtr> FuseElementwiseChains();
+
+    // let the backprop through the nested network of rootNode call 'callback' for each LearnableParameter as soon as its gradient is complete,
+    // while the nodes before it in evaluation order are still to be backpropagated through; an empty callback removes it
+    void SetParameterGradientCompletedCallback(const ComputationNodeBasePtr& rootNode, const std::function<void(const ComputationNodeBasePtr&)>& callback);
+
     // The methods below determine evaluation order, which is tricky in presence of recurrent loops.
     // TODO: Can this be moved to a separate class?
 private:
@@ -462,6 +471,16 @@ public:
     ComputationNodeBasePtr CopyNode(const ComputationNetwork& fromNet, const std::wstring fromName, std::wstring toName, const CopyNodeFlags flags);
     void CopySubTree(const ComputationNetwork& fromNet, const std::wstring fromName, std::wstring toNamePrefix, const CopyNodeFlags flags);
     void CopyInputs(const std::wstring fromName, std::wstring toName);
+    // Create a copy of this network whose LearnableParameters and precomputed nodes share their value matrices with ours,
+    // while all other nodes get their own values. Each copy can then be evaluated on its own thread, as long as the parameters are
+    // not modified. The copy is compiled but has no matrices allocated yet. This network must not be evaluated while it is copied.
+    ComputationNetworkPtr CloneSharingParameters() const;
+    // Create a copy of this network like CloneSharingParameters(), but whose LearnableParameters and precomputed nodes hold
+    // copies of our values in host memory. The copy can be saved on another thread while this network is trained.
+    ComputationNetworkPtr CloneModelToHost() const;
+private:
+    ComputationNetworkPtr CloneWithModelValues(bool copyModelValuesToHost) const;
+public:
     void RenameNode(const std::wstring& nodeNameOrig, const std::wstring& nodeNameNew);
     void RenameNode(ComputationNodeBasePtr node, const std::wstring& newNodeName);
     void DeleteNode(const std::wstring& nodeName);
@@ -554,6 +573,9 @@ public:
                             const double& bMMIfactor = 0.0f,
                             const bool& sMBR = false);
     static void SetMaxTempMemSizeForCNN(ComputationNetworkPtr net, const ComputationNodeBasePtr& criterionNode, const size_t maxTempMemSizeInSamples);
+    // releaseFloatWeights keeps the converted weights only, for networks that are never trained (see TimesNodeBase::PrepareWeightStorage())
+    static void SetTimesWeightStorage(ComputationNetworkPtr net, const ComputationNodeBasePtr& criterionNode, TimesWeightStorage storage,
+                                      const std::vector<std::wstring>& nodeNames = std::vector<std::wstring>(), bool releaseFloatWeights = false);
 
     // -----------------------------------------------------------------------
     // node-group access
@@ -1205,6 +1227,37 @@ protected:
         virtual void RequestMatricesBeforeBackprop(MatrixPool& matrixPool);
         virtual void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool);
 
+        // Detect chains of IElementwiseFusable nodes (e.g. Plus -> ReLU -> ElementTimes) where each node except the last is consumed
+        // only by the next one and none of them needs a gradient. Such a chain is then computed in one pass when its last node
+        // is reached, without materializing the values of the other nodes. 'numConsumers' counts the uses of each node as an input.
+        // Returns the number of chains found.
+        size_t FuseElementwiseChains(const std::map<ComputationNodeBasePtr, size_t>& numConsumers);
+        const std::set<ComputationNodeBasePtr>& GetFusedIntermediateNodes() const { return m_fusedIntermediateNodes; }
+
+        // Called by Backprop() for each LearnableParameter once its gradient is complete. All consumers of a LearnableParameter come after it
+        // in evaluation order, so its gradient is complete when the backwards iteration reaches it.
+        void SetParameterGradientCompletedCallback(const std::function<void(const ComputationNodeBasePtr&)>& callback)
+        {
+            m_parameterGradientCompleted = callback;
+        }
+
+    private:
+        struct FusedElementwiseChain
+        {
+            std::vector<ComputationNodeBasePtr> nodes;    // in evaluation order; only the value of the last one is computed
+            std::vector<ComputationNodeBasePtr> operands; // the nodes whose values the chain reads; operands[0] is the start value
+            std::vector<FusedElementwiseStep> steps;      // one step per entry in 'nodes'
+        };
+
+        void ForwardPropFusedChain(const FusedElementwiseChain& chain, const FrameRange& fr);
+        template <class ElemType>
+        bool TryForwardPropFusedChain(const FusedElementwiseChain& chain);
+
+        std::map<ComputationNodeBasePtr, FusedElementwiseChain> m_fusedChains; // [last node of chain] -> chain
+        std::set<ComputationNodeBasePtr> m_fusedIntermediateNodes;             // chain nodes other than the last; skipped during ForwardProp()
+
+        std::function<void(const ComputationNodeBasePtr&)> m_parameterGradientCompleted;
+
     public:
         // this special constructor constructs the top-level network node
         // There is currently no other constructor for inner nested PAR-traversed sub-networks, but there will be.
@@ -9,6 +9,8 @@
 #include "ComputationNode.h"
 #include "ComputationNetwork.h"
 #include "InputAndParamNodes.h"
+#include "LinearAlgebraNodes.h"
+#include "PreComputeNodes.h"
 #include "TrainingNodes.h"
 #include <string>
 #include <vector>
@@ -97,6 +99,97 @@ void ComputationNetwork::CopySubTree(const ComputationNetwork& fromNet,
     }
 }
 
+// share the value of a node that is a part of the model, i.e. of a parameter or of a precomputed node,
+// or give the copy its own copy of it in host memory
+template <class ElemType>
+static bool ShareOrCopyModelValue(const ComputationNodeBasePtr& fromNode, const ComputationNodeBasePtr& toNode, bool copyToHost)
+{
+    if (!dynamic_pointer_cast<LearnableParameter<ElemType>>(fromNode) && !dynamic_pointer_cast<PreComputedNodeBase<ElemType>>(fromNode))
+        return false;
+    const auto& fromValue = dynamic_pointer_cast<ComputationNode<ElemType>>(fromNode)->ValuePtrRef();
+    auto& toValue = dynamic_pointer_cast<ComputationNode<ElemType>>(toNode)->ValuePtrRef();
+    if (!copyToHost)
+        toValue = fromValue;
+    else if (fromValue->GetMatrixType() == MatrixType::DENSE)
+    {
+        toValue = make_shared<Matrix<ElemType>>(CPUDEVICE);
+        toValue->AssignValuesOf(*fromValue);
+    }
+    else
+    {
+        toValue = make_shared<Matrix<ElemType>>(fromValue->DeepClone());
+        toValue->TransferToDeviceIfNotThere(CPUDEVICE, /*isBeingMoved=*/ true);
+    }
+    return true;
+}
+
+template <class ElemType>
+static void ShareTimesWeightStorage(const ComputationNodeBasePtr& fromNode, const ComputationNodeBasePtr& toNode)
+{
+    auto fromTimes = dynamic_pointer_cast<TimesNode<ElemType>>(fromNode);
+    if (fromTimes)
+        dynamic_pointer_cast<TimesNode<ElemType>>(toNode)->ShareWeightStorageWith(*fromTimes);
+}
+
+ComputationNetworkPtr ComputationNetwork::CloneSharingParameters() const
+{
+    return CloneWithModelValues(/*copyModelValuesToHost=*/ false);
+}
+
+ComputationNetworkPtr ComputationNetwork::CloneModelToHost() const
+{
+    return CloneWithModelValues(/*copyModelValuesToHost=*/ true);
+}
+
+ComputationNetworkPtr ComputationNetwork::CloneWithModelValues(bool copyModelValuesToHost) const
+{
+    auto net = make_shared<ComputationNetwork>(GetDeviceId());
+    *net->m_environment = *m_environment;
+    net->m_randomSeedOffset = m_randomSeedOffset;
+
+    // The nodes are duplicated without their value and gradient matrices: the model values are shared, and all others
+    // are allocated by the copy when it is evaluated. Some nodes still copy matrices of their own (e.g. convolution and
+    // batch normalization state), so the source must not be evaluated while it is cloned.
+    for (const auto& iter : m_nameToNodeMap)
+    {
+        const auto& fromNode = iter.second;
+        auto toNode = fromNode->Duplicate(fromNode->NodeName(), CopyNodeFlags(CopyNodeFlags::copyNodeAll | CopyNodeFlags::copyNodeWithoutMatrices));
+        if (!ShareOrCopyModelValue<float>(fromNode, toNode, copyModelValuesToHost))
+            ShareOrCopyModelValue<double>(fromNode, toNode, copyModelValuesToHost);
+        net->AddNodeToNet(toNode);
+    }
+
+    for (const auto& iter : m_nameToNodeMap)
+    {
+        const auto& fromNode = iter.second;
+        auto toNode = net->GetNodeFromName(fromNode->NodeName());
+        for (size_t i = 0; i < fromNode->GetNumInputs(); i++)
+            toNode->SetInput(i, net->GetNodeFromName(fromNode->GetInputs()[i]->NodeName()));
+    }
+
+    auto fromGroups = const_cast<ComputationNetwork&>(*this).GetAllNodeGroups();
+    auto toGroups = net->GetAllNodeGroups();
+    for (size_t i = 0; i < fromGroups.size(); i++)
+    {
+        for (const auto& fromNode : *fromGroups[i])
+            toGroups[i]->push_back(net->GetNodeFromName(fromNode->NodeName()));
+    }
+
+    net->CompileNetwork();
+    if (copyModelValuesToHost)
+        return net;
+
+    // the converted weights of reduced-precision products are shared as well
+    for (const auto& iter : m_nameToNodeMap)
+    {
+        const auto& fromNode = iter.second;
+        auto toNode = net->GetNodeFromName(fromNode->NodeName());
+        ShareTimesWeightStorage<float>(fromNode, toNode);
+        ShareTimesWeightStorage<double>(fromNode, toNode);
+    }
+    return net;
+}
+
 // you can only copy inputs from nodes in the same network
 void ComputationNetwork::CopyInputs(const std::wstring fromName, std::wstring toName)
 {
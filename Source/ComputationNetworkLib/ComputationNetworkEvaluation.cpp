@@ -11,6 +11,7 @@
 #include "RecurrentNodes.h"
 #include "InputAndParamNodes.h"
 #include "LinearAlgebraNodes.h"
+#include "NodeProfiler.h"
 #include <string>
 #include <vector>
 #include <list>
@@ -40,6 +41,15 @@ void ComputationNetwork::ForwardProp(const ComputationNodeBasePtr rootNode)
 {
     VerifyIsCompiled("ForwardProp");
 
+    // if the minibatch size changed substantially, re-plan memory sharing for it before any node touches its matrices
+    if (m_areMatricesAllocated && Globals::ShouldEnableMinibatchSizeAwareMemorySharing() && m_pMBLayoutOfNetwork &&
+        m_matrixPool.OptimizedMemoryAllocationForMinibatchSize(m_pMBLayoutOfNetwork->GetNumCols()) && TraceLevel() > 0)
+    {
+        const auto& stats = m_matrixPool.GetMemoryPlanStats();
+        fprintf(stderr, "\nMemory Sharing: Re-planned %d requests for %d minibatch columns into %d buffers: %.1f MB peak, lower bound %.1f MB.\n",
+                (int)stats.numRequests, (int)stats.numColumns, (int)stats.numBuffers, stats.plannedBytes / 1048576.0, stats.lowerBoundBytes / 1048576.0);
+    }
+
     // traverse all nodes in the pre-determined evaluation order
     GetNestedNetwork(rootNode)->ForwardProp(FrameRange(nullptr));
 }
@@ -103,6 +113,46 @@ ComputationNodeBasePtr ComputationNetwork::GetNestedNetwork(const ComputationNod
     return m_nestedNetworks[rootNode];
 }
 
+std::set<ComputationNodeBasePtr> ComputationNetwork::FuseElementwiseChains()
+{
+    std::map<ComputationNodeBasePtr, size_t> numConsumers;
+    for (const auto& node : GetAllNodes())
+    {
+        for (const auto& input : node->GetInputs())
+            numConsumers[input]++;
+    }
+
+    size_t numChains = 0;
+    std::set<ComputationNodeBasePtr> intermediateNodes;
+    for (auto& network : m_nestedNetworks)
+    {
+        auto parNode = dynamic_pointer_cast<PARTraversalFlowControlNode>(network.second);
+        if (parNode)
+        {
+            numChains += parNode->FuseElementwiseChains(numConsumers);
+            intermediateNodes.insert(parNode->GetFusedIntermediateNodes().begin(), parNode->GetFusedIntermediateNodes().end());
+        }
+    }
+
+    // The values of the intermediate nodes are not computed, so they get no buffer from the pool. They keep an empty matrix of
+    // their own, which is only filled if a chain falls back to node-by-node evaluation (e.g. for sparse values).
+    for (const auto& node : intermediateNodes)
+        node->MarkValueNonSharable();
+
+    if (TraceLevel() > 0)
+        fprintf(stderr, "\nFused %d chains of elementwise operations.\n", (int) numChains);
+    return intermediateNodes;
+}
+
+void ComputationNetwork::SetParameterGradientCompletedCallback(const ComputationNodeBasePtr& rootNode, const std::function<void(const ComputationNodeBasePtr&)>& callback)
+{
+    auto parNode = dynamic_pointer_cast<PARTraversalFlowControlNode>(GetNestedNetwork(rootNode));
+    if (!parNode)
+        LogicError("SetParameterGradientCompletedCallback: The nested network of %ls %ls operation is not PAR-traversed.", rootNode->NodeName().c_str(), rootNode->OperationName().c_str());
+
+    parNode->SetParameterGradientCompletedCallback(callback);
+}
+
 // -----------------------------------------------------------------------
 // PARTraversalFlowControlNode methods -- implements PAR traversal
 //
@@ -144,6 +194,8 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
 {
     if (node->IsOutOfDateWrtInputs())
     {
+        NodeProfilerScope profile(node, /*isBackward=*/false);
+
         node->BeginForwardProp();
         node->ForwardProp(fr.WithLayout(node->GetMBLayout()));
         node->EndForwardProp();
@@ -160,7 +212,156 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::ForwardProp(const FrameRange& fr) /*override*/
 {
     for (auto& node : m_nestedNodes)
-        ForwardProp(node, fr);
+    {
+        if (m_fusedChains.empty())
+            ForwardProp(node, fr);
+        else if (m_fusedIntermediateNodes.find(node) != m_fusedIntermediateNodes.end())
+            continue; // computed as part of the chain's last node
+        else
+        {
+            auto chain = m_fusedChains.find(node);
+            if (chain != m_fusedChains.end())
+                ForwardPropFusedChain(chain->second, fr);
+            else
+                ForwardProp(node, fr);
+        }
+    }
+}
+
+// compute a chain found by FuseElementwiseChains() when its last node is reached in evaluation order
+void ComputationNetwork::PARTraversalFlowControlNode::ForwardPropFusedChain(const FusedElementwiseChain& chain, const FrameRange& fr)
+{
+    // The values of the intermediate nodes are never computed, hence their time stamps are stale. The chain is up to date if
+    // its last node is newer than everything the chain reads.
+    const auto& lastNode = chain.nodes.back();
+    bool isOutOfDate = false;
+    for (const auto& operand : chain.operands)
+        isOutOfDate |= !operand->IsOlderThan(*lastNode);
+    if (!isOutOfDate)
+        return;
+
+    NodeProfilerScope profile(lastNode, /*isBackward=*/false); // the chain is profiled as its last node
+    if (TryForwardPropFusedChain<float>(chain) || TryForwardPropFusedChain<double>(chain))
+    {
+        lastNode->EndForwardProp();
+        lastNode->BumpEvalTimeStamp();
+    }
+    else // the values do not qualify for the fused kernel (e.g. GPU, sparse, or broadcasting it does not support): compute node by node
+    {
+        profile.Discard();
+        for (const auto& node : chain.nodes)
+            ForwardProp(node, fr);
+    }
+}
+
+template <class ElemType>
+bool ComputationNetwork::PARTraversalFlowControlNode::TryForwardPropFusedChain(const FusedElementwiseChain& chain)
+{
+    auto lastNode = dynamic_pointer_cast<ComputationNode<ElemType>>(chain.nodes.back());
+    if (!lastNode)
+        return false;
+
+    // tracing needs the intermediate values
+    for (const auto& node : chain.nodes)
+    {
+        if (node->HasEnvironmentPtr() && (node->Environment().ShouldDumpNode() || node->Environment().trackGapNans))
+            return false;
+    }
+
+    // Check the operands before anything is resized. Operands with a layout must match the result; operands without
+    // must be column vectors or scalars, which are broadcast along the minibatch.
+    const size_t rows = lastNode->GetSampleMatrixNumRows();
+    std::vector<const Matrix<ElemType>*> operands;
+    for (const auto& operandNode : chain.operands)
+    {
+        auto operand = dynamic_pointer_cast<ComputationNode<ElemType>>(operandNode);
+        if (!operand)
+            return false;
+        const auto& value = operand->Value();
+        if (operand->HasMBLayout() ? (operand->GetMBLayout() != lastNode->GetMBLayout()) : (value.GetNumCols() != 1))
+            return false;
+        if (value.GetNumRows() != rows && value.GetNumElements() != 1)
+            return false;
+        // AllocateAllMatrices() keeps the operands alive until the last node's value is allocated, so none of them shares its buffer
+        operands.push_back(&value);
+    }
+
+    lastNode->BeginForwardProp();
+    return Matrix<ElemType>::FusedElementwiseOf(lastNode->Value(), operands, chain.steps);
+}
+
+size_t ComputationNetwork::PARTraversalFlowControlNode::FuseElementwiseChains(const std::map<ComputationNodeBasePtr, size_t>& numConsumers)
+{
+    m_fusedChains.clear();
+    m_fusedIntermediateNodes.clear();
+
+    std::vector<FusedElementwiseChain> chains;
+    std::map<ComputationNodeBasePtr, size_t> chainEndingIn; // [node] -> index of the chain that it currently ends
+    for (const auto& node : m_nestedNodes)
+    {
+        auto fusable = dynamic_cast<IElementwiseFusable*>(node.get());
+        if (!fusable || node->NeedsGradient() || !node->HasMBLayout() || node->GetNumInputs() < 1 || node->GetNumInputs() > 2)
+            continue;
+        ElementWiseOperator op = fusable->GetFusableForwardOp();
+
+        // We can continue a chain through one of our inputs if we are its only consumer: nobody else, in particular no
+        // gradient computation, will then look at its value. It must also not be an output, and have our own shape.
+        int runningInput = -1;
+        for (size_t i = 0; i < node->GetNumInputs() && runningInput < 0; i++)
+        {
+            const auto& input = node->Input(i);
+            auto consumers = numConsumers.find(input);
+            if (chainEndingIn.find(input) != chainEndingIn.end() && consumers != numConsumers.end() && consumers->second == 1 &&
+                input->IsValueSharable() && input->GetMBLayout() == node->GetMBLayout() &&
+                input->GetSampleMatrixNumRows() == node->GetSampleMatrixNumRows())
+            {
+                runningInput = (int) i;
+            }
+        }
+
+        if (runningInput >= 0)
+        {
+            auto iter = chainEndingIn.find(node->Input(runningInput));
+            size_t chainIndex = iter->second;
+            chainEndingIn.erase(iter);
+
+            auto& chain = chains[chainIndex];
+            chain.nodes.push_back(node);
+            if (node->GetNumInputs() == 1)
+                chain.steps.push_back(FusedElementwiseStep(op));
+            else
+            {
+                chain.operands.push_back(node->Input(1 - runningInput));
+                chain.steps.push_back(FusedElementwiseStep(op, (int) chain.operands.size() - 1, /*runningValueFirst=*/runningInput == 0));
+            }
+            chainEndingIn[node] = chainIndex;
+        }
+        else // start a new chain with this node
+        {
+            FusedElementwiseChain chain;
+            chain.nodes.push_back(node);
+            chain.operands.push_back(node->Input(0));
+            if (node->GetNumInputs() == 1)
+                chain.steps.push_back(FusedElementwiseStep(op));
+            else
+            {
+                chain.operands.push_back(node->Input(1));
+                chain.steps.push_back(FusedElementwiseStep(op, 1));
+            }
+            chainEndingIn[node] = chains.size();
+            chains.push_back(move(chain));
+        }
+    }
+
+    // a single node gains nothing from fusion
+    for (auto& chain : chains)
+    {
+        if (chain.nodes.size() < 2)
+            continue;
+        m_fusedIntermediateNodes.insert(chain.nodes.begin(), chain.nodes.end() - 1);
+        m_fusedChains[chain.nodes.back()] = move(chain);
+    }
+    return m_fusedChains.size();
 }
 
 /*static*/ void ComputationNetwork::PARTraversalFlowControlNode::PostForwardAndBackProp(const ComputationNodeBasePtr& node)
@@ -182,6 +383,8 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
     {
         auto& node = *pnode;
 
+        NodeProfilerScope profile(node, /*isBackward=*/true);
+
         node->BeginBackprop();
         node->Backprop(fr.WithLayout(node->GetMBLayout()), true /*childrenInThisLoop*/, true /*childrenInOuterLoop*/);
         node->EndBackprop();
@@ -189,6 +392,9 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
         // Extreme Tracing, part 2/4
         if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode() && node->NeedsGradient())
             DumpNode<float>(node, /*dumpGradient=*/true) || DumpNode<double>(node, true);
+
+        if (m_parameterGradientCompleted && node->NeedsGradient() && node->OperationName() == OperationNameOf(LearnableParameter))
+            m_parameterGradientCompleted(node);
     }
 }
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) /*override*/
@@ -270,6 +476,7 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
     {
         for (auto& node : m_nestedNodes)
         {
+            NodeProfilerScope profile(node, /*isBackward=*/false, /*isLoopStep=*/true);
             node->ForwardProp(t);
             node->BumpEvalTimeStamp();
         }
@@ -310,6 +517,7 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
         for (auto nodeIter2 = recurrentNodes.rbegin(); nodeIter2 != recurrentNodes.rend(); ++nodeIter2)
         {
             auto& node2 = *nodeIter2;
+            NodeProfilerScope profile(node2, /*isBackward=*/true, /*isLoopStep=*/true);
             node2->Backprop(t, true /*childrenInThisLoop*/, false /*childrenInOuterLoop*/);
             // The above flags tell Backprop() to skip back-propagation from inside a node into
             // a node that is outside the loop, which is done later in EndBackprop() in PAR mode.
@@ -334,6 +542,7 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
     for (auto nodeIter2 = m_nestedNodes.rbegin(); nodeIter2 != m_nestedNodes.rend(); ++nodeIter2)
     {
         auto& node2 = *nodeIter2;
+        NodeProfilerScope profile(node2, /*isBackward=*/true, /*isLoopStep=*/true);
         node2->Backprop(FrameRange(m_nestedNodes[0]->GetMBLayout()), false /*childrenInThisLoop*/, true /*childrenInOuterLoop*/);
     }
 
@@ -1067,6 +1276,11 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
     // Due to special topology, if a node is solely induced by parameters, its function value should not be shared
     MarkValueNonSharableNodes();
 
+    // chains of elementwise nodes are fused before planning, since the plan depends on when each chain reads its operands
+    std::set<ComputationNodeBasePtr> fusedIntermediateNodes;
+    if (Globals::ShouldFuseElementwiseChains())
+        fusedIntermediateNodes = FuseElementwiseChains();
+
     bool performingBackPropagation = (trainRootNode != nullptr);
 
     // Create a composite Eval order with the specified nodes as roots
@@ -1138,7 +1352,11 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
 
     m_matrixPool.Reset();
 
-    TravserseInSortedGlobalEvalOrder(forwardPropRoots, [&outputValueNeededDuringBackProp, &parentsMap, this](const ComputationNodeBasePtr& node) {
+    // A fused chain reads all of its operands when its last node is computed. The inputs of the nodes inside a chain are therefore
+    // only released with the last node: [node] -> chain nodes before it whose inputs are released after its value is allocated.
+    std::unordered_map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>> deferredReleases;
+
+    TravserseInSortedGlobalEvalOrder(forwardPropRoots, [&outputValueNeededDuringBackProp, &parentsMap, &fusedIntermediateNodes, &deferredReleases, this](const ComputationNodeBasePtr& node) {
         if (node->Is<SEQTraversalFlowControlNode>())
         {
             auto seqTraversalFlowControlNode = node->As<SEQTraversalFlowControlNode>();
@@ -1154,8 +1372,28 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         {
             node->SetOutputNeededDuringBackprop(outputValueNeededDuringBackProp[node]);
             node->RequestMatricesBeforeForwardProp(m_matrixPool);
+
+            auto deferred = deferredReleases.find(node);
+            std::vector<ComputationNodeBasePtr> chainNodes;
+            if (deferred != deferredReleases.end())
+            {
+                chainNodes = move(deferred->second);
+                deferredReleases.erase(deferred);
+            }
+
+            if (fusedIntermediateNodes.find(node) != fusedIntermediateNodes.end())
+            {
+                // the node has a single consumer, the next node in its chain
+                chainNodes.push_back(node);
+                auto& next = deferredReleases[*parentsMap[node].begin()];
+                next.insert(next.end(), chainNodes.begin(), chainNodes.end());
+                return;
+            }
+
             // we only release matrices for the children since the root node's information will be used
             // and should not be shared with others
+            for (const auto& chainNode : chainNodes)
+                ReleaseMatricesAfterEvalForChildren(chainNode, parentsMap);
             ReleaseMatricesAfterEvalForChildren(node, parentsMap);
         }
     });
@@ -1251,9 +1489,8 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
     m_matrixPool.OptimizedMemoryAllocation(); 
     m_areMatricesAllocated = true;
 
-    // TO DO: At the time of AllocateAllMatrices we don't know the minibatch size. In theory one may allocate memory again once we start to receive
-    // data from the reader (and the minibatch size is known). For some problems, minibatch size can change constantly, and there needs to be a 
-    // tradeoff in deciding how frequent to run optimized memory allocation. For now, we do it only once at the very beginning for speed concerns. 
+    // At the time of AllocateAllMatrices we don't know the minibatch size. If minibatchSizeAwareMemorySharing is enabled, ForwardProp() re-plans
+    // the sharing once data arrives from the reader, and again whenever the minibatch size moves to a different power-of-two bucket.
 
     // TO DO: when some matrices are sparse, the memory size request may be wrong. One may need to call OptimizedMemoryAllocation later again 
     // if the requests of sparse allocation and release are re-processed correctly. Future work. 
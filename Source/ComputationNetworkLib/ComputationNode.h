@@ -73,7 +73,8 @@ enum CopyNodeFlags // flags to be passed to the CopyTo() function
     copyNodeValue          = 1, // copy everything except for the input links
     copyNodeInputLinks     = 2, // copy over input links
     copyNodeAll            = 3, // copy everything
-    copyNodeAcrossNetworks = 4  // allow a cross network child copy
+    copyNodeAcrossNetworks = 4, // allow a cross network child copy
+    copyNodeWithoutMatrices = 8 // together with copyNodeValue: copy all but the value and gradient matrices, which are left to be allocated or shared
 };
 
 #pragma region base computation class
@@ -1297,7 +1298,7 @@ public:
     virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
     {
         Base::CopyTo(nodeP, newName, flags);
-        if (flags & CopyNodeFlags::copyNodeValue)
+        if ((flags & CopyNodeFlags::copyNodeValue) && !(flags & CopyNodeFlags::copyNodeWithoutMatrices))
         {
             auto node = DownCast(nodeP);
             if (m_value)
@@ -2294,6 +2295,17 @@ struct ILateAttachingNode { virtual void LateAttachInputs() = 0; };
 
 struct IRecurrentNode { virtual int GetRecurrenceSteppingDirection() const = 0; };
 
+// =======================================================================
+// IElementwiseFusable -- nodes whose ForwardProp() is a single elementwise
+// opcode applied to their input(s), which allows the network to compute
+// chains of them in one pass (see ComputationNetwork::FuseElementwiseChains())
+// =======================================================================
+
+struct IElementwiseFusable
+{
+    virtual ElementWiseOperator GetFusableForwardOp() const = 0; // a unary op for nodes with one input, else a binary op
+};
+
 // =======================================================================
 // IFreezable -- nodes that have parameters that can be frozen
 // e.g. if a trained model is to be used as a fixed feature extractor for another
@@ -30,7 +30,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 // -----------------------------------------------------------------------
 
 template <class ElemType>
-class PlusNode : public BinaryElementWiseNode<ElemType>
+class PlusNode : public BinaryElementWiseNode<ElemType>, public IElementwiseFusable
 {
     typedef BinaryElementWiseNode<ElemType> Base; UsingBinaryElementwiseNodeBaseMembers;
     static const std::wstring TypeName() { return L"Plus"; }
@@ -51,6 +51,8 @@ public:
         result.AssignSumOf(input0, input1);
     }
 
+    virtual ElementWiseOperator /*IElementwiseFusable::*/ GetFusableForwardOp() const override { return opSum; }
+
     virtual void /*ComputationNode::*/ BackpropTo(const size_t inputIndex, const FrameRange& fr) override
     {
         size_t rank = DetermineElementwiseTensorRank();
@@ -232,7 +234,7 @@ template class PowNode<double>;
 // -----------------------------------------------------------------------
 
 template <class ElemType>
-class MinusNode : public BinaryElementWiseNode<ElemType>
+class MinusNode : public BinaryElementWiseNode<ElemType>, public IElementwiseFusable
 {
     typedef BinaryElementWiseNode<ElemType> Base; UsingBinaryElementwiseNodeBaseMembers;
     static const std::wstring TypeName() { return L"Minus"; }
@@ -253,6 +255,8 @@ public:
         result.AssignDifferenceOf(input0, input1);
     }
 
+    virtual ElementWiseOperator /*IElementwiseFusable::*/ GetFusableForwardOp() const override { return opDifference; }
+
     virtual void /*ComputationNode::*/ BackpropTo(const size_t inputIndex, const FrameRange& fr) override
     {
         size_t rank = DetermineElementwiseTensorRank();
@@ -295,7 +299,7 @@ template class MinusNode<double>;
 // -----------------------------------------------------------------------
 
 template <class ElemType>
-class ElementTimesNode : public BinaryElementWiseNode<ElemType>
+class ElementTimesNode : public BinaryElementWiseNode<ElemType>, public IElementwiseFusable
 {
     typedef BinaryElementWiseNode<ElemType> Base;
     UsingBinaryElementwiseNodeBaseMembers;
@@ -327,6 +331,8 @@ public:
         return ParentGradientOptimization::Overwrite;
     }
 
+    virtual ElementWiseOperator /*IElementwiseFusable::*/ GetFusableForwardOp() const override { return opElementwiseProduct; }
+
     template <typename classType>
     static void ForwardPropImpl(classType& c, const FrameRange& fr, bool allowBroadcast)
     {
@@ -388,7 +394,8 @@ public:
 
 public:
     TimesNodeBase(DEVICEID_TYPE deviceId, const wstring& name, size_t outputRank = 1, int inferInputRankToMap = NoInferredInputRank)
-        : Base(deviceId, name), m_outputRank(outputRank), m_inferInputRankToMap(inferInputRankToMap), m_beingUnrolled(false)
+        : Base(deviceId, name), m_outputRank(outputRank), m_inferInputRankToMap(inferInputRankToMap), m_beingUnrolled(false),
+          m_weightStorage(TimesWeightStorage::Float), m_weightTimeStamp(0), m_floatWeightsReleased(false)
     {
     }
 
@@ -400,6 +407,7 @@ public:
             auto node = dynamic_pointer_cast<TimesNodeBase<ElemType, m_transpose>>(nodeP);
             node->m_outputRank          = m_outputRank;
             node->m_inferInputRankToMap = m_inferInputRankToMap;
+            node->SetWeightStorage(m_weightStorage);
         }
     }
 
@@ -622,6 +630,12 @@ private:
 public:
     virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& fr) override
     {
+        if (m_floatWeightsReleased)
+        {
+            ForwardProp_ReleasedFloatWeights(fr);
+            return;
+        }
+
         // If argument A is minibatch data, then this must be performed frame-by-frame, sequence-by-sequence, one GEMM call each.
         // This will be inefficient. We hope this will be the baseline of a future, more efficient TensorView-based implementation.
         auto inputMBLayout = InputRef(0).GetMBLayout();
@@ -685,7 +699,8 @@ public:
         auto input0 = OneSampleTensorFor(0,  /*gradient=*/false, fr.AllowBroadcast());
         auto input1 = OneSampleTensorFor(1,  /*gradient=*/false, fr.AllowBroadcast());
         auto output = OneSampleTensorFor(-1, /*gradient=*/false, fr);
-        output.AssignMatrixProductOf(false/*transC*/, input0, m_transpose/*transA*/, input1, false/*transB*/, 1.0f, this->m_pQuantizedMultiplier);
+        auto pMultiplier = this->m_pQuantizedMultiplier ? this->m_pQuantizedMultiplier : WeightStorageMultiplier();
+        output.AssignMatrixProductOf(false/*transC*/, input0, m_transpose/*transA*/, input1, false/*transB*/, 1.0f, pMultiplier);
     }
 
     virtual void /*ComputationNode::*/ BackpropTo(const size_t inputIndex, const FrameRange& fr) override
@@ -998,14 +1013,187 @@ public:
     size_t OutputRank() const { return m_outputRank; }
     int InferInputRankToMap() const { return m_inferInputRankToMap; }
 
+    // Reduced-precision storage of the weights for inference on the CPU. It is only used when the left operand is a
+    // LearnableParameter that is not transposed, and the network is inferring; otherwise the product is computed as usual.
+    void SetWeightStorage(TimesWeightStorage storage)
+    {
+        if (m_floatWeightsReleased)
+            LogicError("%ls %ls operation: The weight storage cannot be changed after the float weights were released.", NodeName().c_str(), OperationName().c_str());
+        m_weightStorage = storage;
+        m_pWeightStorageMultiplier = nullptr;
+        if (ExceedsInt8InnerDimension())
+            fprintf(stderr, "WARNING: %ls %ls operation: The inner dimension %d exceeds the limit %d of int8 products, so the weights are not converted.\n",
+                    NodeName().c_str(), OperationName().c_str(), (int)WeightMatrixCols(), maxInt8InnerDimension);
+    }
+    TimesWeightStorage GetWeightStorage() const { return m_weightStorage; }
+
+    // Convert the weights to the storage type right away, e.g. after the model was loaded, instead of in the first ForwardProp().
+    // With releaseFloatWeights, the weights are afterwards only held in the storage type. This is meant for networks that are
+    // only evaluated, and the caller must make sure that no other node reads the parameter.
+    void PrepareWeightStorage(bool releaseFloatWeights = false)
+    {
+        size_t rows, cols;
+        if (!UsesWeightStorage() || !GetWeightMatrixDims(rows, cols))
+            return;
+        const auto& value = InputRef(0).Value();
+        GetWeightStorageMultiplier()->PrepareA((int)rows, (int)cols, value.Data());
+        m_weightTimeStamp = InputRef(0).GetEvalTimeStamp();
+        if (releaseFloatWeights)
+            ReleaseFloatWeights(rows, cols);
+    }
+
+    // Multiply with weights that are already stored as bfloat16, e.g. the values of a V2 Constant of DataType::BFloat16,
+    // instead of converting the values of the parameter. The weights are shared with owner, which keeps them alive.
+    // Like PrepareWeightStorage(), releaseFloatWeights then drops the values of the parameter.
+    void SetBFloat16Weights(const bfloat16* weights, size_t numWeights, const shared_ptr<const void>& owner, bool releaseFloatWeights = false)
+    {
+        SetWeightStorage(TimesWeightStorage::BFloat16);
+        size_t rows, cols;
+        if (!UsesWeightStorage() || !GetWeightMatrixDims(rows, cols))
+            return;
+        if (numWeights != rows * cols)
+            LogicError("%ls %ls operation: %d bfloat16 weights were given for a %d x %d weight matrix.", NodeName().c_str(), OperationName().c_str(), (int)numWeights, (int)rows, (int)cols);
+        auto multiplier = make_shared<BFloat16Multiplier<ElemType>>(/*isAConstant=*/true);
+        multiplier->SetA((int)rows, (int)cols, weights, owner);
+        m_pWeightStorageMultiplier = multiplier;
+        m_weightTimeStamp = InputRef(0).GetEvalTimeStamp();
+        if (releaseFloatWeights)
+            ReleaseFloatWeights(rows, cols);
+    }
+
+    bool FloatWeightsReleased() const { return m_floatWeightsReleased; }
+
+    // Use the converted weights of the same product in another network whose parameters share their values with ours,
+    // so that they are held in memory only once (see ComputationNetwork::CloneSharingParameters()). Only converted
+    // weights are shared, and they are frozen, since the parameters must not change while they are shared; otherwise
+    // a conversion in one network would race with the products of the others.
+    void ShareWeightStorageWith(const TimesNodeBase<ElemType, m_transpose>& other)
+    {
+        m_weightStorage = other.m_weightStorage;
+        if (other.m_pWeightStorageMultiplier && other.m_pWeightStorageMultiplier->IsAValid())
+        {
+            other.m_pWeightStorageMultiplier->Freeze();
+            m_pWeightStorageMultiplier = other.m_pWeightStorageMultiplier;
+            m_weightTimeStamp = InputRef(0).GetEvalTimeStamp();
+            m_floatWeightsReleased = other.m_floatWeightsReleased; // the parameter value is shared as well
+        }
+        else
+            m_pWeightStorageMultiplier = nullptr;
+    }
+
 protected: 
     shared_ptr<QuantizedMultiplier<ElemType>> m_pQuantizedMultiplier;
 
+private:
+    // The weights are flattened into a matrix whose rows are the first m_outputRank dimensions, cf. TensorView::DoMatrixProductOf().
+    // Returns false if the value of the parameter is not such a dense matrix on the CPU.
+    bool GetWeightMatrixDims(size_t& rows, size_t& cols)
+    {
+        const auto& shape = InputRef(0).GetSampleLayout();
+        rows = WeightMatrixRows();
+        const auto& value = InputRef(0).Value();
+        if (rows == 0 || value.GetCurrentMatrixLocation() != CPU || value.GetMatrixType() != DENSE || value.GetNumElements() != shape.GetNumElements())
+            return false;
+        cols = shape.GetNumElements() / rows;
+        return true;
+    }
+
+    size_t WeightMatrixRows() const
+    {
+        const auto& shape = Input(0)->GetSampleLayout();
+        size_t rows = 1;
+        for (size_t i = 0; i < m_outputRank && i < shape.GetRank(); i++)
+            rows *= shape[i];
+        return rows;
+    }
+
+    // the inner dimension of the product, or 0 if the weights are empty
+    size_t WeightMatrixCols() const
+    {
+        size_t rows = WeightMatrixRows();
+        return rows > 0 ? Input(0)->GetSampleLayout().GetNumElements() / rows : 0;
+    }
+
+    // The int8 product accumulates in int32, which bounds its inner dimension (see Int8Gemm.h). A larger product keeps its float weights.
+    bool ExceedsInt8InnerDimension() const
+    {
+        return m_weightStorage == TimesWeightStorage::Int8 && Input(0) && WeightMatrixCols() > (size_t)maxInt8InnerDimension;
+    }
+
+    void ReleaseFloatWeights(size_t rows, size_t cols)
+    {
+        // ForwardProp_ReleasedFloatWeights() takes each sample of the right operand and of the output as one column of the
+        // product, and a sparse input is better multiplied with the float weights
+        if (InputRef(1).GetSampleLayout().GetNumElements() == cols && GetSampleLayout().GetNumElements() == rows &&
+            !Input(1)->template Is<SparseInputValue<ElemType>>())
+        {
+            // the parameter keeps its shape, so that the network still validates, but no longer holds a value
+            InputRef(0).Value().Resize(0, 0, 0, /*growOnly=*/false);
+            m_floatWeightsReleased = true;
+        }
+    }
+
+    bool UsesWeightStorage()
+    {
+        return m_weightStorage != TimesWeightStorage::Float && !m_transpose && GetDeviceId() == CPUDEVICE &&
+               dynamic_pointer_cast<LearnableParameter<ElemType>>(Input(0)) && !ExceedsInt8InnerDimension();
+    }
+
+    shared_ptr<CachedAMultiplier<ElemType>> GetWeightStorageMultiplier()
+    {
+        if (!m_pWeightStorageMultiplier)
+        {
+            if (m_weightStorage == TimesWeightStorage::Int8)
+                m_pWeightStorageMultiplier = make_shared<Int8Multiplier<ElemType>>(/*isAConstant=*/true);
+            else
+                m_pWeightStorageMultiplier = make_shared<BFloat16Multiplier<ElemType>>(/*isAConstant=*/true);
+            m_weightTimeStamp = InputRef(0).GetEvalTimeStamp();
+        }
+        return m_pWeightStorageMultiplier;
+    }
+
+    // the multiplier that implements m_weightStorage for this product, or nullptr to multiply in ElemType
+    shared_ptr<QuantizedMultiplier<ElemType>> WeightStorageMultiplier()
+    {
+        if (!UsesWeightStorage() || !Base::HasEnvironmentPtr() || !Base::Environment().IsInferring())
+            return nullptr;
+
+        auto pMultiplier = GetWeightStorageMultiplier();
+        // the converted weights are stale once the parameter was updated
+        if (InputRef(0).GetEvalTimeStamp() != m_weightTimeStamp)
+        {
+            pMultiplier->Invalidate();
+            m_weightTimeStamp = InputRef(0).GetEvalTimeStamp();
+        }
+        return pMultiplier;
+    }
+
+    // the product when the weights only exist in the storage type (see PrepareWeightStorage())
+    void ForwardProp_ReleasedFloatWeights(const FrameRange& fr)
+    {
+        if (!m_pWeightStorageMultiplier || !m_pWeightStorageMultiplier->IsAValid())
+            LogicError("%ls %ls operation: The float weights were released without converted weights.", NodeName().c_str(), OperationName().c_str());
+
+        Matrix<ElemType> input1 = InputRef(1).ValueFor(fr);
+        Matrix<ElemType> value = ValueFor(fr);
+        if (input1.GetMatrixType() != DENSE)
+        {
+            Matrix<ElemType> denseInput1(input1.GetNumRows(), input1.GetNumCols(), CPUDEVICE);
+            denseInput1.AssignValuesOf(input1);
+            input1 = std::move(denseInput1);
+        }
+        m_pWeightStorageMultiplier->Multiply((int)value.GetNumRows(), (int)value.GetNumCols(), (int)input1.GetNumRows(), nullptr, input1.Data(), value.Data());
+    }
+
 private:
     size_t m_outputRank;
     int m_inferInputRankToMap;  // -1 (not specified) or says how to expand shape of W, to keep this many mapping dims
     bool m_beingUnrolled;
     std::once_flag m_unrollWarningOnceFlag;
+    TimesWeightStorage m_weightStorage;
+    shared_ptr<CachedAMultiplier<ElemType>> m_pWeightStorageMultiplier;
+    uint64_t m_weightTimeStamp;
+    bool m_floatWeightsReleased;
 
     bool ReduceSequenceAxis() const { return m_inferInputRankToMap == ReduceSequenceAxisWithoutInferredInputRank; }
 
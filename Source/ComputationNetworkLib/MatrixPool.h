@@ -61,6 +61,20 @@ struct MemAllocInfo
     }
 };
 
+// summary of the most recent memory sharing plan, in bytes, summed over devices and element types
+struct MemoryPlanStats
+{
+    size_t numColumns;      // minibatch columns the plan was made for (0 if the minibatch size was unknown)
+    size_t numRequests;     // number of requests that participated in sharing
+    size_t numBuffers;      // number of distinct buffers after sharing
+    size_t plannedBytes;    // peak bytes of the plan, i.e. the sum of all buffer sizes
+    size_t lowerBoundBytes; // largest sum of simultaneously live requests; no plan can do better than this
+    MemoryPlanStats()
+        : numColumns(0), numRequests(0), numBuffers(0), plannedBytes(0), lowerBoundBytes(0)
+    {
+    }
+};
+
 // MatrixPool -- class to support memory sharing
 // Despite the gather general name of this class, it is specifically designed to support the memory sharing of ComputationNodes.
 // Note: see #define SUPRESS_MEMSHARING below as for how to temporarily disable memory sharing altogether, for debugging
@@ -74,6 +88,8 @@ protected:
     vector<MemRequestInfo<double>> m_memRequestInfoDoubleVec;
     set<DEVICEID_TYPE> m_deviceIDSet; 
     int m_stepCounter; 
+    size_t m_plannedNumColumns; // minibatch columns of the current plan; 0 means planned without knowing the minibatch size
+    MemoryPlanStats m_planStats;
 
     template <class ElemType>
     vector<MemRequestInfo<ElemType>>& GetMemRequestInfoVec();
@@ -96,6 +112,11 @@ protected:
 
 public:
 
+    MatrixPool()
+        : m_stepCounter(0), m_plannedNumColumns(0)
+    {
+    }
+
     void Reset()
     {
         m_stepCounter = 0;
@@ -148,12 +169,44 @@ public:
 
     void OptimizedMemoryAllocation()
     {
+        m_plannedNumColumns = 0;
+        m_planStats = MemoryPlanStats();
+
         // MatrixPool is not templated, so we call both float and double versions here 
         OptimizedMemoryAllocationFunc<float>(); 
         OptimizedMemoryAllocationFunc<double>();
         return; 
     }
 
+    // Re-plans memory sharing once the actual minibatch size is known, so that buffers whose size scales with the minibatch
+    // are shared by size rather than by the per-sample estimate. The plan is made for numColumns rounded up to a power of two,
+    // and only redone when the minibatch outgrows that, or shrinks to a quarter of it, so that varying sequence lengths do not
+    // cause a re-plan on every minibatch. Planning itself does not touch any memory; if the sharing changed, the affected
+    // matrices are re-pointed to new (empty) matrices and the old buffers are freed once no node refers to them anymore.
+    // This must only be called between minibatches. Returns true if a new plan was made.
+    bool OptimizedMemoryAllocationForMinibatchSize(size_t numColumns)
+    {
+        if (numColumns == 0)
+            return false;
+
+        size_t bucket = 1;
+        while (bucket < numColumns)
+            bucket *= 2;
+
+        if (m_plannedNumColumns != 0 && bucket <= m_plannedNumColumns && bucket * 4 > m_plannedNumColumns)
+            return false;
+
+        m_plannedNumColumns = bucket;
+        m_planStats = MemoryPlanStats();
+        m_planStats.numColumns = bucket;
+
+        SizeAwareMemoryAllocationFunc<float>();
+        SizeAwareMemoryAllocationFunc<double>();
+        return true;
+    }
+
+    const MemoryPlanStats& GetMemoryPlanStats() const { return m_planStats; }
+
     void SetAliasInfo(
         const unordered_map<AliasNodePtr, unordered_set<AliasNodePtr>>& groupMap,
         const unordered_map<AliasNodePtr, AliasNodePtr>& rootLookupMap)
@@ -226,6 +279,172 @@ public:
     }
 
 private: 
+    // remove all requests that has been marked as sparse matrices, those will not participate in memory sharing 
+    template <class ElemType>
+    static void RemoveSparseRequests(vector<MemRequestInfo<ElemType>>& memInfoVec)
+    {
+        for (auto iter = memInfoVec.begin(); iter != memInfoVec.end(); )
+        {
+            bool hasSparse = false;
+            for (auto matPtr : iter->pMatrixPtrs)
+            {
+                if ((*matPtr)->GetMatrixType() == SPARSE)
+                {
+                    hasSparse = true;
+                    break;
+                }
+            }
+
+            if (hasSparse)
+                iter = memInfoVec.erase(iter);
+            else
+                iter++; 
+        }
+    }
+
+    // point all matrix pointers of a request with the same memory id to one new matrix
+    template <class ElemType>
+    static void AssignMatrixPointers(vector<MemRequestInfo<ElemType>>& memInfoVec, DEVICEID_TYPE devId, bool wsFlag, int memoryCounter)
+    {
+        for (int i = 0; i < memoryCounter; i++)
+        {
+            auto matrixPtr = make_shared<Matrix<ElemType>>(devId);
+            if (!matrixPtr) // this can't really happen, because we haven't started allocating memory yet
+                LogicError("MatrixPool: failed to get a valid matrix.");
+            for (auto& memInfo : memInfoVec)
+            {
+                if (memInfo.deviceId == devId && memInfo.isWorkSpace == wsFlag && memInfo.memoryId == i)
+                {
+                    for (auto pOutMatrixPtr : memInfo.pMatrixPtrs)
+                    {
+                        *pOutMatrixPtr = matrixPtr;
+                    }
+                }
+            }
+        }
+    }
+
+    // Size-aware variant of OptimizedMemoryAllocationFunc() used once the minibatch size is known.
+    // The requests form an interval graph over [allocStep, releaseStep]. Processing them in order of allocStep and
+    // handing each one a buffer that is free at that step colors this graph with the minimum number of buffers
+    // (the maximum number of simultaneously live requests). Among the free buffers we pick the smallest one that
+    // fits, or else the largest one (which then grows), to keep the sum of buffer sizes close to the lower bound.
+    template <class ElemType>
+    void SizeAwareMemoryAllocationFunc()
+    {
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        if (memInfoVec.empty())
+            return;
+
+        RemoveSparseRequests(memInfoVec);
+
+        const size_t numColumns = m_plannedNumColumns;
+        auto requestBytes = [numColumns](const MemRequestInfo<ElemType>& memInfo)
+        {
+            return memInfo.matrixSize * (memInfo.mbScale ? numColumns : 1) * sizeof(ElemType);
+        };
+
+        std::vector<bool> workspaceFlagVec = {true, false};
+        for (auto& devId : m_deviceIDSet)
+        {
+            for (auto wsFlag : workspaceFlagVec) // as above, workspace memory is not shared with non-workspace memory
+            {
+                vector<size_t> requests;
+                for (size_t i = 0; i < memInfoVec.size(); i++)
+                {
+                    if (memInfoVec[i].deviceId == devId && memInfoVec[i].isWorkSpace == wsFlag)
+                        requests.push_back(i);
+                }
+                if (requests.empty())
+                    continue;
+
+                std::stable_sort(requests.begin(), requests.end(), [&memInfoVec](size_t a, size_t b)
+                {
+                    return memInfoVec[a].allocStep < memInfoVec[b].allocStep;
+                });
+
+                struct Buffer
+                {
+                    size_t bytes;
+                    int lastReleaseStep;
+                };
+                vector<Buffer> buffers;
+                vector<int> newMemoryIds(memInfoVec.size(), -1);
+                for (auto i : requests)
+                {
+                    const auto& memInfo = memInfoVec[i];
+                    const size_t bytes = requestBytes(memInfo);
+
+                    int bestFit = -1; // smallest free buffer that is large enough
+                    int largest = -1; // largest free buffer otherwise
+                    for (int b = 0; b < (int)buffers.size(); b++)
+                    {
+                        if (buffers[b].lastReleaseStep >= memInfo.allocStep) // still occupied at this step
+                            continue;
+                        if (buffers[b].bytes >= bytes && (bestFit < 0 || buffers[b].bytes < buffers[bestFit].bytes))
+                            bestFit = b;
+                        if (largest < 0 || buffers[b].bytes > buffers[largest].bytes)
+                            largest = b;
+                    }
+
+                    int chosen = bestFit >= 0 ? bestFit : largest;
+                    if (chosen < 0)
+                    {
+                        chosen = (int)buffers.size();
+                        buffers.push_back(Buffer{ bytes, memInfo.releaseStep });
+                    }
+                    else
+                    {
+                        buffers[chosen].bytes = max(buffers[chosen].bytes, bytes);
+                        buffers[chosen].lastReleaseStep = memInfo.releaseStep;
+                    }
+                    newMemoryIds[i] = chosen;
+                }
+
+                // lower bound: the largest number of bytes live at any one step
+                vector<pair<int, long long>> events; // (step, +/- bytes); releases sort before allocations at the same step
+                for (auto i : requests)
+                {
+                    const long long bytes = (long long)requestBytes(memInfoVec[i]);
+                    events.push_back(make_pair(memInfoVec[i].allocStep, bytes));
+                    if (memInfoVec[i].releaseStep != INT_MAX)
+                        events.push_back(make_pair(memInfoVec[i].releaseStep + 1, -bytes));
+                }
+                std::sort(events.begin(), events.end());
+                long long liveBytes = 0;
+                long long peakLiveBytes = 0;
+                for (const auto& e : events)
+                {
+                    liveBytes += e.second;
+                    peakLiveBytes = max(peakLiveBytes, liveBytes);
+                }
+
+                m_planStats.numRequests += requests.size();
+                m_planStats.numBuffers += buffers.size();
+                for (const auto& buffer : buffers)
+                    m_planStats.plannedBytes += buffer.bytes;
+                m_planStats.lowerBoundBytes += (size_t)peakLiveBytes;
+
+                // only re-point the matrices if the sharing structure actually changed, to keep already allocated buffers
+                bool changed = false;
+                for (auto i : requests)
+                {
+                    if (memInfoVec[i].memoryId != newMemoryIds[i])
+                    {
+                        changed = true;
+                        break;
+                    }
+                }
+                if (!changed)
+                    continue;
+
+                for (auto i : requests)
+                    memInfoVec[i].SetMemoryId(newMemoryIds[i]);
+                AssignMatrixPointers(memInfoVec, devId, wsFlag, (int)buffers.size());
+            }
+        }
+    }
+
     bool CheckOverlap(pair<int, int>occ, vector<pair<int, int>>&occVec)
     {
         bool bRet = false;
@@ -252,24 +471,7 @@ private:
         if (memInfoVec.empty())
             return; 
 
-        // remove all requests that has been marked as sparse matrices, those will not participate in memory sharing 
-        for (auto iter = memInfoVec.begin(); iter != memInfoVec.end(); )
-        {
-            bool hasSparse = false;
-            for (auto matPtr : iter->pMatrixPtrs)
-            {
-                if ((*matPtr)->GetMatrixType() == SPARSE)
-                {
-                    hasSparse = true;
-                    break;
-                }
-            }
-
-            if (hasSparse)
-                memInfoVec.erase(iter);
-            else
-                iter++; 
-        }
+        RemoveSparseRequests(memInfoVec);
 
         // sort the memory request from largest size to smallest 
         std::sort(memInfoVec.begin(), memInfoVec.end(), greater_than_mem_req_size<ElemType>());
@@ -367,22 +569,7 @@ private:
                 }
 
                 // now assign the actual pointers 
-                for (int i = 0; i < memoryCounter; i++)
-                {
-                    auto matrixPtr = make_shared<Matrix<ElemType>>(devId);
-                    if (!matrixPtr) // this can't really happen, because we haven't started allocating memory yet
-                        LogicError("MatrixPool: failed to get a valid matrix.");
-                    for (auto& memInfo : memInfoVec)
-                    {
-                        if (memInfo.deviceId == devId && memInfo.isWorkSpace == wsFlag && memInfo.memoryId == i)
-                        {
-                            for (auto pOutMatrixPtr : memInfo.pMatrixPtrs)
-                            {
-                                *pOutMatrixPtr = matrixPtr;
-                            }
-                        }
-                    }
-                }
+                AssignMatrixPointers(memInfoVec, devId, wsFlag, memoryCounter);
             }
         }
     }
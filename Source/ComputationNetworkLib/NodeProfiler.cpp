@@ -0,0 +1,445 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
+#define _CRT_NONSTDC_NO_DEPRECATE // make VS accept POSIX functions without _
+
+#include "NodeProfiler.h"
+#include "Basics.h"
+#include "ComputationNode.h"
+#include "TimerUtility.h"
+#include "fileutil.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// Accumulated calls of one node (or of one node type, for the report).
+struct NodeProfilerRecord
+{
+    wstring name;
+    wstring type;
+    long long forwardCount;
+    long long forwardTicks;
+    long long backwardCount;
+    long long backwardTicks;
+    long long bytesTouched;
+    long long bytesAllocated;
+
+    long long TotalTicks() const { return forwardTicks + backwardTicks; }
+};
+
+// A call shown in the timeline.
+struct NodeProfilerTraceEvent
+{
+    size_t nameIndex;      // index into NodeProfilerState::traceNames
+    long long beginClock;
+    long long endClock;
+    unsigned int threadIndex;
+    bool isBackward;
+};
+
+//
+// Global state of the profiler
+//
+struct NodeProfilerState
+{
+    wstring profilerDir;                                  // Directory where reports are saved
+    wstring logSuffix;                                    // Suffix to append to report file names
+    vector<NodeProfilerRecord> records;                   // Accumulated calls of each node
+    map<pair<wstring, wstring>, size_t> recordIndex;      // [(name, type)] -> index into records
+    unordered_map<const ComputationNodeBase*, size_t> recordCache; // [node] -> index into records, validated by name
+    vector<NodeProfilerTraceEvent> traceEvents;           // Timeline
+    vector<wstring> traceNames;                           // Names of the timeline events
+    unordered_map<const ComputationNodeBase*, size_t> traceNameCache; // [node] -> index into traceNames, validated by name
+    map<thread::id, unsigned int> threads;                // [thread] -> its index in the timeline
+    size_t maxTraceEvents;
+    bool traceFull;
+};
+
+// We support one global instance of the profiler.
+static unique_ptr<NodeProfilerState> g_nodeProfilerState;
+
+// Separate from the state, so that the check for it in the hot path needs no lock.
+static atomic<bool> g_nodeProfilerEnabled(false);
+
+// Mutex controlling access to g_nodeProfilerState
+static mutex g_nodeProfilerMutex;
+
+static void NodeProfilerGenerateReport(const wstring& fileName, struct tm* timeInfo);
+static void NodeProfilerGenerateTrace(const wstring& fileName);
+
+void NodeProfilerInit(const wstring& profilerDir, const wstring& logSuffix, size_t maxTraceEvents)
+{
+    lock_guard<mutex> lock(g_nodeProfilerMutex);
+    if (g_nodeProfilerState != nullptr)
+        RuntimeError("NodeProfilerInit: Profiler already initialized.");
+
+    g_nodeProfilerState.reset(new NodeProfilerState());
+    g_nodeProfilerState->profilerDir = profilerDir;
+    g_nodeProfilerState->logSuffix = logSuffix;
+    g_nodeProfilerState->maxTraceEvents = maxTraceEvents;
+    g_nodeProfilerState->traceFull = false;
+
+    if (_wmkdir(profilerDir.c_str()) == -1 && errno != EEXIST)
+        RuntimeError("NodeProfilerInit: Cannot create directory <%ls>.", profilerDir.c_str());
+}
+
+void NodeProfilerEnable(bool enable)
+{
+    lock_guard<mutex> lock(g_nodeProfilerMutex);
+
+    // A nullptr state indicates that the profiler is globally disabled, and not initialized
+    if (g_nodeProfilerState == nullptr)
+        return;
+
+    g_nodeProfilerEnabled = enable;
+}
+
+bool NodeProfilerIsEnabled()
+{
+    return g_nodeProfilerEnabled.load(memory_order_relaxed);
+}
+
+void NodeProfilerClose()
+{
+    lock_guard<mutex> lock(g_nodeProfilerMutex);
+
+    // A nullptr state indicates that the profiler is globally disabled, and not initialized
+    if (g_nodeProfilerState == nullptr)
+        return;
+
+    g_nodeProfilerEnabled = false;
+
+    // Get current time as yyyy-mm-dd_hh-mm-ss
+    time_t currentTime;
+    time(&currentTime);
+    struct tm* timeInfo = localtime(&currentTime);
+    wchar_t timeStr[32];
+    wcsftime(timeStr, sizeof(timeStr) / sizeof(timeStr[0]), L"%Y-%m-%d_%H-%M-%S", timeInfo);
+
+    wstring fileName = g_nodeProfilerState->profilerDir + L"/" + wstring(timeStr) + L"_nodes_" + g_nodeProfilerState->logSuffix;
+    NodeProfilerGenerateReport(fileName + L".txt", timeInfo);
+    NodeProfilerGenerateTrace(fileName + L".json");
+
+    g_nodeProfilerState.reset();
+}
+
+void NodeProfilerContext::Init(const wstring& profilerDir, const wstring& logSuffix, size_t maxTraceEvents)
+{
+    NodeProfilerInit(profilerDir, logSuffix, maxTraceEvents);
+}
+
+NodeProfilerContext::~NodeProfilerContext()
+{
+    NodeProfilerClose();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Recording.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Bytes of the data of a matrix (the non-zero elements for sparse ones), and of its buffer.
+template <class ElemType>
+static void AddMatrixBytes(const MatrixBasePtr& matrixBase, size_t* dataBytes, size_t* bufferBytes)
+{
+    auto matrix = static_cast<const Matrix<ElemType>*>(matrixBase.get());
+    if (!matrix || matrix->GetMatrixType() == UNDETERMINED)
+        return;
+
+    size_t buffer = matrix->BufferSize();
+    if (dataBytes)
+        *dataBytes += matrix->GetMatrixType() == DENSE ? matrix->GetNumElements() * sizeof(ElemType) : buffer;
+    if (bufferBytes)
+        *bufferBytes += buffer;
+}
+
+template <class ElemType>
+static bool TryAddNodeBytes(const ComputationNodeBase* nodeBase, size_t* valueBytes, size_t* gradientBytes, size_t* valueBufferBytes, size_t* gradientBufferBytes)
+{
+    auto node = dynamic_cast<const ComputationNode<ElemType>*>(nodeBase);
+    if (!node)
+        return false;
+    AddMatrixBytes<ElemType>(node->ValuePtr(), valueBytes, valueBufferBytes);
+    if (gradientBytes || gradientBufferBytes)
+        AddMatrixBytes<ElemType>(node->GradientPtr(), gradientBytes, gradientBufferBytes);
+    return true;
+}
+
+// Returns false for nodes without matrices of their own (flow control nodes).
+static bool AddNodeBytes(const ComputationNodeBase* node, size_t* valueBytes, size_t* gradientBytes, size_t* valueBufferBytes = nullptr, size_t* gradientBufferBytes = nullptr)
+{
+    return TryAddNodeBytes<float>(node, valueBytes, gradientBytes, valueBufferBytes, gradientBufferBytes) ||
+           TryAddNodeBytes<double>(node, valueBytes, gradientBytes, valueBufferBytes, gradientBufferBytes);
+}
+
+// The buffer that grows if a call allocates its result: the value of the node in forward,
+// the gradients of its inputs in backward.
+static size_t ResultBufferBytes(const ComputationNodeBase* node, bool isBackward)
+{
+    size_t bytes = 0;
+    if (!isBackward)
+        AddNodeBytes(node, nullptr, nullptr, &bytes, nullptr);
+    else
+    {
+        for (size_t i = 0; i < node->GetNumInputs(); i++)
+        {
+            if (node->Input(i)->NeedsGradient())
+                AddNodeBytes(node->Input(i).get(), nullptr, nullptr, nullptr, &bytes);
+        }
+    }
+    return bytes;
+}
+
+// Bytes read or written by a call: forward reads the inputs and writes the value, backward
+// reads the gradient, the value and the inputs, and updates the gradients of the inputs.
+static size_t TouchedBytes(const ComputationNodeBase* node, bool isBackward)
+{
+    size_t bytes = 0;
+    AddNodeBytes(node, &bytes, isBackward ? &bytes : nullptr);
+    for (size_t i = 0; i < node->GetNumInputs(); i++)
+    {
+        const auto& input = node->Input(i);
+        AddNodeBytes(input.get(), &bytes, isBackward && input->NeedsGradient() ? &bytes : nullptr);
+    }
+    return bytes;
+}
+
+static size_t GetRecordIndex(const ComputationNodeBase* node)
+{
+    auto& state = *g_nodeProfilerState;
+    auto cached = state.recordCache.find(node);
+    if (cached != state.recordCache.end() && state.records[cached->second].name == node->NodeName())
+        return cached->second;
+
+    // First call of this node, or another node took the place in memory of a deleted one.
+    auto key = make_pair(node->NodeName(), node->OperationName());
+    auto iter = state.recordIndex.find(key);
+    if (iter == state.recordIndex.end())
+    {
+        iter = state.recordIndex.insert(make_pair(key, state.records.size())).first;
+        state.records.push_back(NodeProfilerRecord{ key.first, key.second, 0, 0, 0, 0, 0, 0 });
+    }
+    state.recordCache[node] = iter->second;
+    return iter->second;
+}
+
+static size_t GetTraceNameIndex(const ComputationNodeBase* node)
+{
+    auto& state = *g_nodeProfilerState;
+    auto cached = state.traceNameCache.find(node);
+    if (cached != state.traceNameCache.end() && state.traceNames[cached->second] == node->NodeName())
+        return cached->second;
+
+    state.traceNameCache[node] = state.traceNames.size();
+    state.traceNames.push_back(node->NodeName());
+    return state.traceNames.size() - 1;
+}
+
+static unsigned int GetThreadIndex()
+{
+    auto& threads = g_nodeProfilerState->threads;
+    auto iter = threads.find(this_thread::get_id());
+    if (iter == threads.end())
+        iter = threads.insert(make_pair(this_thread::get_id(), (unsigned int)threads.size())).first;
+    return iter->second;
+}
+
+void NodeProfilerScope::Begin(const ComputationNodeBase* node, bool isBackward, bool isLoopStep)
+{
+    m_node = node;
+    m_isBackward = isBackward;
+    m_isLoopStep = isLoopStep;
+    m_resultBufferBytes = ResultBufferBytes(node, isBackward);
+    m_beginClock = Clock::GetTimeStamp();
+}
+
+void NodeProfilerScope::End()
+{
+    long long endClock = Clock::GetTimeStamp();
+
+    // Measured outside of the lock; they only look at the matrices of the node and its inputs.
+    size_t resultBufferBytes = ResultBufferBytes(m_node, m_isBackward);
+    bool hasMatrices = AddNodeBytes(m_node, nullptr, nullptr);
+    size_t touchedBytes = hasMatrices ? TouchedBytes(m_node, m_isBackward) : 0;
+
+    lock_guard<mutex> lock(g_nodeProfilerMutex);
+    if (!g_nodeProfilerEnabled || g_nodeProfilerState == nullptr)
+        return;
+
+    // Flow control nodes only appear in the timeline, the nodes inside of them are in the tables.
+    if (hasMatrices)
+    {
+        auto& record = g_nodeProfilerState->records[GetRecordIndex(m_node)];
+        if (m_isBackward)
+        {
+            record.backwardCount++;
+            record.backwardTicks += endClock - m_beginClock;
+        }
+        else
+        {
+            record.forwardCount++;
+            record.forwardTicks += endClock - m_beginClock;
+        }
+        record.bytesTouched += touchedBytes;
+        if (resultBufferBytes > m_resultBufferBytes)
+            record.bytesAllocated += resultBufferBytes - m_resultBufferBytes;
+    }
+
+    if (!m_isLoopStep)
+    {
+        auto& state = *g_nodeProfilerState;
+        if (state.traceEvents.size() >= state.maxTraceEvents)
+        {
+            if (!state.traceFull)
+            {
+                fprintf(stderr, "Warning: Node Profiler: Timeline is full, no more events will be added to it.\n");
+                state.traceFull = true;
+            }
+            return;
+        }
+        state.traceEvents.push_back(NodeProfilerTraceEvent{ GetTraceNameIndex(m_node), m_beginClock, endClock, GetThreadIndex(), m_isBackward });
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reports.
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static double TicksToMilliseconds(long long ticks)
+{
+    return 1000.0 * ticks / Clock::GetTicksPerSecond();
+}
+
+static void PrintRecords(FILE* f, vector<NodeProfilerRecord> records, bool withNames)
+{
+    sort(records.begin(), records.end(), [](const NodeProfilerRecord& a, const NodeProfilerRecord& b)
+    {
+        return a.TotalTicks() > b.TotalTicks();
+    });
+
+    long long totalTicks = 0;
+    for (const auto& record : records)
+        totalTicks += record.TotalTicks();
+
+    fprintfOrDie(f, "%-40s ......Total(ms) ......%% ....Forward(ms) .....Count ...Backward(ms) .....Count ..Touched(MB) ..Allocated(MB)\n\n",
+                 withNames ? "Node (Type)" : "Type");
+    for (const auto& record : records)
+    {
+        string description = withNames ? msra::strfun::utf8(record.name) + " (" + msra::strfun::utf8(record.type) + ")" : msra::strfun::utf8(record.type);
+        fprintfOrDie(f, "%-40s %15.3f %7.2f %15.3f %10lld %15.3f %10lld %13.1f %15.1f\n",
+                     description.c_str(),
+                     TicksToMilliseconds(record.TotalTicks()),
+                     totalTicks > 0 ? 100.0 * record.TotalTicks() / totalTicks : 0.0,
+                     TicksToMilliseconds(record.forwardTicks), record.forwardCount,
+                     TicksToMilliseconds(record.backwardTicks), record.backwardCount,
+                     record.bytesTouched / 1048576.0,
+                     record.bytesAllocated / 1048576.0);
+    }
+    fprintfOrDie(f, "\n");
+}
+
+static void NodeProfilerGenerateReport(const wstring& fileName, struct tm* timeInfo)
+{
+    FILE* f = _wfopen(fileName.c_str(), L"wt");
+    if (f == NULL)
+        RuntimeError("NodeProfilerGenerateReport: Cannot create file <%ls>.", fileName.c_str());
+
+    fprintfOrDie(f, "CNTK Node Profiler Report\n\n");
+    char timeStr[32];
+    strftime(timeStr, sizeof(timeStr), "%Y/%m/%d %H:%M:%S", timeInfo);
+    fprintfOrDie(f, "Time Stamp: %s\n\n", timeStr);
+
+    // aggregate the nodes by type
+    vector<NodeProfilerRecord> types;
+    map<wstring, size_t> typeIndex;
+    for (const auto& record : g_nodeProfilerState->records)
+    {
+        auto iter = typeIndex.find(record.type);
+        if (iter == typeIndex.end())
+        {
+            typeIndex[record.type] = types.size();
+            types.push_back(record);
+            continue;
+        }
+        auto& type = types[iter->second];
+        type.forwardCount += record.forwardCount;
+        type.forwardTicks += record.forwardTicks;
+        type.backwardCount += record.backwardCount;
+        type.backwardTicks += record.backwardTicks;
+        type.bytesTouched += record.bytesTouched;
+        type.bytesAllocated += record.bytesAllocated;
+    }
+
+    PrintRecords(f, types, /*withNames=*/false);
+    PrintRecords(f, g_nodeProfilerState->records, /*withNames=*/true);
+
+    fclose(f);
+}
+
+// Escapes a string for a JSON string literal.
+static string JsonEscape(const string& str)
+{
+    string result;
+    result.reserve(str.size());
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char escaped[8];
+            sprintf(escaped, "\\u%04x", (unsigned int)c);
+            result += escaped;
+        }
+        else
+            result += c;
+    }
+    return result;
+}
+
+static void NodeProfilerGenerateTrace(const wstring& fileName)
+{
+    FILE* f = _wfopen(fileName.c_str(), L"wt");
+    if (f == NULL)
+        RuntimeError("NodeProfilerGenerateTrace: Cannot create file <%ls>.", fileName.c_str());
+
+    const auto& state = *g_nodeProfilerState;
+
+    vector<string> names;
+    for (const auto& name : state.traceNames)
+        names.push_back(JsonEscape(msra::strfun::utf8(name)));
+
+    // complete events ("ph":"X"), with time stamps and durations in microseconds
+    fprintfOrDie(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    const char* separator = "\n";
+    for (const auto& thread : state.threads)
+    {
+        fprintfOrDie(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Nodes %u\"}}", separator, thread.second, thread.second);
+        separator = ",\n";
+    }
+    for (const auto& event : state.traceEvents)
+    {
+        fprintfOrDie(f, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     separator, names[event.nameIndex].c_str(), event.isBackward ? "backward" : "forward", event.threadIndex,
+                     1000.0 * TicksToMilliseconds(event.beginClock), 1000.0 * TicksToMilliseconds(event.endClock - event.beginClock));
+        separator = ",\n";
+    }
+    fprintfOrDie(f, "\n]}\n");
+
+    fclose(f);
+}
+
+}}}
@@ -0,0 +1,101 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Per-node profiler of the forward and backward passes of a ComputationNetwork.
+//
+// The PerformanceProfiler only times the passes as a whole. This profiler breaks them down by node: for each
+// forward and backward call of a node, it records the wall time, the bytes touched (the values of the node and
+// its inputs, and in backprop also the gradients that are read or updated), and the bytes by which the buffer
+// of the result (value or gradient) grew during the call.
+//
+// Usage mirrors the PerformanceProfiler: NodeProfilerInit() and NodeProfilerClose(), or the scoped
+// NodeProfilerContext, with recording switched on and off by NodeProfilerEnable(). NodeProfilerClose() writes
+//  - <time>_nodes_<suffix>.txt: totals per node type and per node, sorted by time
+//  - <time>_nodes_<suffix>.json: the timeline in the Chrome trace event format (chrome://tracing, Perfetto)
+// The calls are recorded by the PAR and SEQ traversal of the network. Inside recurrent loops, the time steps
+// of a node are aggregated in the tables, while the timeline only shows the loop as a whole.
+//
+// Timings of GPU nodes are only meaningful if CUDA calls are synchronous (SyncGuard::EnableSync()).
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+class ComputationNodeBase;
+
+//
+// Initialize the profiler. Recording is disabled until NodeProfilerEnable(true) is called.
+// profilerDir: Directory where the reports will be saved.
+// logSuffix: Suffix string to append to the report file names.
+// maxTraceEvents: Maximum number of events kept for the timeline; the tables are not limited.
+//
+void NodeProfilerInit(const std::wstring& profilerDir, const std::wstring& logSuffix, size_t maxTraceEvents = 1000000);
+
+//
+// Enable/disable recording.
+//
+void NodeProfilerEnable(bool enable);
+
+//
+// True if the profiler is initialized and enabled.
+//
+bool NodeProfilerIsEnabled();
+
+//
+// Write the reports and release all resources.
+//
+void NodeProfilerClose();
+
+//
+// Scoped profiler instantiation.
+//
+struct NodeProfilerContext
+{
+    void Init(const std::wstring& profilerDir, const std::wstring& logSuffix, size_t maxTraceEvents = 1000000);
+    ~NodeProfilerContext();
+};
+
+//
+// Records one forward or backward call of a node, from construction to destruction.
+// Does nothing (other than checking a flag) if the profiler is not enabled.
+// isLoopStep: the call computes a single time step of a recurrent loop; it is not shown in the timeline.
+//
+class NodeProfilerScope
+{
+public:
+    NodeProfilerScope(const std::shared_ptr<ComputationNodeBase>& node, bool isBackward, bool isLoopStep = false)
+        : m_node(nullptr)
+    {
+        if (NodeProfilerIsEnabled())
+            Begin(node.get(), isBackward, isLoopStep);
+    }
+
+    ~NodeProfilerScope()
+    {
+        if (m_node)
+            End();
+    }
+
+    // Drops the call, e.g. if the work was handed over to another code path that records it by itself.
+    void Discard() { m_node = nullptr; }
+
+private:
+    void Begin(const ComputationNodeBase* node, bool isBackward, bool isLoopStep);
+    void End();
+
+    const ComputationNodeBase* m_node;
+    bool m_isBackward;
+    bool m_isLoopStep;
+    long long m_beginClock;
+    size_t m_resultBufferBytes; // size of the buffer of the result when the call started
+
+    NodeProfilerScope(const NodeProfilerScope&) = delete;
+    NodeProfilerScope& operator=(const NodeProfilerScope&) = delete;
+};
+
+}}}
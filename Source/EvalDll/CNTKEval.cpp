@@ -37,6 +37,8 @@ void CNTKEvalBase<ElemType>::Init(const std::string& config)
     CPUMatrix<ElemType>::SetNumThreads(nThreads);
 
     Globals::SetShareNodeValueMatrices(m_config(L"shareNodeValueMatrices", true));
+    Globals::SetMinibatchSizeAwareMemorySharing(m_config(L"minibatchSizeAwareMemorySharing", false));
+    Globals::SetFuseElementwiseChains(m_config(L"fuseElementwiseChains", false));
 }
 
 
@@ -55,6 +57,20 @@ void CNTKEvalBase<ElemType>::CreateNetwork(const std::string& networkDescription
     {
         LogicError("Unable to construct network from description");
     }
+
+    // optional reduced-precision storage of the weights of Times operations, either of all or of the ones named in timesWeightStorageNodes;
+    // since the network is only evaluated, the float weights are released wherever no other node reads them
+    wstring timesWeightStorage = config(L"timesWeightStorage", L"float");
+    ConfigArray timesWeightStorageNodes = config(L"timesWeightStorageNodes", ConfigArray(""));
+    vector<wstring> nodeNames;
+    for (wstring name : timesWeightStorageNodes)
+        nodeNames.push_back(name);
+    if (timesWeightStorage == L"bf16" || timesWeightStorage == L"bfloat16")
+        ComputationNetwork::SetTimesWeightStorage(this->m_net, nullptr, TimesWeightStorage::BFloat16, nodeNames, /*releaseFloatWeights=*/true);
+    else if (timesWeightStorage == L"int8")
+        ComputationNetwork::SetTimesWeightStorage(this->m_net, nullptr, TimesWeightStorage::Int8, nodeNames, /*releaseFloatWeights=*/true);
+    else if (timesWeightStorage != L"float")
+        InvalidArgument("Unknown timesWeightStorage '%ls'; valid values are 'float', 'bf16' and 'int8'.", timesWeightStorage.c_str());
 }
 
 
@@ -252,6 +268,7 @@ VariableLayout CNTKEvalExtended<ElemType>::ToVariableLayout(const ComputationNod
 template<typename ElemType>
 void CNTKEvalExtended<ElemType>::StartForwardEvaluation(const std::vector<wstring>& outputNodeNames)
 {
+    std::lock_guard<std::mutex> lock(m_evaluationMutex);
     m_scopedNetworkOperationMode = make_shared<ScopedNetworkOperationMode>(this->m_net, NetworkOperationMode::inferring);
     m_outputNodes  = this->m_net->OutputNodesByName(outputNodeNames);
     m_inputNodes = this->m_net->InputNodesForOutputs(outputNodeNames);
@@ -304,6 +321,7 @@ template<typename ElemType>
 template<template<typename> class ValueContainer>
 void CNTKEvalExtended<ElemType>::ForwardPassT(const std::vector<ValueBuffer<ElemType, ValueContainer> >& inputs, std::vector<ValueBuffer<ElemType, ValueContainer> >& outputs, bool resetRNN)
 {
+    std::lock_guard<std::mutex> lock(m_evaluationMutex);
     if (!m_started)
         RuntimeError("ForwardPass() called before StartForwardEvaluation()");
 
@@ -438,6 +456,20 @@ void CNTKEvalExtended<ElemType>::Destroy()
     delete this;
 }
 
+template <typename ElemType>
+CNTKEvalExtended<ElemType>* CNTKEvalExtended<ElemType>::CloneSharingParameters() const
+{
+    if (!this->m_net)
+        RuntimeError("CloneSharingParameters() called before CreateNetwork()");
+
+    // some nodes copy matrices of their own, so the network must not be evaluated while it is cloned
+    std::lock_guard<std::mutex> lock(m_evaluationMutex);
+    auto clone = new CNTKEvalExtended<ElemType>();
+    clone->m_config = this->m_config;
+    clone->m_net = this->m_net->CloneSharingParameters();
+    return clone;
+}
+
 template <typename ElemType>
 void EVAL_API GetEvalExtended(IEvaluateModelExtended<ElemType>** peval)
 {
@@ -453,6 +485,24 @@ extern "C" EVAL_API void GetEvalExtendedD(IEvaluateModelExtended<double>** peval
     GetEvalExtended(peval);
 }
 
+template <typename ElemType>
+void EVAL_API GetEvalExtendedSharingParameters(IEvaluateModelExtended<ElemType>* model, IEvaluateModelExtended<ElemType>** peval)
+{
+    auto source = dynamic_cast<CNTKEvalExtended<ElemType>*>(model);
+    if (!source)
+        InvalidArgument("GetEvalExtendedSharingParameters: the model was not created by GetEvalExtended().");
+    *peval = source->CloneSharingParameters();
+}
+
+extern "C" EVAL_API void GetEvalExtendedSharingParametersF(IEvaluateModelExtended<float>* model, IEvaluateModelExtended<float>** peval)
+{
+    GetEvalExtendedSharingParameters(model, peval);
+}
+extern "C" EVAL_API void GetEvalExtendedSharingParametersD(IEvaluateModelExtended<double>* model, IEvaluateModelExtended<double>** peval)
+{
+    GetEvalExtendedSharingParameters(model, peval);
+}
+
 template class CNTKEvalExtended<double>;
 template class CNTKEvalExtended<float>;
 } } }
@@ -13,6 +13,7 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <mutex>
 
 #include "Eval.h"
 #include "EvalReader.h"
@@ -119,6 +120,9 @@ public:
         CNTKEvalBase<ElemType>::Init(config);
     }
 
+    // new evaluator whose network shares the parameters of ours (see GetEvalExtendedSharingParameters())
+    CNTKEvalExtended<ElemType>* CloneSharingParameters() const;
+
 private:
     static VariableLayout ToVariableLayout(const ComputationNodeBasePtr n);
     std::vector<ComputationNodeBasePtr> m_outputNodes;
@@ -126,6 +130,8 @@ private:
     std::vector<ComputationNodeBasePtr> m_inputNodes;
     StreamMinibatchInputs m_inputMatrices;
     bool m_started;
+    // held while the network is evaluated or cloned: cloning reads node state that evaluating writes
+    mutable std::mutex m_evaluationMutex;
 
     template<template<typename> class ValueContainer> 
     void ForwardPassT(const std::vector < ValueBuffer<ElemType, ValueContainer> >& inputs,
@@ -0,0 +1,129 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// BFloat16.cpp -- conversions from and to bfloat16, and GEMM with a bfloat16 left operand
+//
+
+#include "stdafx.h"
+#include "BFloat16.h"
+#include "CPUTensorKernels.h" // for GetCPUVectorExtension()
+#include "CPUVectorKernels.h"
+#include <algorithm>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// conversions run in parallel once there are at least this many elements
+static const size_t minParallelConversionElements = 65536;
+
+// the product runs in parallel once it has at least this many multiply-adds
+static const size_t minParallelMultiplyOps = 1 << 20;
+
+// Each task computes a block of multiplyRowBlock rows and multiplyColumnBlock columns of c, in steps of multiplyDepthBlock
+// columns of a, so that the bfloat16 panel of a and the block of b that it meets stay in cache while the kernel sweeps over them.
+static const int multiplyRowBlock = 64;
+static const int multiplyColumnBlock = 64;
+static const int multiplyDepthBlock = 256;
+
+// shape of the block of c that one kernel call keeps in registers
+static const int kernelRows = (int) bfloat16KernelRows;
+static const int kernelColumns = 4;
+
+template <class ElemType>
+static void ConvertToBFloat16Impl(const ElemType* src, bfloat16* dst, size_t n)
+{
+#pragma omp parallel for if (n >= minParallelConversionElements)
+    for (long i = 0; i < (long) n; i++)
+        dst[i] = bfloat16((float) src[i]);
+}
+
+template <class ElemType>
+static void ConvertFromBFloat16Impl(const bfloat16* src, ElemType* dst, size_t n)
+{
+#pragma omp parallel for if (n >= minParallelConversionElements)
+    for (long i = 0; i < (long) n; i++)
+        dst[i] = (ElemType) (float) src[i];
+}
+
+void ConvertToBFloat16(const float* src, bfloat16* dst, size_t n)    { ConvertToBFloat16Impl(src, dst, n); }
+void ConvertToBFloat16(const double* src, bfloat16* dst, size_t n)   { ConvertToBFloat16Impl(src, dst, n); }
+void ConvertFromBFloat16(const bfloat16* src, float* dst, size_t n)  { ConvertFromBFloat16Impl(src, dst, n); }
+void ConvertFromBFloat16(const bfloat16* src, double* dst, size_t n) { ConvertFromBFloat16Impl(src, dst, n); }
+
+// generic version of the AVX2 kernel in CPUVectorKernelsAVX2.cpp, for any block of up to kernelRows x kernelColumns;
+// a is widened one element at a time, and the block of c is accumulated in ElemType
+template <class ElemType>
+static void BFloat16MultiplyBlock(int numRows, int numColumns, int k, const bfloat16* a, size_t lda, const ElemType* b, size_t ldb,
+                                  ElemType* c, size_t ldc, bool accumulate)
+{
+    ElemType acc[kernelColumns][kernelRows] = {};
+    for (int l = 0; l < k; l++)
+    {
+        const bfloat16* column = a + l * lda;
+        for (int q = 0; q < numColumns; q++)
+        {
+            const ElemType bl = b[l + q * ldb];
+            for (int i = 0; i < numRows; i++)
+                acc[q][i] += (ElemType) bfloat16::ToFloat(column[i].m_bits) * bl;
+        }
+    }
+    for (int q = 0; q < numColumns; q++)
+        for (int i = 0; i < numRows; i++)
+            c[i + q * ldc] = accumulate ? c[i + q * ldc] + acc[q][i] : acc[q][i];
+}
+
+static void MultiplyBlock(BFloat16MultiplyKernel kernel, int numRows, int numColumns, int k, const bfloat16* a, size_t lda,
+                          const float* b, size_t ldb, float* c, size_t ldc, bool accumulate)
+{
+    if (kernel && numRows == kernelRows)
+        kernel(&a->m_bits, lda, b, ldb, numColumns, k, c, ldc, accumulate);
+    else
+        BFloat16MultiplyBlock(numRows, numColumns, k, a, lda, b, ldb, c, ldc, accumulate);
+}
+
+// there is no vectorized kernel for double
+static void MultiplyBlock(BFloat16MultiplyKernel, int numRows, int numColumns, int k, const bfloat16* a, size_t lda,
+                          const double* b, size_t ldb, double* c, size_t ldc, bool accumulate)
+{
+    BFloat16MultiplyBlock(numRows, numColumns, k, a, lda, b, ldb, c, ldc, accumulate);
+}
+
+// a is never widened in memory: the kernels load it as bfloat16 and widen it in registers. The first step along the
+// depth assigns the block of c, and the later ones add onto it, so that c need not be initialized.
+template <class ElemType>
+static void BFloat16MultiplyImpl(int m, int n, int k, const bfloat16* a, const ElemType* b, ElemType* c)
+{
+    if (m <= 0 || n <= 0)
+        return;
+    if (k <= 0)
+    {
+        std::fill(c, c + (size_t) m * n, (ElemType) 0);
+        return;
+    }
+
+    BFloat16MultiplyKernel kernel = GetCPUVectorExtension() != CPUVectorExtension::None ? GetAVX2BFloat16Multiply() : nullptr;
+    long numRowBlocks = (m + multiplyRowBlock - 1) / multiplyRowBlock;
+    long numColumnBlocks = (n + multiplyColumnBlock - 1) / multiplyColumnBlock;
+    long numTasks = numRowBlocks * numColumnBlocks;
+#pragma omp parallel for if ((size_t) m * n * k >= minParallelMultiplyOps)
+    for (long task = 0; task < numTasks; task++)
+    {
+        int i0 = (int) (task % numRowBlocks) * multiplyRowBlock;
+        int i1 = std::min(m, i0 + multiplyRowBlock);
+        int j0 = (int) (task / numRowBlocks) * multiplyColumnBlock;
+        int j1 = std::min(n, j0 + multiplyColumnBlock);
+        for (int l0 = 0; l0 < k; l0 += multiplyDepthBlock)
+        {
+            int kb = std::min(multiplyDepthBlock, k - l0);
+            for (int j = j0; j < j1; j += kernelColumns)
+                for (int i = i0; i < i1; i += kernelRows)
+                    MultiplyBlock(kernel, std::min(kernelRows, i1 - i), std::min(kernelColumns, j1 - j), kb,
+                                  a + i + (size_t) l0 * m, m, b + l0 + (size_t) j * k, k, c + i + (size_t) j * m, m, l0 > 0);
+        }
+    }
+}
+
+void BFloat16Multiply(int m, int n, int k, const bfloat16* a, const float* b, float* c)    { BFloat16MultiplyImpl(m, n, k, a, b, c); }
+void BFloat16Multiply(int m, int n, int k, const bfloat16* a, const double* b, double* c) { BFloat16MultiplyImpl(m, n, k, a, b, c); }
+
+}}}
@@ -0,0 +1,61 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// BFloat16.h -- 16-bit brain floating point storage type for the CPU
+//
+// bfloat16 keeps the sign, the 8 exponent bits and the upper 7 mantissa bits of an IEEE float, so it has the
+// range of float at about 3 significant digits. It is a storage type only: values are widened to float (or double)
+// before any arithmetic, so products are accumulated at full precision.
+//
+
+#pragma once
+
+#include "CommonMatrix.h" // for MATH_API
+#include <cstdint>
+#include <cstring>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+struct bfloat16
+{
+    uint16_t m_bits;
+
+    bfloat16() : m_bits(0) { }
+    explicit bfloat16(float value) : m_bits(FromFloat(value)) { }
+    operator float() const { return ToFloat(m_bits); }
+
+    // round to nearest even; NaNs stay (quiet) NaNs instead of being rounded to infinity
+    static uint16_t FromFloat(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        if ((bits & 0x7fffffff) > 0x7f800000)
+            return (uint16_t)((bits >> 16) | 0x0040);
+        bits += 0x7fff + ((bits >> 16) & 1);
+        return (uint16_t)(bits >> 16);
+    }
+
+    static float ToFloat(uint16_t bits)
+    {
+        uint32_t wide = (uint32_t)bits << 16;
+        float value;
+        memcpy(&value, &wide, sizeof(value));
+        return value;
+    }
+};
+
+static_assert(sizeof(bfloat16) == 2, "bfloat16 must be a 16-bit type");
+
+// element-wise conversion of n values
+MATH_API void ConvertToBFloat16(const float* src, bfloat16* dst, size_t n);
+MATH_API void ConvertToBFloat16(const double* src, bfloat16* dst, size_t n);
+MATH_API void ConvertFromBFloat16(const bfloat16* src, float* dst, size_t n);
+MATH_API void ConvertFromBFloat16(const bfloat16* src, double* dst, size_t n);
+
+// c[m x n] = a[m x k] * b[k x n], column-major without transposition, where a is stored as bfloat16.
+// a is widened to float in the registers of a blocked GEMM kernel (AVX2 if available), and the products are accumulated in ElemType.
+MATH_API void BFloat16Multiply(int m, int n, int k, const bfloat16* a, const float* b, float* c);
+MATH_API void BFloat16Multiply(int m, int n, int k, const bfloat16* a, const double* b, double* c);
+
+}}}
@@ -0,0 +1,429 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUArenaAllocator.cpp -- size-class arena used for the buffers of CPU matrices
+//
+
+#include "stdafx.h"
+#include "Basics.h"
+#include "CPUArenaAllocator.h"
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+namespace
+{
+    const size_t MinClassBytes = 256;      // smallest size class (2^8)
+    const size_t MinClassLog2 = 8;
+    const size_t NumSizeClasses = 4 * 48;  // four classes per power of two, up to 2^56 bytes
+    const size_t SlabBytes = 2 * 1024 * 1024;          // one huge page
+    const size_t MaxSlabClassBytes = 64 * 1024;         // larger blocks get their own mapping
+    const size_t MaxThreadCachedClassBytes = 1024 * 1024;
+    const size_t ThreadCacheDepth = 8;                  // blocks per size class cached by each thread
+    const size_t DefaultMaxCachedBytes = (size_t)4 * 1024 * 1024 * 1024;
+    const uint64_t BlockMagic = 0xC47A4E4AB10C4ULL;
+
+    // precedes every block handed out; padded so that the user pointer stays 64-byte aligned
+    struct BlockHeader
+    {
+        uint64_t magic;
+        uint64_t sizeClass;
+        char padding[CPUArenaAllocator::Alignment - 2 * sizeof(uint64_t)];
+    };
+    static_assert(sizeof(BlockHeader) == CPUArenaAllocator::Alignment, "BlockHeader must be exactly one alignment unit");
+
+    inline BlockHeader* HeaderOf(void* p) { return reinterpret_cast<BlockHeader*>(p) - 1; }
+    inline void* PayloadOf(void* block) { return reinterpret_cast<BlockHeader*>(block) + 1; }
+
+    inline size_t RoundUp(size_t n, size_t multiple) { return (n + multiple - 1) / multiple * multiple; }
+}
+
+// per-thread cache of free blocks for the smaller size classes
+// Blocks are returned to the central free lists when the thread exits. The large classes (above MaxSlabClassBytes)
+// count toward the arena's cache budget and are guarded by m_largeLock, which only Trim() contends for.
+struct CPUArenaAllocator::ThreadCache
+{
+    static const size_t NumCachedClasses = 4 * 13; // classes up to MaxThreadCachedClassBytes
+
+    CPUArenaAllocator* m_owner;
+    void* m_blocks[NumCachedClasses][ThreadCacheDepth];
+    size_t m_count[NumCachedClasses];
+    std::atomic_flag m_largeLock;
+
+    // takes m_largeLock for the large classes only
+    class LargeClassLock
+    {
+    public:
+        LargeClassLock(ThreadCache& cache, size_t sizeClass)
+            : m_lock(SizeOfClass(sizeClass) > MaxSlabClassBytes ? &cache.m_largeLock : nullptr)
+        {
+            if (m_lock)
+                while (m_lock->test_and_set(std::memory_order_acquire))
+                    ;
+        }
+        ~LargeClassLock()
+        {
+            if (m_lock)
+                m_lock->clear(std::memory_order_release);
+        }
+
+    private:
+        std::atomic_flag* m_lock;
+    };
+
+    explicit ThreadCache(CPUArenaAllocator* owner)
+        : m_owner(owner)
+    {
+        memset(m_count, 0, sizeof(m_count));
+        m_largeLock.clear();
+
+        std::lock_guard<std::mutex> lock(m_owner->m_mutex);
+        m_owner->m_threadCaches.push_back(this);
+    }
+
+    ~ThreadCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_owner->m_mutex);
+            auto& caches = m_owner->m_threadCaches;
+            caches.erase(std::find(caches.begin(), caches.end(), this));
+        }
+
+        // no longer reachable by Trim(); ReleaseToCentral() accounts for the large blocks again
+        for (size_t c = 0; c < NumCachedClasses; c++)
+        {
+            size_t classBytes = SizeOfClass(c);
+            for (size_t i = 0; i < m_count[c]; i++)
+            {
+                if (classBytes > MaxSlabClassBytes)
+                    m_owner->m_cachedLargeBytes -= classBytes;
+                m_owner->ReleaseToCentral(m_blocks[c][i], c);
+            }
+        }
+    }
+
+    void* Pop(size_t sizeClass)
+    {
+        if (sizeClass >= NumCachedClasses)
+            return nullptr;
+
+        LargeClassLock lock(*this, sizeClass);
+        if (m_count[sizeClass] == 0)
+            return nullptr;
+
+        size_t classBytes = SizeOfClass(sizeClass);
+        if (classBytes > MaxSlabClassBytes)
+            m_owner->m_cachedLargeBytes -= classBytes;
+        return m_blocks[sizeClass][--m_count[sizeClass]];
+    }
+
+    bool Push(void* block, size_t sizeClass)
+    {
+        if (sizeClass >= NumCachedClasses)
+            return false;
+
+        LargeClassLock lock(*this, sizeClass);
+        if (m_count[sizeClass] == ThreadCacheDepth)
+            return false;
+
+        size_t classBytes = SizeOfClass(sizeClass);
+        if (classBytes > MaxSlabClassBytes && !m_owner->TryReserveCachedBytes(classBytes))
+            return false;
+        m_blocks[sizeClass][m_count[sizeClass]++] = block;
+        return true;
+    }
+
+    // moves the cached large blocks to 'blocks'; called with the arena's m_mutex held
+    void DrainLargeClasses(std::vector<std::pair<void*, size_t>>& blocks)
+    {
+        for (size_t c = 0; c < NumCachedClasses; c++)
+        {
+            size_t classBytes = SizeOfClass(c);
+            if (classBytes <= MaxSlabClassBytes)
+                continue;
+
+            LargeClassLock lock(*this, c);
+            for (size_t i = 0; i < m_count[c]; i++)
+                blocks.push_back(std::make_pair(m_blocks[c][i], classBytes));
+            m_owner->m_cachedLargeBytes -= m_count[c] * classBytes;
+            m_count[c] = 0;
+        }
+    }
+};
+
+/*static*/ CPUArenaAllocator& CPUArenaAllocator::Instance()
+{
+    // intentionally never destroyed, since thread caches and static matrices may release memory during shutdown
+    static CPUArenaAllocator* s_instance = new CPUArenaAllocator();
+    return *s_instance;
+}
+
+CPUArenaAllocator::CPUArenaAllocator()
+    : m_centralFreeLists(NumSizeClasses), m_slabCurrent(nullptr), m_slabRemaining(0), m_cachedLargeBytes(0), m_maxCachedBytes(DefaultMaxCachedBytes),
+      m_numMallocs(0), m_numFrees(0), m_numThreadCacheHits(0), m_numCentralCacheHits(0), m_numSlabs(0), m_numLargeMappings(0),
+      m_bytesReservedFromOS(0), m_bytesInUse(0), m_peakBytesInUse(0)
+{
+}
+
+// size classes: 2^k, 1.25 * 2^k, 1.5 * 2^k, 1.75 * 2^k for k >= 8
+/*static*/ size_t CPUArenaAllocator::SizeOfClass(size_t sizeClass)
+{
+    size_t k = MinClassLog2 + sizeClass / 4;
+    size_t j = sizeClass % 4;
+    return ((size_t)1 << k) + j * ((size_t)1 << (k - 2));
+}
+
+/*static*/ size_t CPUArenaAllocator::SizeClassOf(size_t bytes)
+{
+    if (bytes <= MinClassBytes)
+        return 0;
+
+    // find k with 2^k < bytes <= 2^(k+1)
+    size_t k = 0;
+    for (size_t v = bytes - 1; v > 1; v >>= 1)
+        k++;
+    size_t quarter = (size_t)1 << (k - 2);
+    size_t j = (bytes - ((size_t)1 << k) + quarter - 1) / quarter; // 1..4
+    size_t sizeClass = (j == 4) ? (k + 1 - MinClassLog2) * 4 : (k - MinClassLog2) * 4 + j;
+    if (sizeClass >= NumSizeClasses)
+        RuntimeError("CPUArenaAllocator: allocation of %llu bytes is too large.", (unsigned long long)bytes);
+    return sizeClass;
+}
+
+CPUArenaAllocator::ThreadCache& CPUArenaAllocator::GetThreadCache()
+{
+    static THREAD_LOCAL ThreadCache t_cache(&Instance());
+    return t_cache;
+}
+
+void* CPUArenaAllocator::Malloc(size_t size)
+{
+    if (size == 0)
+        return nullptr;
+
+    m_numMallocs++;
+    size_t sizeClass = SizeClassOf(size);
+    size_t classBytes = SizeOfClass(sizeClass);
+
+    bool reused = true;
+    void* block = nullptr;
+    if (classBytes <= MaxThreadCachedClassBytes)
+        block = GetThreadCache().Pop(sizeClass);
+    if (block)
+        m_numThreadCacheHits++;
+    else
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& freeList = m_centralFreeLists[sizeClass];
+            if (!freeList.empty())
+            {
+                block = freeList.back();
+                freeList.pop_back();
+                if (classBytes > MaxSlabClassBytes)
+                    m_cachedLargeBytes -= classBytes;
+            }
+        }
+        if (block)
+            m_numCentralCacheHits++;
+        else
+        {
+            block = AllocateBlock(sizeClass);
+            reused = false; // fresh pages from the OS are zero already
+        }
+    }
+
+    auto* header = reinterpret_cast<BlockHeader*>(block);
+    header->magic = BlockMagic;
+    header->sizeClass = sizeClass;
+    void* p = PayloadOf(block);
+    if (reused)
+        memset(p, 0, size);
+
+    size_t inUse = (m_bytesInUse += classBytes);
+    size_t peak = m_peakBytesInUse.load();
+    while (inUse > peak && !m_peakBytesInUse.compare_exchange_weak(peak, inUse))
+        ;
+    return p;
+}
+
+void CPUArenaAllocator::Free(void* p)
+{
+    if (p == nullptr)
+        return;
+
+    BlockHeader* header = HeaderOf(p);
+    if (header->magic != BlockMagic)
+        LogicError("CPUArenaAllocator: Free() called on a pointer that was not allocated by this allocator, or freed twice.");
+    header->magic = 0;
+
+    m_numFrees++;
+    size_t sizeClass = (size_t)header->sizeClass;
+    size_t classBytes = SizeOfClass(sizeClass);
+    m_bytesInUse -= classBytes;
+
+    if (classBytes <= MaxThreadCachedClassBytes && GetThreadCache().Push(header, sizeClass))
+        return;
+    ReleaseToCentral(header, sizeClass);
+}
+
+bool CPUArenaAllocator::TryReserveCachedBytes(size_t classBytes)
+{
+    size_t cached = m_cachedLargeBytes.load();
+    do
+    {
+        if (cached + classBytes > m_maxCachedBytes)
+            return false;
+    } while (!m_cachedLargeBytes.compare_exchange_weak(cached, cached + classBytes));
+    return true;
+}
+
+void CPUArenaAllocator::ReleaseToCentral(void* block, size_t sizeClass)
+{
+    size_t classBytes = SizeOfClass(sizeClass);
+    if (classBytes <= MaxSlabClassBytes || TryReserveCachedBytes(classBytes))
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_centralFreeLists[sizeClass].push_back(block);
+        return;
+    }
+
+    // over the cache budget: give large blocks back
+    size_t mappedBytes = RoundUp(sizeof(BlockHeader) + classBytes, 4096);
+    UnmapToOS(block, mappedBytes);
+    m_numLargeMappings--;
+    m_bytesReservedFromOS -= mappedBytes;
+}
+
+void* CPUArenaAllocator::AllocateBlock(size_t sizeClass)
+{
+    size_t classBytes = SizeOfClass(sizeClass);
+    if (classBytes <= MaxSlabClassBytes)
+        return CarveFromSlab(sizeClass);
+
+    size_t mappedBytes = RoundUp(sizeof(BlockHeader) + classBytes, 4096);
+    void* block = MapFromOS(mappedBytes);
+    m_numLargeMappings++;
+    m_bytesReservedFromOS += mappedBytes;
+    return block;
+}
+
+void* CPUArenaAllocator::CarveFromSlab(size_t sizeClass)
+{
+    size_t blockBytes = sizeof(BlockHeader) + SizeOfClass(sizeClass);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_slabRemaining < blockBytes)
+    {
+        // the tail of the previous slab is lost; with blocks of at most 64 KB this is a few percent at worst
+        m_slabCurrent = (char*)MapFromOS(SlabBytes);
+        m_slabRemaining = SlabBytes;
+        m_numSlabs++;
+        m_bytesReservedFromOS += SlabBytes;
+    }
+    void* block = m_slabCurrent;
+    m_slabCurrent += blockBytes;
+    m_slabRemaining -= blockBytes;
+    return block;
+}
+
+void CPUArenaAllocator::Trim()
+{
+    std::vector<std::pair<void*, size_t>> toRelease; // blocks with their class bytes
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t c = 0; c < NumSizeClasses; c++)
+        {
+            size_t classBytes = SizeOfClass(c);
+            if (classBytes <= MaxSlabClassBytes)
+                continue;
+            for (auto block : m_centralFreeLists[c])
+                toRelease.push_back(std::make_pair(block, classBytes));
+            m_cachedLargeBytes -= m_centralFreeLists[c].size() * classBytes;
+            m_centralFreeLists[c].clear();
+        }
+
+        for (auto cache : m_threadCaches)
+            cache->DrainLargeClasses(toRelease);
+    }
+    for (const auto& block : toRelease)
+    {
+        size_t mappedBytes = RoundUp(sizeof(BlockHeader) + block.second, 4096);
+        UnmapToOS(block.first, mappedBytes);
+        m_numLargeMappings--;
+        m_bytesReservedFromOS -= mappedBytes;
+    }
+}
+
+/*static*/ void* CPUArenaAllocator::MapFromOS(size_t bytes)
+{
+#ifdef _WIN32
+    void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (p == nullptr)
+        RuntimeError("CPUArenaAllocator: failed to allocate %llu bytes.", (unsigned long long)bytes);
+    return p;
+#else
+    // over-allocate so that the block can be aligned to a huge page boundary, then give back the unused ends
+    size_t alignment = bytes >= SlabBytes ? SlabBytes : 4096;
+    size_t mapped = bytes + alignment - 4096;
+    char* raw = (char*)mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        RuntimeError("CPUArenaAllocator: failed to map %llu bytes.", (unsigned long long)bytes);
+    char* aligned = (char*)RoundUp((size_t)raw, alignment);
+    if (aligned > raw)
+        munmap(raw, aligned - raw);
+    char* end = aligned + bytes;
+    if (raw + mapped > end)
+        munmap(end, raw + mapped - end);
+#ifdef MADV_HUGEPAGE
+    if (bytes >= SlabBytes)
+        madvise(aligned, bytes, MADV_HUGEPAGE); // a hint only; failure is harmless
+#endif
+    return aligned;
+#endif
+}
+
+/*static*/ void CPUArenaAllocator::UnmapToOS(void* p, size_t bytes)
+{
+#ifdef _WIN32
+    bytes;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, bytes);
+#endif
+}
+
+CPUArenaAllocator::Stats CPUArenaAllocator::GetStats() const
+{
+    Stats stats;
+    stats.numMallocs = m_numMallocs;
+    stats.numFrees = m_numFrees;
+    stats.numThreadCacheHits = m_numThreadCacheHits;
+    stats.numCentralCacheHits = m_numCentralCacheHits;
+    stats.numSlabs = m_numSlabs;
+    stats.numLargeMappings = m_numLargeMappings;
+    stats.bytesReservedFromOS = m_bytesReservedFromOS;
+    stats.bytesInUse = m_bytesInUse;
+    stats.peakBytesInUse = m_peakBytesInUse;
+    return stats;
+}
+
+void CPUArenaAllocator::PrintStats(FILE* f) const
+{
+    Stats stats = GetStats();
+    size_t hits = stats.numThreadCacheHits + stats.numCentralCacheHits;
+    fprintf(f, "CPU memory arena: %llu allocations (%.1f%% reused, %llu from thread caches), %llu frees; "
+               "%.1f MB in use (peak %.1f MB), %.1f MB reserved in %llu slabs and %llu large blocks.\n",
+            (unsigned long long)stats.numMallocs, stats.numMallocs ? 100.0 * hits / stats.numMallocs : 0.0, (unsigned long long)stats.numThreadCacheHits,
+            (unsigned long long)stats.numFrees,
+            stats.bytesInUse / 1048576.0, stats.peakBytesInUse / 1048576.0, stats.bytesReservedFromOS / 1048576.0,
+            (unsigned long long)stats.numSlabs, (unsigned long long)stats.numLargeMappings);
+}
+
+}}}
@@ -0,0 +1,109 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUArenaAllocator.h -- size-class arena used for the buffers of CPU matrices
+//
+
+#pragma once
+
+#include "MemAllocator.h"
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// CPUArenaAllocator -- persistent arena for CPU matrix buffers
+//
+// Every request is rounded up to a size class (four classes per power of two, starting at 256 bytes).
+// Freed blocks are not returned to the operating system but kept on a free list of their size class,
+// so that the Resize() calls of matrices whose dimensions vary from minibatch to minibatch are served
+// without going through malloc and without faulting in fresh pages.
+//  - small classes (up to 64 KB) are carved out of 2 MB slabs that are allocated huge-page aligned
+//    (and advised as huge pages on Linux); slabs are never released
+//  - larger blocks are mapped individually; freed ones are cached up to a byte budget (see SetMaxCachedBytes()),
+//    which includes the large blocks held in thread caches
+//  - each thread keeps a small cache of free blocks per class up to 1 MB, so the common alloc/free pair does not
+//    take the arena's lock; the large classes of a thread cache take a per-thread spin lock, so that Trim() can drain them
+// Each block carries a small header in front of the returned pointer, so Free() needs no size.
+// Returned memory is 64-byte aligned and zero-initialized (CPUMatrix relies on the latter).
+// -----------------------------------------------------------------------
+
+class MATH_API CPUArenaAllocator : public MemAllocator
+{
+public:
+    struct Stats
+    {
+        size_t numMallocs;           // calls to Malloc()
+        size_t numFrees;             // calls to Free()
+        size_t numThreadCacheHits;   // Malloc() served from the calling thread's cache
+        size_t numCentralCacheHits;  // Malloc() served from the shared free lists
+        size_t numSlabs;             // 2 MB slabs taken from the OS
+        size_t numLargeMappings;     // large blocks currently mapped from the OS
+        size_t bytesReservedFromOS;  // bytes currently mapped (slabs and large blocks)
+        size_t bytesInUse;           // bytes currently handed out (rounded to size classes)
+        size_t peakBytesInUse;       // high-water mark of bytesInUse
+    };
+
+    // the process-wide arena used for all CPUMatrix and CPUSparseMatrix value buffers
+    static CPUArenaAllocator& Instance();
+
+    void* Malloc(size_t size) override;
+    void Free(void* p) override;
+
+    Stats GetStats() const;
+    void PrintStats(FILE* f) const;
+
+    // Return all cached large blocks, including those in thread caches, to the OS. Slabs and blocks in use are kept.
+    void Trim();
+
+    // upper bound on the bytes of freed large blocks that are kept for reuse
+    void SetMaxCachedBytes(size_t bytes) { m_maxCachedBytes = bytes; }
+    size_t GetMaxCachedBytes() const { return m_maxCachedBytes; }
+
+    static const size_t Alignment = 64;
+
+private:
+    CPUArenaAllocator();
+    CPUArenaAllocator(const CPUArenaAllocator&) = delete;
+    CPUArenaAllocator& operator=(const CPUArenaAllocator&) = delete;
+
+    static size_t SizeClassOf(size_t bytes);
+    static size_t SizeOfClass(size_t sizeClass);
+
+    void* AllocateBlock(size_t sizeClass);
+    void* CarveFromSlab(size_t sizeClass);
+    void ReleaseToCentral(void* block, size_t sizeClass);
+
+    // accounts for a large block that is about to be cached; false if that would exceed m_maxCachedBytes
+    bool TryReserveCachedBytes(size_t classBytes);
+
+    static void* MapFromOS(size_t bytes);
+    static void UnmapToOS(void* p, size_t bytes);
+
+    struct ThreadCache;
+    ThreadCache& GetThreadCache();
+
+    std::mutex m_mutex; // guards the central free lists, the current slab and the list of thread caches
+    std::vector<std::vector<void*>> m_centralFreeLists;
+    std::vector<ThreadCache*> m_threadCaches;
+    char* m_slabCurrent;
+    size_t m_slabRemaining;
+    std::atomic<size_t> m_cachedLargeBytes; // in the central free lists and in thread caches
+    std::atomic<size_t> m_maxCachedBytes;
+
+    mutable std::atomic<size_t> m_numMallocs;
+    mutable std::atomic<size_t> m_numFrees;
+    mutable std::atomic<size_t> m_numThreadCacheHits;
+    mutable std::atomic<size_t> m_numCentralCacheHits;
+    std::atomic<size_t> m_numSlabs;
+    std::atomic<size_t> m_numLargeMappings;
+    std::atomic<size_t> m_bytesReservedFromOS;
+    std::atomic<size_t> m_bytesInUse;
+    std::atomic<size_t> m_peakBytesInUse;
+};
+
+}}}
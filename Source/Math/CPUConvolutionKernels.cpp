@@ -0,0 +1,449 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUConvolutionKernels.cpp -- 2D convolution kernels of the CPU direct convolution engine
+//
+
+#include "stdafx.h"
+#include "CPUConvolutionKernels.h"
+#include "Basics.h"
+#include <algorithm>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// the range [begin, end) of outputs o for which the input index o * stride - pad + offset lies inside [0, size)
+static void ValidOutputRange(ptrdiff_t offset, ptrdiff_t pad, size_t stride, size_t size, size_t outSize, size_t& begin, size_t& end)
+{
+    const ptrdiff_t s = (ptrdiff_t) stride;
+    const ptrdiff_t first = pad - offset;                    // smallest valid o * stride
+    const ptrdiff_t last = (ptrdiff_t) size - 1 + pad - offset; // largest valid o * stride
+    if (last < 0)
+    {
+        begin = end = 0;
+        return;
+    }
+    begin = first <= 0 ? 0 : (size_t) ((first + s - 1) / s);
+    end = std::min(outSize, (size_t) (last / s + 1));
+    begin = std::min(begin, end);
+}
+
+// -----------------------------------------------------------------------
+// Winograd transforms (Fast Algorithms for Convolutional Neural Networks; Lavin, Gray)
+// Each struct applies B^T, G and A^T of F(m, 3) to a vector with the given strides; the 2D transforms
+// B^T d B, G g G^T and A^T M A apply them to the columns and then to the rows of a tile.
+// -----------------------------------------------------------------------
+
+template <class ElemType, size_t m>
+struct Winograd;
+
+template <class ElemType>
+struct Winograd<ElemType, 2>
+{
+    static const size_t tileSize = 2;
+    static const size_t alpha = 4;
+
+    static void Input(const ElemType* d, size_t ds, ElemType* t, size_t ts)
+    {
+        const ElemType d0 = d[0], d1 = d[ds], d2 = d[2 * ds], d3 = d[3 * ds];
+        t[0]      = d0 - d2;
+        t[ts]     = d1 + d2;
+        t[2 * ts] = d2 - d1;
+        t[3 * ts] = d1 - d3;
+    }
+
+    static void Kernel(const ElemType* g, size_t gs, ElemType* u, size_t us)
+    {
+        const ElemType g0 = g[0], g1 = g[gs], g2 = g[2 * gs];
+        u[0]      = g0;
+        u[us]     = (g0 + g1 + g2) * (ElemType) 0.5;
+        u[2 * us] = (g0 - g1 + g2) * (ElemType) 0.5;
+        u[3 * us] = g2;
+    }
+
+    static void Output(const ElemType* x, size_t xs, ElemType* y, size_t ys)
+    {
+        const ElemType x1 = x[xs], x2 = x[2 * xs];
+        y[0]  = x[0] + x1 + x2;
+        y[ys] = x1 - x2 - x[3 * xs];
+    }
+};
+
+template <class ElemType>
+struct Winograd<ElemType, 4>
+{
+    static const size_t tileSize = 4;
+    static const size_t alpha = 6;
+
+    static void Input(const ElemType* d, size_t ds, ElemType* t, size_t ts)
+    {
+        const ElemType d0 = d[0], d1 = d[ds], d2 = d[2 * ds], d3 = d[3 * ds], d4 = d[4 * ds], d5 = d[5 * ds];
+        t[0]      = 4 * d0 - 5 * d2 + d4;
+        t[ts]     = -4 * (d1 + d2) + d3 + d4;
+        t[2 * ts] = 4 * (d1 - d2) - d3 + d4;
+        t[3 * ts] = 2 * (d3 - d1) - d2 + d4;
+        t[4 * ts] = 2 * (d1 - d3) - d2 + d4;
+        t[5 * ts] = 4 * d1 - 5 * d3 + d5;
+    }
+
+    static void Kernel(const ElemType* g, size_t gs, ElemType* u, size_t us)
+    {
+        const ElemType g0 = g[0], g1 = g[gs], g2 = g[2 * gs];
+        u[0]      = g0 / 4;
+        u[us]     = -(g0 + g1 + g2) / 6;
+        u[2 * us] = -(g0 - g1 + g2) / 6;
+        u[3 * us] = g0 / 24 + g1 / 12 + g2 / 6;
+        u[4 * us] = g0 / 24 - g1 / 12 + g2 / 6;
+        u[5 * us] = g2;
+    }
+
+    static void Output(const ElemType* x, size_t xs, ElemType* y, size_t ys)
+    {
+        const ElemType x1 = x[xs], x2 = x[2 * xs], x3 = x[3 * xs], x4 = x[4 * xs];
+        const ElemType s12 = x1 + x2, d12 = x1 - x2, s34 = x3 + x4, d34 = x3 - x4;
+        y[0]      = x[0] + s12 + s34;
+        y[ys]     = d12 + 2 * d34;
+        y[2 * ys] = s12 + 4 * s34;
+        y[3 * ys] = d12 + 8 * d34 + x[5 * xs];
+    }
+};
+
+template <class W, class ElemType>
+static void WinogradInputTile(const ElemType* d, ElemType* v)
+{
+    const size_t alpha = W::alpha;
+    ElemType tmp[alpha * alpha];
+    for (size_t j = 0; j < alpha; j++)
+        W::Input(d + j, alpha, tmp + j, alpha);
+    for (size_t i = 0; i < alpha; i++)
+        W::Input(tmp + i * alpha, 1, v + i * alpha, 1);
+}
+
+template <class W, class ElemType>
+static void WinogradKernelTile(const ElemType* g, ElemType* u)
+{
+    const size_t alpha = W::alpha;
+    ElemType tmp[alpha * 3];
+    for (size_t j = 0; j < 3; j++)
+        W::Kernel(g + j, 3, tmp + j, 3);
+    for (size_t i = 0; i < alpha; i++)
+        W::Kernel(tmp + i * 3, 1, u + i * alpha, 1);
+}
+
+template <class W, class ElemType>
+static void WinogradOutputTile(const ElemType* x, ElemType* y)
+{
+    const size_t alpha = W::alpha;
+    const size_t m = W::tileSize;
+    ElemType tmp[m * alpha];
+    for (size_t j = 0; j < alpha; j++)
+        W::Output(x + j, alpha, tmp + j, alpha);
+    for (size_t i = 0; i < m; i++)
+        W::Output(tmp + i * alpha, 1, y + i * m, 1);
+}
+
+template <class W, class ElemType>
+static void WinogradTransformKernelImpl(const CPUConv2DGeometry& g, const ElemType* kernel, ElemType* u)
+{
+    const size_t alpha2 = W::alpha * W::alpha;
+    const size_t K = g.outC;
+    const size_t C = g.inC;
+    const size_t matSize = K * C;
+#pragma omp parallel for
+    for (long k = 0; k < (long) K; k++)
+    {
+        ElemType ut[alpha2];
+        for (size_t c = 0; c < C; c++)
+        {
+            WinogradKernelTile<W>(kernel + (k * C + c) * 9, ut);
+            for (size_t xi = 0; xi < alpha2; xi++)
+                u[xi * matSize + k + K * c] = ut[xi];
+        }
+    }
+}
+
+template <class W, class ElemType>
+static void WinogradTransformInputImpl(const CPUConv2DGeometry& g, const ElemType* in, size_t firstTile, size_t numTiles, ElemType* v)
+{
+    const size_t m = W::tileSize;
+    const size_t alpha = W::alpha;
+    const size_t tilesW = (g.outW + m - 1) / m;
+    const size_t tilesPerSample = tilesW * ((g.outH + m - 1) / m);
+    const size_t C = g.inC;
+    const size_t matSize = C * numTiles;
+    const ptrdiff_t inW = (ptrdiff_t) g.inW;
+    const ptrdiff_t inH = (ptrdiff_t) g.inH;
+#pragma omp parallel for
+    for (long t = 0; t < (long) numTiles; t++)
+    {
+        const size_t tile = firstTile + t;
+        const size_t n = tile / tilesPerSample;
+        const size_t ty = (tile % tilesPerSample) / tilesW;
+        const size_t tx = (tile % tilesPerSample) % tilesW;
+        const ptrdiff_t x0 = (ptrdiff_t) (tx * m) - g.padW;
+        const ptrdiff_t y0 = (ptrdiff_t) (ty * m) - g.padH;
+        const bool interior = x0 >= 0 && y0 >= 0 && x0 + (ptrdiff_t) alpha <= inW && y0 + (ptrdiff_t) alpha <= inH;
+
+        ElemType d[alpha * alpha];
+        ElemType vt[alpha * alpha];
+        for (size_t c = 0; c < C; c++)
+        {
+            const ElemType* plane = in + n * g.InputSize() + c * g.inW * g.inH;
+            for (size_t i = 0; i < alpha; i++)
+            {
+                const ptrdiff_t y = y0 + (ptrdiff_t) i;
+                for (size_t j = 0; j < alpha; j++)
+                {
+                    const ptrdiff_t x = x0 + (ptrdiff_t) j;
+                    d[i * alpha + j] = (interior || (0 <= y && y < inH && 0 <= x && x < inW)) ? plane[y * inW + x] : 0;
+                }
+            }
+            WinogradInputTile<W>(d, vt);
+            for (size_t xi = 0; xi < alpha * alpha; xi++)
+                v[xi * matSize + c + C * t] = vt[xi];
+        }
+    }
+}
+
+template <class W, class ElemType>
+static void WinogradTransformOutputImpl(const CPUConv2DGeometry& g, const ElemType* mm, size_t firstTile, size_t numTiles, ElemType* out)
+{
+    const size_t m = W::tileSize;
+    const size_t alpha2 = W::alpha * W::alpha;
+    const size_t tilesW = (g.outW + m - 1) / m;
+    const size_t tilesPerSample = tilesW * ((g.outH + m - 1) / m);
+    const size_t K = g.outC;
+    const size_t matSize = K * numTiles;
+#pragma omp parallel for
+    for (long t = 0; t < (long) numTiles; t++)
+    {
+        const size_t tile = firstTile + t;
+        const size_t n = tile / tilesPerSample;
+        const size_t oy0 = (tile % tilesPerSample) / tilesW * m;
+        const size_t ox0 = (tile % tilesPerSample) % tilesW * m;
+        const size_t rows = std::min(m, g.outH - oy0);
+        const size_t cols = std::min(m, g.outW - ox0);
+
+        ElemType x[alpha2];
+        ElemType y[m * m];
+        for (size_t k = 0; k < K; k++)
+        {
+            for (size_t xi = 0; xi < alpha2; xi++)
+                x[xi] = mm[xi * matSize + k + K * t];
+            WinogradOutputTile<W>(x, y);
+            ElemType* plane = out + n * g.OutputSize() + k * g.outW * g.outH;
+            for (size_t i = 0; i < rows; i++)
+                for (size_t j = 0; j < cols; j++)
+                    plane[(oy0 + i) * g.outW + ox0 + j] = y[i * m + j];
+        }
+    }
+}
+
+template <class ElemType>
+size_t CPUConvolutionKernels<ElemType>::WinogradTilesPerSample(size_t tileSize, const CPUConv2DGeometry& g)
+{
+    return ((g.outW + tileSize - 1) / tileSize) * ((g.outH + tileSize - 1) / tileSize);
+}
+
+template <class ElemType>
+void CPUConvolutionKernels<ElemType>::WinogradTransformKernel(size_t tileSize, const CPUConv2DGeometry& g, const ElemType* kernel, ElemType* u)
+{
+    if (tileSize == 2)
+        WinogradTransformKernelImpl<Winograd<ElemType, 2>>(g, kernel, u);
+    else if (tileSize == 4)
+        WinogradTransformKernelImpl<Winograd<ElemType, 4>>(g, kernel, u);
+    else
+        LogicError("WinogradTransformKernel: Unsupported tile size %d.", (int) tileSize);
+}
+
+template <class ElemType>
+void CPUConvolutionKernels<ElemType>::WinogradTransformInput(size_t tileSize, const CPUConv2DGeometry& g, const ElemType* in, size_t firstTile, size_t numTiles, ElemType* v)
+{
+    if (tileSize == 2)
+        WinogradTransformInputImpl<Winograd<ElemType, 2>>(g, in, firstTile, numTiles, v);
+    else if (tileSize == 4)
+        WinogradTransformInputImpl<Winograd<ElemType, 4>>(g, in, firstTile, numTiles, v);
+    else
+        LogicError("WinogradTransformInput: Unsupported tile size %d.", (int) tileSize);
+}
+
+template <class ElemType>
+void CPUConvolutionKernels<ElemType>::WinogradTransformOutput(size_t tileSize, const CPUConv2DGeometry& g, const ElemType* m, size_t firstTile, size_t numTiles, ElemType* out)
+{
+    if (tileSize == 2)
+        WinogradTransformOutputImpl<Winograd<ElemType, 2>>(g, m, firstTile, numTiles, out);
+    else if (tileSize == 4)
+        WinogradTransformOutputImpl<Winograd<ElemType, 4>>(g, m, firstTile, numTiles, out);
+    else
+        LogicError("WinogradTransformOutput: Unsupported tile size %d.", (int) tileSize);
+}
+
+// -----------------------------------------------------------------------
+// direct convolutions
+// -----------------------------------------------------------------------
+
+// number of output maps computed together by PointwiseForward(); their rows stay in L1 while the input channels are swept
+static const size_t pointwiseMapBlock = 8;
+
+template <class ElemType>
+void CPUConvolutionKernels<ElemType>::PointwiseForward(const CPUConv2DGeometry& g, const ElemType* in, const ElemType* kernel, ElemType* out, size_t batchSize)
+{
+    const size_t K = g.outC;
+    const size_t C = g.inC;
+    const size_t numBlocks = (K + pointwiseMapBlock - 1) / pointwiseMapBlock;
+    size_t oxBegin, oxEnd;
+    ValidOutputRange(0, g.padW, g.strideW, g.inW, g.outW, oxBegin, oxEnd);
+
+#pragma omp parallel for
+    for (long nb = 0; nb < (long) (batchSize * numBlocks); nb++)
+    {
+        const size_t n = nb / numBlocks;
+        const size_t k0 = (nb % numBlocks) * pointwiseMapBlock;
+        const size_t k1 = std::min(K, k0 + pointwiseMapBlock);
+        const ElemType* inSample = in + n * g.InputSize();
+        ElemType* outSample = out + n * g.OutputSize();
+        for (size_t oy = 0; oy < g.outH; oy++)
+        {
+            for (size_t k = k0; k < k1; k++)
+                std::fill_n(outSample + (k * g.outH + oy) * g.outW, g.outW, (ElemType) 0);
+            const ptrdiff_t iy = (ptrdiff_t) (oy * g.strideH) - g.padH;
+            if (iy < 0 || iy >= (ptrdiff_t) g.inH)
+                continue;
+            for (size_t c = 0; c < C; c++)
+            {
+                const ElemType* inRow = inSample + (c * g.inH + iy) * g.inW;
+                for (size_t k = k0; k < k1; k++)
+                {
+                    const ElemType w = kernel[k * C + c];
+                    ElemType* outRow = outSample + (k * g.outH + oy) * g.outW;
+                    for (size_t ox = oxBegin; ox < oxEnd; ox++)
+                        outRow[ox] += w * inRow[(ptrdiff_t) (ox * g.strideW) - g.padW];
+                }
+            }
+        }
+    }
+}
+
+template <class ElemType>
+void CPUConvolutionKernels<ElemType>::DepthwiseForward(const CPUConv2DGeometry& g, const ElemType* in, const ElemType* kernel, ElemType* out, size_t batchSize)
+{
+    const size_t kernelSize = g.kernelW * g.kernelH;
+#pragma omp parallel for
+    for (long no = 0; no < (long) (batchSize * g.outC); no++)
+    {
+        const size_t n = no / g.outC;
+        const size_t o = no % g.outC;
+        const size_t c = o % g.inC;
+        const ElemType* inPlane = in + n * g.InputSize() + c * g.inW * g.inH;
+        ElemType* outPlane = out + n * g.OutputSize() + o * g.outW * g.outH;
+        const ElemType* w = kernel + o * kernelSize;
+        for (size_t oy = 0; oy < g.outH; oy++)
+        {
+            ElemType* outRow = outPlane + oy * g.outW;
+            std::fill_n(outRow, g.outW, (ElemType) 0);
+            for (size_t ky = 0; ky < g.kernelH; ky++)
+            {
+                const ptrdiff_t iy = (ptrdiff_t) (oy * g.strideH) - g.padH + (ptrdiff_t) ky;
+                if (iy < 0 || iy >= (ptrdiff_t) g.inH)
+                    continue;
+                const ElemType* inRow = inPlane + iy * g.inW;
+                for (size_t kx = 0; kx < g.kernelW; kx++)
+                {
+                    const ElemType wt = w[ky * g.kernelW + kx];
+                    const ptrdiff_t offset = (ptrdiff_t) kx - g.padW;
+                    size_t oxBegin, oxEnd;
+                    ValidOutputRange(kx, g.padW, g.strideW, g.inW, g.outW, oxBegin, oxEnd);
+                    for (size_t ox = oxBegin; ox < oxEnd; ox++)
+                        outRow[ox] += wt * inRow[(ptrdiff_t) (ox * g.strideW) + offset];
+                }
+            }
+        }
+    }
+}
+
+template <class ElemType>
+void CPUConvolutionKernels<ElemType>::DepthwiseBackwardData(const CPUConv2DGeometry& g, const ElemType* srcGrad, const ElemType* kernel, ElemType* grad, size_t batchSize)
+{
+    const size_t kernelSize = g.kernelW * g.kernelH;
+    const size_t multiplier = g.outC / g.inC;
+    // parallel over input channels, as all maps computed from a channel add to its gradient
+#pragma omp parallel for
+    for (long nc = 0; nc < (long) (batchSize * g.inC); nc++)
+    {
+        const size_t n = nc / g.inC;
+        const size_t c = nc % g.inC;
+        ElemType* gradPlane = grad + n * g.InputSize() + c * g.inW * g.inH;
+        for (size_t j = 0; j < multiplier; j++)
+        {
+            const size_t o = c + g.inC * j;
+            const ElemType* srcPlane = srcGrad + n * g.OutputSize() + o * g.outW * g.outH;
+            const ElemType* w = kernel + o * kernelSize;
+            for (size_t oy = 0; oy < g.outH; oy++)
+            {
+                const ElemType* srcRow = srcPlane + oy * g.outW;
+                for (size_t ky = 0; ky < g.kernelH; ky++)
+                {
+                    const ptrdiff_t iy = (ptrdiff_t) (oy * g.strideH) - g.padH + (ptrdiff_t) ky;
+                    if (iy < 0 || iy >= (ptrdiff_t) g.inH)
+                        continue;
+                    ElemType* gradRow = gradPlane + iy * g.inW;
+                    for (size_t kx = 0; kx < g.kernelW; kx++)
+                    {
+                        const ElemType wt = w[ky * g.kernelW + kx];
+                        const ptrdiff_t offset = (ptrdiff_t) kx - g.padW;
+                        size_t oxBegin, oxEnd;
+                        ValidOutputRange(kx, g.padW, g.strideW, g.inW, g.outW, oxBegin, oxEnd);
+                        for (size_t ox = oxBegin; ox < oxEnd; ox++)
+                            gradRow[(ptrdiff_t) (ox * g.strideW) + offset] += wt * srcRow[ox];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <class ElemType>
+void CPUConvolutionKernels<ElemType>::DepthwiseBackwardKernel(const CPUConv2DGeometry& g, const ElemType* srcGrad, const ElemType* in, ElemType* kernelGrad, size_t batchSize)
+{
+    const size_t kernelSize = g.kernelW * g.kernelH;
+    // parallel over kernels, each one is owned by a single output map
+#pragma omp parallel for
+    for (long o = 0; o < (long) g.outC; o++)
+    {
+        const size_t c = o % g.inC;
+        std::vector<ElemType> sums(kernelSize, 0);
+        for (size_t n = 0; n < batchSize; n++)
+        {
+            const ElemType* inPlane = in + n * g.InputSize() + c * g.inW * g.inH;
+            const ElemType* srcPlane = srcGrad + n * g.OutputSize() + o * g.outW * g.outH;
+            for (size_t oy = 0; oy < g.outH; oy++)
+            {
+                const ElemType* srcRow = srcPlane + oy * g.outW;
+                for (size_t ky = 0; ky < g.kernelH; ky++)
+                {
+                    const ptrdiff_t iy = (ptrdiff_t) (oy * g.strideH) - g.padH + (ptrdiff_t) ky;
+                    if (iy < 0 || iy >= (ptrdiff_t) g.inH)
+                        continue;
+                    const ElemType* inRow = inPlane + iy * g.inW;
+                    for (size_t kx = 0; kx < g.kernelW; kx++)
+                    {
+                        const ptrdiff_t offset = (ptrdiff_t) kx - g.padW;
+                        size_t oxBegin, oxEnd;
+                        ValidOutputRange(kx, g.padW, g.strideW, g.inW, g.outW, oxBegin, oxEnd);
+                        ElemType sum = 0;
+                        for (size_t ox = oxBegin; ox < oxEnd; ox++)
+                            sum += srcRow[ox] * inRow[(ptrdiff_t) (ox * g.strideW) + offset];
+                        sums[ky * g.kernelW + kx] += sum;
+                    }
+                }
+            }
+        }
+        for (size_t i = 0; i < kernelSize; i++)
+            kernelGrad[o * kernelSize + i] += sums[i];
+    }
+}
+
+template class CPUConvolutionKernels<float>;
+template class CPUConvolutionKernels<double>;
+
+}}}
@@ -0,0 +1,67 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUConvolutionKernels.h -- 2D convolution kernels of the CPU direct convolution engine
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// A 2D convolution over a minibatch of images in CHW layout (W is the innermost dimension), with
+// one image per matrix column. Output pixel (ox, oy) applies the kernel at input (ox * strideW - padW, oy * strideH - padH);
+// input pixels outside of the image are zero. Pads may be negative.
+struct CPUConv2DGeometry
+{
+    size_t inW, inH, inC;
+    size_t outW, outH, outC;
+    size_t kernelW, kernelH;
+    size_t strideW, strideH;
+    ptrdiff_t padW, padH;
+
+    size_t InputSize() const { return inW * inH * inC; }
+    size_t OutputSize() const { return outW * outH * outC; }
+};
+
+// -----------------------------------------------------------------------
+// CPUConvolutionKernels -- the loops of DirectConvolutionEngine (see ConvolutionEngine.cpp)
+//
+// Kernels are stored as in the other engines: all weights of output map k are contiguous, in [W x H x C] order.
+// Backward functions add to their result, just like the reference and GEMM engines do.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class CPUConvolutionKernels
+{
+public:
+    // Winograd minimal filtering F(m x m, 3 x 3) for 3x3 kernels with stride 1, where m (the tile size) is 2 or 4.
+    // Each m x m output tile is computed from an (m + 2) x (m + 2) input tile, which turns the convolution
+    // into (m + 2)^2 independent GEMMs [K x C] * [C x tiles] in the transformed domain.
+    // Tiles are numbered across the minibatch, sample by sample and in row-major order within a sample.
+    static size_t WinogradAlpha(size_t tileSize) { return tileSize + 2; }
+    static size_t WinogradTilesPerSample(size_t tileSize, const CPUConv2DGeometry& g);
+
+    // kernel [3 x 3 x C] x K -> u: alpha^2 matrices [K x C]
+    static void WinogradTransformKernel(size_t tileSize, const CPUConv2DGeometry& g, const ElemType* kernel, ElemType* u);
+
+    // input tiles [firstTile, firstTile + numTiles) -> v: alpha^2 matrices [C x numTiles]
+    static void WinogradTransformInput(size_t tileSize, const CPUConv2DGeometry& g, const ElemType* in, size_t firstTile, size_t numTiles, ElemType* v);
+
+    // m: alpha^2 matrices [K x numTiles] -> output tiles [firstTile, firstTile + numTiles), clipped at the image borders
+    static void WinogradTransformOutput(size_t tileSize, const CPUConv2DGeometry& g, const ElemType* m, size_t firstTile, size_t numTiles, ElemType* out);
+
+    // 1x1 convolution with arbitrary strides and pads. Output rows are computed in blocks of output maps
+    // so that each input row is loaded once per block rather than once per map.
+    static void PointwiseForward(const CPUConv2DGeometry& g, const ElemType* in, const ElemType* kernel, ElemType* out, size_t batchSize);
+
+    // Depthwise convolution: every kernel has depth 1 and its own input channel. Output map c + inC * j is
+    // the j-th map computed from input channel c, for j < outC / inC, and uses the kernel with the same index.
+    static void DepthwiseForward(const CPUConv2DGeometry& g, const ElemType* in, const ElemType* kernel, ElemType* out, size_t batchSize);
+    static void DepthwiseBackwardData(const CPUConv2DGeometry& g, const ElemType* srcGrad, const ElemType* kernel, ElemType* grad, size_t batchSize);
+    static void DepthwiseBackwardKernel(const CPUConv2DGeometry& g, const ElemType* srcGrad, const ElemType* in, ElemType* kernelGrad, size_t batchSize);
+};
+
+}}}
@@ -11,6 +11,10 @@
 #include "File.h"
 
 #include "CPUMatrix.h"
+#include "BFloat16.h"
+#include "CPUArenaAllocator.h"
+#include "CPUTensorKernels.h"
+#include "CPURNN.h"
 #include "TensorOps.h"
 #include <assert.h>
 #include <stdexcept>
@@ -126,6 +130,22 @@ static ElemType* NewArray(size_t n)
     return p;
 }
 
+// helper to allocate the value buffer owned by a matrix
+// Unlike NewArray(), which is used for arrays handed to the caller, this draws from the CPU arena, so that
+// repeated resizing does not go through the system allocator. Like NewArray(), the buffer is zero-initialized.
+// Buffers obtained here are released by DeleteStorageArray() or BaseMatrixStorage::ReleaseMemory().
+template <class ElemType>
+static ElemType* NewStorageArray(size_t n)
+{
+    return (ElemType*) CPUArenaAllocator::Instance().Malloc(AsMultipleOf(n, 2) * sizeof(ElemType));
+}
+
+template <class ElemType>
+static void DeleteStorageArray(ElemType* p)
+{
+    CPUArenaAllocator::Instance().Free(p);
+}
+
 template <class ElemType>
 CPUMatrix<ElemType>::CPUMatrix(const size_t numRows, const size_t numCols)
 {
@@ -137,7 +157,7 @@ CPUMatrix<ElemType>::CPUMatrix(const size_t numRows, const size_t numCols)
 
     if (GetNumElements() != 0)
     {
-        SetBuffer(NewArray<ElemType>(GetNumElements()), GetNumElements() * sizeof(ElemType));
+        SetBuffer(NewStorageArray<ElemType>(GetNumElements()), GetNumElements() * sizeof(ElemType));
     }
 }
 
@@ -875,7 +895,8 @@ void CPUMatrix<ElemType>::SetValue(const size_t numRows, const size_t numCols, E
     if (matrixFlags & matrixFlagDontOwnBuffer)
     {
         // free previous array allocation if any before overwriting
-        delete[] Buffer();
+        if (!HasExternalBuffer())
+            DeleteStorageArray(Buffer());
 
         m_numRows = numRows;
         m_numCols = numCols;
@@ -1526,10 +1547,10 @@ void CPUMatrix<ElemType>::Resize(const size_t numRows, const size_t numCols, boo
         ElemType* pArray = nullptr;
         if (numElements > 0)
         {
-            pArray = NewArray<ElemType>(numElements);
+            pArray = NewStorageArray<ElemType>(numElements);
         }
         // success: update the object
-        delete[] Buffer();
+        DeleteStorageArray(Buffer());
 
         SetBuffer(pArray, numElements * sizeof(ElemType));
         SetSizeAllocated(numElements);
@@ -4962,6 +4983,18 @@ void CPUMatrix<ElemType>::BatchNormalizationBackward(const CPUMatrix<ElemType>&
     RuntimeError("Batch normalization training on CPU is not yet implemented.");
 }
 
+template <class ElemType>
+void CPUMatrix<ElemType>::RNNForward(const CPUMatrix<ElemType>& inputX, const CPUMatrix<ElemType>& paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, CPUMatrix<ElemType>& workspace)
+{
+    if (inputX.GetNumRows() != xDim || GetNumRows() != yDim || GetNumCols() != inputX.GetNumCols())
+        InvalidArgument("RNNForward: The input [%lu x %lu] and output [%lu x %lu] do not match the RNN dimensions %lu and %lu.",
+                        (unsigned long) inputX.GetNumRows(), (unsigned long) inputX.GetNumCols(), (unsigned long) GetNumRows(), (unsigned long) GetNumCols(),
+                        (unsigned long) xDim, (unsigned long) yDim);
+
+    workspace.RequireSize(CPURNN<ElemType>::GetWorkspaceSize(numSequencesForFrame, rnnAttributes), 1);
+    CPURNN<ElemType>::Forward(paramW.Data(), paramW.GetNumElements(), inputX.Data(), xDim, Data(), yDim, numSequencesForFrame, rnnAttributes, workspace.Data());
+}
+
 
 #pragma region Static BLAS Functions
 
@@ -7211,6 +7244,10 @@ void CPUMatrix<ElemType>::TensorOp(ElemType beta, const CPUMatrix<ElemType>& a,
         reductionOp != ElementWiseOperator::opElementwiseProduct)
         InvalidArgument("TensorOp: Unary reduction operations other than opMax, opMin, opSum, and opLogSum are not implemented.");
 
+    // the most common cases have explicitly vectorized kernels, selected at runtime based on CPUID
+    if (CPUTensorKernels<ElemType>::TryTensorOp(beta, a.Data(), Data(), alpha, op, reductionOp, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides))
+        return;
+
 // TODO: Change the lambda to take a pointer and a number of elements, so that we can pass it 1 or 4 elements, in order for it to SSE-vectorize.
 #define CaseUnaryTensorOp(oper)                                                        \
     case ElementWiseOperator::op##oper:                                                \
@@ -7240,6 +7277,9 @@ void CPUMatrix<ElemType>::TensorOp(ElemType beta, const CPUMatrix<ElemType>& a,
     if (reductionOp != ElementWiseOperator::opSum)
         InvalidArgument("TensorOp (binary): The only permitted binary reduction operation is opSum.");
 
+    if (CPUTensorKernels<ElemType>::TryTensorOp(beta, a.Data(), b.Data(), Data(), alpha, op, reductionOp, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides))
+        return;
+
 #define CaseBinaryTensorOp(oper)                                                       \
     case ElementWiseOperator::op##oper:                                                \
         return TensorOpWithFn(beta, pointers, alpha, [](const array<ElemType*, 3>& pp) \
@@ -7285,6 +7325,115 @@ void CPUMatrix<ElemType>::TensorOp(ElemType beta, const CPUMatrix<ElemType>& a,
     }
 }
 
+// -----------------------------------------------------------------------
+// fused elementwise chains
+// -----------------------------------------------------------------------
+
+// apply a unary op to a tile of values in place
+// The op is dispatched once per tile, so that the loop itself is specialized for the op and can be vectorized.
+template <class ElemType>
+static void ApplyUnaryOpToTile(ElementWiseOperator op, ElemType* acc, size_t n)
+{
+#define CaseUnaryTileOp(oper)              \
+    case ElementWiseOperator::op##oper:    \
+        for (size_t i = 0; i < n; i++)     \
+            acc[i] = Op##oper(acc[i]);     \
+        return
+
+    switch (op)
+    {
+        ForAllUnaryOps(CaseUnaryTileOp);
+    default:
+        LogicError("FusedElementwiseOf: Unknown unary op code %d.", (int) op);
+    }
+#undef CaseUnaryTileOp
+}
+
+// apply a binary op between a tile of values and a tile of the other operand, in place
+template <class ElemType>
+static void ApplyBinaryOpToTile(ElementWiseOperator op, ElemType* acc, const ElemType* other, bool accFirst, size_t n)
+{
+#define CaseBinaryTileOp(oper)                         \
+    case ElementWiseOperator::op##oper:                \
+        if (accFirst)                                  \
+            for (size_t i = 0; i < n; i++)             \
+                acc[i] = Op##oper(acc[i], other[i]);   \
+        else                                           \
+            for (size_t i = 0; i < n; i++)             \
+                acc[i] = Op##oper(other[i], acc[i]);   \
+        return
+
+    switch (op)
+    {
+        ForAllBinaryOps(CaseBinaryTileOp);
+    default:
+        LogicError("FusedElementwiseOf: Unknown binary op code %d.", (int) op);
+    }
+#undef CaseBinaryTileOp
+}
+
+// compute a chain of elementwise ops in one pass (see Matrix::FusedElementwiseOf(); shapes have been checked there)
+// The result is computed in tiles small enough to stay in L1 cache: each tile of operand 0 is loaded once, all steps are
+// applied to it in turn, and it is then stored once. Hence memory is touched once per operand and once for the result,
+// instead of once per step and intermediate result.
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::FusedElementwiseOf(CPUMatrix<ElemType>& result, const std::vector<const CPUMatrix<ElemType>*>& operands, const std::vector<FusedElementwiseStep>& steps)
+{
+    const size_t tileSize = 512;
+
+    // Without column-vector operands, the whole matrix is processed as one long column, which gives better tiles.
+    bool hasColumnOperands = false;
+    for (auto operand : operands)
+        hasColumnOperands |= operand->GetNumElements() != 1 && operand->GetNumCols() != result.GetNumCols();
+    const size_t rows = hasColumnOperands ? result.GetNumRows() : result.GetNumElements();
+    const size_t cols = hasColumnOperands ? result.GetNumCols() : 1;
+    const size_t tilesPerCol = (rows + tileSize - 1) / tileSize;
+    const long long numTiles = (long long) (tilesPerCol * cols);
+
+    ElemType* us = result.Data();
+
+#pragma omp parallel for
+    for (long long t = 0; t < numTiles; t++)
+    {
+        ElemType acc[tileSize];
+        ElemType broadcast[tileSize];
+
+        const size_t j = (size_t) t / tilesPerCol;
+        const size_t i0 = ((size_t) t % tilesPerCol) * tileSize;
+        const size_t n = min(tileSize, rows - i0);
+
+        // get the tile of an operand; scalars are expanded into 'broadcast'
+        auto operandTile = [&](const CPUMatrix<ElemType>& operand) -> const ElemType*
+        {
+            if (operand.GetNumElements() == 1 && rows * cols != 1)
+            {
+                ElemType value = operand.Data()[0];
+                for (size_t i = 0; i < n; i++)
+                    broadcast[i] = value;
+                return broadcast;
+            }
+            size_t colOffset = operand.GetNumCols() == 1 ? 0 : j * rows; // column vectors are broadcast along the columns
+            return operand.Data() + colOffset + i0;
+        };
+
+        const ElemType* first = operandTile(*operands[0]);
+        for (size_t i = 0; i < n; i++)
+            acc[i] = first[i];
+
+        for (const auto& step : steps)
+        {
+            if (step.operand < 0)
+                ApplyUnaryOpToTile(step.op, acc, n);
+            else
+                ApplyBinaryOpToTile(step.op, acc, operandTile(*operands[step.operand]), step.runningValueFirst, n);
+        }
+
+        ElemType* out = us + j * rows + i0;
+        for (size_t i = 0; i < n; i++)
+            out[i] = acc[i];
+    }
+}
+
 template <class ElemType>
 int CPUMatrix<ElemType>::Argmin() const
 {
@@ -7500,6 +7649,25 @@ template short* CPUMatrix<short>::CopyToArray(void) const;
 template void CPUMatrix<short>::CopySection(size_t numRows, size_t numCols, short* dst, size_t colStride) const;
 template void CPUMatrix<short>::Reshape(const size_t, const size_t);
 
+// Support <bfloat16>, the 16-bit storage of NDArrayViews and of the weights of Times operations (see BFloat16.h).
+// There is no arithmetic on it; the values are widened to float or double first.
+template CPUMatrix<bfloat16>::CPUMatrix(const size_t numRows, const size_t numCols);
+template CPUMatrix<bfloat16>::CPUMatrix(const size_t numRows, const size_t numCols, bfloat16* pArray, const size_t matrixFlags);
+template CPUMatrix<bfloat16>::CPUMatrix();
+template CPUMatrix<bfloat16>::CPUMatrix(CPUMatrix<bfloat16> const&);
+template CPUMatrix<bfloat16>::CPUMatrix(CPUMatrix<bfloat16>&&);
+template size_t CPUMatrix<bfloat16>::LocateElement(size_t, size_t) const;
+template CPUMatrix<bfloat16> CPUMatrix<bfloat16>::ColumnSlice(size_t startColumn, size_t numCols) const;
+template CPUMatrix<bfloat16>& CPUMatrix<bfloat16>::operator=(CPUMatrix<bfloat16>&&);
+template void CPUMatrix<bfloat16>::SetValue(const bfloat16);
+template void CPUMatrix<bfloat16>::SetValue(const size_t numRows, const size_t numCols, bfloat16* pArray, size_t matrixFlags);
+template void CPUMatrix<bfloat16>::SetValue(CPUMatrix<bfloat16> const&);
+template void CPUMatrix<bfloat16>::RequireSize(const size_t numRows, const size_t numCols, bool growOnly);
+template void CPUMatrix<bfloat16>::Resize(const size_t numRows, const size_t numCols, bool growOnly);
+template bfloat16* CPUMatrix<bfloat16>::CopyToArray(void) const;
+template void CPUMatrix<bfloat16>::CopySection(size_t numRows, size_t numCols, bfloat16* dst, size_t colStride) const;
+template void CPUMatrix<bfloat16>::Reshape(const size_t, const size_t);
+
 template CPUMatrix<int>::CPUMatrix(const size_t, const size_t, int*, const size_t);
 
 }}}
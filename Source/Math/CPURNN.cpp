@@ -0,0 +1,231 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPURNN.cpp -- CPU forward computation of OptimizedRNNStack
+//
+
+#include "stdafx.h"
+#include "CPURNN.h"
+#include "TensorOps.h"
+#include <algorithm>
+
+#ifdef USE_MKL
+#include <mkl.h>
+#else
+#ifdef _MSC_VER
+// Visual Studio doesn't define standard complex types properly
+#define HAVE_LAPACK_CONFIG_H
+#define LAPACK_COMPLEX_STRUCTURE
+#endif
+#include <cblas.h>
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+enum class RNNCellType
+{
+    LSTM,
+    GRU,
+    Tanh,
+    ReLU
+};
+
+static RNNCellType GetCellType(const RnnAttributes& rnnAttributes)
+{
+    if (rnnAttributes.m_recurrentOp == L"lstm")
+        return RNNCellType::LSTM;
+    else if (rnnAttributes.m_recurrentOp == L"gru")
+        return RNNCellType::GRU;
+    else if (rnnAttributes.m_recurrentOp == L"rnnTanh")
+        return RNNCellType::Tanh;
+    else
+        return RNNCellType::ReLU;
+}
+
+static size_t NumGates(RNNCellType cellType)
+{
+    return cellType == RNNCellType::LSTM ? 4 : cellType == RNNCellType::GRU ? 3 : 1;
+}
+
+// the gate loop runs in parallel once a frame has at least this many hidden values
+static const size_t minParallelGateElements = 4096;
+
+// column-major c = op(a) * b + beta * c
+static void Gemm(bool transA, size_t m, size_t n, size_t k, const float* a, size_t lda, const float* b, size_t ldb, float beta, float* c, size_t ldc)
+{
+    cblas_sgemm(CblasColMajor, transA ? CblasTrans : CblasNoTrans, CblasNoTrans, (int) m, (int) n, (int) k, 1.0f, a, (int) lda, b, (int) ldb, beta, c, (int) ldc);
+}
+
+static void Gemm(bool transA, size_t m, size_t n, size_t k, const double* a, size_t lda, const double* b, size_t ldb, double beta, double* c, size_t ldc)
+{
+    cblas_dgemm(CblasColMajor, transA ? CblasTrans : CblasNoTrans, CblasNoTrans, (int) m, (int) n, (int) k, 1.0, a, (int) lda, b, (int) ldb, beta, c, (int) ldc);
+}
+
+// the layer counts below are unsigned, so an empty stack would wrap around
+static void VerifyNumLayers(const RnnAttributes& rnnAttributes)
+{
+    if (rnnAttributes.m_numLayers < 1)
+        InvalidArgument("CPURNN: The number of layers must be at least 1.");
+}
+
+template <class ElemType>
+size_t CPURNN<ElemType>::GetWorkspaceSize(const std::vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes)
+{
+    VerifyNumLayers(rnnAttributes);
+    const size_t numDirections = rnnAttributes.m_bidirectional ? 2 : 1;
+    const size_t hiddenSize = rnnAttributes.m_hiddenSize;
+    const size_t gateRows = NumGates(GetCellType(rnnAttributes)) * hiddenSize;
+    size_t numFrames = 0;
+    for (auto n : numSequencesForFrame)
+        numFrames += n;
+    const size_t maxSequences = numSequencesForFrame.empty() ? 0 : numSequencesForFrame[0];
+    const size_t numLayerBuffers = std::min<size_t>(rnnAttributes.m_numLayers - 1, 2); // the outputs of the inner layers, used alternately
+
+    return gateRows * numFrames                                // input projections plus biases of all frames
+         + numLayerBuffers * numDirections * hiddenSize * numFrames
+         + gateRows                                            // the combined bias
+         + gateRows * maxSequences;                            // LSTM cell state, GRU recurrent projection
+}
+
+template <class ElemType>
+void CPURNN<ElemType>::Forward(const ElemType* w, size_t numParameters, const ElemType* x, size_t xDim, ElemType* y, size_t yDim,
+                               const std::vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, ElemType* workspace)
+{
+    VerifyNumLayers(rnnAttributes);
+    const RNNCellType cellType = GetCellType(rnnAttributes);
+    const size_t numDirections = rnnAttributes.m_bidirectional ? 2 : 1;
+    const size_t numLayers = rnnAttributes.m_numLayers;
+    const size_t H = rnnAttributes.m_hiddenSize;
+    const size_t gateRows = NumGates(cellType) * H;
+
+    if (yDim != numDirections * H)
+        InvalidArgument("CPURNN: The output leading dimension is %lu, but must be %lu for a %s network with hidden size %lu.",
+                        (unsigned long) yDim, (unsigned long) (numDirections * H), numDirections == 2 ? "bidirectional" : "unidirectional", (unsigned long) H);
+    const size_t expectedParameters = rnnAttributes.GetNumParameters(xDim).second * H;
+    if (expectedParameters != numParameters)
+        InvalidArgument("RNN needs %ld parameters, but %ld were allocated", (long) expectedParameters, (long) numParameters);
+
+    // first column of each frame
+    const size_t numTimeSteps = numSequencesForFrame.size();
+    std::vector<size_t> frameStart(numTimeSteps + 1, 0);
+    for (size_t t = 0; t < numTimeSteps; t++)
+    {
+        if (t > 0 && numSequencesForFrame[t] > numSequencesForFrame[t - 1])
+            LogicError("CPURNN: Sequences must be sorted by decreasing length.");
+        frameStart[t + 1] = frameStart[t] + numSequencesForFrame[t];
+    }
+    const size_t numFrames = frameStart[numTimeSteps];
+    if (numFrames == 0)
+        return;
+    const size_t maxSequences = numSequencesForFrame[0];
+
+    ElemType* gates = workspace;
+    ElemType* layerBuffers[2] = { gates + gateRows * numFrames, gates + gateRows * numFrames + (numLayers > 2 ? yDim * numFrames : 0) };
+    ElemType* bias = layerBuffers[1] + (numLayers > 1 ? yDim * numFrames : 0);
+    ElemType* state = bias + gateRows;
+
+    const ElemType* weights = w;
+    const ElemType* biases = w;
+    for (size_t layer = 0, inDim = xDim; layer < numLayers; layer++, inDim = yDim)
+        biases += numDirections * (inDim + H) * gateRows;
+
+    const ElemType* in = x;
+    size_t inDim = xDim;
+    for (size_t layer = 0; layer < numLayers; layer++)
+    {
+        ElemType* out = layer + 1 == numLayers ? y : layerBuffers[layer % 2];
+        for (size_t dir = 0; dir < numDirections; dir++)
+        {
+            const ElemType* W = weights;
+            const ElemType* R = W + inDim * gateRows;
+            const ElemType* b1 = biases;
+            const ElemType* b2 = b1 + gateRows;
+            weights = R + H * gateRows;
+            biases = b2 + gateRows;
+
+            // cuDNN applies the recurrent bias of the GRU candidate gate inside the reset gate product, so it is kept separate
+            const size_t sharedBiasRows = cellType == RNNCellType::GRU ? 2 * H : gateRows;
+            for (size_t i = 0; i < gateRows; i++)
+                bias[i] = i < sharedBiasRows ? b1[i] + b2[i] : b1[i];
+            const ElemType* candidateBias = b2 + 2 * H;
+
+            // input projections of all frames at once
+            Gemm(true, gateRows, numFrames, inDim, W, inDim, in, inDim, 0, gates, gateRows);
+
+            ElemType* hiddenOut = out + dir * H; // this direction's rows of the output
+            const bool backward = dir == 1;
+            for (size_t i = 0; i < numTimeSteps; i++)
+            {
+                const size_t t = backward ? numTimeSteps - 1 - i : i;
+                const size_t n = numSequencesForFrame[t];
+                // sequences [0, nPrev) continue from the previous step, the others start from a zero state
+                const size_t nPrev = i == 0 ? 0 : backward ? numSequencesForFrame[t + 1] : n;
+                const ElemType* hPrev = i == 0 ? nullptr : hiddenOut + frameStart[backward ? t + 1 : t - 1] * yDim;
+                ElemType* g = gates + frameStart[t] * gateRows;
+                ElemType* h = hiddenOut + frameStart[t] * yDim;
+
+                if (nPrev > 0)
+                {
+                    if (cellType == RNNCellType::GRU)
+                        Gemm(true, gateRows, nPrev, H, R, H, hPrev, yDim, 0, state, gateRows);
+                    else
+                        Gemm(true, gateRows, nPrev, H, R, H, hPrev, yDim, 1, g, gateRows);
+                }
+
+#pragma omp parallel for if (n * H >= minParallelGateElements)
+                for (long s = 0; s < (long) n; s++)
+                {
+                    const bool hasPrev = (size_t) s < nPrev;
+                    ElemType* gs = g + s * gateRows;
+                    ElemType* hs = h + s * yDim;
+                    const ElemType* hPrevS = hasPrev ? hPrev + s * yDim : nullptr;
+                    switch (cellType)
+                    {
+                    case RNNCellType::LSTM:
+                    {
+                        ElemType* c = state + s * H;
+                        for (size_t k = 0; k < H; k++)
+                        {
+                            const ElemType inGate = StableSigmoid(gs[k] + bias[k]);
+                            const ElemType forgetGate = StableSigmoid(gs[H + k] + bias[H + k]);
+                            const ElemType candidate = tanh_(gs[2 * H + k] + bias[2 * H + k]);
+                            const ElemType outGate = StableSigmoid(gs[3 * H + k] + bias[3 * H + k]);
+                            c[k] = (hasPrev ? forgetGate * c[k] : 0) + inGate * candidate;
+                            hs[k] = outGate * tanh_(c[k]);
+                        }
+                        break;
+                    }
+                    case RNNCellType::GRU:
+                    {
+                        const ElemType* rs = state + s * gateRows;
+                        for (size_t k = 0; k < H; k++)
+                        {
+                            const ElemType resetGate = StableSigmoid(gs[k] + bias[k] + (hasPrev ? rs[k] : 0));
+                            const ElemType updateGate = StableSigmoid(gs[H + k] + bias[H + k] + (hasPrev ? rs[H + k] : 0));
+                            const ElemType candidate = tanh_(gs[2 * H + k] + bias[2 * H + k] + resetGate * ((hasPrev ? rs[2 * H + k] : 0) + candidateBias[k]));
+                            hs[k] = (1 - updateGate) * candidate + (hasPrev ? updateGate * hPrevS[k] : 0);
+                        }
+                        break;
+                    }
+                    case RNNCellType::Tanh:
+                        for (size_t k = 0; k < H; k++)
+                            hs[k] = tanh_(gs[k] + bias[k]);
+                        break;
+                    case RNNCellType::ReLU:
+                        for (size_t k = 0; k < H; k++)
+                            hs[k] = std::max<ElemType>(gs[k] + bias[k], 0);
+                        break;
+                    }
+                }
+            }
+        }
+        in = out;
+        inDim = yDim;
+    }
+}
+
+template class CPURNN<float>;
+template class CPURNN<double>;
+
+}}}
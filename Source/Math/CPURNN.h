@@ -0,0 +1,43 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPURNN.h -- CPU forward computation of OptimizedRNNStack
+//
+
+#pragma once
+
+#include "RNNCommon.h"
+#include <vector>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// CPURNN -- computes the same function as the cuDNN RNN executor (CuDnnRNN.cpp), for inference on the CPU
+//
+// The data is in the dense packing that OptimizedRNNStackNode passes to cuDNN: frame by frame, with the
+// sequences sorted by decreasing length, so that the sequences active at frame t are the first
+// numSequencesForFrame[t] columns of that frame. Weights are the flat cuDNN parameter vector:
+//  - for each layer, for each direction: W [inputDim x gates * hidden], then R [hidden x gates * hidden]
+//  - for each layer, for each direction: the bias vectors b1 and b2 [gates * hidden]
+// Gates are ordered i, f, c, o for LSTM and r, z, n for GRU. Bidirectional layers output the forward
+// hidden state stacked on top of the backward one, which is the input of the next layer.
+//
+// For each layer and direction, the input projections of all frames are computed by a single GEMM. Each
+// frame then only adds the recurrent projection of the previous hidden state, followed by one loop that
+// applies all gate nonlinearities and the cell update.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class CPURNN
+{
+public:
+    // number of elements of the workspace that Forward() needs
+    static size_t GetWorkspaceSize(const std::vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes);
+
+    // x: [xDim x totalFrames], y: [yDim x totalFrames], where yDim is hidden size times the number of directions
+    static void Forward(const ElemType* w, size_t numParameters, const ElemType* x, size_t xDim, ElemType* y, size_t yDim,
+                        const std::vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, ElemType* workspace);
+};
+
+}}}
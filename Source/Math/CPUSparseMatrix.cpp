@@ -289,8 +289,9 @@ void CPUSparseMatrix<ElemType>::SetValue(const size_t row, const size_t col, con
         SetColIdx((int) c);
     }
     // Note we don't have m_nz anymore. In order for the change from m_nz to
-    // NzCount to make sense, we need to propogate nz+1 to all col slices.
-    for (size_t max = c + 1; max < m_numCols + 1; max++)
+    // NzCount to make sense, we need to propogate nz+1 to all col slices (row slices for CSR).
+    size_t numSlices = (GetFormat() == matrixFormatSparseCSC) ? m_numCols : m_numRows;
+    for (size_t max = c + 1; max < numSlices + 1; max++)
     {
         SecondaryIndexLocation()[max] = CPUSPARSE_INDEX_TYPE(nz + 1);
     }
@@ -703,6 +704,37 @@ void CPUSparseMatrix<ElemType>::SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYP
     memcpy(NzValues(), h_Val, sizeof(ElemType)*nz);
 }
 
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::SetMatrixFromExternalCSCFormat(CPUSPARSE_INDEX_TYPE* h_CSCCol, CPUSPARSE_INDEX_TYPE* h_Row, ElemType* h_Val,
+                                                               const size_t nz, const size_t numRows, const size_t numCols)
+{
+    if (!OwnBuffer())
+        LogicError("Cannot modify since the buffer is managed externally.");
+    VerifyResizable(__func__);
+
+    if (h_CSCCol[0] != 0 || (size_t) h_CSCCol[numCols] != nz)
+        InvalidArgument("SetMatrixFromExternalCSCFormat: The column starts must begin at 0 and end at the number (%d) of non-zero values.", (int) nz);
+
+    ReleaseStorageMemory();
+
+    m_sliceViewOffset = 0;
+    m_numRows = numRows;
+    m_numCols = numCols;
+    SetNumStorageRows(numRows);
+    SetNumStorageCols(numCols);
+    SetFormat(matrixFormatSparseCSC);
+
+    // the storage object frees none of these, since the buffer is marked external
+    SetBuffer(h_Val, nz, /*external=*/true);
+    SetUnCompIndex(h_Row);
+    SetCompIndex(h_CSCCol);
+    SetCompIndexSize(numCols + 1);
+    SetSizeAllocated(nz);
+    SetColIdx(-1);
+    SetBlockSize(0);
+    SetBlockIdShift(0);
+}
+
 template <class ElemType>
 void CPUSparseMatrix<ElemType>::SetMatrixFromSBCFormat(const size_t* blockIds, const ElemType* val, const size_t numBlocks, const size_t numRows, const size_t numCols)
 {
@@ -747,8 +779,8 @@ void CPUSparseMatrix<ElemType>::Allocate(const size_t numRows, const size_t numC
     {
         if (GetFormat() == MatrixFormat::matrixFormatSparseCSC || GetFormat() == MatrixFormat::matrixFormatSparseCSR)
         {
-            // The initialization of the following buffer is done by new []().
-            auto* pArray      = new ElemType[numNZElemToReserve]();
+            // The initialization of the following buffers is done by new []() and the arena, respectively.
+            auto* pArray      = (ElemType*) CPUArenaAllocator::Instance().Malloc(numNZElemToReserve * sizeof(ElemType));
             auto* unCompIndex = new CPUSPARSE_INDEX_TYPE[numNZElemToReserve]();
             auto* compIndex   = new CPUSPARSE_INDEX_TYPE[newCompIndexSize]();
 
@@ -764,7 +796,7 @@ void CPUSparseMatrix<ElemType>::Allocate(const size_t numRows, const size_t numC
             }
 
             // TODO: This is super ugly. The internals of the storage object should be a shared_ptr.
-            delete[] Buffer();
+            CPUArenaAllocator::Instance().Free(Buffer());
             delete[] GetUnCompIndex();
             delete[] GetCompIndex();
 
@@ -774,7 +806,7 @@ void CPUSparseMatrix<ElemType>::Allocate(const size_t numRows, const size_t numC
         }
         else if (GetFormat() == MatrixFormat::matrixFormatSparseBlockCol || GetFormat() == MatrixFormat::matrixFormatSparseBlockRow)
         {
-            ElemType* blockVal = new ElemType[numNZElemToReserve];
+            ElemType* blockVal = (ElemType*) CPUArenaAllocator::Instance().Malloc(numNZElemToReserve * sizeof(ElemType));
             size_t* blockIds = new size_t[newCompIndexSize];
 
             if (keepExistingValues && (NzCount() > numNZElemToReserve || GetCompIndexSize() > newCompIndexSize))
@@ -787,7 +819,7 @@ void CPUSparseMatrix<ElemType>::Allocate(const size_t numRows, const size_t numC
                 memcpy(blockIds, GetBlockIds(), sizeof(size_t) * GetCompIndexSize());
             }
 
-            delete[] Buffer();
+            CPUArenaAllocator::Instance().Free(Buffer());
             delete[] GetBlockIds();
 
             SetBuffer(blockVal, numNZElemToReserve, false);
@@ -870,8 +902,18 @@ void CPUSparseMatrix<ElemType>::Reset()
     SetBlockIdShift(0);
 }
 
+// The products of a sparse and a dense matrix run in parallel once they have at least this many multiply-adds.
+static const size_t minParallelSparseMultiplyOps = 65536;
+
+// Number of rows of the dense result that one task updates, so that the parts of its columns that it touches stay in cache.
+static const size_t sparseMultiplyRowBlock = 256;
+
+// Number of columns of the dense result that are updated together, so that the elements of the dense factor they need are loaded once.
+static const size_t sparseMultiplyColumnGroup = 4;
+
 // Implements product of one sparse and one dense matrix updating a third dense matrix. Input matrices are optionally transposed.
 // NOTE: The only for using a class template instead of a function template was that I couldn't make the function template compile.
+// A CSR matrix is the CSC representation of its transpose, so the callers flip the transpose flag of a CSR matrix, and the kernels below only deal with CSC.
 template <class ElemType, bool denseTimesSparse /* false means SparseTimesDense */, bool transposeA, bool transposeB>
 class MultiplyDenseAndSparse{
 public:
@@ -879,25 +921,34 @@ public:
     // by the value of the boolean template parameter 'denseTimesSparse'.
     static void MultiplyAndWeightedAdd(ElemType alpha, const CPUSparseMatrix<ElemType>& sparse, const CPUMatrix<ElemType>& dense, ElemType beta, CPUMatrix<ElemType>& c)
     {
-        const BaseMatrix<ElemType>* lhs = denseTimesSparse ? (const BaseMatrix<ElemType>*) &dense  : (const BaseMatrix<ElemType>*) &sparse;
-        const BaseMatrix<ElemType>* rhs = denseTimesSparse ? (const BaseMatrix<ElemType>*) &sparse : (const BaseMatrix<ElemType>*) &dense;
+        if (sparse.GetFormat() != matrixFormatSparseCSC && sparse.GetFormat() != matrixFormatSparseCSR)
+            NOT_IMPLEMENTED;
+
+        // The dimensions of the sparse matrix as a CSC matrix.
+        bool isCSR = sparse.GetFormat() == matrixFormatSparseCSR;
+        size_t sparseRows = isCSR ? sparse.GetNumCols() : sparse.GetNumRows();
+        size_t sparseCols = isCSR ? sparse.GetNumRows() : sparse.GetNumCols();
 
         // C(m:n) is the product of matrices X * Y where we have the shapes X(m:k) and Y(l:n)
-        size_t m = transposeA ? lhs->GetNumCols() : lhs->GetNumRows();
-        size_t k = transposeA ? lhs->GetNumRows() : lhs->GetNumCols();
-        size_t l = transposeB ? rhs->GetNumCols() : rhs->GetNumRows();
-        size_t n = transposeB ? rhs->GetNumRows() : rhs->GetNumCols();
+        size_t m, k, l, n;
+        if (denseTimesSparse)
+        {
+            m = transposeA ? dense.GetNumCols() : dense.GetNumRows();
+            k = transposeA ? dense.GetNumRows() : dense.GetNumCols();
+            l = transposeB ? sparseCols : sparseRows;
+            n = transposeB ? sparseRows : sparseCols;
+        }
+        else
+        {
+            m = transposeA ? sparseCols : sparseRows;
+            k = transposeA ? sparseRows : sparseCols;
+            l = transposeB ? dense.GetNumCols() : dense.GetNumRows();
+            n = transposeB ? dense.GetNumRows() : dense.GetNumCols();
+        }
 
         if (k != l)
             InvalidArgument("CPUSparseMatrix::MultiplyAndWeightedAdd: The inner dimensions of a (= %lu) and b (= %lu) don't match.", k, l);
 
-        // Determine the dimension of the outer index of the dense matrix.
-        size_t outerDimensionDense;
-        if      ( denseTimesSparse && !transposeA) outerDimensionDense = dense.GetNumRows();
-        else if ( denseTimesSparse &&  transposeA) outerDimensionDense = dense.GetNumCols();
-        else if (!denseTimesSparse && !transposeB) outerDimensionDense = dense.GetNumCols();
-        else if (!denseTimesSparse &&  transposeB) outerDimensionDense = dense.GetNumRows();
-
         if (beta == 0)
             c.RequireSize(m, n);
         else
@@ -920,60 +971,183 @@ public:
         if (sparse.IsEmpty() || dense.IsEmpty())
             return;
 
-        // TODO: Implement CSR as a transposition of b, like we do for GPU.
-        if (sparse.GetFormat() != matrixFormatSparseCSC)
-            NOT_IMPLEMENTED;
-
         // Up to here we have:
         // * checked that the matrices are compatible in size
         // * Initialized the output matrix c
 
-        // Now do the actual multiplication.
-        ElemType* valueBuffer = sparse.Buffer() + *sparse.SecondaryIndexLocation(); // Points to the value buffer of the current view (i.e. buffer containing values of non-zero elements).
-        int* rowIndexBuffer = sparse.MajorIndexLocation();                          // Points to the index buffer of the current view (i.e. buffer containing indices of non-zero elements).
-        size_t iNonzero = 0;                                                           // Number of nonzero elements handled so far for current slice view.
-        int numPreviosNonzero = sparse.SecondaryIndexLocation()[0];                 // Total number of nonzero values handled in previous slices.
+        // Now do the actual multiplication. The column starts are offsets into the index and value buffers of the
+        // whole matrix, so for a slice view the start of its first column needs to be subtracted.
+        CSCView s = { sparse.SecondaryIndexLocation(), sparse.MajorIndexLocation(), sparse.Data() };
+        const ElemType* d = dense.Data();
+        size_t ld = dense.GetNumRows();
+
+        // Below if-statements are evaluated at compile time.
+        if      ( denseTimesSparse && !transposeB) DenseTimesSparse(alpha, d, ld, s, m, n, c.Data());
+        else if ( denseTimesSparse &&  transposeB) DenseTimesSparseTransposed(alpha, d, ld, s, m, k, c.Data());
+        else if (!denseTimesSparse && !transposeA) SparseTimesDense(alpha, s, d, ld, m, k, n, c.Data());
+        else if (!denseTimesSparse &&  transposeA) SparseTransposedTimesDense(alpha, s, d, ld, m, n, c.Data());
+    }
+
+private:
+    static const bool transposeDense = denseTimesSparse ? transposeA : transposeB;
+
+    struct CSCView
+    {
+        const CPUSPARSE_INDEX_TYPE* colStarts;
+        const CPUSPARSE_INDEX_TYPE* rowIndices;
+        const ElemType* values;
+
+        size_t Begin(size_t col) const { return colStarts[col] - colStarts[0]; }
+        size_t End(size_t col) const { return colStarts[col + 1] - colStarts[0]; }
+    };
+
+    // element (i, j) of the dense factor after the optional transposition
+    static ElemType DenseElement(const ElemType* d, size_t ld, size_t i, size_t j)
+    {
+        return transposeDense ? d[j + i * ld] : d[i + j * ld];
+    }
+
+    // c(:, j) += alpha * s(l, j) * op(d)(:, l) for the nonzeros s(l, j). Each task updates one block of rows of one column of c.
+    static void DenseTimesSparse(ElemType alpha, const ElemType* d, size_t ld, const CSCView& s, size_t m, size_t n, ElemType* c)
+    {
+        long numRowBlocks = (long) ((m + sparseMultiplyRowBlock - 1) / sparseMultiplyRowBlock);
+        long numTasks = numRowBlocks * (long) n;
+#pragma omp parallel for if (s.End(n - 1) * m >= minParallelSparseMultiplyOps)
+        for (long task = 0; task < numTasks; task++)
+        {
+            size_t j = task / numRowBlocks;
+            size_t i0 = (task % numRowBlocks) * sparseMultiplyRowBlock;
+            size_t i1 = std::min(m, i0 + sparseMultiplyRowBlock);
+            ElemType* cj = c + j * m;
+            if (!transposeDense) // the columns of d are contiguous
+            {
+                for (size_t p = s.Begin(j); p < s.End(j); p++)
+                {
+                    ElemType val = alpha * s.values[p];
+                    const ElemType* dl = d + s.rowIndices[p] * ld;
+                    for (size_t i = i0; i < i1; i++)
+                        cj[i] += val * dl[i];
+                }
+            }
+            else // the rows of op(d) are the contiguous columns of d, so compute dot products instead
+            {
+                for (size_t i = i0; i < i1; i++)
+                {
+                    const ElemType* di = d + i * ld;
+                    ElemType sum = 0;
+                    for (size_t p = s.Begin(j); p < s.End(j); p++)
+                        sum += s.values[p] * di[s.rowIndices[p]];
+                    cj[i] += alpha * sum;
+                }
+            }
+        }
+    }
 
-        // Loop over columns of the sparse matrix
-        for (size_t colSparse = 0; colSparse < sparse.GetNumCols(); colSparse++)
+    // c(:, j) += alpha * s(j, l) * op(d)(:, l) for the nonzeros s(j, l). The nonzeros of one column of s update different
+    // columns of c, so each task updates one block of rows of all of c.
+    static void DenseTimesSparseTransposed(ElemType alpha, const ElemType* d, size_t ld, const CSCView& s, size_t m, size_t k, ElemType* c)
+    {
+        long numRowBlocks = (long) ((m + sparseMultiplyRowBlock - 1) / sparseMultiplyRowBlock);
+#pragma omp parallel for if (s.End(k - 1) * m >= minParallelSparseMultiplyOps)
+        for (long rowBlock = 0; rowBlock < numRowBlocks; rowBlock++)
         {
-            size_t numNonzeroInSparseCol = sparse.SecondaryIndexLocation()[colSparse + 1] - numPreviosNonzero;
-            // Loop over the nonzero rows of the current column of the sparse matrix
-            for (; iNonzero < numNonzeroInSparseCol; iNonzero++)
+            size_t i0 = rowBlock * sparseMultiplyRowBlock;
+            size_t i1 = std::min(m, i0 + sparseMultiplyRowBlock);
+            for (size_t l = 0; l < k; l++)
             {
-                size_t rowSparse = rowIndexBuffer[iNonzero]; // RowLocation
-                ElemType sparseVal = valueBuffer[iNonzero];
-
-                // Determine the index of the 'outer' dimension of the sparse matrix and the common inner index.
-                size_t outerIndexSparse;
-                size_t innerIndex;
-                // Below if-statements are evaluated at compile time.
-                if      ( denseTimesSparse && !transposeB) { outerIndexSparse = colSparse; innerIndex = rowSparse; }
-                else if ( denseTimesSparse &&  transposeB) { outerIndexSparse = rowSparse; innerIndex = colSparse; }
-                else if (!denseTimesSparse && !transposeA) { outerIndexSparse = rowSparse; innerIndex = colSparse; }
-                else if (!denseTimesSparse &&  transposeA) { outerIndexSparse = colSparse; innerIndex = rowSparse; }
-
-                // Loop over the outer index of the dense matrix
-                for (size_t outerIndexDense = 0; outerIndexDense < outerDimensionDense; outerIndexDense++)
+                for (size_t p = s.Begin(l); p < s.End(l); p++)
                 {
-                    // Determine the row index of the dense input matrix.
-                    // Below if-statements are evaluated at compile time.
-                    ElemType denseVal;
-                    if      ( denseTimesSparse && !transposeA) denseVal = dense(outerIndexDense,      innerIndex);
-                    else if ( denseTimesSparse &&  transposeA) denseVal = dense(     innerIndex, outerIndexDense);
-                    else if (!denseTimesSparse && !transposeB) denseVal = dense(     innerIndex, outerIndexDense);
-                    else if (!denseTimesSparse &&  transposeB) denseVal = dense(outerIndexDense,      innerIndex);
-                    
-
-                    // Update matrix c.
-                    if (denseTimesSparse)
-                        c(outerIndexDense, outerIndexSparse) += alpha * denseVal * sparseVal;
-                    else /*Sparse times dense */
-                        c(outerIndexSparse, outerIndexDense) += alpha * denseVal * sparseVal;
+                    ElemType val = alpha * s.values[p];
+                    ElemType* cj = c + s.rowIndices[p] * m;
+                    if (!transposeDense)
+                    {
+                        const ElemType* dl = d + l * ld;
+                        for (size_t i = i0; i < i1; i++)
+                            cj[i] += val * dl[i];
+                    }
+                    else
+                    {
+                        for (size_t i = i0; i < i1; i++)
+                            cj[i] += val * d[l + i * ld];
+                    }
                 }
             }
         }
     }
+
+    // c(i, :) += alpha * s(i, l) * op(d)(l, :) for the nonzeros s(i, l). Each task updates a group of columns of c, for which
+    // the elements of op(d)(l, :) are kept in registers while the nonzeros of column l of s are processed.
+    static void SparseTimesDense(ElemType alpha, const CSCView& s, const ElemType* d, size_t ld, size_t m, size_t k, size_t n, ElemType* c)
+    {
+        long numColumnGroups = (long) ((n + sparseMultiplyColumnGroup - 1) / sparseMultiplyColumnGroup);
+#pragma omp parallel for if (s.End(k - 1) * n >= minParallelSparseMultiplyOps)
+        for (long group = 0; group < numColumnGroups; group++)
+        {
+            size_t j0 = group * sparseMultiplyColumnGroup;
+            size_t numColumns = std::min(sparseMultiplyColumnGroup, n - j0);
+            ElemType* cj = c + j0 * m;
+            for (size_t l = 0; l < k; l++)
+            {
+                if (s.Begin(l) == s.End(l))
+                    continue;
+
+                ElemType dl[sparseMultiplyColumnGroup];
+                for (size_t q = 0; q < numColumns; q++)
+                    dl[q] = alpha * DenseElement(d, ld, l, j0 + q);
+
+                if (numColumns == sparseMultiplyColumnGroup)
+                {
+                    for (size_t p = s.Begin(l); p < s.End(l); p++)
+                    {
+                        size_t i = s.rowIndices[p];
+                        ElemType val = s.values[p];
+                        for (size_t q = 0; q < sparseMultiplyColumnGroup; q++)
+                            cj[i + q * m] += val * dl[q];
+                    }
+                }
+                else
+                {
+                    for (size_t p = s.Begin(l); p < s.End(l); p++)
+                    {
+                        size_t i = s.rowIndices[p];
+                        ElemType val = s.values[p];
+                        for (size_t q = 0; q < numColumns; q++)
+                            cj[i + q * m] += val * dl[q];
+                    }
+                }
+            }
+        }
+    }
+
+    // c(i, j) += alpha * sum of s(l, i) * op(d)(l, j) over the nonzeros s(l, i). Each task computes the dot products of a
+    // block of columns of s with a group of columns of op(d), accumulating them in registers.
+    static void SparseTransposedTimesDense(ElemType alpha, const CSCView& s, const ElemType* d, size_t ld, size_t m, size_t n, ElemType* c)
+    {
+        long numRowBlocks = (long) ((m + sparseMultiplyRowBlock - 1) / sparseMultiplyRowBlock);
+        long numColumnGroups = (long) ((n + sparseMultiplyColumnGroup - 1) / sparseMultiplyColumnGroup);
+        long numTasks = numRowBlocks * numColumnGroups;
+#pragma omp parallel for if (s.End(m - 1) * n >= minParallelSparseMultiplyOps)
+        for (long task = 0; task < numTasks; task++)
+        {
+            size_t j0 = (task / numRowBlocks) * sparseMultiplyColumnGroup;
+            size_t numColumns = std::min(sparseMultiplyColumnGroup, n - j0);
+            size_t i0 = (task % numRowBlocks) * sparseMultiplyRowBlock;
+            size_t i1 = std::min(m, i0 + sparseMultiplyRowBlock);
+            for (size_t i = i0; i < i1; i++)
+            {
+                ElemType sums[sparseMultiplyColumnGroup] = {};
+                for (size_t p = s.Begin(i); p < s.End(i); p++)
+                {
+                    size_t l = s.rowIndices[p];
+                    ElemType val = s.values[p];
+                    for (size_t q = 0; q < numColumns; q++)
+                        sums[q] += val * DenseElement(d, ld, l, j0 + q);
+                }
+                for (size_t q = 0; q < numColumns; q++)
+                    c[i + (j0 + q) * m] += alpha * sums[q];
+            }
+        }
+    }
 };
 
 // c = alpha * lhs * rhs + beta * c
@@ -982,14 +1156,17 @@ template <class ElemType>
 void CPUSparseMatrix<ElemType>::MultiplyAndWeightedAdd(ElemType alpha, const CPUMatrix<ElemType>& a, const bool transposeA,
                                                        const CPUSparseMatrix<ElemType>& b, const bool transposeB, ElemType beta, CPUMatrix<ElemType>& c)
 {
+    // A CSR matrix is multiplied as the CSC representation of its transpose.
+    bool transposeSparse = (b.GetFormat() == matrixFormatSparseCSR) ? !transposeB : transposeB;
+
     // Mapping variables to compile time template parameters for efficiency
-    if      ( transposeA &&  transposeB)
+    if      ( transposeA &&  transposeSparse)
         MultiplyDenseAndSparse<ElemType, true /* dense times sparse */,  true /* transposeA */,  true  /*transposeB*/>::MultiplyAndWeightedAdd(alpha, b /*sparse*/, a /* dense */, beta, c /* matrix beeing updated */);
-    else if ( transposeA && !transposeB)
+    else if ( transposeA && !transposeSparse)
         MultiplyDenseAndSparse<ElemType, true /* dense times sparse */,  true /* transposeA */, false  /*transposeB*/>::MultiplyAndWeightedAdd(alpha, b /*sparse*/, a /* dense */, beta, c /* matrix beeing updated */);
-    else if (!transposeA &&  transposeB)
+    else if (!transposeA &&  transposeSparse)
         MultiplyDenseAndSparse<ElemType, true /* dense times sparse */, false /* transposeA */,  true  /*transposeB*/>::MultiplyAndWeightedAdd(alpha, b /*sparse*/, a /* dense */, beta, c /* matrix beeing updated */);
-    else if (!transposeA && !transposeB)
+    else if (!transposeA && !transposeSparse)
         MultiplyDenseAndSparse<ElemType, true /* dense times sparse */, false /* transposeA */, false  /*transposeB*/>::MultiplyAndWeightedAdd(alpha, b /*sparse*/, a /* dense */, beta, c /* matrix beeing updated */);
 }
 
@@ -999,14 +1176,17 @@ template <class ElemType>
 void CPUSparseMatrix<ElemType>::MultiplyAndWeightedAdd(ElemType alpha, const CPUSparseMatrix<ElemType>& a, const bool transposeA,
     const CPUMatrix<ElemType>& b, const bool transposeB, ElemType beta, CPUMatrix<ElemType>& c)
 {
+    // A CSR matrix is multiplied as the CSC representation of its transpose.
+    bool transposeSparse = (a.GetFormat() == matrixFormatSparseCSR) ? !transposeA : transposeA;
+
     // Mapping variables to compile time template parameters for efficiency
-    if (transposeA &&  transposeB)
+    if (transposeSparse &&  transposeB)
         MultiplyDenseAndSparse<ElemType, false /* dense times sparse */,  true /* transposeA */,  true /*transposeB*/>::MultiplyAndWeightedAdd(alpha, a /*sparse*/, b /* dense */, beta, c /* matrix beeing updated */);
-    else if (transposeA && !transposeB)
+    else if (transposeSparse && !transposeB)
         MultiplyDenseAndSparse<ElemType, false /* dense times sparse */,  true /* transposeA */, false /*transposeB*/>::MultiplyAndWeightedAdd(alpha, a /*sparse*/, b /* dense */, beta, c /* matrix beeing updated */);
-    else if (!transposeA &&  transposeB)
+    else if (!transposeSparse &&  transposeB)
         MultiplyDenseAndSparse<ElemType, false /* dense times sparse */, false /* transposeA */,  true /*transposeB*/>::MultiplyAndWeightedAdd(alpha, a /*sparse*/, b /* dense */, beta, c /* matrix beeing updated */);
-    else if (!transposeA && !transposeB)
+    else if (!transposeSparse && !transposeB)
         MultiplyDenseAndSparse<ElemType, false /* dense times sparse */, false /* transposeA */, false /*transposeB*/>::MultiplyAndWeightedAdd(alpha, a /*sparse*/, b /* dense */, beta, c /* matrix beeing updated */);
 }
 
@@ -1036,76 +1216,91 @@ void CPUSparseMatrix<ElemType>::MultiplyAndAdd(ElemType alpha, const CPUMatrix<E
         InvalidArgument("CPUSparseMatrix::MultiplyAndAdd: The inner dimensions of a (= %lu) and b (= %lu) don't match.", k, l);
     }
 
-    if (!transposeA && !transposeB)
-    {
+    if (rhs.GetFormat() != matrixFormatSparseCSC && rhs.GetFormat() != matrixFormatSparseCSR)
         NOT_IMPLEMENTED;
-    }
-    else if (!transposeA && transposeB)
-    {
-        if (rhs.GetFormat() != matrixFormatSparseCSC)
-            NOT_IMPLEMENTED;
 
-        // allocate enough memory
-        c.SetFormat(matrixFormatSparseBlockCol);
-        size_t blockSizePrev = c.GetBlockSize();
+    // A CSR matrix is multiplied as the CSC representation of its transpose.
+    bool isCSR = rhs.GetFormat() == matrixFormatSparseCSR;
+    bool transposeSparse = isCSR ? !transposeB : transposeB;
+    size_t sparseCols = isCSR ? rhs.GetNumRows() : rhs.GetNumCols();
+    const CPUSPARSE_INDEX_TYPE* colStarts = rhs.SecondaryIndexLocation();
+    const CPUSPARSE_INDEX_TYPE* rowIndices = rhs.MajorIndexLocation();
+    const ElemType* values = rhs.Data();
+    size_t nz = colStarts[sparseCols] - colStarts[0];
 
-        if (blockSizePrev == 0)
-        {
-            c.RequireSizeAndAllocate(m, n, 0, true); // allocate for blockIds
-        }
+    // allocate enough memory
+    c.SetFormat(matrixFormatSparseBlockCol);
+    size_t blockSizePrev = c.GetBlockSize();
 
-        map<size_t, size_t> col2BlockId;
-        for (size_t blockId = 0; blockId < blockSizePrev; blockId++)
-        {
-            col2BlockId[c.GetBlockIds()[blockId]] = blockId;
-        }
+    if (blockSizePrev == 0)
+    {
+        c.RequireSizeAndAllocate(m, n, 0, true); // allocate for blockIds
+    }
 
-        size_t blockSizeCurr = blockSizePrev;
-        for (size_t rhsNz = 0; rhsNz < rhs.NzCount(); rhsNz++)
+    map<size_t, size_t> col2BlockId;
+    for (size_t blockId = 0; blockId < blockSizePrev; blockId++)
+    {
+        col2BlockId[c.GetBlockIds()[blockId]] = blockId;
+    }
+
+    // Each nonzero of rhs adds a multiple of one column of op(lhs) to one column of c. Find both for every nonzero,
+    // adding the columns of c that are not stored yet.
+    vector<size_t> blockIds(nz);
+    vector<size_t> lhsCols(nz);
+    size_t blockSizeCurr = blockSizePrev;
+    for (size_t rhsCol = 0; rhsCol < sparseCols; rhsCol++)
+    {
+        for (size_t p = colStarts[rhsCol] - colStarts[0]; p < colStarts[rhsCol + 1] - colStarts[0]; p++)
         {
-            size_t resultCol = rhs.MajorIndexLocation()[rhsNz];
-            if (col2BlockId.find(resultCol) == col2BlockId.end())
+            size_t rhsRow = rowIndices[p];
+            size_t resultCol = transposeSparse ? rhsRow : rhsCol;
+            lhsCols[p] = transposeSparse ? rhsCol : rhsRow;
+
+            auto iter = col2BlockId.find(resultCol);
+            if (iter == col2BlockId.end())
             {
-                col2BlockId[resultCol] = blockSizeCurr;
+                iter = col2BlockId.insert(make_pair(resultCol, blockSizeCurr)).first;
                 c.GetBlockIds()[blockSizeCurr] = resultCol;
                 blockSizeCurr ++;
             }
+            blockIds[p] = iter->second;
         }
+    }
 
-        if (blockSizeCurr > blockSizePrev)
-        {
-            c.RequireSizeAndAllocate(m, n, m * blockSizeCurr, true, true);
-            c.SetBlockSize(blockSizeCurr);
-            memset(c.Data() + m * blockSizePrev, 0, sizeof(ElemType) * m * (blockSizeCurr - blockSizePrev));
-        }
+    if (blockSizeCurr > blockSizePrev)
+    {
+        c.RequireSizeAndAllocate(m, n, m * blockSizeCurr, true, true);
+        c.SetBlockSize(blockSizeCurr);
+        memset(c.Data() + m * blockSizePrev, 0, sizeof(ElemType) * m * (blockSizeCurr - blockSizePrev));
+    }
 
-        for (size_t rhsCol = 0; rhsCol < rhs.GetNumCols(); rhsCol++)
+    // Several nonzeros may update the same column of c, so each task updates one block of rows of all of c.
+    ElemType* results = c.Data();
+    const ElemType* lhsData = lhs.Data();
+    size_t ld = lhs.GetNumRows();
+    long numRowBlocks = (long) ((m + sparseMultiplyRowBlock - 1) / sparseMultiplyRowBlock);
+#pragma omp parallel for if (nz * m >= minParallelSparseMultiplyOps)
+    for (long rowBlock = 0; rowBlock < numRowBlocks; rowBlock++)
+    {
+        size_t i0 = rowBlock * sparseMultiplyRowBlock;
+        size_t i1 = std::min(m, i0 + sparseMultiplyRowBlock);
+        for (size_t p = 0; p < nz; p++)
         {
-            size_t start = rhs.SecondaryIndexLocation()[rhsCol];
-            size_t end = rhs.SecondaryIndexLocation()[rhsCol + 1];
-
-            for (size_t p = start; p < end; p++)
+            ElemType val = alpha * values[p];
+            ElemType* resultCol = results + blockIds[p] * m;
+            if (!transposeA)
             {
-                size_t rhsRow = rhs.MajorIndexLocation()[p];
-                ElemType val = rhs.Buffer()[p];
-
-                ElemType* results = c.Buffer() + col2BlockId[rhsRow] * m;
-                #pragma omp parallel for
-                for (int lhsRow = 0; lhsRow < (int)m; lhsRow++)
-                {
-                    results[lhsRow] += alpha * lhs((size_t)lhsRow, rhsCol) * val;
-                }
+                const ElemType* lhsCol = lhsData + lhsCols[p] * ld;
+                for (size_t i = i0; i < i1; i++)
+                    resultCol[i] += val * lhsCol[i];
+            }
+            else
+            {
+                for (size_t i = i0; i < i1; i++)
+                    resultCol[i] += val * lhsData[lhsCols[p] + i * ld];
             }
         }
     }
-    else if (transposeA && !transposeB)
-    {
-        NOT_IMPLEMENTED;
-    }
-    else
-    {
-        NOT_IMPLEMENTED;
-    }
 }
 
 // c[:,j] = alpha * v[j] * a[:,j] + beta * c[:,j]
@@ -1180,7 +1375,9 @@ void CPUSparseMatrix<ElemType>::ScaleAndAdd(const ElemType alpha, const CPUSpars
     }
     else if (lhs.GetFormat() == MatrixFormat::matrixFormatSparseBlockCol || lhs.GetFormat() == MatrixFormat::matrixFormatSparseBlockRow)
     {
-        for (size_t j = 0; j < lhs.GetBlockSize(); j++)
+        // Each block is a different column (row) of rhs, so the blocks can be added in parallel.
+#pragma omp parallel for
+        for (long j = 0; j < (long)lhs.GetBlockSize(); j++)
         {
             size_t i = lhs.GetBlockIds()[j] - lhs.GetBlockIdShift();
             size_t len = (lhs.GetFormat() == MatrixFormat::matrixFormatSparseBlockCol) ? lhs.GetNumRows() : lhs.GetNumCols();
@@ -1438,6 +1635,199 @@ void CPUSparseMatrix<ElemType>::AdaDelta(CPUMatrix<ElemType>& c, CPUMatrix<ElemT
     }
 }
 
+// The optimizers below only update the columns that are present in the block-sparse gradient ("lazy" updates), so that their cost
+// is proportional to the number of those columns instead of the size of the model. Other than in the dense and GPU versions, the
+// smoothed gradients of the other columns are not decayed in the meantime.
+
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::FSAdagrad(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample,
+                                          ElemType momentum, ElemType adaWeight, ElemType adaMul, bool unitGainMomentum)
+{
+    auto unitGainFactor = ElemType(unitGainMomentum ? (1.0 - momentum) : 1.0);
+
+    size_t numColsNeeded = 2 * GetNumCols();
+
+    if (c.IsEmpty() || (c.GetNumCols() < numColsNeeded))
+    {
+        c.RequireSize(GetNumRows(), numColsNeeded);
+        c.SetValue(0.0);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != numColsNeeded)
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    size_t n = GetNumElements();
+    ElemType* grad = Data();
+    ElemType* smoothAda = c.Data();
+    ElemType* smoothMom = c.Data() + n;
+    ElemType* val = functionValues.Data();
+
+#pragma omp parallel for
+    for (long j = 0; j < (long)GetBlockSize(); j++)
+    {
+        size_t len = GetNumRows();
+        size_t start = j * len;
+        size_t denseStart = (GetBlockIds()[j] - GetBlockIdShift()) * len;
+        for (size_t p = 0; p < len; p++)
+        {
+            size_t denseIndex = denseStart + p;
+            ElemType g = grad[start + p];
+            ElemType adaSqr = adaWeight * smoothAda[denseIndex] + (1.0f - adaWeight) * g * g;
+            smoothAda[denseIndex] = adaSqr;
+            if (adaSqr != 0.0f)
+            {
+                ElemType w = adaMul * ((ElemType) 1.0 / sqrt(adaSqr));
+                if (w > 10.0f)
+                    w = 10.0f;
+                g *= w;
+            }
+
+            if (momentum > 0.0f)
+            {
+                g = momentum * smoothMom[denseIndex] + unitGainFactor * g;
+                smoothMom[denseIndex] = g;
+            }
+
+            val[denseIndex] -= learnRatePerSample * g;
+        }
+    }
+}
+
+// The returned average multiplier is the one of the elements in the gradient.
+template <class ElemType>
+ElemType CPUSparseMatrix<ElemType>::RmsProp(CPUMatrix<ElemType>& c,
+                                            ElemType RMS_GAMMA,
+                                            ElemType RMS_WGT_INC,
+                                            ElemType RMS_WGT_MAX,
+                                            ElemType RMS_WGT_DEC,
+                                            ElemType RMS_WGT_MIN,
+                                            const bool needAveMultiplier,
+                                            const bool initialized)
+{
+    const ElemType floor = 1e-6f;
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    size_t n = GetNumElements();
+    size_t numColsNeeded = 3 * GetNumCols();
+
+    // The moving average of gradient-squared is initialized to the current gradient, which is 0 outside of the gradient blocks.
+    bool initializeAvars = c.IsEmpty() || c.GetNumCols() < numColsNeeded || !initialized;
+    if (initializeAvars)
+    {
+        c.RequireSize(GetNumRows(), numColsNeeded);
+        c.SetValue(0.0);
+
+        // initialize starting step size
+        ElemType* steps = c.Data() + 2 * n;
+        for (long i = 0; i < (long)n; i++)
+            steps[i] = ElemType(0.02);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != numColsNeeded)
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    ElemType* grad = Data();
+    ElemType* avars = c.Data();         // accumulated variances for RMS scaling
+    ElemType* signs = c.Data() + n;     // sign of previous gradient
+    ElemType* steps = c.Data() + 2 * n; // current step size
+
+    ElemType ONE_MINUS_GAMMA = ElemType(1.0) - RMS_GAMMA;
+    ElemType aveMultiplier = 0;
+#pragma omp parallel for reduction(+ : aveMultiplier)
+    for (long j = 0; j < (long)GetBlockSize(); j++)
+    {
+        size_t len = GetNumRows();
+        size_t start = j * len;
+        size_t denseStart = (GetBlockIds()[j] - GetBlockIdShift()) * len;
+        for (size_t p = 0; p < len; p++)
+        {
+            size_t i = denseStart + p;
+            ElemType g = grad[start + p];
+            if (initializeAvars)
+                avars[i] = g * g;
+
+            avars[i] = RMS_GAMMA * avars[i] + ONE_MINUS_GAMMA * (g * g);
+            const int grad_sign = (ElemType(0) < g) - (g < ElemType(0));
+
+            if (signs[i] * grad_sign > 0)
+                steps[i] = std::min(steps[i] * RMS_WGT_INC, RMS_WGT_MAX);
+            else
+                steps[i] = std::max(steps[i] * RMS_WGT_DEC, RMS_WGT_MIN);
+
+            ElemType a = steps[i] / sqrt(avars[i] + floor);
+            grad[start + p] *= a;
+            signs[i] = (ElemType) grad_sign;
+
+            aveMultiplier += a;
+        }
+    }
+
+    size_t nz = NzCount();
+    if (needAveMultiplier && nz > 0)
+        return aveMultiplier / nz;
+    else
+        return 1;
+}
+
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::Adam(CPUMatrix<ElemType>& c, CPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample,
+                                     ElemType momentum, ElemType adaWeight, ElemType adaMul, ElemType epsilon, bool unitGainMomentum, bool adamax)
+{
+    auto unitGainFactor = ElemType(unitGainMomentum ? (1.0 - momentum) : 1.0);
+
+    size_t numColsNeeded = 2 * GetNumCols();
+
+    if (c.IsEmpty() || (c.GetNumCols() < numColsNeeded))
+    {
+        c.RequireSize(GetNumRows(), numColsNeeded);
+        c.SetValue(0.0);
+    }
+
+    if (c.GetNumRows() != GetNumRows() || c.GetNumCols() != numColsNeeded)
+        LogicError("The matrix gradients does not have expected dimensions.");
+
+    if (GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+        LogicError("Unsupported sparse format.");
+
+    size_t n = GetNumElements();
+    ElemType* grad = Data();
+    ElemType* smoothAda = c.Data();
+    ElemType* smoothMom = c.Data() + n;
+    ElemType* val = functionValues.Data();
+
+#pragma omp parallel for
+    for (long j = 0; j < (long)GetBlockSize(); j++)
+    {
+        size_t len = GetNumRows();
+        size_t start = j * len;
+        size_t denseStart = (GetBlockIds()[j] - GetBlockIdShift()) * len;
+        for (size_t p = 0; p < len; p++)
+        {
+            size_t denseIndex = denseStart + p;
+            ElemType g = grad[start + p];
+            ElemType ada;
+            if (!adamax)
+            {
+                ElemType adaSqr = adaWeight * smoothAda[denseIndex] + (1.0f - adaWeight) * g * g;
+                smoothAda[denseIndex] = adaSqr;
+                ada = sqrt(adaSqr);
+            }
+            else
+                ada = smoothAda[denseIndex] = std::max(adaWeight * smoothAda[denseIndex], abs(g));
+
+            ElemType w = adaMul * (ElemType)(1.0 / (ada + epsilon));
+            g = momentum * smoothMom[denseIndex] + unitGainFactor * g;
+            smoothMom[denseIndex] = g;
+            val[denseIndex] -= g * w * learnRatePerSample;
+        }
+    }
+}
+
 template <class ElemType>
 CPUSparseMatrix<ElemType>& CPUSparseMatrix<ElemType>::InplaceTruncateTop(const ElemType threshold)
 {
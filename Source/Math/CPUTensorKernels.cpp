@@ -0,0 +1,259 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUTensorKernels.cpp -- runtime-dispatched SIMD fast paths for CPUMatrix::TensorOp()
+//
+
+#include "stdafx.h"
+#include "CPUTensorKernels.h"
+#include "CPUVectorKernels.h"
+#include <atomic>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define HAS_X86_CPUID
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// instruction set detection
+// -----------------------------------------------------------------------
+
+#ifdef HAS_X86_CPUID
+static void CpuId(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+{
+#ifdef _MSC_VER
+    __cpuidex((int*) regs, (int) leaf, (int) subleaf);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// which register states the OS saves on context switches
+static unsigned long long GetXCR0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long) edx << 32) | eax;
+#endif
+}
+#endif
+
+static CPUVectorExtension DetectCPUVectorExtension()
+{
+#ifdef HAS_X86_CPUID
+    unsigned int regs[4]; // eax, ebx, ecx, edx
+    CpuId(0, 0, regs);
+    if (regs[0] < 7)
+        return CPUVectorExtension::None;
+
+    CpuId(1, 0, regs);
+    const bool hasFMA     = (regs[2] & (1u << 12)) != 0;
+    const bool hasOSXSAVE = (regs[2] & (1u << 27)) != 0;
+    const bool hasAVX     = (regs[2] & (1u << 28)) != 0;
+    if (!hasOSXSAVE || !hasAVX)
+        return CPUVectorExtension::None;
+
+    const unsigned long long xcr0 = GetXCR0();
+    const bool osSavesYMM = (xcr0 & 0x06) == 0x06;      // XMM and YMM state
+    const bool osSavesZMM = (xcr0 & 0xe6) == 0xe6;      // additionally opmask and both halves of the ZMM state
+
+    CpuId(7, 0, regs);
+    const bool hasAVX2    = (regs[1] & (1u << 5)) != 0;
+    const bool hasAVX512F = (regs[1] & (1u << 16)) != 0;
+
+    if (hasAVX512F && osSavesZMM && GetAVX512VectorKernels<float>())
+        return CPUVectorExtension::AVX512;
+    if (hasAVX2 && hasFMA && osSavesYMM && GetAVX2VectorKernels<float>())
+        return CPUVectorExtension::AVX2;
+#endif
+    return CPUVectorExtension::None;
+}
+
+static std::atomic<int> s_maxCPUVectorExtension((int) CPUVectorExtension::AVX512);
+
+CPUVectorExtension GetCPUVectorExtension()
+{
+    static const CPUVectorExtension detected = DetectCPUVectorExtension();
+    return (CPUVectorExtension) std::min((int) detected, s_maxCPUVectorExtension.load());
+}
+
+void SetMaxCPUVectorExtension(CPUVectorExtension maxExtension)
+{
+    s_maxCPUVectorExtension = (int) maxExtension;
+}
+
+template <class ElemType>
+static const CPUVectorKernelTable<ElemType>* GetVectorKernels()
+{
+    switch (GetCPUVectorExtension())
+    {
+    case CPUVectorExtension::AVX512: return GetAVX512VectorKernels<ElemType>();
+    case CPUVectorExtension::AVX2:   return GetAVX2VectorKernels<ElemType>();
+    default:                         return nullptr;
+    }
+}
+
+// -----------------------------------------------------------------------
+// recognizing the shapes that the kernels handle
+// -----------------------------------------------------------------------
+
+// below this many rows, most of the work would be in the scalar tails of the kernels
+static const size_t minVectorRows = 16;
+
+static bool ToVectorOp(ElementWiseOperator op, VectorOp& vectorOp)
+{
+    switch (op)
+    {
+    case ElementWiseOperator::opCopy:               vectorOp = VectorOp::Copy;               return true;
+    case ElementWiseOperator::opLinearRectifier:    vectorOp = VectorOp::LinearRectifier;    return true;
+    case ElementWiseOperator::opSum:                vectorOp = VectorOp::Sum;                return true;
+    case ElementWiseOperator::opDifference:         vectorOp = VectorOp::Difference;         return true;
+    case ElementWiseOperator::opElementwiseProduct: vectorOp = VectorOp::ElementwiseProduct; return true;
+    case ElementWiseOperator::opMax:                vectorOp = VectorOp::Max;                return true;
+    case ElementWiseOperator::opMin:                vectorOp = VectorOp::Min;                return true;
+    default:                                        return false;
+    }
+}
+
+// interpret the (already flattened) regular dims as a column-major [rows x cols] array
+// 'inc' is the stride along the rows, 'ld' the one along the columns.
+struct Strides2D
+{
+    ptrdiff_t inc;
+    ptrdiff_t ld;
+};
+
+static bool As2D(const SmallVector<size_t>& opDims, size_t& rows, size_t& cols)
+{
+    if (opDims.size() == 1)
+    {
+        rows = opDims[0];
+        cols = 1;
+    }
+    else if (opDims.size() == 2)
+    {
+        rows = opDims[0];
+        cols = opDims[1];
+    }
+    else
+        return false;
+    return rows >= minVectorRows;
+}
+
+static Strides2D StridesOf(const SmallVector<size_t>& opDims, const SmallVector<ptrdiff_t>& strides)
+{
+    Strides2D s = { strides[0], opDims.size() > 1 ? strides[1] : 0 };
+    return s;
+}
+
+// The kernels process columns in parallel and load broadcast values once per column. Hence an input may share
+// memory with the output only if both are laid out identically, so that each element is read before it is written.
+template <class ElemType>
+static bool IsSafeOverlap(const ElemType* in, Strides2D inStrides, const ElemType* out, Strides2D outStrides, size_t rows, size_t cols)
+{
+    if (inStrides.ld < 0 || (cols > 1 && outStrides.ld < (ptrdiff_t) rows)) // also, the columns of the output must not overlap each other
+        return false;
+    const ElemType* outEnd = out + (cols - 1) * outStrides.ld + rows;
+    const ElemType* inEnd = in + (cols - 1) * inStrides.ld + (inStrides.inc ? rows : 1);
+    bool overlaps = in < outEnd && out < inEnd;
+    return !overlaps || (in == out && inStrides.inc == outStrides.inc && inStrides.ld == outStrides.ld);
+}
+
+template <class ElemType>
+bool CPUTensorKernels<ElemType>::TryTensorOp(ElemType beta, const ElemType* a, ElemType* c, ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
+                                             const std::array<size_t, 2>& offsets,
+                                             const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+                                             const SmallVector<size_t>& reducingOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& reducingStrides)
+{
+    auto kernels = GetVectorKernels<ElemType>();
+    if (!kernels)
+        return false;
+
+    VectorOp vectorOp;
+    a += offsets[0];
+    c += offsets[1];
+
+    if (reducingOpDims.empty()) // elementwise
+    {
+        size_t rows, cols;
+        if (!ToVectorOp(op, vectorOp) || (vectorOp != VectorOp::Copy && vectorOp != VectorOp::LinearRectifier) || !As2D(regularOpDims, rows, cols))
+            return false;
+        Strides2D as = StridesOf(regularOpDims, regularStrides[0]);
+        Strides2D cs = StridesOf(regularOpDims, regularStrides[1]);
+        if (cs.inc != 1 || (as.inc != 0 && as.inc != 1) || !IsSafeOverlap(a, as, c, cs, rows, cols))
+            return false;
+        kernels->elementwiseUnary(vectorOp, rows, cols, a, as.inc, as.ld, c, cs.ld, alpha, beta);
+        return true;
+    }
+
+    // reduction: only plain reductions over a single (flattened) dimension
+    if (op != ElementWiseOperator::opCopy || reducingOpDims.size() != 1 || regularOpDims.size() > 1 ||
+        !ToVectorOp(reductionOp, vectorOp) || (vectorOp != VectorOp::Sum && vectorOp != VectorOp::Max && vectorOp != VectorOp::Min))
+        return false;
+
+    const size_t reducingDim = reducingOpDims[0];
+    const size_t regularDim = regularOpDims.empty() ? 1 : regularOpDims[0];
+    const ptrdiff_t aRegularStride = regularOpDims.empty() ? 0 : regularStrides[0][0];
+    const ptrdiff_t cRegularStride = regularOpDims.empty() ? 0 : regularStrides[1][0];
+    const ElemType* aEnd = a + (regularDim - 1) * aRegularStride + (reducingDim - 1) * reducingStrides[0][0] + 1;
+    const ElemType* cEnd = c + (regularDim - 1) * cRegularStride + 1;
+    if (aRegularStride < 0 || cRegularStride < 0 || reducingStrides[0][0] <= 0 || (a < cEnd && c < aEnd)) // or the result overlaps the input
+        return false;
+
+    if (reducingStrides[0][0] == 1 && reducingDim >= minVectorRows) // reducing the contiguous dimension, e.g. ReduceSum() along the first axis
+    {
+        kernels->reduceRows(vectorOp, reducingDim, regularDim, a, aRegularStride, c, cRegularStride, alpha, beta);
+        return true;
+    }
+    if (aRegularStride == 1 && cRegularStride == 1 && regularDim >= minVectorRows) // reducing the outer dimension, e.g. a bias gradient
+    {
+        kernels->reduceColumns(vectorOp, regularDim, reducingDim, a, reducingStrides[0][0], c, alpha, beta);
+        return true;
+    }
+    return false;
+}
+
+template <class ElemType>
+bool CPUTensorKernels<ElemType>::TryTensorOp(ElemType beta, const ElemType* a, const ElemType* b, ElemType* c, ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
+                                             const std::array<size_t, 3>& offsets,
+                                             const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, 3>& regularStrides,
+                                             const SmallVector<size_t>& reducingOpDims, const std::array<SmallVector<ptrdiff_t>, 3>&)
+{
+    auto kernels = GetVectorKernels<ElemType>();
+    if (!kernels)
+        return false;
+
+    VectorOp vectorOp;
+    size_t rows, cols;
+    if (!reducingOpDims.empty() || reductionOp != ElementWiseOperator::opSum || !ToVectorOp(op, vectorOp) ||
+        vectorOp == VectorOp::Copy || vectorOp == VectorOp::LinearRectifier || !As2D(regularOpDims, rows, cols))
+        return false;
+
+    a += offsets[0];
+    b += offsets[1];
+    c += offsets[2];
+    Strides2D as = StridesOf(regularOpDims, regularStrides[0]);
+    Strides2D bs = StridesOf(regularOpDims, regularStrides[1]);
+    Strides2D cs = StridesOf(regularOpDims, regularStrides[2]);
+    if (cs.inc != 1 || (as.inc != 0 && as.inc != 1) || (bs.inc != 0 && bs.inc != 1) ||
+        !IsSafeOverlap(a, as, c, cs, rows, cols) || !IsSafeOverlap(b, bs, c, cs, rows, cols))
+        return false;
+
+    kernels->elementwiseBinary(vectorOp, rows, cols, a, as.inc, as.ld, b, bs.inc, bs.ld, c, cs.ld, alpha, beta);
+    return true;
+}
+
+template class CPUTensorKernels<float>;
+template class CPUTensorKernels<double>;
+
+}}}
@@ -0,0 +1,59 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUTensorKernels.h -- runtime-dispatched SIMD fast paths for CPUMatrix::TensorOp()
+//
+
+#pragma once
+
+#include "CommonMatrix.h"
+#include "TensorShape.h"
+#include <array>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// instruction set extensions that CPU tensor kernels exist for, in increasing order
+enum class CPUVectorExtension
+{
+    None,
+    AVX2,
+    AVX512
+};
+
+// The extension used by the CPU tensor kernels: the best one supported by the CPU, the OS, and this build, unless
+// capped by SetMaxCPUVectorExtension(). Detected once via CPUID.
+MATH_API CPUVectorExtension GetCPUVectorExtension();
+
+// Do not use extensions beyond 'maxExtension'. CPUVectorExtension::None disables the fast paths, which is meant for
+// comparing them against the generic tensor loops.
+MATH_API void SetMaxCPUVectorExtension(CPUVectorExtension maxExtension);
+
+// -----------------------------------------------------------------------
+// CPUTensorKernels -- recognizes the common shapes of tensor operations and
+// computes them with explicitly vectorized loops (see CPUVectorKernels.h):
+//  - elementwise ops over a contiguous inner dimension, e.g. copies, ReLU, sums
+//  - elementwise binary ops where one input is a broadcast row or column vector, e.g. bias addition
+//  - Sum/Max/Min reductions over the inner dimension (ReduceSum along the first axis), or over the
+//    outer dimension (bias gradients)
+// Everything else, including all ops not listed above, is left to the generic loops in CPUMatrixImpl.h.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class CPUTensorKernels
+{
+public:
+    // The arguments are those of the corresponding CPUMatrix::TensorOp(), with the data pointers of the
+    // matrices in the same order. Returns false if the operation was not computed.
+    static bool TryTensorOp(ElemType beta, const ElemType* a, ElemType* c, ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
+                            const std::array<size_t, 2>& offsets,
+                            const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& regularStrides,
+                            const SmallVector<size_t>& reducingOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& reducingStrides);
+
+    static bool TryTensorOp(ElemType beta, const ElemType* a, const ElemType* b, ElemType* c, ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
+                            const std::array<size_t, 3>& offsets,
+                            const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, 3>& regularStrides,
+                            const SmallVector<size_t>& reducingOpDims, const std::array<SmallVector<ptrdiff_t>, 3>& reducingStrides);
+};
+
+}}}
@@ -0,0 +1,389 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUVectorKernels.h -- explicitly vectorized loops for the most common CPU tensor operations
+//
+// The kernels are written once against a small set of vector traits (load, store, add, max, ...), and compiled once per
+// instruction set in CPUVectorKernelsAVX2.cpp and CPUVectorKernelsAVX512.cpp, which are built with the respective
+// compiler flags. CPUTensorKernels.cpp picks one of them at runtime, based on CPUID.
+//
+// This header is deliberately free of other CNTK headers: anything inline that it pulls in would also be compiled
+// with the instruction-set flags, and the linker may pick that copy for code that runs on any CPU.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// the operations that have vectorized kernels (subset of ElementWiseOperator)
+enum class VectorOp
+{
+    Copy,
+    LinearRectifier,
+    Sum,
+    Difference,
+    ElementwiseProduct,
+    Max,
+    Min
+};
+
+// All kernels operate on column-major [rows x cols] arrays with unit stride along the rows for the result.
+// An input with inc = 0 is broadcast along the rows (one value per column); ld = 0 broadcasts it along the columns.
+// Like CPUMatrix::TensorOp(), they compute c = beta * c + alpha * op(...), and do not read c if beta is 0.
+template <class ElemType>
+struct CPUVectorKernelTable
+{
+    // c = op(a); op is Copy or LinearRectifier
+    void (*elementwiseUnary)(VectorOp op, size_t rows, size_t cols,
+                             const ElemType* a, ptrdiff_t aInc, ptrdiff_t lda,
+                             ElemType* c, ptrdiff_t ldc, ElemType alpha, ElemType beta);
+    // c = op(a, b); op is Sum, Difference, ElementwiseProduct, Max, or Min
+    void (*elementwiseBinary)(VectorOp op, size_t rows, size_t cols,
+                              const ElemType* a, ptrdiff_t aInc, ptrdiff_t lda,
+                              const ElemType* b, ptrdiff_t bInc, ptrdiff_t ldb,
+                              ElemType* c, ptrdiff_t ldc, ElemType alpha, ElemType beta);
+    // c[j * cInc] = reduce_i a[i + j * lda], i.e. reduce over the rows; op is Sum, Max, or Min
+    void (*reduceRows)(VectorOp op, size_t rows, size_t cols,
+                       const ElemType* a, ptrdiff_t lda,
+                       ElemType* c, ptrdiff_t cInc, ElemType alpha, ElemType beta);
+    // c[i] = reduce_j a[i + j * lda], i.e. reduce over the columns (e.g. a bias gradient); op is Sum, Max, or Min
+    void (*reduceColumns)(VectorOp op, size_t rows, size_t cols,
+                          const ElemType* a, ptrdiff_t lda,
+                          ElemType* c, ElemType alpha, ElemType beta);
+};
+
+// Defined in CPUVectorKernelsAVX2.cpp and CPUVectorKernelsAVX512.cpp.
+// These return nullptr if the file was compiled without support for the instruction set.
+template <class ElemType> const CPUVectorKernelTable<ElemType>* GetAVX2VectorKernels();
+template <> const CPUVectorKernelTable<float>* GetAVX2VectorKernels<float>();
+template <> const CPUVectorKernelTable<double>* GetAVX2VectorKernels<double>();
+template <class ElemType> const CPUVectorKernelTable<ElemType>* GetAVX512VectorKernels();
+template <> const CPUVectorKernelTable<float>* GetAVX512VectorKernels<float>();
+template <> const CPUVectorKernelTable<double>* GetAVX512VectorKernels<double>();
+
+// sums[q] = sum_l a[l] * b[l + q * ldb] for q < numColumns <= 4, i.e. the dot products of one row of int8 values
+// with up to four columns of uint8 values, accumulated exactly in int32 (used by Int8Gemm.cpp)
+typedef void (*Int8DotProductsKernel)(const int8_t* a, const uint8_t* b, size_t ldb, size_t numColumns, size_t k, int32_t* sums);
+
+// Defined in CPUVectorKernelsAVX2.cpp; returns nullptr if the file was compiled without AVX2 support.
+Int8DotProductsKernel GetAVX2Int8DotProducts();
+
+// c[i + q * ldc] = sum_l a[i + l * lda] * b[l + q * ldb] (plus c[i + q * ldc] if accumulate) for i < 16 and q < numColumns <= 4,
+// where a holds the bit patterns of bfloat16 values, which are widened to float in registers (used by BFloat16.cpp)
+typedef void (*BFloat16MultiplyKernel)(const uint16_t* a, size_t lda, const float* b, size_t ldb, size_t numColumns, size_t k,
+                                       float* c, size_t ldc, bool accumulate);
+
+// number of rows of c that are computed by one call of a BFloat16MultiplyKernel
+static const size_t bfloat16KernelRows = 16;
+
+// Defined in CPUVectorKernelsAVX2.cpp; returns nullptr if the file was compiled without AVX2 support.
+BFloat16MultiplyKernel GetAVX2BFloat16Multiply();
+
+#ifdef CNTK_VECTOR_KERNELS_IMPLEMENTATION // only defined by the per-instruction-set source files
+
+// -----------------------------------------------------------------------
+// VectorKernels -- the kernels, for vector traits 'V' that provide:
+//  - ElemType, Vec, width
+//  - Load(), Store(), Set1(), Add(), Sub(), Mul(), Max(), Min(), HorizontalMax(), HorizontalMin()
+//  - SumAcc, ZeroSum(), AddToSum(), SumToVec(), HorizontalSum(): sums are accumulated in double, like the generic
+//    CPU reduction does, so that results do not change noticeably when switching between the two
+// -----------------------------------------------------------------------
+
+template <class V>
+struct VectorKernels
+{
+    typedef typename V::ElemType ElemType;
+    typedef typename V::Vec Vec;
+    static const size_t width = V::width;
+
+    // work is split into blocks of at most this many elements for OpenMP
+    static const size_t blockSize = 8192;
+
+    enum Scaling { noScaling, alphaScaling, alphaBetaScaling };
+
+    static Scaling ScalingFor(ElemType alpha, ElemType beta)
+    {
+        return beta != 0 ? alphaBetaScaling : alpha != 1 ? alphaScaling : noScaling;
+    }
+
+    static const CPUVectorKernelTable<ElemType>& Table()
+    {
+        static const CPUVectorKernelTable<ElemType> table = { &ElementwiseUnary, &ElementwiseBinary, &ReduceRows, &ReduceColumns };
+        return table;
+    }
+
+    // --- scalar and vector versions of the ops; VectorOp is a template parameter so that the loops are specialized for it
+
+    template <VectorOp op>
+    static ElemType Apply(ElemType a, ElemType b)
+    {
+        switch (op)
+        {
+        case VectorOp::Copy:               return a;
+        case VectorOp::LinearRectifier:    return a > 0 ? a : 0;
+        case VectorOp::Sum:                return a + b;
+        case VectorOp::Difference:         return a - b;
+        case VectorOp::ElementwiseProduct: return a * b;
+        case VectorOp::Max:                return a > b ? a : b;
+        case VectorOp::Min:                return a < b ? a : b;
+        }
+        return a;
+    }
+
+    template <VectorOp op>
+    static Vec Apply(Vec a, Vec b)
+    {
+        switch (op)
+        {
+        case VectorOp::Copy:               return a;
+        case VectorOp::LinearRectifier:    return V::Max(a, V::Set1(0)); // Max() returns the second argument for NaN, like the scalar op
+        case VectorOp::Sum:                return V::Add(a, b);
+        case VectorOp::Difference:         return V::Sub(a, b);
+        case VectorOp::ElementwiseProduct: return V::Mul(a, b);
+        case VectorOp::Max:                return V::Max(a, b);
+        case VectorOp::Min:                return V::Min(a, b);
+        }
+        return a;
+    }
+
+    template <Scaling scaling>
+    static ElemType Scale(ElemType val, const ElemType* c, ElemType alpha, ElemType beta)
+    {
+        if (scaling == noScaling)
+            return val;
+        val *= alpha;
+        if (scaling == alphaBetaScaling)
+            val += beta * *c;
+        return val;
+    }
+
+    template <Scaling scaling>
+    static Vec Scale(Vec val, const ElemType* c, Vec alpha, Vec beta)
+    {
+        if (scaling == noScaling)
+            return val;
+        val = V::Mul(val, alpha);
+        if (scaling == alphaBetaScaling)
+            val = V::Add(val, V::Mul(beta, V::Load(c)));
+        return val;
+    }
+
+    // --- elementwise
+
+    // one segment [i0, i1) of a column; aInc/bInc of 0 means the value is broadcast, which is hoisted out of the loop
+    template <VectorOp op, bool aVec, bool bVec, Scaling scaling>
+    static void BinarySegment(size_t i0, size_t i1, const ElemType* a, const ElemType* b, ElemType* c, ElemType alpha, ElemType beta)
+    {
+        const Vec va0 = V::Set1(*a), vb0 = V::Set1(*b);
+        const Vec valpha = V::Set1(alpha), vbeta = V::Set1(beta);
+        size_t i = i0;
+        for (; i + width <= i1; i += width)
+        {
+            Vec va = aVec ? V::Load(a + i) : va0;
+            Vec vb = bVec ? V::Load(b + i) : vb0;
+            V::Store(c + i, Scale<scaling>(Apply<op>(va, vb), c + i, valpha, vbeta));
+        }
+        for (; i < i1; i++)
+            c[i] = Scale<scaling>(Apply<op>(aVec ? a[i] : *a, bVec ? b[i] : *b), c + i, alpha, beta);
+    }
+
+    template <VectorOp op, bool aVec, bool bVec, Scaling scaling>
+    static void BinaryLoop(size_t rows, size_t cols, const ElemType* a, ptrdiff_t lda, const ElemType* b, ptrdiff_t ldb, ElemType* c, ptrdiff_t ldc, ElemType alpha, ElemType beta)
+    {
+        const size_t blocksPerCol = (rows + blockSize - 1) / blockSize;
+        const long long numBlocks = (long long) (blocksPerCol * cols);
+#pragma omp parallel for if (numBlocks > 1 && rows * cols >= 4 * blockSize)
+        for (long long block = 0; block < numBlocks; block++)
+        {
+            const size_t j = (size_t) block / blocksPerCol;
+            const size_t i0 = ((size_t) block % blocksPerCol) * blockSize;
+            const size_t i1 = i0 + blockSize < rows ? i0 + blockSize : rows;
+            BinarySegment<op, aVec, bVec, scaling>(i0, i1, a + j * lda, b + j * ldb, c + j * ldc, alpha, beta);
+        }
+    }
+
+    template <VectorOp op, bool aVec, bool bVec>
+    static void BinaryWithScaling(size_t rows, size_t cols, const ElemType* a, ptrdiff_t lda, const ElemType* b, ptrdiff_t ldb, ElemType* c, ptrdiff_t ldc, ElemType alpha, ElemType beta)
+    {
+        switch (ScalingFor(alpha, beta))
+        {
+        case noScaling:        return BinaryLoop<op, aVec, bVec, noScaling>(rows, cols, a, lda, b, ldb, c, ldc, alpha, beta);
+        case alphaScaling:     return BinaryLoop<op, aVec, bVec, alphaScaling>(rows, cols, a, lda, b, ldb, c, ldc, alpha, beta);
+        case alphaBetaScaling: return BinaryLoop<op, aVec, bVec, alphaBetaScaling>(rows, cols, a, lda, b, ldb, c, ldc, alpha, beta);
+        }
+    }
+
+    template <VectorOp op>
+    static void BinaryWithBroadcasting(size_t rows, size_t cols, const ElemType* a, ptrdiff_t aInc, ptrdiff_t lda, const ElemType* b, ptrdiff_t bInc, ptrdiff_t ldb, ElemType* c, ptrdiff_t ldc, ElemType alpha, ElemType beta)
+    {
+        if (aInc && bInc)
+            BinaryWithScaling<op, true, true>(rows, cols, a, lda, b, ldb, c, ldc, alpha, beta);
+        else if (aInc)
+            BinaryWithScaling<op, true, false>(rows, cols, a, lda, b, ldb, c, ldc, alpha, beta);
+        else if (bInc)
+            BinaryWithScaling<op, false, true>(rows, cols, a, lda, b, ldb, c, ldc, alpha, beta);
+        else
+            BinaryWithScaling<op, false, false>(rows, cols, a, lda, b, ldb, c, ldc, alpha, beta);
+    }
+
+    static void ElementwiseBinary(VectorOp op, size_t rows, size_t cols,
+                                  const ElemType* a, ptrdiff_t aInc, ptrdiff_t lda,
+                                  const ElemType* b, ptrdiff_t bInc, ptrdiff_t ldb,
+                                  ElemType* c, ptrdiff_t ldc, ElemType alpha, ElemType beta)
+    {
+        switch (op)
+        {
+        case VectorOp::Sum:                return BinaryWithBroadcasting<VectorOp::Sum>(rows, cols, a, aInc, lda, b, bInc, ldb, c, ldc, alpha, beta);
+        case VectorOp::Difference:         return BinaryWithBroadcasting<VectorOp::Difference>(rows, cols, a, aInc, lda, b, bInc, ldb, c, ldc, alpha, beta);
+        case VectorOp::ElementwiseProduct: return BinaryWithBroadcasting<VectorOp::ElementwiseProduct>(rows, cols, a, aInc, lda, b, bInc, ldb, c, ldc, alpha, beta);
+        case VectorOp::Max:                return BinaryWithBroadcasting<VectorOp::Max>(rows, cols, a, aInc, lda, b, bInc, ldb, c, ldc, alpha, beta);
+        case VectorOp::Min:                return BinaryWithBroadcasting<VectorOp::Min>(rows, cols, a, aInc, lda, b, bInc, ldb, c, ldc, alpha, beta);
+        default:                           return;
+        }
+    }
+
+    // unary ops are binary ops that ignore their second argument; pass 'a' for it to keep the loads in bounds
+    static void ElementwiseUnary(VectorOp op, size_t rows, size_t cols,
+                                 const ElemType* a, ptrdiff_t aInc, ptrdiff_t lda,
+                                 ElemType* c, ptrdiff_t ldc, ElemType alpha, ElemType beta)
+    {
+        switch (op)
+        {
+        case VectorOp::Copy:            return BinaryWithBroadcasting<VectorOp::Copy>(rows, cols, a, aInc, lda, a, 0, lda, c, ldc, alpha, beta);
+        case VectorOp::LinearRectifier: return BinaryWithBroadcasting<VectorOp::LinearRectifier>(rows, cols, a, aInc, lda, a, 0, lda, c, ldc, alpha, beta);
+        default:                        return;
+        }
+    }
+
+    // --- reductions
+
+    // reduce a contiguous vector of n >= 1 elements
+    template <VectorOp op>
+    static ElemType ReduceContiguous(const ElemType* a, size_t n)
+    {
+        size_t i = 0;
+        if (op == VectorOp::Sum)
+        {
+            // two accumulators to hide the latency of the additions
+            typename V::SumAcc acc0 = V::ZeroSum(), acc1 = V::ZeroSum();
+            for (; i + 2 * width <= n; i += 2 * width)
+            {
+                acc0 = V::AddToSum(acc0, V::Load(a + i));
+                acc1 = V::AddToSum(acc1, V::Load(a + i + width));
+            }
+            for (; i + width <= n; i += width)
+                acc0 = V::AddToSum(acc0, V::Load(a + i));
+            double sum = V::HorizontalSum(acc0) + V::HorizontalSum(acc1);
+            for (; i < n; i++)
+                sum += a[i];
+            return (ElemType) sum;
+        }
+        else // Max, Min
+        {
+            ElemType result = a[0];
+            if (n >= width)
+            {
+                Vec acc = V::Load(a);
+                for (i = width; i + width <= n; i += width)
+                    acc = Apply<op>(acc, V::Load(a + i));
+                result = op == VectorOp::Max ? V::HorizontalMax(acc) : V::HorizontalMin(acc);
+            }
+            else
+                i = 1;
+            for (; i < n; i++)
+                result = Apply<op>(result, a[i]);
+            return result;
+        }
+    }
+
+    template <VectorOp op>
+    static void ReduceRowsFor(size_t rows, size_t cols, const ElemType* a, ptrdiff_t lda, ElemType* c, ptrdiff_t cInc, ElemType alpha, ElemType beta)
+    {
+#pragma omp parallel for if (cols > 1 && rows * cols >= 4 * blockSize)
+        for (long long j = 0; j < (long long) cols; j++)
+        {
+            ElemType* pc = c + j * cInc;
+            ElemType val = ReduceContiguous<op>(a + j * lda, rows) * alpha;
+            if (beta != 0)
+                val += beta * *pc;
+            *pc = val;
+        }
+    }
+
+    static void ReduceRows(VectorOp op, size_t rows, size_t cols, const ElemType* a, ptrdiff_t lda, ElemType* c, ptrdiff_t cInc, ElemType alpha, ElemType beta)
+    {
+        switch (op)
+        {
+        case VectorOp::Sum: return ReduceRowsFor<VectorOp::Sum>(rows, cols, a, lda, c, cInc, alpha, beta);
+        case VectorOp::Max: return ReduceRowsFor<VectorOp::Max>(rows, cols, a, lda, c, cInc, alpha, beta);
+        case VectorOp::Min: return ReduceRowsFor<VectorOp::Min>(rows, cols, a, lda, c, cInc, alpha, beta);
+        default:            return;
+        }
+    }
+
+    // reduce over the columns for one vector's worth of rows starting at a (vectorized across the rows)
+    template <VectorOp op>
+    static Vec ReduceColumnsOfVector(const ElemType* a, size_t cols, ptrdiff_t lda)
+    {
+        if (op == VectorOp::Sum)
+        {
+            typename V::SumAcc acc = V::ZeroSum();
+            for (size_t j = 0; j < cols; j++)
+                acc = V::AddToSum(acc, V::Load(a + j * lda));
+            return V::SumToVec(acc);
+        }
+        else
+        {
+            Vec acc = V::Load(a);
+            for (size_t j = 1; j < cols; j++)
+                acc = Apply<op>(acc, V::Load(a + j * lda));
+            return acc;
+        }
+    }
+
+    template <VectorOp op>
+    static void ReduceColumnsFor(size_t rows, size_t cols, const ElemType* a, ptrdiff_t lda, ElemType* c, ElemType alpha, ElemType beta)
+    {
+        const Vec valpha = V::Set1(alpha), vbeta = V::Set1(beta);
+        const long long numVectors = (long long) (rows / width);
+#pragma omp parallel for if (numVectors > 1 && rows * cols >= 4 * blockSize)
+        for (long long v = 0; v < numVectors; v++)
+        {
+            const size_t i = (size_t) v * width;
+            Vec val = V::Mul(ReduceColumnsOfVector<op>(a + i, cols, lda), valpha);
+            if (beta != 0)
+                val = V::Add(val, V::Mul(vbeta, V::Load(c + i)));
+            V::Store(c + i, val);
+        }
+        // remaining rows
+        for (size_t i = (size_t) numVectors * width; i < rows; i++)
+        {
+            double agg = a[i];
+            for (size_t j = 1; j < cols; j++)
+                agg = op == VectorOp::Sum ? agg + a[i + j * lda] : (double) Apply<op>((ElemType) agg, a[i + j * lda]);
+            ElemType val = (ElemType) agg * alpha;
+            if (beta != 0)
+                val += beta * c[i];
+            c[i] = val;
+        }
+    }
+
+    static void ReduceColumns(VectorOp op, size_t rows, size_t cols, const ElemType* a, ptrdiff_t lda, ElemType* c, ElemType alpha, ElemType beta)
+    {
+        switch (op)
+        {
+        case VectorOp::Sum: return ReduceColumnsFor<VectorOp::Sum>(rows, cols, a, lda, c, alpha, beta);
+        case VectorOp::Max: return ReduceColumnsFor<VectorOp::Max>(rows, cols, a, lda, c, alpha, beta);
+        case VectorOp::Min: return ReduceColumnsFor<VectorOp::Min>(rows, cols, a, lda, c, alpha, beta);
+        default:            return;
+        }
+    }
+};
+
+#endif // CNTK_VECTOR_KERNELS_IMPLEMENTATION
+
+}}}
@@ -0,0 +1,249 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUVectorKernelsAVX2.cpp -- the kernels of CPUVectorKernels.h for AVX2
+//
+// This file is compiled with AVX2 code generation enabled (-mavx2 -mfma, /arch:AVX2). Its functions must only be
+// called after CPUID has confirmed AVX2 support, hence it must not include any other CNTK headers (see CPUVectorKernels.h).
+//
+
+#define CNTK_VECTOR_KERNELS_IMPLEMENTATION
+#include "CPUVectorKernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+#ifdef __AVX2__
+
+struct AVX2Float
+{
+    typedef float ElemType;
+    typedef __m256 Vec;
+    static const size_t width = 8;
+
+    static Vec Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static Vec Set1(float x) { return _mm256_set1_ps(x); }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec Sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+
+    static float HorizontalMax(Vec v)
+    {
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+    static float HorizontalMin(Vec v)
+    {
+        __m128 m = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+
+    struct SumAcc { __m256d lo, hi; };
+    static SumAcc ZeroSum() { SumAcc s = { _mm256_setzero_pd(), _mm256_setzero_pd() }; return s; }
+    static SumAcc AddToSum(SumAcc s, Vec v)
+    {
+        s.lo = _mm256_add_pd(s.lo, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        s.hi = _mm256_add_pd(s.hi, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+        return s;
+    }
+    static Vec SumToVec(SumAcc s) { return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(s.lo)), _mm256_cvtpd_ps(s.hi), 1); }
+    static double HorizontalSum(SumAcc s)
+    {
+        __m256d t = _mm256_add_pd(s.lo, s.hi);
+        __m128d m = _mm_add_pd(_mm256_castpd256_pd128(t), _mm256_extractf128_pd(t, 1));
+        m = _mm_add_sd(m, _mm_unpackhi_pd(m, m));
+        return _mm_cvtsd_f64(m);
+    }
+};
+
+struct AVX2Double
+{
+    typedef double ElemType;
+    typedef __m256d Vec;
+    static const size_t width = 4;
+
+    static Vec Load(const double* p) { return _mm256_loadu_pd(p); }
+    static void Store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    static Vec Set1(double x) { return _mm256_set1_pd(x); }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Vec Sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+
+    static double HorizontalMax(Vec v)
+    {
+        __m128d m = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        m = _mm_max_sd(m, _mm_unpackhi_pd(m, m));
+        return _mm_cvtsd_f64(m);
+    }
+    static double HorizontalMin(Vec v)
+    {
+        __m128d m = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        m = _mm_min_sd(m, _mm_unpackhi_pd(m, m));
+        return _mm_cvtsd_f64(m);
+    }
+
+    typedef __m256d SumAcc;
+    static SumAcc ZeroSum() { return _mm256_setzero_pd(); }
+    static SumAcc AddToSum(SumAcc s, Vec v) { return _mm256_add_pd(s, v); }
+    static Vec SumToVec(SumAcc s) { return s; }
+    static double HorizontalSum(SumAcc s)
+    {
+        __m128d m = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+        m = _mm_add_sd(m, _mm_unpackhi_pd(m, m));
+        return _mm_cvtsd_f64(m);
+    }
+};
+
+// The int8 and uint8 values are widened to int16, so that the pairwise multiply-adds into int32 cannot saturate.
+template <size_t numColumns>
+static void Int8DotProductsFor(const int8_t* a, const uint8_t* b, size_t ldb, size_t k, int32_t* sums)
+{
+    __m256i acc[numColumns];
+    for (size_t q = 0; q < numColumns; q++)
+        acc[q] = _mm256_setzero_si256();
+    size_t l = 0;
+    for (; l + 16 <= k; l += 16)
+    {
+        const __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a + l)));
+        for (size_t q = 0; q < numColumns; q++)
+        {
+            const __m256i vb = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*) (b + q * ldb + l)));
+            acc[q] = _mm256_add_epi32(acc[q], _mm256_madd_epi16(va, vb));
+        }
+    }
+    for (size_t q = 0; q < numColumns; q++)
+    {
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc[q]), _mm256_extracti128_si256(acc[q], 1));
+        s = _mm_hadd_epi32(s, s);
+        s = _mm_hadd_epi32(s, s);
+        int32_t sum = _mm_cvtsi128_si32(s);
+        for (size_t i = l; i < k; i++)
+            sum += (int32_t) a[i] * (int32_t) b[q * ldb + i];
+        sums[q] = sum;
+    }
+}
+
+static void Int8DotProducts(const int8_t* a, const uint8_t* b, size_t ldb, size_t numColumns, size_t k, int32_t* sums)
+{
+    switch (numColumns)
+    {
+    case 1:  return Int8DotProductsFor<1>(a, b, ldb, k, sums);
+    case 2:  return Int8DotProductsFor<2>(a, b, ldb, k, sums);
+    case 3:  return Int8DotProductsFor<3>(a, b, ldb, k, sums);
+    default: return Int8DotProductsFor<4>(a, b, ldb, k, sums);
+    }
+}
+
+// a bfloat16 is the upper half of a float, so 8 of them are widened by zero-extending them to 32 bits and shifting them up
+static inline __m256 LoadBFloat16(const uint16_t* p)
+{
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*) p)), 16));
+}
+
+// The 16 rows of c are held in two registers per column, so each widened column of a is used for all columns of b.
+template <size_t numColumns>
+static void BFloat16MultiplyFor(const uint16_t* a, size_t lda, const float* b, size_t ldb, size_t k, float* c, size_t ldc, bool accumulate)
+{
+    __m256 acc0[numColumns], acc1[numColumns];
+    for (size_t q = 0; q < numColumns; q++)
+    {
+        acc0[q] = _mm256_setzero_ps();
+        acc1[q] = _mm256_setzero_ps();
+    }
+    for (size_t l = 0; l < k; l++)
+    {
+        const __m256 va0 = LoadBFloat16(a + l * lda);
+        const __m256 va1 = LoadBFloat16(a + l * lda + 8);
+        for (size_t q = 0; q < numColumns; q++)
+        {
+            const __m256 vb = _mm256_broadcast_ss(b + q * ldb + l);
+            acc0[q] = _mm256_fmadd_ps(va0, vb, acc0[q]);
+            acc1[q] = _mm256_fmadd_ps(va1, vb, acc1[q]);
+        }
+    }
+    for (size_t q = 0; q < numColumns; q++)
+    {
+        float* column = c + q * ldc;
+        if (accumulate)
+        {
+            acc0[q] = _mm256_add_ps(acc0[q], _mm256_loadu_ps(column));
+            acc1[q] = _mm256_add_ps(acc1[q], _mm256_loadu_ps(column + 8));
+        }
+        _mm256_storeu_ps(column, acc0[q]);
+        _mm256_storeu_ps(column + 8, acc1[q]);
+    }
+}
+
+static void BFloat16Multiply(const uint16_t* a, size_t lda, const float* b, size_t ldb, size_t numColumns, size_t k, float* c, size_t ldc, bool accumulate)
+{
+    switch (numColumns)
+    {
+    case 1:  return BFloat16MultiplyFor<1>(a, lda, b, ldb, k, c, ldc, accumulate);
+    case 2:  return BFloat16MultiplyFor<2>(a, lda, b, ldb, k, c, ldc, accumulate);
+    case 3:  return BFloat16MultiplyFor<3>(a, lda, b, ldb, k, c, ldc, accumulate);
+    default: return BFloat16MultiplyFor<4>(a, lda, b, ldb, k, c, ldc, accumulate);
+    }
+}
+
+template <>
+const CPUVectorKernelTable<float>* GetAVX2VectorKernels<float>()
+{
+    return &VectorKernels<AVX2Float>::Table();
+}
+
+template <>
+const CPUVectorKernelTable<double>* GetAVX2VectorKernels<double>()
+{
+    return &VectorKernels<AVX2Double>::Table();
+}
+
+Int8DotProductsKernel GetAVX2Int8DotProducts()
+{
+    return &Int8DotProducts;
+}
+
+BFloat16MultiplyKernel GetAVX2BFloat16Multiply()
+{
+    return &BFloat16Multiply;
+}
+
+#else // compiler not set up for AVX2 (e.g. non-x86 builds)
+
+template <>
+const CPUVectorKernelTable<float>* GetAVX2VectorKernels<float>()
+{
+    return nullptr;
+}
+
+template <>
+const CPUVectorKernelTable<double>* GetAVX2VectorKernels<double>()
+{
+    return nullptr;
+}
+
+Int8DotProductsKernel GetAVX2Int8DotProducts()
+{
+    return nullptr;
+}
+
+BFloat16MultiplyKernel GetAVX2BFloat16Multiply()
+{
+    return nullptr;
+}
+
+#endif
+
+}}}
@@ -0,0 +1,108 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// CPUVectorKernelsAVX512.cpp -- the kernels of CPUVectorKernels.h for AVX-512
+//
+// This file is compiled with AVX-512 code generation enabled (-mavx512f, /arch:AVX512). Its functions must only be called after
+// CPUID has confirmed AVX-512 support, hence it must not include any other CNTK headers (see CPUVectorKernels.h).
+//
+
+#define CNTK_VECTOR_KERNELS_IMPLEMENTATION
+#include "CPUVectorKernels.h"
+
+#ifdef __AVX512F__
+#include <immintrin.h>
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+#ifdef __AVX512F__
+
+struct AVX512Float
+{
+    typedef float ElemType;
+    typedef __m512 Vec;
+    static const size_t width = 16;
+
+    static Vec Load(const float* p) { return _mm512_loadu_ps(p); }
+    static void Store(float* p, Vec v) { _mm512_storeu_ps(p, v); }
+    static Vec Set1(float x) { return _mm512_set1_ps(x); }
+    static Vec Add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+    static Vec Sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm512_max_ps(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm512_min_ps(a, b); }
+    static float HorizontalMax(Vec v) { return _mm512_reduce_max_ps(v); }
+    static float HorizontalMin(Vec v) { return _mm512_reduce_min_ps(v); }
+
+    struct SumAcc { __m512d lo, hi; };
+    static SumAcc ZeroSum() { SumAcc s = { _mm512_setzero_pd(), _mm512_setzero_pd() }; return s; }
+    static __m256 UpperHalf(Vec v) { return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)); }
+    static SumAcc AddToSum(SumAcc s, Vec v)
+    {
+        s.lo = _mm512_add_pd(s.lo, _mm512_cvtps_pd(_mm512_castps512_ps256(v)));
+        s.hi = _mm512_add_pd(s.hi, _mm512_cvtps_pd(UpperHalf(v)));
+        return s;
+    }
+    static Vec SumToVec(SumAcc s)
+    {
+        __m512d lo = _mm512_castps_pd(_mm512_castps256_ps512(_mm512_cvtpd_ps(s.lo)));
+        return _mm512_castpd_ps(_mm512_insertf64x4(lo, _mm256_castps_pd(_mm512_cvtpd_ps(s.hi)), 1));
+    }
+    static double HorizontalSum(SumAcc s) { return _mm512_reduce_add_pd(_mm512_add_pd(s.lo, s.hi)); }
+};
+
+struct AVX512Double
+{
+    typedef double ElemType;
+    typedef __m512d Vec;
+    static const size_t width = 8;
+
+    static Vec Load(const double* p) { return _mm512_loadu_pd(p); }
+    static void Store(double* p, Vec v) { _mm512_storeu_pd(p, v); }
+    static Vec Set1(double x) { return _mm512_set1_pd(x); }
+    static Vec Add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static Vec Sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm512_max_pd(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm512_min_pd(a, b); }
+    static double HorizontalMax(Vec v) { return _mm512_reduce_max_pd(v); }
+    static double HorizontalMin(Vec v) { return _mm512_reduce_min_pd(v); }
+
+    typedef __m512d SumAcc;
+    static SumAcc ZeroSum() { return _mm512_setzero_pd(); }
+    static SumAcc AddToSum(SumAcc s, Vec v) { return _mm512_add_pd(s, v); }
+    static Vec SumToVec(SumAcc s) { return s; }
+    static double HorizontalSum(SumAcc s) { return _mm512_reduce_add_pd(s); }
+};
+
+template <>
+const CPUVectorKernelTable<float>* GetAVX512VectorKernels<float>()
+{
+    return &VectorKernels<AVX512Float>::Table();
+}
+
+template <>
+const CPUVectorKernelTable<double>* GetAVX512VectorKernels<double>()
+{
+    return &VectorKernels<AVX512Double>::Table();
+}
+
+#else // compiler not set up for AVX-512 (e.g. non-x86 builds, or compilers without AVX-512 code generation)
+
+template <>
+const CPUVectorKernelTable<float>* GetAVX512VectorKernels<float>()
+{
+    return nullptr;
+}
+
+template <>
+const CPUVectorKernelTable<double>* GetAVX512VectorKernels<double>()
+{
+    return nullptr;
+}
+
+#endif
+
+}}}
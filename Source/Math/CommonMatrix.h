@@ -15,6 +15,7 @@
 
 #include "Basics.h"
 #include "basetypes.h"
+#include "CPUArenaAllocator.h"
 #include <string>
 #include <stdint.h>
 #include <memory>
@@ -190,6 +191,26 @@ enum ElementWiseOperator
     Macro(ElementwiseProductWithPowExponentDerivative); \
     Macro(ElementwiseProductWithPowBaseDerivative);
 
+// -----------------------------------------------------------------------
+// FusedElementwiseStep -- one step of a chain of elementwise operations that
+// is computed in a single pass over memory (see Matrix::FusedElementwiseOf()).
+// The chain starts out with the value of operand 0. Each step then applies a
+// unary op to the running value, or a binary op between the running value and
+// another operand.
+// -----------------------------------------------------------------------
+
+struct FusedElementwiseStep
+{
+    ElementWiseOperator op; // a unary op (ForAllUnaryOps) if operand < 0, else a binary op (ForAllBinaryOps)
+    int operand;            // index of the second argument of a binary op; -1 for unary ops
+    bool runningValueFirst; // for binary ops: whether the running value is the first argument (matters for e.g. opDifference)
+
+    FusedElementwiseStep(ElementWiseOperator op, int operand = -1, bool runningValueFirst = true)
+        : op(op), operand(operand), runningValueFirst(runningValueFirst)
+    {
+    }
+};
+
 // -----------------------------------------------------------------------
 // various enums to describe
 // -----------------------------------------------------------------------
@@ -268,7 +289,7 @@ public:
         {
             if (m_computeDevice < 0)
             {
-                delete[] m_pArray;
+                CPUArenaAllocator::Instance().Free(m_pArray); // CPU value buffers, dense or sparse, come from the arena
                 m_pArray = nullptr;
                 m_nzValues = nullptr;
 
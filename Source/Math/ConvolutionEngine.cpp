@@ -6,6 +6,7 @@
 #include "stdafx.h"
 #include "ConvolutionEngine.h"
 #include "CuDnnFactories.h"
+#include "CPUConvolutionKernels.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -854,6 +855,251 @@ public:
     }
 };
 
+// Workspace budget for the transformed tiles of a Winograd block, and the smallest block that
+// still keeps the GEMMs in the transformed domain efficient.
+static const size_t winogradBlockBytes = 4 * 1024 * 1024;
+static const size_t minWinogradBlockTiles = 64;
+
+//------------------------------------------------------------------
+// Direct convolution engine implementation.
+// CPU-only engine for the 2D convolutions that dominate CNN evaluation, computed without
+// the unrolled input that the GEMM engine materializes:
+// - 3x3 kernels with stride 1 use Winograd minimal filtering F(4x4, 3x3), or F(2x2, 3x3) for small outputs
+//   (Fast Algorithms for Convolutional Neural Networks; Lavin, Gray).
+// - 1x1 kernels are a single GEMM per sample if they have stride 1 and no padding, and cache-blocked
+//   direct loops otherwise.
+// - Depthwise convolutions (kernel depth 1, no weight sharing along the channel dimension) use direct loops.
+// Backpropagation of the 3x3 and strided 1x1 convolutions is done by the GEMM engine.
+// Uses reference engine for pooling operations.
+//------------------------------------------------------------------
+template <class ElemType>
+class DirectConvolutionEngine : public GemmConvolutionEngine<ElemType>
+{
+public:
+    using Base = GemmConvolutionEngine<ElemType>;
+    using typename Base::Mat;
+
+public:
+    DirectConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind, bool poolIncludePad)
+        : Base(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, poolIncludePad)
+    {
+        m_algo = Analyze(*geometry, m_geom);
+    }
+
+protected:
+    using Base::IsGpu;
+
+    using Base::m_geometry;
+    using Base::m_deviceId;
+    using Base::m_imageLayout;
+
+    enum class Algo
+    {
+        None,
+        Winograd,
+        Pointwise,
+        Depthwise
+    };
+
+    void EnsureCompatible() override
+    {
+        if (m_imageLayout != ImageLayoutKind::CHW)
+            LogicError("Direct convolution engine supports only CHW/cudnn layout.");
+        if (IsGpu(m_deviceId))
+            LogicError("Direct convolution engine supports only CPU device.");
+        if (m_algo == Algo::None)
+            LogicError("Direct convolution engine does not support this convolution configuration. Geometry: %s", ((string)*m_geometry).c_str());
+    }
+
+    void ForwardCore(const Mat& in, const Mat& kernel, Mat& out, Mat& workspace) override
+    {
+        switch (m_algo)
+        {
+        case Algo::Winograd:
+            WinogradForward(in, kernel, out, workspace);
+            break;
+        case Algo::Pointwise:
+            if (IsPlainPointwise())
+                PlainPointwiseForward(in, kernel, out);
+            else
+                Kernels::PointwiseForward(m_geom, in.Data(), kernel.Data(), out.Data(), in.GetNumCols());
+            break;
+        case Algo::Depthwise:
+            Kernels::DepthwiseForward(m_geom, in.Data(), kernel.Data(), out.Data(), in.GetNumCols());
+            break;
+        default:
+            LogicError("Direct convolution engine: unexpected algorithm.");
+        }
+    }
+
+    void BackwardDataCore(const Mat& srcGrad, const Mat& kernel, Mat& grad, bool accumulateGradient, Mat& workspace) override
+    {
+        if (m_algo == Algo::Depthwise)
+            Kernels::DepthwiseBackwardData(m_geom, srcGrad.Data(), kernel.Data(), grad.Data(), srcGrad.GetNumCols());
+        else if (m_algo == Algo::Pointwise && IsPlainPointwise())
+        {
+            // [WH x K] * [C x K]^T -> [WH x C], for each sample.
+            auto kern = PointwiseKernel(kernel);
+            for (size_t n = 0; n < srcGrad.GetNumCols(); n++)
+            {
+                auto srcGradSlice = SampleAsMatrix(srcGrad, n, m_geom.outC);
+                auto gradSlice = SampleAsMatrix(grad, n, m_geom.inC);
+                Mat::MultiplyAndAdd(srcGradSlice, false, kern, true, gradSlice);
+            }
+        }
+        else
+            Base::BackwardDataCore(srcGrad, kernel, grad, accumulateGradient, workspace);
+    }
+
+    void BackwardKernelCore(const Mat& srcGrad, const Mat& in, Mat& kernelGrad, bool accumulateGradient, bool allowReuse, Mat& workspace) override
+    {
+        if (m_algo == Algo::Depthwise)
+            Kernels::DepthwiseBackwardKernel(m_geom, srcGrad.Data(), in.Data(), kernelGrad.Data(), srcGrad.GetNumCols());
+        else if (m_algo == Algo::Pointwise && IsPlainPointwise())
+        {
+            // [WH x C]^T * [WH x K] -> [C x K], summed over the samples.
+            auto kernGrad = PointwiseKernel(kernelGrad);
+            for (size_t n = 0; n < srcGrad.GetNumCols(); n++)
+            {
+                auto inSlice = SampleAsMatrix(in, n, m_geom.inC);
+                auto srcGradSlice = SampleAsMatrix(srcGrad, n, m_geom.outC);
+                Mat::MultiplyAndAdd(inSlice, true, srcGradSlice, false, kernGrad);
+            }
+        }
+        else
+            Base::BackwardKernelCore(srcGrad, in, kernelGrad, accumulateGradient, allowReuse, workspace);
+    }
+
+    // The Winograd forward method processes the tiles of the whole minibatch in blocks whose transformed
+    // inputs and outputs fit into a few MB of workspace:
+    // 1. Transform the kernels once: [XYC x K] -> alpha^2 x [K x C].
+    // 2. For each block of P tiles, transform the input tiles: alpha^2 x [C x P].
+    // 3. Multiply in the transformed domain: alpha^2 x ([K x C] * [C x P] -> [K x P]).
+    // 4. Transform back and write the m x m output tiles.
+    void WinogradForward(const Mat& in, const Mat& kernel, Mat& out, Mat& workspace)
+    {
+        const size_t batchSize = in.GetNumCols();
+        const size_t tileSize = min(m_geom.outW, m_geom.outH) >= 4 ? 4 : 2;
+        const size_t alpha = Kernels::WinogradAlpha(tileSize);
+        const size_t alpha2 = alpha * alpha;
+        const size_t C = m_geom.inC;
+        const size_t K = m_geom.outC;
+        const size_t numTiles = Kernels::WinogradTilesPerSample(tileSize, m_geom) * batchSize;
+        const size_t bytesPerTile = alpha2 * (C + K) * sizeof(ElemType);
+        const size_t blockTiles = min(numTiles, max(minWinogradBlockTiles, winogradBlockBytes / bytesPerTile));
+
+        workspace.Resize(1, alpha2 * (K * C + blockTiles * (C + K)));
+        ElemType* u = workspace.Data();
+        ElemType* v = u + alpha2 * K * C;
+        ElemType* m = v + alpha2 * C * blockTiles;
+        Kernels::WinogradTransformKernel(tileSize, m_geom, kernel.Data(), u);
+
+        for (size_t first = 0; first < numTiles; first += blockTiles)
+        {
+            size_t curTiles = min(blockTiles, numTiles - first);
+            Kernels::WinogradTransformInput(tileSize, m_geom, in.Data(), first, curTiles, v);
+            for (size_t xi = 0; xi < alpha2; xi++)
+            {
+                auto uSlice = workspace.ColumnSlice(xi * K * C, K * C);
+                uSlice.Reshape(K, C);
+                auto vSlice = workspace.ColumnSlice(alpha2 * K * C + xi * C * curTiles, C * curTiles);
+                vSlice.Reshape(C, curTiles);
+                auto mSlice = workspace.ColumnSlice(alpha2 * (K * C + C * blockTiles) + xi * K * curTiles, K * curTiles);
+                mSlice.Reshape(K, curTiles);
+                Mat::Multiply(uSlice, false, vSlice, false, mSlice);
+            }
+            Kernels::WinogradTransformOutput(tileSize, m_geom, m, first, curTiles, out.Data());
+        }
+    }
+
+    // 1x1 convolution with stride 1 and no padding: [WH x C] * [C x K] -> [WH x K], for each sample.
+    void PlainPointwiseForward(const Mat& in, const Mat& kernel, Mat& out)
+    {
+        auto kern = PointwiseKernel(kernel);
+        for (size_t n = 0; n < in.GetNumCols(); n++)
+        {
+            auto inSlice = SampleAsMatrix(in, n, m_geom.inC);
+            auto outSlice = SampleAsMatrix(out, n, m_geom.outC);
+            Mat::Multiply(inSlice, false, kern, false, outSlice);
+        }
+    }
+
+    bool IsPlainPointwise() const
+    {
+        return m_geom.strideW == 1 && m_geom.strideH == 1 && m_geom.padW == 0 && m_geom.padH == 0 &&
+               m_geom.outW == m_geom.inW && m_geom.outH == m_geom.inH;
+    }
+
+    // cudnn layout uses row-major kernel weight matrix, i.e. a 1x1 kernel is a [C x K] column-major matrix.
+    Mat PointwiseKernel(const Mat& kernel) const
+    {
+        auto kern = kernel.ColumnSlice(0, kernel.GetNumCols());
+        kern.Reshape(m_geom.inC, m_geom.outC);
+        return kern;
+    }
+
+    // sample n of a minibatch of [W x H x C] images, as a [WH x C] matrix
+    static Mat SampleAsMatrix(const Mat& mat, size_t n, size_t channels)
+    {
+        auto slice = mat.ColumnSlice(n, 1);
+        slice.Reshape(mat.GetNumRows() / channels, channels);
+        return slice;
+    }
+
+    // Finds the algorithm for the geometry and describes the geometry as a 2D convolution.
+    static Algo Analyze(const ConvolveGeometry& geometry, CPUConv2DGeometry& g)
+    {
+        const auto& inT = geometry.InputShape();
+        const auto& kernT = geometry.KernelShape();
+        const auto& outT = geometry.OutputShape();
+        if (inT.GetRank() != 3 || kernT.GetRank() != 3 || outT.GetRank() != 3 ||
+            !geometry.GetSharing(0) || !geometry.GetSharing(1) || geometry.GetMapCount(0) != 1 || geometry.GetMapCount(1) != 1)
+            return Algo::None;
+
+        g.inW = inT[0];
+        g.inH = inT[1];
+        g.inC = inT[2];
+        g.outW = outT[0];
+        g.outH = outT[1];
+        g.outC = outT[2];
+        g.kernelW = kernT[0];
+        g.kernelH = kernT[1];
+        g.strideW = geometry.GetStride(0);
+        g.strideH = geometry.GetStride(1);
+        g.padW = geometry.GetLowerPad(0);
+        g.padH = geometry.GetLowerPad(1);
+
+        const size_t mapCount = geometry.GetMapCount(2);
+        if (kernT[2] == g.inC && g.outC == mapCount && geometry.KernelCount() == mapCount)
+        {
+            // Regular convolution: each kernel spans all input channels.
+            if (g.kernelW == 3 && g.kernelH == 3 && g.strideW == 1 && g.strideH == 1)
+                return Algo::Winograd;
+            if (g.kernelW == 1 && g.kernelH == 1)
+                return Algo::Pointwise;
+        }
+        else if (kernT[2] == 1 && g.outC == g.inC * mapCount && !geometry.GetSharing(2) &&
+                 geometry.GetStride(2) == 1 && geometry.GetLowerPad(2) == 0 && geometry.KernelCount() == g.outC)
+        {
+            return Algo::Depthwise;
+        }
+        return Algo::None;
+    }
+
+public:
+    static bool IsSupported(DEVICEID_TYPE deviceId, ConvolveGeometryPtr geometry)
+    {
+        CPUConv2DGeometry g;
+        return deviceId < 0 && Analyze(*geometry, g) != Algo::None;
+    }
+
+private:
+    using Kernels = CPUConvolutionKernels<ElemType>;
+
+    Algo m_algo;
+    CPUConv2DGeometry m_geom;
+};
+
 template <class ElemType>
 std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId,
                                                                                  ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind,
@@ -892,6 +1138,14 @@ std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create
                                                                forceDeterministicAlgorithms, poolIncludePad, inputHasFreeDimension);
     }
 
+    if (isEnabled(ConvolutionEngineKind::Direct) && DirectConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
+    {
+        if (GetMathLibTraceLevel() > 0)
+            fprintf(stderr, "%lsusing direct convolution engine for geometry: %s.\n", logPrefix.c_str(), engStr.c_str());
+
+        return std::make_unique<DirectConvolutionEngine<ElemType>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, poolIncludePad);
+    }
+
     if (isEnabled(ConvolutionEngineKind::Gemm) && GemmConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
     {
         if (GetMathLibTraceLevel() > 0)
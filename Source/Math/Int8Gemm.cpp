@@ -0,0 +1,149 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Int8Gemm.cpp -- quantization to 8 bits and the uint8 x int8 matrix product
+//
+
+#include "stdafx.h"
+#include "Int8Gemm.h"
+#include "CPUTensorKernels.h" // for GetCPUVectorExtension()
+#include "CPUVectorKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// quantization runs in parallel once there are at least this many elements
+static const size_t minParallelQuantizeElements = 65536;
+
+// the product runs in parallel once it has at least this many multiply-adds
+static const size_t minParallelMultiplyOps = 1 << 20;
+
+// number of rows of a whose dot products with a group of columns of b are computed by one task, so that the columns stay in cache
+static const int multiplyRowBlock = 32;
+
+// number of columns of b that each row of a is multiplied with at once, which is what the dot product kernels support
+static const int multiplyColumnGroup = 4;
+
+static void VerifyInt8InnerDimension(const char* function, int k)
+{
+    if (k > maxInt8InnerDimension)
+        InvalidArgument("%s: The inner dimension %d exceeds %d, beyond which the int32 accumulation of an int8 product may overflow.", function, k, maxInt8InnerDimension);
+}
+
+template <class ElemType>
+static void QuantizeInt8RowsImpl(int m, int k, const ElemType* a, int8_t* rows, float* scales, int32_t* rowSums)
+{
+    VerifyInt8InnerDimension("QuantizeInt8Rows", k);
+#pragma omp parallel for if ((size_t) m * k >= minParallelQuantizeElements)
+    for (long i = 0; i < m; i++)
+    {
+        float maxAbs = 0;
+        for (int l = 0; l < k; l++)
+            maxAbs = std::max(maxAbs, (float) std::fabs(a[i + (size_t) l * m]));
+        float scale = maxAbs > 0 ? maxAbs / 127 : 1;
+        int8_t* row = rows + (size_t) i * k;
+        int32_t sum = 0;
+        for (int l = 0; l < k; l++)
+        {
+            int q = (int) std::lround((float) a[i + (size_t) l * m] / scale);
+            row[l] = (int8_t) std::max(-127, std::min(127, q));
+            sum += row[l];
+        }
+        scales[i] = scale;
+        rowSums[i] = sum;
+    }
+}
+
+// The range of each column is extended to include 0, so that zero (e.g. padding or ReLU output) is quantized exactly.
+template <class ElemType>
+static void QuantizeUInt8ColumnsImpl(int k, int n, const ElemType* b, uint8_t* columns, float* scales, int32_t* zeroPoints)
+{
+#pragma omp parallel for if ((size_t) n * k >= minParallelQuantizeElements)
+    for (long j = 0; j < n; j++)
+    {
+        const ElemType* in = b + (size_t) j * k;
+        float lo = 0, hi = 0;
+        for (int l = 0; l < k; l++)
+        {
+            lo = std::min(lo, (float) in[l]);
+            hi = std::max(hi, (float) in[l]);
+        }
+        float scale = hi > lo ? (hi - lo) / 255 : 1;
+        int zeroPoint = std::max(0, std::min(255, (int) std::lround(-lo / scale)));
+        uint8_t* out = columns + (size_t) j * k;
+        for (int l = 0; l < k; l++)
+            out[l] = (uint8_t) std::max(0, std::min(255, (int) std::lround((float) in[l] / scale) + zeroPoint));
+        scales[j] = scale;
+        zeroPoints[j] = zeroPoint;
+    }
+}
+
+// generic version of the AVX2 kernel in CPUVectorKernelsAVX2.cpp
+static void Int8DotProducts(const int8_t* a, const uint8_t* b, size_t ldb, size_t numColumns, size_t k, int32_t* sums)
+{
+    for (size_t q = 0; q < numColumns; q++)
+    {
+        const uint8_t* column = b + q * ldb;
+        int32_t sum = 0;
+        for (size_t l = 0; l < k; l++)
+            sum += (int32_t) a[l] * (int32_t) column[l];
+        sums[q] = sum;
+    }
+}
+
+// Each task computes one block of rows for one group of columns of c, so that there is enough parallelism for
+// a single sample (n = 1) as well as for a single output row (m = 1).
+template <class ElemType>
+static void Int8MultiplyImpl(int m, int n, int k, const int8_t* aRows, const float* aScales, const int32_t* aRowSums,
+                             const uint8_t* bColumns, const float* bScales, const int32_t* bZeroPoints, ElemType* c)
+{
+    VerifyInt8InnerDimension("Int8Multiply", k);
+    Int8DotProductsKernel dotProducts = GetCPUVectorExtension() != CPUVectorExtension::None ? GetAVX2Int8DotProducts() : nullptr;
+    if (!dotProducts)
+        dotProducts = &Int8DotProducts;
+
+    long numRowBlocks = (m + multiplyRowBlock - 1) / multiplyRowBlock;
+    long numColumnGroups = (n + multiplyColumnGroup - 1) / multiplyColumnGroup;
+    long numTasks = numRowBlocks * numColumnGroups;
+#pragma omp parallel for if ((size_t) m * n * k >= minParallelMultiplyOps)
+    for (long task = 0; task < numTasks; task++)
+    {
+        int j0 = (int) (task / numRowBlocks) * multiplyColumnGroup;
+        int numColumns = std::min(multiplyColumnGroup, n - j0);
+        int i0 = (int) (task % numRowBlocks) * multiplyRowBlock;
+        int i1 = std::min(m, i0 + multiplyRowBlock);
+        for (int i = i0; i < i1; i++)
+        {
+            int32_t dots[multiplyColumnGroup];
+            dotProducts(aRows + (size_t) i * k, bColumns + (size_t) j0 * k, k, numColumns, k, dots);
+            for (int q = 0; q < numColumns; q++)
+            {
+                int j = j0 + q;
+                // the zero point is subtracted in 64 bits, so that the correction cannot overflow
+                c[i + (size_t) j * m] = (ElemType) (aScales[i] * bScales[j] * (float) ((int64_t) dots[q] - (int64_t) bZeroPoints[j] * aRowSums[i]));
+            }
+        }
+    }
+}
+
+void QuantizeInt8Rows(int m, int k, const float* a, int8_t* rows, float* scales, int32_t* rowSums)  { QuantizeInt8RowsImpl(m, k, a, rows, scales, rowSums); }
+void QuantizeInt8Rows(int m, int k, const double* a, int8_t* rows, float* scales, int32_t* rowSums) { QuantizeInt8RowsImpl(m, k, a, rows, scales, rowSums); }
+
+void QuantizeUInt8Columns(int k, int n, const float* b, uint8_t* columns, float* scales, int32_t* zeroPoints)  { QuantizeUInt8ColumnsImpl(k, n, b, columns, scales, zeroPoints); }
+void QuantizeUInt8Columns(int k, int n, const double* b, uint8_t* columns, float* scales, int32_t* zeroPoints) { QuantizeUInt8ColumnsImpl(k, n, b, columns, scales, zeroPoints); }
+
+void Int8Multiply(int m, int n, int k, const int8_t* aRows, const float* aScales, const int32_t* aRowSums,
+                  const uint8_t* bColumns, const float* bScales, const int32_t* bZeroPoints, float* c)
+{
+    Int8MultiplyImpl(m, n, k, aRows, aScales, aRowSums, bColumns, bScales, bZeroPoints, c);
+}
+
+void Int8Multiply(int m, int n, int k, const int8_t* aRows, const float* aScales, const int32_t* aRowSums,
+                  const uint8_t* bColumns, const float* bScales, const int32_t* bZeroPoints, double* c)
+{
+    Int8MultiplyImpl(m, n, k, aRows, aScales, aRowSums, bColumns, bScales, bZeroPoints, c);
+}
+
+}}}
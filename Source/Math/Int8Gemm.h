@@ -0,0 +1,42 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// Int8Gemm.h -- 8-bit quantized matrix product for the CPU
+//
+// The left operand A (weights) is quantized symmetrically to int8 with one scale per row, i.e. per output channel.
+// The right operand B (activations) is quantized asymmetrically to uint8 with one scale and zero point per column,
+// i.e. per sample. The uint8 x int8 products are accumulated in int32 and de-quantized per element of the result:
+//
+//   C[i,j] = scaleA[i] * scaleB[j] * (sum_l qA[i,l] * qB[l,j] - zeroPointB[j] * sum_l qA[i,l])
+//
+// With |qA| <= 127 and 0 <= qB, zeroPointB <= 255, both sums and their difference are bounded by 127 * 255 * k, so the int32
+// accumulator cannot overflow for an inner dimension k up to maxInt8InnerDimension; larger products are rejected.
+//
+
+#pragma once
+
+#include "CommonMatrix.h" // for MATH_API
+#include <cstdint>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// the largest inner dimension k of an int8 product, i.e. the number of columns of a and of rows of b
+const int maxInt8InnerDimension = 65535;
+
+// Quantize the column-major a[m x k] into m rows of k int8 values each (i.e. transposed, so that each row is
+// contiguous), with one scale and the sum of the quantized values per row.
+MATH_API void QuantizeInt8Rows(int m, int k, const float* a, int8_t* rows, float* scales, int32_t* rowSums);
+MATH_API void QuantizeInt8Rows(int m, int k, const double* a, int8_t* rows, float* scales, int32_t* rowSums);
+
+// Quantize the column-major b[k x n] into uint8, with one scale and zero point per column.
+MATH_API void QuantizeUInt8Columns(int k, int n, const float* b, uint8_t* columns, float* scales, int32_t* zeroPoints);
+MATH_API void QuantizeUInt8Columns(int k, int n, const double* b, uint8_t* columns, float* scales, int32_t* zeroPoints);
+
+// c[m x n] = a[m x k] * b[k x n] from the quantized operands above; c is column-major.
+MATH_API void Int8Multiply(int m, int n, int k, const int8_t* aRows, const float* aScales, const int32_t* aRowSums,
+                           const uint8_t* bColumns, const float* bScales, const int32_t* bZeroPoints, float* c);
+MATH_API void Int8Multiply(int m, int n, int k, const int8_t* aRows, const float* aScales, const int32_t* aRowSums,
+                           const uint8_t* bColumns, const float* bScales, const int32_t* bZeroPoints, double* c);
+
+}}}
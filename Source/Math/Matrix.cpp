@@ -1421,6 +1421,17 @@ void Matrix<ElemType>::SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYPE* h_CSCC
         { m_GPUSparseMatrix->SetMatrixFromCSCFormat(h_CSCCol, h_Row, h_Val, nz, numRows, numCols, false, -1, transferer); });
 }
 
+// The arrays must outlive the matrix, which cannot be resized or moved to another device.
+template <class ElemType>
+void Matrix<ElemType>::SetMatrixFromExternalCSCFormat(CPUSPARSE_INDEX_TYPE* h_CSCCol, CPUSPARSE_INDEX_TYPE* h_Row, ElemType* h_Val,
+    const size_t nz, const size_t numRows, const size_t numCols)
+{
+    if (GetMatrixType() != MatrixType::SPARSE || GetCurrentMatrixLocation() != CurrentDataLocation::CPU)
+        LogicError("SetMatrixFromExternalCSCFormat: Only a sparse matrix on the CPU can refer to external CSC arrays.");
+
+    m_CPUSparseMatrix->SetMatrixFromExternalCSCFormat(h_CSCCol, h_Row, h_Val, nz, numRows, numCols);
+}
+
 template <class ElemType>
 void Matrix<ElemType>::SetDiagonalValue(const ElemType v)
 {
@@ -1775,7 +1786,12 @@ void Matrix<ElemType>::FSAdagradUpdate(Matrix<ElemType>& gradients, Matrix<ElemT
                                    (ElemType)targetAdagradAvDenom_x_sqrtAdagradSqrFrames, unitGainMomentum);
             SetDataLocation(GPU); 
         },
-        { NOT_IMPLEMENTED; },
+        {
+            gradients.m_CPUSparseMatrix->FSAdagrad(*m_CPUMatrix, *functionValues.m_CPUMatrix,
+                                                   (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum,
+                                                   (ElemType)targetAdagradAvDenom_x_sqrtAdagradSqrFrames, unitGainMomentum);
+            SetDataLocation(CPU);
+        },
         {
             gradients.m_GPUSparseMatrix->FSAdagrad(*m_GPUMatrix, *functionValues.m_GPUMatrix, 
                                                    (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum,
@@ -1810,7 +1826,10 @@ void Matrix<ElemType>::AdamUpdate(Matrix<ElemType>& gradients, Matrix<ElemType>&
         biasCorrection, (ElemType)epsilon, unitGainMomentum, adamax);
         SetDataLocation(GPU);
     },
-    { NOT_IMPLEMENTED; },
+    { gradients.m_CPUSparseMatrix->Adam(*m_CPUMatrix, *functionValues.m_CPUMatrix,
+        (ElemType)learnRatePerSample, (ElemType)meanMomentum,
+        (ElemType)varMomentum, biasCorrection, (ElemType)epsilon, unitGainMomentum, adamax);
+        SetDataLocation(CPU); },
     { gradients.m_GPUSparseMatrix->Adam(*m_GPUMatrix, *functionValues.m_GPUMatrix, 
         (ElemType)learnRatePerSample, (ElemType)meanMomentum, 
         (ElemType)varMomentum, biasCorrection, (ElemType)epsilon, unitGainMomentum, adamax); 
@@ -1834,7 +1853,7 @@ ElemType Matrix<ElemType>::RmsProp(Matrix<ElemType>& gradients,
     DISPATCH_MATRIX_ON_FLAG(&gradients, &gradients,
         { return m_CPUMatrix->RmsProp(*gradients.m_CPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized); SetDataLocation(CPU); },
         { return m_GPUMatrix->RmsProp(*gradients.m_GPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized); SetDataLocation(GPU); },
-        { NOT_IMPLEMENTED; },
+        { return gradients.m_CPUSparseMatrix->RmsProp(*m_CPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized); SetDataLocation(CPU); },
         { return gradients.m_GPUSparseMatrix->RmsProp(*m_GPUMatrix, RMS_GAMMA, RMS_WGT_INC, RMS_WGT_MAX, RMS_WGT_DEC, RMS_WGT_MIN, needAveMultiplier, initialized); SetDataLocation(GPU); });
     // Note: Since both 'this' and gradients are changed, we must call SetDataLocation() on 'this' as well.
 }
@@ -4868,7 +4887,7 @@ void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<E
 
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            m_CPUMatrix->RNNForward(*(inputX.m_CPUMatrix), *(paramW.m_CPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(workspace.m_CPUMatrix)),
                             m_GPUMatrix->RNNForward(*(inputX.m_GPUMatrix), *(paramW.m_GPUMatrix), xDim, yDim, numSequencesForFrame, rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -4883,7 +4902,7 @@ void Matrix<ElemType>::RNNBackwardData(const Matrix<ElemType>& outputDY, const M
     workspace._transferToDevice(GetDeviceId());
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            RuntimeError("OptimizedRNNStack training on CPU is not yet implemented."),
                             m_GPUMatrix->RNNBackwardData(*(outputDY.m_GPUMatrix), *(paramW.m_GPUMatrix), *(outputDX.m_GPUMatrix), rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -4898,7 +4917,7 @@ void Matrix<ElemType>::RNNBackwardWeights(const Matrix<ElemType>& inputX, const
     workspace._transferToDevice(GetDeviceId());
     DISPATCH_MATRIX_ON_FLAG(this,
                             this,
-                            NOT_IMPLEMENTED,
+                            RuntimeError("OptimizedRNNStack training on CPU is not yet implemented."),
                             m_GPUMatrix->RNNBackwardWeights(*(inputX.m_GPUMatrix), *(outputY.m_GPUMatrix), *(dw.m_GPUMatrix), rnnAttributes, *(reserve.m_GPUMatrix), *(workspace.m_GPUMatrix)),
                             NOT_IMPLEMENTED,
                             NOT_IMPLEMENTED);
@@ -6056,6 +6075,49 @@ static bool VerifyIsDense(const Matrix<ElemType>& a)
     return true;
 }
 
+template <class ElemType>
+/*static*/ bool Matrix<ElemType>::FusedElementwiseOf(Matrix<ElemType>& result, const std::vector<const Matrix<ElemType>*>& operands, const std::vector<FusedElementwiseStep>& steps)
+{
+    if (operands.empty() || result.GetDeviceId() != CPUDEVICE || result.GetMatrixType() != DENSE || result.GetCurrentMatrixLocation() != CurrentDataLocation::CPU)
+        return false;
+
+    const size_t rows = result.GetNumRows();
+    const size_t cols = result.GetNumCols();
+    const ElemType* resultBegin = result.Data();
+    const ElemType* resultEnd = resultBegin + result.GetNumElements();
+
+    std::vector<const CPUMatrix<ElemType>*> cpuOperands;
+    for (auto operand : operands)
+    {
+        if (operand->GetDeviceId() != CPUDEVICE || operand->GetMatrixType() != DENSE || operand->GetCurrentMatrixLocation() == CurrentDataLocation::GPU)
+            return false;
+
+        bool isFull = operand->GetNumRows() == rows && operand->GetNumCols() == cols;
+        bool isColumn = operand->GetNumRows() == rows && operand->GetNumCols() == 1;
+        bool isScalar = operand->GetNumElements() == 1;
+        if (!isFull && !isColumn && !isScalar)
+            return false;
+
+        // The result may share memory with an operand of the same size (e.g. due to memory sharing); since every element is read
+        // before it is written, that is fine. A broadcast operand inside the result buffer, however, would be overwritten while still needed.
+        const ElemType* data = operand->Data();
+        bool overlaps = data < resultEnd && data + operand->GetNumElements() > resultBegin;
+        if (overlaps && !(isFull && data == resultBegin))
+            return false;
+
+        cpuOperands.push_back(operand->m_CPUMatrix.get());
+    }
+
+    for (const auto& step : steps)
+    {
+        if (step.operand >= (int)operands.size())
+            InvalidArgument("FusedElementwiseOf: Step refers to operand %d, but only %d operands were given.", step.operand, (int)operands.size());
+    }
+
+    CPUMatrix<ElemType>::FusedElementwiseOf(*result.m_CPUMatrix, cpuOperands, steps);
+    return true;
+}
+
 template <class ElemType>
 void Matrix<ElemType>::TensorOp(ElemType beta, const Matrix<ElemType>& a, ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
                                 const array<size_t, 2>& offsets,
@@ -282,6 +282,9 @@ public:
     }
     void SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYPE* h_CSCCol, const CPUSPARSE_INDEX_TYPE* h_Row, const ElemType* h_Val,
         const size_t nz, const size_t numRows, const size_t numCols, DataTransferer* transferer = nullptr);
+    // same as SetMatrixFromCSCFormat(), except that the (CPU sparse) matrix refers to the given arrays instead of copying them
+    void SetMatrixFromExternalCSCFormat(CPUSPARSE_INDEX_TYPE* h_CSCCol, CPUSPARSE_INDEX_TYPE* h_Row, ElemType* h_Val,
+        const size_t nz, const size_t numRows, const size_t numCols);
 
     void MaskColumnsValue(const Matrix<char>& columnsMask, ElemType val, size_t numColsPerMaskEntry);
 
@@ -612,6 +615,12 @@ public:
 
     static void TensorShuffleScaleAndAdd(ElemType keepWeight, const Matrix<ElemType>& a, size_t D, size_t S, size_t M, size_t K, size_t T, ElemType scaleFactor, const Matrix<ElemType>& b, Matrix<ElemType>& c);
 
+    // Computes a chain of elementwise operations in a single pass over memory, without materializing intermediate results.
+    // Each operand must either have the size of the result, be a column vector of the result's height (broadcast along the
+    // columns), or be a scalar. Currently only implemented for dense CPU matrices. Returns false, without computing anything,
+    // if the matrices do not qualify; the caller is then expected to compute the chain step by step.
+    static bool FusedElementwiseOf(Matrix<ElemType>& result, const std::vector<const Matrix<ElemType>*>& operands, const std::vector<FusedElementwiseStep>& steps);
+
     void TensorOp(ElemType beta, const Matrix<ElemType>& a, ElemType alpha, ElementWiseOperator op, ElementWiseOperator reductionOp,
                   const std::array<size_t, 2>& offsets,
                   const SmallVector<size_t>& regularOpDims, const std::array<SmallVector<ptrdiff_t>, 2>& regularStrides,
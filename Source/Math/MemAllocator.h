@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace Microsoft { namespace MSR { namespace CNTK {
 
 #ifdef _WIN32
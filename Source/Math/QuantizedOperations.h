@@ -4,9 +4,18 @@
 //
 #pragma once
 #include "Quantizers.h"
+#include "BFloat16.h"
+#include "Int8Gemm.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// Storage type of the weights of a matrix product that is evaluated for inference on the CPU
+enum class TimesWeightStorage
+{
+    Float,   // the element type of the network, i.e. no conversion
+    BFloat16,
+    Int8     // int8 weights with one scale per output row, times uint8 activations with one scale per sample
+};
 
 // Quantized product of two dense matrices A and B, where each matrix has its own quantizer.
 // This class handles quantization of both matrices, product and de-quantization of the result.
@@ -29,7 +38,18 @@ class QuantizedMultiplier
 
     bool m_firstPass;
 
+protected:
+    // for derived multipliers that do not quantize through a pair of quantizers
+    QuantizedMultiplier(bool isAConstant) :
+        m_isAConstant(isAConstant), m_isBConstant(false), m_firstPass(true)
+    {
+    }
+
+    bool IsAConstant() const { return m_isAConstant; }
+
 public: 
+    virtual ~QuantizedMultiplier() { }
+
     QuantizedMultiplier(shared_ptr<QuantizerBase<ElemType, short>> pQuantizerA, bool isAConstant, shared_ptr<QuantizerBase<ElemType, short>> pQuantizerB, bool isBConstant) :
         m_pQuantizerA(pQuantizerA), m_pQuantizerB(pQuantizerB), m_isAConstant(isAConstant), m_isBConstant(isBConstant), m_firstPass(true)
     {
@@ -42,7 +62,7 @@ public:
     };
 
     // A[m,k]*B[k,n] = C[m,n]
-    void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C)
+    virtual void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C)
     {
         // Quantize
         if (!m_isAConstant || m_firstPass)
@@ -86,4 +106,147 @@ public:
     void SetIsBConstant(bool v) { m_isBConstant = v; }
 };
 
+// Base of the multipliers that keep A converted to another storage type. If A is constant (i.e. weights),
+// it is converted once, on the first pass or by PrepareA(), until Invalidate() is called.
+template <class ElemType>
+class CachedAMultiplier : public QuantizedMultiplier<ElemType>
+{
+    int m_rowsA;
+    int m_colsA;
+    bool m_isAValid;
+    bool m_isFrozen;
+
+protected:
+    CachedAMultiplier(bool isAConstant) :
+        QuantizedMultiplier<ElemType>(isAConstant), m_rowsA(0), m_colsA(0), m_isAValid(false), m_isFrozen(false)
+    {
+    }
+
+    virtual void ConvertA(int m, int k, const ElemType* A) = 0;
+
+    // C[m,n] = A[m,k]*B[k,n], with the converted A
+    virtual void MultiplyConverted(int m, int n, int k, const ElemType* B, ElemType* C) = 0;
+
+    // for derived multipliers that are given A in the storage type
+    void SetAValid(int m, int k)
+    {
+        m_rowsA = m;
+        m_colsA = k;
+        m_isAValid = true;
+    }
+
+public:
+    // convert a constant A ahead of the first product, e.g. right after the model was loaded
+    void PrepareA(int m, int k, const ElemType* A)
+    {
+        ConvertA(m, k, A);
+        SetAValid(m, k);
+    }
+
+    // A[m,k]*B[k,n] = C[m,n]
+    void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C) override
+    {
+        if (m_isFrozen)
+        {
+            if (m != m_rowsA || k != m_colsA)
+                LogicError("CachedAMultiplier: A is %d x %d, but the frozen converted A is %d x %d.", m, k, m_rowsA, m_colsA);
+        }
+        else if (!this->IsAConstant() || !m_isAValid || m != m_rowsA || k != m_colsA)
+            PrepareA(m, k, A);
+        MultiplyConverted(m, n, k, B, C);
+    }
+
+    // drop the converted copy of a constant A, e.g. after the weights were updated
+    void Invalidate()
+    {
+        if (!m_isFrozen)
+            m_isAValid = false;
+    }
+
+    bool IsAValid() const { return m_isAValid; }
+
+    // Keep the converted A for good, so that Multiply() never modifies the multiplier and it can be used from
+    // several threads at once. Only a prepared, constant A can be frozen.
+    void Freeze()
+    {
+        if (!this->IsAConstant() || !m_isAValid)
+            LogicError("CachedAMultiplier: only a prepared constant A can be frozen.");
+        m_isFrozen = true;
+    }
+};
+
+// Product where A is stored as bfloat16 and B and C are full precision. The products are accumulated in ElemType.
+template <class ElemType>
+class BFloat16Multiplier : public CachedAMultiplier<ElemType>
+{
+    vector<bfloat16> m_matA;
+    const bfloat16* m_pA;             // m_matA, or the storage given to SetA()
+    shared_ptr<const void> m_sharedA; // keeps the storage given to SetA() alive
+
+protected:
+    void ConvertA(int m, int k, const ElemType* A) override
+    {
+        m_matA.resize((size_t)m * k);
+        ConvertToBFloat16(A, m_matA.data(), m_matA.size());
+        m_pA = m_matA.data();
+        m_sharedA = nullptr;
+    }
+
+    void MultiplyConverted(int m, int n, int k, const ElemType* B, ElemType* C) override
+    {
+        BFloat16Multiply(m, n, k, m_pA, B, C);
+    }
+
+public:
+    BFloat16Multiplier(bool isAConstant) :
+        CachedAMultiplier<ElemType>(isAConstant), m_pA(nullptr)
+    {
+    }
+
+    // Use an A that is already stored as bfloat16, e.g. the value of a bfloat16 Constant, instead of converting it.
+    // A is not copied; owner keeps it alive for as long as the multiplier uses it.
+    void SetA(int m, int k, const bfloat16* A, const shared_ptr<const void>& owner)
+    {
+        vector<bfloat16>().swap(m_matA);
+        m_pA = A;
+        m_sharedA = owner;
+        this->SetAValid(m, k);
+    }
+};
+
+// Product of A quantized to int8 per row and B quantized to uint8 per column (see Int8Gemm.h).
+template <class ElemType>
+class Int8Multiplier : public CachedAMultiplier<ElemType>
+{
+    vector<int8_t> m_matA;
+    vector<float> m_scalesA;
+    vector<int32_t> m_rowSumsA;
+
+protected:
+    void ConvertA(int m, int k, const ElemType* A) override
+    {
+        m_matA.resize((size_t)m * k);
+        m_scalesA.resize(m);
+        m_rowSumsA.resize(m);
+        QuantizeInt8Rows(m, k, A, m_matA.data(), m_scalesA.data(), m_rowSumsA.data());
+    }
+
+    // The quantized B is local to the call, so that a multiplier whose A is prepared can be shared by networks
+    // that are evaluated concurrently (see ComputationNetwork::CloneSharingParameters()).
+    void MultiplyConverted(int m, int n, int k, const ElemType* B, ElemType* C) override
+    {
+        vector<uint8_t> matB((size_t)k * n);
+        vector<float> scalesB(n);
+        vector<int32_t> zeroPointsB(n);
+        QuantizeUInt8Columns(k, n, B, matB.data(), scalesB.data(), zeroPointsB.data());
+        Int8Multiply(m, n, k, m_matA.data(), m_scalesA.data(), m_rowSumsA.data(), matB.data(), scalesB.data(), zeroPointsB.data(), C);
+    }
+
+public:
+    Int8Multiplier(bool isAConstant) :
+        CachedAMultiplier<ElemType>(isAConstant)
+    {
+    }
+};
+
 }}}
\ No newline at end of file
@@ -17,8 +17,10 @@
 #include "fileutil.h"
 #include "TimerUtility.h"
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <stdio.h>
 #ifndef CPUONLY
 #include <cuda_runtime_api.h>
@@ -67,6 +69,13 @@ static const FixedEventDesc c_fixedEvtDesc[profilerEvtMax] = {
     { "", profilerEvtSeparator, false },                            // profilerSepSpace2
 
     { "Prefetch Minibatch", profilerEvtTime, false },               // profilerEvtPrefetchMinibatch
+
+    { "", profilerEvtSeparator, false },                            // profilerSepSpace3
+    { "Gradient Aggregation", profilerEvtSeparator, false },        // profilerSepGradientAggregation
+    { "", profilerEvtSeparator, false },                            // profilerSepSpace4
+
+    { "Async Gradient Aggregation", profilerEvtTime, false },       // profilerEvtAsyncGradientAggregation
+    { "Async Gradient Wait", profilerEvtTime, false },              // profilerEvtAsyncGradientWait
 };
 
 
@@ -107,6 +116,7 @@ struct ProfilerState
     unsigned long long      customEventBufferBytes;      // Number of bytes allocated for the custom event buffer
     unsigned long long      customEventOffset;           // Offset to current place in buffer
     unique_ptr<char[]>      customEventBuffer;           // Pointer to custom event buffer
+    std::map<unsigned int, int> threadSections;          // Thread id -> section header of the fixed events it recorded
 };
 
 
@@ -124,6 +134,7 @@ void FormatTimeStr(char* str, size_t strLen, double value);
 void FormatThroughputStr(char* str, size_t strLen, double value);
 void FormatBytesStr(char* str, size_t strLen, long long bytes);
 void ProfilerGenerateDetailFile(const std::wstring& fileName);
+void ProfilerGenerateTraceFile(const std::wstring& fileName);
 
 
 double TicksToSeconds(long long ticks)
@@ -208,6 +219,18 @@ void ProfilerTimeRecordFixedEvent(const int eventId, const long long beginClock,
     g_profilerState->fixedEvents[eventId].sum += delta;
     g_profilerState->fixedEvents[eventId].sumsq += (double)delta * (double)delta;
     g_profilerState->fixedEvents[eventId].cnt++;
+
+    // The section header of the event (the closest non-empty separator before it) names the track of
+    // the thread in the timeline. If a thread records events of several sections (e.g. the main thread
+    // waits for the gradient aggregation), the section that comes first in the report wins.
+    int section = eventId;
+    while (section > 0 && (c_fixedEvtDesc[section].eventType != profilerEvtSeparator || c_fixedEvtDesc[section].eventDescription[0] == '\0'))
+        section--;
+    auto threadSection = g_profilerState->threadSections.find(GetThreadId());
+    if (threadSection == g_profilerState->threadSections.end())
+        g_profilerState->threadSections[GetThreadId()] = section;
+    else
+        threadSection->second = std::min(threadSection->second, section);
 }
 
 void ProfilerTimeRecordToBuffer(const char* eventDescription, const long long beginClock, const long long endClock)
@@ -366,6 +389,10 @@ void PERF_PROFILER_API ProfilerClose()
     fileName = g_profilerState->profilerDir + L"/" + std::wstring(timeStr) + L"_detail_" + g_profilerState->logSuffix + L".csv";
     ProfilerGenerateDetailFile(fileName);
 
+    // Generate timeline
+    fileName = g_profilerState->profilerDir + L"/" + std::wstring(timeStr) + L"_trace_" + g_profilerState->logSuffix + L".json";
+    ProfilerGenerateTraceFile(fileName);
+
     g_profilerState.reset();
 }
 
@@ -555,6 +582,103 @@ void ProfilerGenerateDetailFile(const std::wstring& fileName)
 }
 
 
+//
+// Escape a string for a JSON string literal.
+//
+std::string JsonEscape(const char* str)
+{
+    std::string result;
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\')
+        {
+            result += '\\';
+            result += *str;
+        }
+        else if ((unsigned char)*str < 0x20)
+        {
+            char escaped[8];
+            sprintf_s(escaped, sizeof(escaped), "\\u%04x", (unsigned int)*str);
+            result += escaped;
+        }
+        else
+            result += *str;
+    }
+    return result;
+}
+
+//
+// Generate timeline file in the Chrome trace event format.
+// Threads that recorded fixed events are merged into one track per section (e.g. the data reader may
+// prefetch each minibatch in a new thread); all other threads get a track of their own.
+//
+void ProfilerGenerateTraceFile(const std::wstring& fileName)
+{
+    FILE* f = _wfopen(fileName.c_str(), L"wt");
+    if (f == NULL)
+    {
+        RuntimeError("Error: ProfilerGenerateTraceFile: Cannot create file <%ls>.\n", fileName.c_str());
+    }
+
+    // Section tracks are numbered by their header, thread tracks by the thread id (which is not small).
+    auto getTrackId = [](unsigned int threadId)
+    {
+        auto threadSection = g_profilerState->threadSections.find(threadId);
+        return threadSection != g_profilerState->threadSections.end() ? (unsigned int)threadSection->second : threadId;
+    };
+
+    fprintfOrDie(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintfOrDie(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CNTK %ls\"}}",
+        g_profilerState->logSuffix.c_str());
+
+    // Metadata naming and ordering the tracks.
+    std::set<unsigned int> tracks;
+    char* eventPtr = g_profilerState->customEventBuffer.get();
+    char* eventEnd = g_profilerState->customEventBuffer.get() + g_profilerState->customEventOffset;
+    while (eventPtr < eventEnd)
+    {
+        eventPtr += strlen(eventPtr) + 1;
+        tracks.insert(getTrackId(((CustomEventRecord*)eventPtr)->threadId));
+        eventPtr += sizeof(CustomEventRecord);
+    }
+    std::set<unsigned int> sectionTracks;
+    for (const auto& threadSection : g_profilerState->threadSections)
+        sectionTracks.insert((unsigned int)threadSection.second);
+    for (auto track : tracks)
+    {
+        bool isSection = sectionTracks.find(track) != sectionTracks.end();
+        if (isSection)
+            fprintfOrDie(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", track, c_fixedEvtDesc[track].eventDescription);
+        else
+            fprintfOrDie(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}", track, track);
+        fprintfOrDie(f, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"sort_index\":%u}}", track, isSection ? track : profilerEvtMax);
+    }
+
+    // Complete events, with time stamps and durations in microseconds. Events of a track nest by time.
+    eventPtr = g_profilerState->customEventBuffer.get();
+    while (eventPtr < eventEnd)
+    {
+        char* descriptionStr = eventPtr;
+        eventPtr += strlen(descriptionStr) + 1;
+
+        CustomEventRecord* eventRecord = (CustomEventRecord*)eventPtr;
+        eventPtr += sizeof(CustomEventRecord);
+
+        // leading underscores indent the fixed events in the summary report
+        while (*descriptionStr == '_')
+            descriptionStr++;
+
+        fprintfOrDie(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            JsonEscape(descriptionStr).c_str(), getTrackId(eventRecord->threadId),
+            1000000.0 * TicksToSeconds(eventRecord->beginClock),
+            1000000.0 * TicksToSeconds(eventRecord->endClock - eventRecord->beginClock));
+    }
+
+    fprintfOrDie(f, "\n]}\n");
+    fclose(f);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Scoped helpers.
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
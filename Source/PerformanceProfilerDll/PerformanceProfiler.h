@@ -11,7 +11,10 @@
 // To initialize and tear down the profiler, call ProfilerInit() and ProfilerClose(). The scoped
 // object, ProfilerContext can also be used for managing the lifetime of the profiler. The profiler
 // works by accumulating events in a pre-allocated buffer, up until the buffer is full. At the
-// time when the profiler is torn down, a summary report and a detailed log file is written to disk.
+// time when the profiler is torn down, a summary report, a detailed log file and a timeline in the
+// Chrome trace event format (which can be loaded by chrome://tracing or Perfetto) are written to disk.
+// In the timeline, each section of fixed events (main thread, data reader, gradient aggregation) is
+// a separate track, that shows all events of the threads that recorded events of that section.
 //
 // When profiling code, two types of events can be used - fixed or custom. A fixed event is
 // predefined in the ProfilerEvents enum and by the FixedEventDesc struct. A custom event is
@@ -80,6 +83,15 @@ enum ProfilerEvents
     // Data reader events
     profilerEvtPrefetchMinibatch,           // Prefetching the next minibatch in a background thread
 
+    // Gradient aggregation header (dummy events)
+    profilerSepSpace3,
+    profilerSepGradientAggregation,
+    profilerSepSpace4,
+
+    // Gradient aggregation events
+    profilerEvtAsyncGradientAggregation,    // Aggregating gradients in a background thread
+    profilerEvtAsyncGradientWait,           // Waiting for the pending background aggregation to finish
+
     profilerEvtMax
 };
 
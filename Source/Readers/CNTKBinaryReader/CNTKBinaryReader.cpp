@@ -33,8 +33,11 @@ CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config)
 
         if (configHelper.ShouldKeepDataInMemory())
         {
-            m_deserializer = shared_ptr<DataDeserializer>(new ChunkCache(m_deserializer));
+            size_t cacheSize = configHelper.GetChunkCacheSize();
+            m_deserializer = shared_ptr<DataDeserializer>(new ChunkCache(m_deserializer, cacheSize > 0 ? cacheSize : SIZE_MAX));
             log << " | keeping data in memory";
+            if (cacheSize > 0)
+                log << " (up to " << cacheSize << " bytes)";
         }
 
         size_t window = configHelper.GetRandomizationWindow();
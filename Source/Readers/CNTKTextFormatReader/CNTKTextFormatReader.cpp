@@ -8,6 +8,7 @@
 #include "Config.h"
 #include "TextConfigHelper.h"
 #include "ChunkCache.h"
+#include "BinaryChunkCache.h"
 #include "BlockRandomizer.h"
 #include "NoRandomizer.h"
 #include "TextParser.h"
@@ -34,8 +35,14 @@ CNTKTextFormatReader::CNTKTextFormatReader(const ConfigParameters& config)
         else
             m_deserializer = make_shared<TextParser<double>>(corpus, configHelper, true);
 
+        if (configHelper.ShouldUseBinaryCache())
+            m_deserializer = make_shared<BinaryChunkCache>(m_deserializer, configHelper.GetFilePath());
+
         if (configHelper.ShouldKeepDataInMemory())
-            m_deserializer = make_shared<ChunkCache>(m_deserializer);
+        {
+            size_t cacheSize = configHelper.GetChunkCacheSize();
+            m_deserializer = make_shared<ChunkCache>(m_deserializer, cacheSize > 0 ? cacheSize : SIZE_MAX);
+        }
 
         size_t window = configHelper.GetRandomizationWindow();
         if (window > 0)
@@ -10,6 +10,7 @@
 #include "DataReader.h"
 #include "ReaderShim.h"
 #include "CNTKTextFormatReader.h"
+#include "BinaryChunkCache.h"
 #include "StringUtil.h"
 #include "V2Dependencies.h"
 
@@ -47,10 +48,14 @@ extern "C" DATAREADER_API bool CreateDeserializer(DataDeserializerPtr& deseriali
     // TODO: Remove type from the parser. Current implementation does not support streams of different types.
     if (type == L"CNTKTextFormatDeserializer")
     {
+        TextConfigHelper config(deserializerConfig);
         if (precision == "float")
-            deserializer = make_shared<TextParser<float>>(corpus, TextConfigHelper(deserializerConfig), primary);
+            deserializer = make_shared<TextParser<float>>(corpus, config, primary);
         else // double
-            deserializer = make_shared<TextParser<double>>(corpus, TextConfigHelper(deserializerConfig), primary);
+            deserializer = make_shared<TextParser<double>>(corpus, config, primary);
+
+        if (config.ShouldUseBinaryCache())
+            deserializer = make_shared<BinaryChunkCache>(deserializer, config.GetFilePath());
     }
     else
         InvalidArgument("Unknown deserializer type '%ls'", type.c_str());
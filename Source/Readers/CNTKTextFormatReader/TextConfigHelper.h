@@ -33,6 +33,10 @@ public:
 
     bool ShouldCacheIndex() const { return m_cacheIndex; }
 
+    bool ShouldUseMemoryMapping() const { return m_memoryMapping; }
+
+    bool ShouldUseBinaryCache() const { return m_binaryCache; }
+
     unsigned int GetMaxAllowedErrors() const { return m_maxErrors; }
 
     unsigned int GetTraceLevel() const { return m_traceLevel; }
@@ -41,6 +45,8 @@ public:
 
     bool ShouldKeepDataInMemory() const { return m_keepDataInMemory; }
 
+    size_t GetChunkCacheSize() const { return m_chunkCacheSizeBytes; }
+
     bool IsInFrameMode() const { return m_frameMode; }
 
     DataType GetDataType() const { return m_elementType; }
@@ -60,9 +66,12 @@ private:
     unsigned int m_traceLevel;
     size_t m_chunkSizeBytes; // chunks size in bytes
     bool m_keepDataInMemory; // if true the whole dataset is kept in memory
+    size_t m_chunkCacheSizeBytes; // if not 0, the memory budget of the cache of chunks kept in memory
     bool m_frameMode; // if true, the maximum expected sequence length in the dataset is one sample.
     bool m_cacheIndex; // When true, the index will be loaded from a cache file it if exists.
                        // If cache does not exist, the index, once created, will be written out to a file.
+    bool m_memoryMapping; // if true, the input file is memory mapped and sequences of a chunk are parsed in parallel.
+    bool m_binaryCache; // if true, parsed chunks are written to (and later read from) a binary cache file next to the input.
 };
 
 }
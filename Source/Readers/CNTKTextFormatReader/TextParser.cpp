@@ -8,6 +8,8 @@
 #include <inttypes.h>
 #include <cfloat>
 #include "BufferedFileReader.h"
+#include "MemoryMappedFile.h"
+#include "ExceptionCapture.h"
 #include "IndexBuilder.h"
 #include "TextParser.h"
 #include "TextReaderConstants.h"
@@ -71,6 +73,7 @@ TextParser(corpus, helper.GetFilePath(), helper.GetStreams(), primary)
     SetSkipSequenceIds(helper.ShouldSkipSequenceIds());
 
     SetCacheIndex(helper.ShouldCacheIndex());
+    SetMemoryMapping(helper.ShouldUseMemoryMapping());
 
     Initialize();
 }
@@ -93,7 +96,8 @@ TextParser<ElemType>::TextParser(CorpusDescriptorPtr corpus, const std::wstring&
     m_numRetries(5),
     m_corpus(corpus),
     m_useMaximumAsSequenceLength(true),
-    m_cacheIndex(false)
+    m_cacheIndex(false),
+    m_memoryMapping(false)
 {
     assert(streams.size() > 0);
 
@@ -140,8 +144,6 @@ TextParser<ElemType>::TextParser(CorpusDescriptorPtr corpus, const std::wstring&
     }
 
     assert(m_maxAliasLength > 0);
-
-    m_scratch = unique_ptr<char[]>(new char[m_maxAliasLength + 1]);
 }
 
 template <class ElemType>
@@ -198,7 +200,10 @@ void TextParser<ElemType>::Initialize()
 
         m_index = builder.Build();
 
-        m_fileReader = std::make_shared<BufferedFileReader>(BUFFER_SIZE, *m_file);
+        if (m_memoryMapping)
+            m_mappedFile = std::make_shared<MemoryMappedFile>(*m_file);
+        else
+            m_fileReader = std::make_shared<BufferedFileReader>(BUFFER_SIZE, *m_file);
     });
 
     assert(m_index != nullptr);
@@ -282,33 +287,53 @@ template <class ElemType>
 void TextParser<ElemType>::LoadChunk(TextChunkPtr& chunk, const ChunkDescriptor& descriptor)
 {
     chunk->m_sequenceMap.resize(descriptor.NumberOfSequences());
+
+    if (m_mappedFile)
+    {
+        // Sequences are independent, each one is parsed by its own reader straight from the mapped pages.
+        ExceptionCapture capture;
+#pragma omp parallel for schedule(dynamic)
+        for (int sequenceIndex = 0; sequenceIndex < (int)descriptor.NumberOfSequences(); ++sequenceIndex)
+        {
+            capture.SafeRun([this, &chunk, &descriptor](int i)
+            {
+                const auto& sequenceDescriptor = descriptor.Sequences()[i];
+                MemoryBufferReader reader(*m_mappedFile, descriptor.StartOffset() + sequenceDescriptor.OffsetInChunk());
+                chunk->m_sequenceMap[i] = LoadSequence(reader, sequenceDescriptor);
+            }, sequenceIndex);
+        }
+        capture.RethrowIfHappened();
+        return;
+    }
+
     for (size_t sequenceIndex = 0; sequenceIndex < descriptor.NumberOfSequences(); ++sequenceIndex)
     {
         const auto& sequenceDescriptor = descriptor.Sequences()[sequenceIndex];
-        chunk->m_sequenceMap[sequenceIndex] = LoadSequence(sequenceDescriptor, descriptor.StartOffset());
+        m_fileReader->SetFileOffset(descriptor.StartOffset() + sequenceDescriptor.OffsetInChunk());
+        chunk->m_sequenceMap[sequenceIndex] = LoadSequence(*m_fileReader, sequenceDescriptor);
     }
 }
 
 template <class ElemType>
 void TextParser<ElemType>::IncrementNumberOfErrorsOrDie()
 {
-    if (m_numAllowedErrors == 0)
+    unsigned int numAllowedErrors = m_numAllowedErrors;
+    do
     {
-        PrintWarningNotification();
-        RuntimeError("Reached the maximum number of allowed errors"
-            " while reading the input file (%ls).",
-            m_filename.c_str());
-    }
-    --m_numAllowedErrors;
+        if (numAllowedErrors == 0)
+        {
+            PrintWarningNotification();
+            RuntimeError("Reached the maximum number of allowed errors"
+                " while reading the input file (%ls).",
+                m_filename.c_str());
+        }
+    } while (!m_numAllowedErrors.compare_exchange_weak(numAllowedErrors, numAllowedErrors - 1));
 }
 
 template <class ElemType>
-typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence(const SequenceDescriptor& sequenceDsc, size_t chunkOffsetInFile)
+template <class Reader>
+typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence(Reader& reader, const SequenceDescriptor& sequenceDsc)
 {
-    size_t fileOffset = sequenceDsc.OffsetInChunk() + chunkOffsetInFile;
-
-    m_fileReader->SetFileOffset(fileOffset);
-
     size_t bytesToRead = sequenceDsc.SizeInBytes();
 
     SequenceBuffer sequence;
@@ -331,7 +356,7 @@ typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence
     size_t rowNumber = 1;
     while(bytesToRead)
     {
-        if ((TryReadRow(sequence, bytesToRead)))
+        if ((TryReadRow(reader, sequence, bytesToRead)))
         {
             ++numRowsRead;
         }
@@ -344,7 +369,7 @@ typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence
                     " while loading sequence (id = %" PRIu64 ") %ls.\n",
                     rowNumber,
                     sequenceDsc.m_key,
-                    GetFileInfo().c_str());
+                    GetFileInfo(reader).c_str());
             }
             IncrementNumberOfErrorsOrDie();
         }
@@ -358,7 +383,7 @@ typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence
             " expected for the current sequence (id = %" PRIu64 ") %ls,"
             " but only read %" PRIu64 " out of %" PRIu64 " expected rows.\n",
             sequenceDsc.m_key,
-            GetFileInfo().c_str(), numRowsRead, expectedRowCount);
+            GetFileInfo(reader).c_str(), numRowsRead, expectedRowCount);
 
     }
 
@@ -372,7 +397,7 @@ typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence
         {
             fprintf(stderr,
                 "ERROR: Input ('%ls') is empty in sequence (id = %" PRIu64 ") %ls.\n",
-                m_streams[i].m_name.c_str(), sequenceDsc.m_key, GetFileInfo().c_str());
+                m_streams[i].m_name.c_str(), sequenceDsc.m_key, GetFileInfo(reader).c_str());
             hasEmptyInputs = true;
         }
 
@@ -392,7 +417,7 @@ typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence
                     "WARNING: Input ('%ls') contains more samples than expected"
                     " (%u vs. %" PRIu64 ") for sequence (id = %" PRIu64 ") %ls.\n",
                     m_streams[i].m_name.c_str(), sequence[i]->m_numberOfSamples,
-                    expectedRowCount, sequenceDsc.m_key, GetFileInfo().c_str());
+                    expectedRowCount, sequenceDsc.m_key, GetFileInfo(reader).c_str());
             }
         }
         
@@ -416,7 +441,7 @@ typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence
                 "WARNING: Number of samples for sequence (id = %" PRIu64 ") %ls"
                 " is less than expected (%u vs. %" PRIu64 ").\n",
                 sequenceDsc.m_key,
-                GetFileInfo().c_str(), overallSequenceLength, expectedRowCount);
+                GetFileInfo(reader).c_str(), overallSequenceLength, expectedRowCount);
         }
         IncrementNumberOfErrorsOrDie();
     }
@@ -426,7 +451,7 @@ typename TextParser<ElemType>::SequenceBuffer TextParser<ElemType>::LoadSequence
         fprintf(stderr,
             "INFO: Finished loading sequence (id = %" PRIu64 ") %ls,"
             " successfully read %" PRIu64 " out of expected %" PRIu64 " rows.\n",
-            sequenceDsc.m_key, GetFileInfo().c_str(), numRowsRead, expectedRowCount);
+            sequenceDsc.m_key, GetFileInfo(reader).c_str(), numRowsRead, expectedRowCount);
     }
 
     FillSequenceMetadata(sequence, { sequenceDsc.m_key, 0 });
@@ -452,38 +477,39 @@ void TextParser<ElemType>::FillSequenceMetadata(SequenceBuffer& sequenceData, co
 }
 
 template <class ElemType>
-bool TextParser<ElemType>::TryReadRow(SequenceBuffer& sequence, size_t& bytesToRead)
+template <class Reader>
+bool TextParser<ElemType>::TryReadRow(Reader& reader, SequenceBuffer& sequence, size_t& bytesToRead)
 {
-    while (bytesToRead && CanRead() && IsDigit(m_fileReader->Peek()))
+    while (bytesToRead && !reader.Empty() && IsDigit(reader.Peek()))
     {
         // skip sequence ids
-        m_fileReader->Pop();
+        reader.Pop();
         --bytesToRead;
     }
 
     size_t numSampleRead = 0;
 
-    while (bytesToRead && CanRead())
+    while (bytesToRead && !reader.Empty())
     {
-        char c = m_fileReader->Peek();
+        char c = reader.Peek();
 
         if (c == ROW_DELIMITER)
         {
             // found the end of row, skip the delimiter, return.
-            m_fileReader->Pop();
+            reader.Pop();
             --bytesToRead;
 
             if (numSampleRead == 0 && ShouldWarn())
             {
                 fprintf(stderr,
-                    "WARNING: Empty input row %ls.\n", GetFileInfo().c_str());
+                    "WARNING: Empty input row %ls.\n", GetFileInfo(reader).c_str());
             }
             else if (numSampleRead > m_streams.size() && ShouldWarn())
             {
                 fprintf(stderr,
                     "WARNING: Input row %ls contains more"
                     " samples than expected (%" PRIu64 " vs. %" PRIu64 ").\n",
-                    GetFileInfo().c_str(), numSampleRead, m_streams.size());
+                    GetFileInfo(reader).c_str(), numSampleRead, m_streams.size());
             }
 
             return numSampleRead > 0;
@@ -492,19 +518,19 @@ bool TextParser<ElemType>::TryReadRow(SequenceBuffer& sequence, size_t& bytesToR
         if (isColumnDelimiter(c))
         {
             // skip column (input) delimiters.
-            m_fileReader->Pop();
+            reader.Pop();
             --bytesToRead;
             continue;
         }
 
-        if (TryReadSample(sequence, bytesToRead))
+        if (TryReadSample(reader, sequence, bytesToRead))
         {
             numSampleRead++;
         }
         else
         {
             // skip over until the next sample/end of row
-            SkipToNextInput(bytesToRead);
+            SkipToNextInput(reader, bytesToRead);
         }
     }
 
@@ -513,7 +539,7 @@ bool TextParser<ElemType>::TryReadRow(SequenceBuffer& sequence, size_t& bytesToR
         fprintf(stderr,
             "WARNING: Exhausted all input expected for the current sequence"
             " while reading an input row %ls."
-            " Possibly, a trailing newline is missing.\n", GetFileInfo().c_str());
+            " Possibly, a trailing newline is missing.\n", GetFileInfo(reader).c_str());
     }
 
     // Return true when we've consumed all expected input.
@@ -522,38 +548,39 @@ bool TextParser<ElemType>::TryReadRow(SequenceBuffer& sequence, size_t& bytesToR
 
 // Reads one sample (an pipe-prefixed input identifier followed by a list of values)
 template <class ElemType>
-bool TextParser<ElemType>::TryReadSample(SequenceBuffer& sequence, size_t& bytesToRead)
+template <class Reader>
+bool TextParser<ElemType>::TryReadSample(Reader& reader, SequenceBuffer& sequence, size_t& bytesToRead)
 {
     // prefix check.
-    if (m_fileReader->Peek() != NAME_PREFIX)
+    if (reader.Peek() != NAME_PREFIX)
     {
         if (ShouldWarn())
         {
             fprintf(stderr,
                 "WARNING: Unexpected character('%c') in place of a name prefix ('%c')"
                 " in an input name %ls.\n",
-                m_fileReader->Peek(), NAME_PREFIX, GetFileInfo().c_str());
+                reader.Peek(), NAME_PREFIX, GetFileInfo(reader).c_str());
         }
         IncrementNumberOfErrorsOrDie();
         return false;
     }
 
     // skip name prefix
-    m_fileReader->Pop();
+    reader.Pop();
     --bytesToRead;
 
-    if (bytesToRead && CanRead() && m_fileReader->Peek() == ESCAPE_SYMBOL)
+    if (bytesToRead && !reader.Empty() && reader.Peek() == ESCAPE_SYMBOL)
     {
         // A vertical bar followed by the number sign (|#) is treated as an escape sequence, 
         // everything that follows is ignored until the next vertical bar or the end of 
         // row, whichever comes first.
-        m_fileReader->Pop();
+        reader.Pop();
         --bytesToRead;
         return false;
     }
 
     size_t id;
-    if (!TryGetInputId(id, bytesToRead))
+    if (!TryGetInputId(reader, id, bytesToRead))
     {
         return false;
     }
@@ -566,7 +593,7 @@ bool TextParser<ElemType>::TryReadSample(SequenceBuffer& sequence, size_t& bytes
         vector<ElemType>& values = data->m_buffer;
         size_t size = values.size();
         assert(size % stream.m_sampleShape.Dimensions()[0] == 0);
-        if (!TryReadDenseSample(values, stream.m_sampleShape.Dimensions()[0], bytesToRead))
+        if (!TryReadDenseSample(reader, values, stream.m_sampleShape.Dimensions()[0], bytesToRead))
         {
             // expected a dense sample, but was not able to fully read it, ignore it.
             if (values.size() != size)
@@ -587,7 +614,7 @@ bool TextParser<ElemType>::TryReadSample(SequenceBuffer& sequence, size_t& bytes
         vector<SparseIndexType>& indices = data->m_indicesBuffer;
         assert(values.size() == indices.size());
         size_t size = values.size();
-        if (!TryReadSparseSample(values, indices, stream.m_sampleShape.Dimensions()[0], bytesToRead))
+        if (!TryReadSparseSample(reader, values, indices, stream.m_sampleShape.Dimensions()[0], bytesToRead))
         {
             // expected a sparse sample, but something went south, ignore it.
             if (values.size() != size)
@@ -615,22 +642,22 @@ bool TextParser<ElemType>::TryReadSample(SequenceBuffer& sequence, size_t& bytes
 }
 
 template <class ElemType>
-bool TextParser<ElemType>::TryGetInputId(size_t& id, size_t& bytesToRead)
+template <class Reader>
+bool TextParser<ElemType>::TryGetInputId(Reader& reader, size_t& id, size_t& bytesToRead)
 {
-    char* scratchIndex = m_scratch.get();
+    // a local buffer, the parser may be used by several threads at once.
+    string name;
 
-    for (; bytesToRead && CanRead(); m_fileReader->Pop(), --bytesToRead)
+    for (; bytesToRead && !reader.Empty(); reader.Pop(), --bytesToRead)
     {
-        unsigned char c = m_fileReader->Peek();
+        unsigned char c = reader.Peek();
 
         // stop as soon as there's a value delimiter, an input prefix
         // or a non-printable character (e.g., newline, carriage return).
         if (isValueDelimiter(c) || c == NAME_PREFIX || isNonPrintable(c))
         {
-            size_t size = scratchIndex - m_scratch.get();
-            if (size)
+            if (!name.empty())
             {
-                string name(m_scratch.get(), size);
                 auto it = m_aliasToIdMap.find(name);
                 if (it != m_aliasToIdMap.end())
                 {
@@ -643,7 +670,7 @@ bool TextParser<ElemType>::TryGetInputId(size_t& id, size_t& bytesToRead)
                     fprintf(stderr,
                         "INFO: Skipping unknown input ('%s') %ls. "
                         "Input name '%s' was not specified in the reader config section.\n",
-                        name.c_str(), GetFileInfo().c_str(), name.c_str());
+                        name.c_str(), GetFileInfo(reader).c_str(), name.c_str());
                 }
 
                 // return false here to skip this input, but do not call IncrementNumberOfErrorsOrDie()
@@ -655,15 +682,14 @@ bool TextParser<ElemType>::TryGetInputId(size_t& id, size_t& bytesToRead)
                 fprintf(stderr,
                     "WARNING: Input name prefix ('%c') is followed by"
                     " an invalid character ('%c') %ls.\n",
-                    NAME_PREFIX, c, GetFileInfo().c_str());
+                    NAME_PREFIX, c, GetFileInfo(reader).c_str());
             }
 
             break;
         }
-        else if (scratchIndex < (m_scratch.get() + m_maxAliasLength))
+        else if (name.length() < m_maxAliasLength)
         {
-            *scratchIndex = c;
-            ++scratchIndex;
+            name.push_back(c);
         }
         else
         {
@@ -671,12 +697,11 @@ bool TextParser<ElemType>::TryGetInputId(size_t& id, size_t& bytesToRead)
             // yet it's not followed by a delimiter.
             if (m_traceLevel >= Info)
             {
-                string namePrefix(m_scratch.get(), m_maxAliasLength);
                 fprintf(stderr,
                     "INFO: Skipping unknown input %ls. "
                     "Input name (with the %" PRIu64 "-character prefix '%s') "
                     "exceeds the maximum expected length (%" PRIu64 ").\n",
-                    GetFileInfo().c_str(), m_maxAliasLength, namePrefix.c_str(), m_maxAliasLength);
+                    GetFileInfo(reader).c_str(), m_maxAliasLength, name.c_str(), m_maxAliasLength);
             }
             return false;
         }
@@ -687,13 +712,13 @@ bool TextParser<ElemType>::TryGetInputId(size_t& id, size_t& bytesToRead)
         {
             fprintf(stderr,
                 "WARNING: Exhausted all input expected for the current sequence"
-                " while reading an input name %ls.\n", GetFileInfo().c_str());
+                " while reading an input name %ls.\n", GetFileInfo(reader).c_str());
         }
-        else if (!CanRead()) 
+        else if (reader.Empty()) 
         {
             fprintf(stderr,
                 "WARNING: Expected %" PRIu64 " more bytes, but no more input is available for the current sequence"
-                " while reading an input name %ls.\n", bytesToRead, GetFileInfo().c_str());
+                " while reading an input name %ls.\n", bytesToRead, GetFileInfo(reader).c_str());
         }
     }
     
@@ -703,19 +728,20 @@ bool TextParser<ElemType>::TryGetInputId(size_t& id, size_t& bytesToRead)
 }
 
 template <class ElemType>
-bool TextParser<ElemType>::TryReadDenseSample(vector<ElemType>& values, size_t sampleSize, size_t& bytesToRead)
+template <class Reader>
+bool TextParser<ElemType>::TryReadDenseSample(Reader& reader, vector<ElemType>& values, size_t sampleSize, size_t& bytesToRead)
 {
     size_t counter = 0;
     ElemType value;
 
-    while (bytesToRead && CanRead())
+    while (bytesToRead && !reader.Empty())
     {
-        char c = m_fileReader->Peek();
+        char c = reader.Peek();
 
         if (isValueDelimiter(c))
         {
             // skip value delimiters
-            m_fileReader->Pop();
+            reader.Pop();
             --bytesToRead;
             continue;
         }
@@ -730,7 +756,7 @@ bool TextParser<ElemType>::TryReadDenseSample(vector<ElemType>& values, size_t s
                     fprintf(stderr,
                         "WARNING: Dense sample (size = %" PRIu64 ") %ls"
                         " exceeds the expected size (%" PRIu64 ").\n",
-                        counter, GetFileInfo().c_str(), sampleSize);
+                        counter, GetFileInfo(reader).c_str(), sampleSize);
                 }
                 return false;
             }
@@ -744,7 +770,7 @@ bool TextParser<ElemType>::TryReadDenseSample(vector<ElemType>& values, size_t s
                     fprintf(stderr,
                         "WARNING: A dense sample %ls has a sparse suffix "
                         "(expected size = %" PRIu64 ", actual size = %" PRIu64 ").\n",
-                        GetFileInfo().c_str(), sampleSize, counter);
+                        GetFileInfo(reader).c_str(), sampleSize, counter);
                 }
                 for (; counter < sampleSize; ++counter)
                 {
@@ -755,7 +781,7 @@ bool TextParser<ElemType>::TryReadDenseSample(vector<ElemType>& values, size_t s
             return true;
         }
 
-        if (!TryReadRealNumber(value, bytesToRead))
+        if (!TryReadRealNumber(reader, value, bytesToRead))
         {
             // bail out.
             return false;
@@ -771,13 +797,13 @@ bool TextParser<ElemType>::TryReadDenseSample(vector<ElemType>& values, size_t s
         {
             fprintf(stderr,
                 "WARNING: Exhausted all input expected for the current sequence"
-                " while reading a dense sample %ls.\n", GetFileInfo().c_str());
+                " while reading a dense sample %ls.\n", GetFileInfo(reader).c_str());
         }
-        else if (!CanRead())
+        else if (reader.Empty())
         {
             fprintf(stderr,
                 "WARNING: Expected %" PRIu64 " more bytes, but no more input is available for the current sequence"
-                " while reading a dense sample %ls.\n", bytesToRead, GetFileInfo().c_str());
+                " while reading a dense sample %ls.\n", bytesToRead, GetFileInfo(reader).c_str());
         }
     }
 
@@ -787,20 +813,21 @@ bool TextParser<ElemType>::TryReadDenseSample(vector<ElemType>& values, size_t s
 }
 
 template <class ElemType>
-bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, std::vector<SparseIndexType>& indices,
+template <class Reader>
+bool TextParser<ElemType>::TryReadSparseSample(Reader& reader, std::vector<ElemType>& values, std::vector<SparseIndexType>& indices,
     size_t sampleSize, size_t& bytesToRead)
 {
     size_t index = 0;
     ElemType value;
 
-    while (bytesToRead && CanRead())
+    while (bytesToRead && !reader.Empty())
     {
-        char c = m_fileReader->Peek();
+        char c = reader.Peek();
 
         if (isValueDelimiter(c))
         {
             // skip value delimiters
-            m_fileReader->Pop();
+            reader.Pop();
             --bytesToRead;
             continue;
         }
@@ -813,7 +840,7 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
         }
 
         // read next sparse index
-        if (!TryReadUint64(index, bytesToRead))
+        if (!TryReadUint64(reader, index, bytesToRead))
         {
             // bail out.
             return false;
@@ -826,14 +853,14 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
                 fprintf(stderr,
                     "WARNING: Sparse index value (%" PRIu64 ") %ls"
                     " exceeds the maximum expected value (%" PRIu64 ").\n",
-                    index, GetFileInfo().c_str(), sampleSize - 1);
+                    index, GetFileInfo(reader).c_str(), sampleSize - 1);
             }
             // bail out.
             return false;
         }
 
         // an index must be followed by a delimiter
-        c = m_fileReader->Peek();
+        c = reader.Peek();
         if (c != INDEX_DELIMITER)
         {
             if (ShouldWarn())
@@ -842,17 +869,17 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
                     "WARNING: Unexpected character('%c')"
                     " in place of the index delimiter ('%c')"
                     " after a sparse value index (%" PRIu64 ") %ls.\n",
-                    c, INDEX_DELIMITER, index, GetFileInfo().c_str());
+                    c, INDEX_DELIMITER, index, GetFileInfo(reader).c_str());
             }
             return false;
         }
 
         // skip index delimiter
-        m_fileReader->Pop();
+        reader.Pop();
         --bytesToRead;
 
         // read the corresponding value
-        if (!TryReadRealNumber(value, bytesToRead))
+        if (!TryReadRealNumber(reader, value, bytesToRead))
         {
             // bail out.
             return false;
@@ -868,13 +895,13 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
         {
             fprintf(stderr,
                 "WARNING: Exhausted all input expected for the current sequence"
-                " while reading a sparse sample %ls.\n", GetFileInfo().c_str());
+                " while reading a sparse sample %ls.\n", GetFileInfo(reader).c_str());
         }
-        else if (!CanRead())
+        else if (reader.Empty())
         {
             fprintf(stderr,
                 "WARNING: Expected %" PRIu64 " more bytes, but no more input is available for the current sequence"
-                " while reading a sparse sample %ls.\n", bytesToRead, GetFileInfo().c_str());
+                " while reading a sparse sample %ls.\n", bytesToRead, GetFileInfo(reader).c_str());
         }
     }
 
@@ -884,11 +911,12 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
 }
 
 template <class ElemType>
-void TextParser<ElemType>::SkipToNextInput(size_t& bytesToRead)
+template <class Reader>
+void TextParser<ElemType>::SkipToNextInput(Reader& reader, size_t& bytesToRead)
 {
-    for (; bytesToRead && CanRead(); m_fileReader->Pop(), --bytesToRead)
+    for (; bytesToRead && !reader.Empty(); reader.Pop(), --bytesToRead)
     {
-        char c = m_fileReader->Peek();
+        char c = reader.Peek();
         // skip everything until we hit either an input marker or the end of row.
         if (c == NAME_PREFIX || c == ROW_DELIMITER)
         {
@@ -898,13 +926,14 @@ void TextParser<ElemType>::SkipToNextInput(size_t& bytesToRead)
 }
 
 template <class ElemType>
-bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
+template <class Reader>
+bool TextParser<ElemType>::TryReadUint64(Reader& reader, size_t& value, size_t& bytesToRead)
 {
     value = 0;
     bool found = false;
-    for (; bytesToRead && CanRead(); m_fileReader->Pop(), --bytesToRead)
+    for (; bytesToRead && !reader.Empty(); reader.Pop(), --bytesToRead)
     {
-        char c = m_fileReader->Peek();
+        char c = reader.Peek();
 
         if (!IsDigit(c))
         {
@@ -912,7 +941,7 @@ bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
             {
                 fprintf(stderr,
                     "WARNING: Expected a uint64 value, but none found %ls.\n", 
-                    GetFileInfo().c_str());
+                    GetFileInfo(reader).c_str());
             }
 
             return found;
@@ -928,7 +957,7 @@ bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
             {
                 fprintf(stderr,
                     "WARNING: Overflow while reading a uint64 value %ls.\n",
-                    GetFileInfo().c_str());
+                    GetFileInfo(reader).c_str());
             }
 
             return false;
@@ -941,13 +970,13 @@ bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
         if (bytesToRead == 0) {
             fprintf(stderr,
                 "WARNING: Exhausted all input expected for the current sequence"
-                " while reading a uint64 value %ls.\n", GetFileInfo().c_str());
+                " while reading a uint64 value %ls.\n", GetFileInfo(reader).c_str());
         }
-        else if (!CanRead())
+        else if (reader.Empty())
         {
             fprintf(stderr,
                 "WARNING: Expected %" PRIu64 " more bytes, but no more input is available for the current sequence"
-                " while reading a uint64 value %ls.\n", bytesToRead, GetFileInfo().c_str());
+                " while reading a uint64 value %ls.\n", bytesToRead, GetFileInfo(reader).c_str());
         }
         
     }
@@ -966,15 +995,16 @@ bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
 // cannot be parsed as part of a floating point number.
 // Returns true if parsing was successful.
 template <class ElemType>
-bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRead)
+template <class Reader>
+bool TextParser<ElemType>::TryReadRealNumber(Reader& reader, ElemType& value, size_t& bytesToRead)
 {
     State state = State::Init;
     double coefficient = .0, number = .0, divider = .0;
     bool negative = false;
 
-    for (; bytesToRead && CanRead(); m_fileReader->Pop(), --bytesToRead)
+    for (; bytesToRead && !reader.Empty(); reader.Pop(), --bytesToRead)
     {
-        char c = m_fileReader->Peek();
+        char c = reader.Peek();
 
         switch (state)
         {
@@ -997,7 +1027,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
                     fprintf(stderr,
                         "WARNING: Unexpected character ('%c')"
                         " in a floating point value %ls.\n",
-                        c, GetFileInfo().c_str());
+                        c, GetFileInfo(reader).c_str());
                 }
                 return false;
             }
@@ -1016,7 +1046,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
                     fprintf(stderr,
                         "WARNING: A sign symbol is followed by an invalid character('%c')"
                         " in a floating point value %ls.\n",
-                        c, GetFileInfo().c_str());
+                        c, GetFileInfo(reader).c_str());
                 }
                 return false;
             }
@@ -1100,7 +1130,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
                     fprintf(stderr,
                         "WARNING: An exponent symbol is followed by"
                         " an invalid character('%c')"
-                        " in a floating point value %ls.\n", c, GetFileInfo().c_str());
+                        " in a floating point value %ls.\n", c, GetFileInfo(reader).c_str());
                 }
                 return false;
             }
@@ -1119,7 +1149,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
                     fprintf(stderr,
                         "WARNING: An exponent sign symbol followed by"
                         " an unexpected character('%c')"
-                        " in a floating point value %ls.\n", c, GetFileInfo().c_str());
+                        " in a floating point value %ls.\n", c, GetFileInfo(reader).c_str());
                 }
                 return false;
             }
@@ -1143,7 +1173,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
             {
                 fprintf(stderr,
                     "WARNING: Reached an invalid state while reading a floating point value %ls.\n",
-                    GetFileInfo().c_str());
+                    GetFileInfo(reader).c_str());
             }
             return false;
         }
@@ -1157,7 +1187,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
             fprintf(stderr,
                 "WARNING: Exhausted all input expected for the current sequence"
                 " while reading an input row %ls."
-                " Possibly, a trailing newline is missing.\n", GetFileInfo().c_str());
+                " Possibly, a trailing newline is missing.\n", GetFileInfo(reader).c_str());
         }
 
         switch (state)
@@ -1181,7 +1211,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
         {
             fprintf(stderr,
                 "WARNING: Reached an invalid state while reading a floating point value %ls.\n",
-                GetFileInfo().c_str());
+                GetFileInfo(reader).c_str());
         }
         return false;
     }
@@ -1190,7 +1220,7 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
     {
         fprintf(stderr,
             "WARNING: Expected %" PRIu64 " more bytes, but no more input is available for the current sequence"
-            " while reading an input row %ls.\n", bytesToRead, GetFileInfo().c_str());
+            " while reading an input row %ls.\n", bytesToRead, GetFileInfo(reader).c_str());
     }
 
     return false;
@@ -1232,23 +1262,18 @@ void TextParser<ElemType>::SetCacheIndex(bool value)
     m_cacheIndex = value;
 }
 
-template<class ElemType>
-inline bool TextParser<ElemType>::CanRead()
-{
-    return !m_fileReader->Empty();
-}
-
 template <class ElemType>
-int64_t TextParser<ElemType>::GetFileOffset() const
+void TextParser<ElemType>::SetMemoryMapping(bool value)
 {
-    return m_fileReader->GetFileOffset();
+    m_memoryMapping = value;
 }
 
 template <class ElemType>
-std::wstring TextParser<ElemType>::GetFileInfo()
+template <class Reader>
+std::wstring TextParser<ElemType>::GetFileInfo(const Reader& reader)
 {
     std::wstringstream info;
-    info << L"at offset " << GetFileOffset() << L" in the input file (" << m_filename << L")";
+    info << L"at offset " << reader.GetFileOffset() << L" in the input file (" << m_filename << L")";
     return info.str();
 }
 
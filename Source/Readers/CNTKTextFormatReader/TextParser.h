@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <atomic>
 #include "DataDeserializerBase.h"
 #include "Descriptors.h"
 #include "TextConfigHelper.h"
@@ -18,6 +19,7 @@ class CNTKTextFormatReaderTestRunner;
 
 class FileWrapper;
 class BufferedFileReader;
+class MemoryMappedFile;
 
 // TODO: more details when tracing warnings
 // (e.g., buffer content around the char that triggered the warning)
@@ -110,6 +112,10 @@ private:
     std::shared_ptr<FileWrapper> m_file;
     std::shared_ptr<BufferedFileReader> m_fileReader;
 
+    // The whole input file, when it is memory mapped. In this mode sequences
+    // are parsed straight from the mapped pages, several at a time.
+    std::shared_ptr<MemoryMappedFile> m_mappedFile;
+
     // An internal structure to assist with copying from input stream buffers into
     // into sequence data in a proper format.
     struct StreamInfo;
@@ -121,18 +127,17 @@ private:
 
     std::shared_ptr<Index> m_index;
 
-    unique_ptr<char[]> m_scratch; // local buffer for string parsing
-
     // Indicates if the sequence length is computed as the maximum 
     // of number of samples across all streams (inputs).
     bool m_useMaximumAsSequenceLength;
 
     size_t m_chunkSizeBytes;
     unsigned int m_traceLevel;
-    bool m_hadWarnings;
-    unsigned int m_numAllowedErrors;
+    std::atomic<bool> m_hadWarnings;
+    std::atomic<unsigned int> m_numAllowedErrors;
     bool m_skipSequenceIds;
     bool m_cacheIndex;
+    bool m_memoryMapping;
     unsigned int m_numRetries; // specifies the number of times an unsuccessful
                                // file operation should be repeated (default value is 5).
 
@@ -147,43 +152,53 @@ private:
     // have been swallowed.
     void PrintWarningNotification();
 
-    int64_t GetFileOffset() const;
+    // The parsing methods below are templated on the input reader, which is either
+    // the BufferedFileReader or a MemoryBufferReader over the mapped file.
+    // They do not modify the parser, except for its (thread-safe) error and warning counters,
+    // so that several sequences can be parsed at the same time with different readers.
 
-    void SkipToNextInput(size_t& bytesToRead);
+    template <class Reader>
+    void SkipToNextInput(Reader& reader, size_t& bytesToRead);
 
     // Returns a string containing input file information (current offset, file name, etc.),
     // which can be included as a part of the trace/log message.
-    std::wstring GetFileInfo();
+    template <class Reader>
+    std::wstring GetFileInfo(const Reader& reader);
 
     // Reads an alias/name and converts it to an internal stream id (= stream index).
-    bool TryGetInputId(size_t& id, size_t& bytesToRead);
+    template <class Reader>
+    bool TryGetInputId(Reader& reader, size_t& id, size_t& bytesToRead);
 
-    bool TryReadRealNumber(ElemType& value, size_t& bytesToRead);
+    template <class Reader>
+    bool TryReadRealNumber(Reader& reader, ElemType& value, size_t& bytesToRead);
 
-    bool TryReadUint64(size_t& value, size_t& bytesToRead);
+    template <class Reader>
+    bool TryReadUint64(Reader& reader, size_t& value, size_t& bytesToRead);
 
     // Reads dense sample values into the provided vector.
-    bool TryReadDenseSample(std::vector<ElemType>& values, size_t sampleSize, size_t& bytesToRead);
+    template <class Reader>
+    bool TryReadDenseSample(Reader& reader, std::vector<ElemType>& values, size_t sampleSize, size_t& bytesToRead);
 
     // Reads sparse sample values and corresponding indices into the provided vectors.
-    bool TryReadSparseSample(std::vector<ElemType>& values, std::vector<SparseIndexType>& indices,
+    template <class Reader>
+    bool TryReadSparseSample(Reader& reader, std::vector<ElemType>& values, std::vector<SparseIndexType>& indices,
         size_t sampleSize, size_t& bytesToRead);
 
     // Reads one sample (an input identifier followed by a list of values)
-    bool TryReadSample(SequenceBuffer& sequence, size_t& bytesToRead);
+    template <class Reader>
+    bool TryReadSample(Reader& reader, SequenceBuffer& sequence, size_t& bytesToRead);
 
     // Reads one whole row (terminated by a row delimiter) of samples
-    bool TryReadRow(SequenceBuffer& sequence, size_t& bytesToRead);
-
-    // Returns true if there's still data available.
-    bool inline CanRead();
+    template <class Reader>
+    bool TryReadRow(Reader& reader, SequenceBuffer& sequence, size_t& bytesToRead);
 
     // Returns true if the trace level is greater or equal to 'Warning'
     bool inline ShouldWarn() { m_hadWarnings = true; return m_traceLevel >= Warning; }
 
-    // Given a descriptor and the file offset of the containing chunk,
-    // retrieves the data for the corresponding sequence from the file.
-    SequenceBuffer LoadSequence(const SequenceDescriptor& descriptor, size_t chunkOffset);
+    // Given a descriptor, retrieves the data for the corresponding sequence
+    // from the reader, which has to be positioned at the start of the sequence.
+    template <class Reader>
+    SequenceBuffer LoadSequence(Reader& reader, const SequenceDescriptor& descriptor);
 
     // Given a descriptor, retrieves the data for the corresponding chunk from the file.
     void LoadChunk(TextChunkPtr& chunk, const ChunkDescriptor& descriptor);
@@ -203,6 +218,8 @@ private:
 
     void SetCacheIndex(bool value);
 
+    void SetMemoryMapping(bool value);
+
     friend class CNTKTextFormatReaderTestRunner<ElemType>;
 
     DISABLE_COPY_AND_MOVE(TextParser);
@@ -13,6 +13,7 @@
 
 #include "CompositeDataReader.h"
 #include "Bundler.h"
+#include "ChunkCache.h"
 #include "BlockRandomizer.h"
 #include "NoRandomizer.h"
 #include "FramePacker.h"
@@ -103,6 +104,11 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
         deserializer = std::make_shared<Bundler>(config, deserializer, m_deserializers, cleanse);
     }
 
+    // Keeping (bundled) chunks in memory, with a budget shared by all deserializers.
+    size_t chunkCacheSize = config(L"chunkCacheSizeInBytes", (size_t)0);
+    if (chunkCacheSize > 0)
+        deserializer = std::make_shared<ChunkCache>(deserializer, chunkCacheSize);
+
     int verbosity = config(L"verbosity", 0);
 
     // Pick up the randomizer, always picking up no randomization for the write mode.
@@ -164,8 +170,15 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
             }
 
             bool shouldPrefetch = true;
+
+            // Loading several chunks ahead hides the latency of slow (e.g. network) file systems.
+            ChunkPrefetchConfiguration prefetchConfig;
+            prefetchConfig.m_depth = config(L"prefetchDepth", prefetchConfig.m_depth);
+            prefetchConfig.m_numThreads = config(L"prefetchThreads", prefetchConfig.m_numThreads);
+            prefetchConfig.m_maxSamples = config(L"prefetchMaxSamples", prefetchConfig.m_maxSamples);
+
             m_sequenceEnumerator = std::make_shared<BlockRandomizer>(verbosity, randomizationWindow, deserializer, shouldPrefetch,
-                multiThreadedDeserialization, maxErrors, sampleBasedRandomizationWindow, GetRandomSeed(config));
+                multiThreadedDeserialization, maxErrors, sampleBasedRandomizationWindow, GetRandomSeed(config), prefetchConfig);
         }
         else
             m_sequenceEnumerator = std::make_shared<NoRandomizer>(deserializer, multiThreadedDeserialization, maxErrors);
@@ -186,6 +199,11 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
 
     // Check whether to use local timeline, by default we use it for better performance.
     bool localTimeline = config(L"localTimeline", true);
+
+    // Number of minibatches to read ahead and regroup by sequence length (sequence mode only).
+    size_t bucketingWindow = config(L"bucketingWindow", (size_t)0);
+    if (bucketingWindow > 0 && m_packingMode != PackingMode::sequence)
+        InvalidArgument("bucketingWindow can only be used for full sequences, not with frameMode or truncated BPTT.");
     switch (m_packingMode)
     {
     case PackingMode::sample:
@@ -202,7 +220,9 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
             outputStreams,
             numAlternatingBuffers,
             localTimeline,
-            m_corpus);
+            m_corpus,
+            bucketingWindow,
+            verbosity);
         break;
     case PackingMode::truncated:
     {
@@ -0,0 +1,520 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <cstring>
+#include "BinaryChunkCache.h"
+#include "EnvironmentUtil.h"
+
+namespace CNTK {
+
+using namespace std;
+
+// Same as in the CNTKBinaryReader.
+enum class MatrixEncodingType : unsigned char
+{
+    dense = 0,
+    sparse_csc = 1,
+};
+
+enum class CachedDataType : unsigned char
+{
+    tfloat = 0,
+    tdouble = 1,
+};
+
+static size_t SizeOfElement(DataType type)
+{
+    return type == DataType::Double ? sizeof(double) : sizeof(float);
+}
+
+namespace {
+
+struct CachedDenseSequence : DenseSequenceData
+{
+    const void* GetDataBuffer() override { return m_data; }
+    const NDShape& GetSampleShape() override { return *m_sampleShape; }
+
+    const void* m_data;
+    const NDShape* m_sampleShape;
+    shared_ptr<vector<char>> m_buffer; // keeps the data alive
+};
+
+struct CachedSparseSequence : SparseSequenceData
+{
+    const void* GetDataBuffer() override { return m_data; }
+    const NDShape& GetSampleShape() override { return *m_sampleShape; }
+
+    const void* m_data;
+    const NDShape* m_sampleShape;
+    shared_ptr<vector<char>> m_buffer;
+};
+
+template <class T>
+inline void Append(vector<char>& buffer, const T& value)
+{
+    const char* p = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+inline void Append(vector<char>& buffer, const void* data, size_t size)
+{
+    const char* p = reinterpret_cast<const char*>(data);
+    buffer.insert(buffer.end(), p, p + size);
+}
+
+template <class T>
+inline T Take(const char*& p)
+{
+    T value;
+    memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return value;
+}
+
+}
+
+// Sequences of a chunk read from the cache. They point into the buffer the chunk was read into.
+class BinaryChunkCache::CachedChunk : public Chunk
+{
+public:
+    void GetSequence(size_t sequenceId, vector<SequenceDataPtr>& result) override
+    {
+        assert(sequenceId < m_sequences.size());
+        const auto& sequence = m_sequences[sequenceId];
+        result.insert(result.end(), sequence.begin(), sequence.end());
+    }
+
+    vector<vector<SequenceDataPtr>> m_sequences;
+};
+
+BinaryChunkCache::BinaryChunkCache(DataDeserializerPtr deserializer, const wstring& inputFilename, bool writable,
+                                   size_t numberOfWorkers, size_t workerRank)
+    : m_deserializer(deserializer),
+      m_streams(deserializer->StreamInfos()),
+      m_chunks(deserializer->ChunkInfos()),
+      m_inputFilename(inputFilename),
+      m_numCachedChunks(0),
+      m_fileSize(0),
+      m_isComplete(false),
+      m_isWritable(writable),
+      m_isWrittenByOtherWorker(false)
+{
+    for (const auto& stream : m_streams)
+    {
+        if (stream.m_storageFormat != StorageFormat::Dense && stream.m_storageFormat != StorageFormat::SparseCSC)
+            InvalidArgument("Binary chunk cache: stream '%ls' has an unsupported storage format.", stream.m_name.c_str());
+
+        if (stream.m_elementType != DataType::Float && stream.m_elementType != DataType::Double)
+            InvalidArgument("Binary chunk cache: stream '%ls' has an unsupported element type.", stream.m_name.c_str());
+    }
+
+    {
+        FileWrapper input = FileWrapper::OpenOrDie(inputFilename, L"rb");
+        m_filename = inputFilename + L"." + std::to_wstring(input.Filesize()) + L".cbf";
+    }
+    m_tempFilename = m_filename + L".chunks.tmp";
+
+    m_locations.resize(m_chunks.size(), ChunkLocation{ 0, 0 });
+
+    if (msra::files::fuptodate(m_filename, inputFilename, true) && TryOpen())
+    {
+        m_isComplete = true;
+        m_numCachedChunks = m_chunks.size();
+        m_isWritable = false;
+        return;
+    }
+
+    if (workerRank != 0)
+    {
+        // only the main worker writes the cache file, the others use it once it is there.
+        m_isWrittenByOtherWorker = m_isWritable;
+        m_isWritable = false;
+    }
+    else if (m_isWritable && numberOfWorkers > 1)
+    {
+        // the main worker only sees its share of the chunks, so they are all written up front.
+        WriteAllChunks();
+    }
+}
+
+BinaryChunkCache::~BinaryChunkCache()
+{
+    // A cache that was not completed is not reused by a later run.
+    if (!m_isComplete && m_file)
+    {
+        m_file.reset();
+        _wunlink(m_tempFilename.c_str());
+    }
+}
+
+bool BinaryChunkCache::TryOpen()
+{
+    auto file = make_unique<FileWrapper>(m_filename, L"rb");
+    if (!file->IsOpen())
+        return false;
+
+    uint64_t magic;
+    uint32_t version;
+    if (!file->TryRead(magic) || magic != s_magic || !file->TryRead(version) || version != s_version)
+        return false;
+
+    // The header offset is stored in the last 8 bytes of the file.
+    int64_t headerOffset;
+    if (!file->TrySeek(-int64_t(sizeof(headerOffset)), SEEK_END) || !file->TryRead(headerOffset) ||
+        !file->TrySeek(headerOffset, SEEK_SET))
+        return false;
+
+    uint32_t numChunks, numInputs;
+    if (!file->TryRead(magic) || magic != s_magic || !file->TryRead(numChunks) || !file->TryRead(numInputs) ||
+        numChunks != m_chunks.size() || numInputs != m_streams.size())
+        return false;
+
+    for (const auto& stream : m_streams)
+    {
+        MatrixEncodingType encoding;
+        uint32_t length;
+        if (!file->TryRead(encoding) || !file->TryRead(length))
+            return false;
+
+        string name(length, '\0');
+        CachedDataType type;
+        uint32_t dimension;
+        if ((length > 0 && !file->TryRead(&name[0], 1, length)) || !file->TryRead(type) || !file->TryRead(dimension))
+            return false;
+
+        auto expectedEncoding = stream.m_storageFormat == StorageFormat::Dense ? MatrixEncodingType::dense : MatrixEncodingType::sparse_csc;
+        auto expectedType = stream.m_elementType == DataType::Double ? CachedDataType::tdouble : CachedDataType::tfloat;
+        if (encoding != expectedEncoding || type != expectedType || dimension != stream.m_sampleLayout.TotalSize() ||
+            name != msra::strfun::utf8(stream.m_name))
+            return false;
+    }
+
+    vector<ChunkTableEntry> table(numChunks);
+    if (numChunks > 0 && !file->TryRead(table.data(), sizeof(ChunkTableEntry), numChunks))
+        return false;
+
+    vector<ChunkLocation> locations(numChunks);
+    for (size_t i = 0; i < numChunks; ++i)
+    {
+        if (table[i].m_numSequences != m_chunks[i].m_numberOfSequences || table[i].m_numSamples != m_chunks[i].m_numberOfSamples)
+            return false;
+
+        int64_t end = i + 1 < numChunks ? table[i + 1].m_offset : headerOffset;
+        if (table[i].m_offset < 0 || end < table[i].m_offset)
+            return false;
+
+        locations[i] = ChunkLocation{ table[i].m_offset, size_t(end - table[i].m_offset) };
+    }
+
+    m_locations = move(locations);
+    m_file = move(file);
+    return true;
+}
+
+bool BinaryChunkCache::TryOpenWrittenByOtherWorker()
+{
+    if (!m_isWrittenByOtherWorker || !msra::files::fuptodate(m_filename, m_inputFilename, true))
+        return false;
+
+    // The cache file is renamed into place once it is complete, so it is either missing or complete.
+    if (!TryOpen())
+    {
+        m_isWrittenByOtherWorker = false;
+        fprintf(stderr, "WARNING: Binary chunk cache '%ls' cannot be used, it does not match the input.\n", m_filename.c_str());
+        return false;
+    }
+
+    fprintf(stderr, "Switching to the binary chunk cache '%ls'.\n", m_filename.c_str());
+    m_isComplete = true;
+    m_numCachedChunks = m_chunks.size();
+    m_isWrittenByOtherWorker = false;
+    return true;
+}
+
+ChunkPtr BinaryChunkCache::GetChunk(ChunkIdType chunkId)
+{
+    {
+        unique_lock<mutex> lock(m_mutex);
+        if (m_locations[chunkId].m_size == 0)
+            TryOpenWrittenByOtherWorker();
+
+        const auto& location = m_locations[chunkId];
+        if (location.m_size != 0)
+        {
+            auto buffer = make_shared<vector<char>>(location.m_size);
+            m_file->SeekOrDie(location.m_offset, SEEK_SET);
+            m_file->ReadOrDie(buffer->data(), 1, buffer->size());
+            lock.unlock();
+
+            return Deserialize(chunkId, buffer);
+        }
+
+        if (!m_isWritable)
+        {
+            lock.unlock();
+            return m_deserializer->GetChunk(chunkId);
+        }
+    }
+
+    ChunkPtr chunk = m_deserializer->GetChunk(chunkId);
+
+    vector<SequenceInfo> sequences;
+    m_deserializer->SequenceInfosForChunk(chunkId, sequences);
+    auto data = Serialize(chunk, sequences);
+
+    unique_lock<mutex> lock(m_mutex);
+    if (!m_isWritable || m_locations[chunkId].m_size != 0)
+        return chunk;
+
+    if (!m_file)
+    {
+        m_file = make_unique<FileWrapper>(m_tempFilename, L"w+b");
+        if (!m_file->IsOpen())
+        {
+            m_file.reset();
+            DisableWriting("cannot create a temporary file");
+            return chunk;
+        }
+    }
+
+    if (!m_file->TrySeek(m_fileSize, SEEK_SET) || !m_file->TryWrite(data.data(), 1, data.size()) || !m_file->TryFlush())
+    {
+        DisableWriting("cannot write to a temporary file");
+        return chunk;
+    }
+
+    m_locations[chunkId] = ChunkLocation{ m_fileSize, data.size() };
+    m_fileSize += data.size();
+
+    if (++m_numCachedChunks == m_chunks.size())
+        Finalize();
+
+    return chunk;
+}
+
+bool BinaryChunkCache::TryWriteHeader(FileWrapper& file, const vector<ChunkLocation>& locations)
+{
+    uint64_t headerOffset;
+    bool success = file.TryTell(headerOffset);
+
+    success = success && file.TryWrite(uint64_t(s_magic)) &&
+        file.TryWrite(uint32_t(m_chunks.size())) &&
+        file.TryWrite(uint32_t(m_streams.size()));
+
+    for (const auto& stream : m_streams)
+    {
+        string name = msra::strfun::utf8(stream.m_name);
+        auto encoding = stream.m_storageFormat == StorageFormat::Dense ? MatrixEncodingType::dense : MatrixEncodingType::sparse_csc;
+        auto type = stream.m_elementType == DataType::Double ? CachedDataType::tdouble : CachedDataType::tfloat;
+        success = success && file.TryWrite(encoding) &&
+            file.TryWrite(uint32_t(name.size())) &&
+            file.TryWrite(name.data(), 1, name.size()) &&
+            file.TryWrite(type) &&
+            file.TryWrite(uint32_t(stream.m_sampleLayout.TotalSize()));
+    }
+
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+    {
+        ChunkTableEntry entry{ locations[i].m_offset, uint32_t(m_chunks[i].m_numberOfSequences), uint32_t(m_chunks[i].m_numberOfSamples) };
+        success = success && file.TryWrite(entry);
+    }
+
+    return success && file.TryWrite(int64_t(headerOffset));
+}
+
+void BinaryChunkCache::Finalize()
+{
+    bool success = TryWriteCacheFile([this](ChunkIdType chunkId, vector<char>& buffer)
+    {
+        buffer.resize(m_locations[chunkId].m_size);
+        return m_file->TrySeek(m_locations[chunkId].m_offset, SEEK_SET) &&
+            m_file->TryRead(buffer.data(), 1, buffer.size());
+    });
+
+    if (success)
+        _wunlink(m_tempFilename.c_str());
+    else
+        DisableWriting("cannot write the cache file"); // keep serving chunks from the temporary file.
+}
+
+void BinaryChunkCache::WriteAllChunks()
+{
+    fprintf(stderr, "Writing the binary chunk cache '%ls' (%zu chunks).\n", m_filename.c_str(), m_chunks.size());
+    bool success = TryWriteCacheFile([this](ChunkIdType chunkId, vector<char>& buffer)
+    {
+        vector<SequenceInfo> sequences;
+        m_deserializer->SequenceInfosForChunk(chunkId, sequences);
+        buffer = Serialize(m_deserializer->GetChunk(chunkId), sequences);
+        return true;
+    });
+
+    if (!success)
+        DisableWriting("cannot write the cache file");
+}
+
+bool BinaryChunkCache::TryWriteCacheFile(const function<bool(ChunkIdType, vector<char>&)>& getChunkData)
+{
+    // At this point, it's safe to assume that the previous cache is stale,
+    // remove the cache file if it exists (return value is ignored).
+    _wunlink(m_filename.c_str());
+
+    auto temp = m_filename + L".tmp";
+    vector<ChunkLocation> locations(m_chunks.size());
+    bool success = true;
+    {
+        FileWrapper cache(temp, L"wb");
+        success = cache.IsOpen() && cache.TryWrite(uint64_t(s_magic)) && cache.TryWrite(uint32_t(s_version));
+
+        vector<char> buffer;
+        int64_t offset = sizeof(s_magic) + sizeof(s_version);
+        for (size_t i = 0; success && i < m_chunks.size(); ++i)
+        {
+            success = getChunkData((ChunkIdType)i, buffer) &&
+                cache.TryWrite(buffer.data(), 1, buffer.size());
+
+            locations[i] = ChunkLocation{ offset, buffer.size() };
+            offset += buffer.size();
+        }
+
+        success = success && TryWriteHeader(cache, locations) && cache.TryFlush();
+    }
+
+    if (success)
+    {
+        try
+        {
+            renameOrDie(temp, m_filename);
+            auto file = make_unique<FileWrapper>(m_filename, L"rb");
+            if (file->IsOpen())
+            {
+                m_file = move(file);
+                m_locations = locations;
+                m_numCachedChunks = m_chunks.size();
+                m_isComplete = true;
+                m_isWritable = false;
+                return true;
+            }
+        }
+        catch (...) {}
+    }
+
+    _wunlink(temp.c_str());
+    return false;
+}
+
+void BinaryChunkCache::DisableWriting(const char* reason)
+{
+    fprintf(stderr, "WARNING: Binary chunk cache '%ls' is not written: %s.\n", m_filename.c_str(), reason);
+    m_isWritable = false;
+}
+
+vector<char> BinaryChunkCache::Serialize(const ChunkPtr& chunk, const vector<SequenceInfo>& sequences)
+{
+    vector<vector<SequenceDataPtr>> data(sequences.size());
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        chunk->GetSequence(sequences[i].m_indexInChunk, data[i]);
+        if (data[i].size() != m_streams.size())
+            LogicError("Binary chunk cache: expected %zu streams, but the chunk returned %zu.", m_streams.size(), data[i].size());
+    }
+
+    vector<char> buffer;
+    for (const auto& sequence : sequences)
+        Append(buffer, uint32_t(sequence.m_numberOfSamples));
+
+    for (size_t j = 0; j < m_streams.size(); ++j)
+    {
+        const auto& stream = m_streams[j];
+        size_t elementSize = SizeOfElement(stream.m_elementType);
+        for (size_t i = 0; i < sequences.size(); ++i)
+        {
+            const auto& sequence = data[i][j];
+            Append(buffer, uint32_t(sequence->m_numberOfSamples));
+            if (stream.m_storageFormat == StorageFormat::Dense)
+            {
+                Append(buffer, sequence->GetDataBuffer(), sequence->m_numberOfSamples * stream.m_sampleLayout.TotalSize() * elementSize);
+                continue;
+            }
+
+            auto sparse = static_cast<SparseSequenceData*>(sequence.get());
+            assert(sparse->m_nnzCounts.size() == sparse->m_numberOfSamples);
+            Append(buffer, int32_t(sparse->m_totalNnzCount));
+            Append(buffer, sparse->GetDataBuffer(), sparse->m_totalNnzCount * elementSize);
+            Append(buffer, sparse->m_indices, sparse->m_totalNnzCount * sizeof(int32_t));
+            Append(buffer, sparse->m_nnzCounts.data(), sparse->m_nnzCounts.size() * sizeof(int32_t));
+        }
+    }
+
+    return buffer;
+}
+
+ChunkPtr BinaryChunkCache::Deserialize(ChunkIdType chunkId, shared_ptr<vector<char>> buffer)
+{
+    vector<SequenceInfo> sequences;
+    m_deserializer->SequenceInfosForChunk(chunkId, sequences);
+
+    auto chunk = make_shared<CachedChunk>();
+    chunk->m_sequences.resize(sequences.size());
+
+    const char* p = buffer->data();
+    const char* end = buffer->data() + buffer->size();
+    // Skips 'count' items of 'size' bytes, after checking that they are in the buffer.
+    auto skip = [&](size_t count, size_t size)
+    {
+        if (size != 0 && count > size_t(end - p) / size)
+            RuntimeError("Binary chunk cache '%ls' is corrupt (chunk %u).", m_filename.c_str(), (unsigned int)chunkId);
+        const char* start = p;
+        p += count * size;
+        return start;
+    };
+
+    skip(sequences.size(), sizeof(uint32_t));
+    for (size_t j = 0; j < m_streams.size(); ++j)
+    {
+        const auto& stream = m_streams[j];
+        size_t elementSize = SizeOfElement(stream.m_elementType);
+        for (size_t i = 0; i < sequences.size(); ++i)
+        {
+            const char* start = skip(1, sizeof(uint32_t));
+            uint32_t numberOfSamples = Take<uint32_t>(start);
+            if (stream.m_storageFormat == StorageFormat::Dense)
+            {
+                auto sequence = make_shared<CachedDenseSequence>();
+                sequence->m_numberOfSamples = numberOfSamples;
+                sequence->m_data = skip(numberOfSamples, stream.m_sampleLayout.TotalSize() * elementSize);
+                sequence->m_sampleShape = &stream.m_sampleLayout;
+                sequence->m_elementType = stream.m_elementType;
+                sequence->m_key = sequences[i].m_key;
+                sequence->m_buffer = buffer;
+                chunk->m_sequences[sequences[i].m_indexInChunk].push_back(sequence);
+                continue;
+            }
+
+            auto sequence = make_shared<CachedSparseSequence>();
+            sequence->m_numberOfSamples = numberOfSamples;
+            start = skip(1, sizeof(int32_t));
+            sequence->m_totalNnzCount = Take<int32_t>(start);
+            if (sequence->m_totalNnzCount < 0)
+                RuntimeError("Binary chunk cache '%ls' is corrupt (chunk %u).", m_filename.c_str(), (unsigned int)chunkId);
+            sequence->m_data = skip(sequence->m_totalNnzCount, elementSize);
+            sequence->m_indices = reinterpret_cast<SparseIndexType*>(const_cast<char*>(skip(sequence->m_totalNnzCount, sizeof(int32_t))));
+            sequence->m_nnzCounts.resize(numberOfSamples);
+            start = skip(numberOfSamples, sizeof(int32_t));
+            if (numberOfSamples > 0)
+                memcpy(sequence->m_nnzCounts.data(), start, numberOfSamples * sizeof(int32_t));
+            sequence->m_sampleShape = &stream.m_sampleLayout;
+            sequence->m_elementType = stream.m_elementType;
+            sequence->m_key = sequences[i].m_key;
+            sequence->m_buffer = buffer;
+            chunk->m_sequences[sequences[i].m_indexInChunk].push_back(sequence);
+        }
+    }
+
+    return chunk;
+}
+
+}
@@ -0,0 +1,140 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include "DataDeserializer.h"
+#include "EnvironmentUtil.h"
+#include "FileWrapper.h"
+
+namespace CNTK {
+
+// A persistent cache of the chunks of a deserializer, in the CNTK binary format (CBF)
+// that the CNTKBinaryReader reads. Implemented as a wrapping proxy around a deserializer
+// (like ChunkCache): the first time a chunk is requested, it is loaded by the deserializer
+// and appended to a temporary file; any later request of that chunk, in this or in
+// a later run, is served from the cache without touching the original input.
+// Once all chunks have been seen, they are written out in order, together with the
+// CBF header and chunk table, to '<input file>.<input size>.cbf'.
+// The cache is invalidated when the input file changes (its size is a part of the cache
+// file name, and the cache has to be newer than the input), or when its streams or
+// chunks do not match the ones of the deserializer. Only dense and sparse streams of
+// float or double values are supported.
+// With several workers, each of them only sees a part of the chunks, so the cache would
+// never be completed by one of them: the main worker writes the cache in a single pass over
+// all chunks when it is created, and the other workers switch to it once it appears.
+class BinaryChunkCache : public DataDeserializer
+{
+public:
+    // 'writable' specifies whether the cache may be created, if it does not exist yet.
+    // Only the worker of rank 0 creates it. By default, the workers are the nodes of the MPI job
+    // and 'workerRank' is the global rank of this node in it, not its rank within its host.
+    BinaryChunkCache(DataDeserializerPtr deserializer, const std::wstring& inputFilename, bool writable = true,
+                     size_t numberOfWorkers = Microsoft::MSR::CNTK::EnvironmentUtil::GetTotalNumberOfMPINodes(),
+                     size_t workerRank = Microsoft::MSR::CNTK::EnvironmentUtil::GetGlobalMPINodeRank());
+    ~BinaryChunkCache();
+
+    virtual std::vector<StreamInformation> StreamInfos() override
+    {
+        return m_streams;
+    }
+
+    virtual std::vector<ChunkInfo> ChunkInfos() override
+    {
+        return m_chunks;
+    }
+
+    virtual void SequenceInfosForChunk(ChunkIdType chunkId, std::vector<SequenceInfo>& descriptions) override
+    {
+        return m_deserializer->SequenceInfosForChunk(chunkId, descriptions);
+    }
+
+    virtual bool GetSequenceInfo(const SequenceInfo& primary, SequenceInfo& description) override
+    {
+        return m_deserializer->GetSequenceInfo(primary, description);
+    }
+
+    // Gets chunk data given its id.
+    virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
+
+    const std::wstring& Filename() const { return m_filename; }
+
+    // Returns true if all chunks are served from the final cache file.
+    bool IsComplete() const { return m_isComplete; }
+
+    static const uint64_t s_magic = 0x636e746b5f62696eU; // "cntk_bin"
+    static const uint32_t s_version = 1;
+
+private:
+    class CachedChunk;
+
+    // Location of a chunk in the cache file.
+    struct ChunkLocation
+    {
+        int64_t m_offset;
+        size_t m_size; // 0 if the chunk is not cached
+    };
+
+    // An entry of the chunk table of the CBF format.
+    struct ChunkTableEntry
+    {
+        int64_t m_offset;
+        uint32_t m_numSequences;
+        uint32_t m_numSamples;
+    };
+
+    // Tries to open an existing cache file, returns false if it is missing or stale.
+    bool TryOpen();
+
+    // Switches to the cache file if it was written in the meantime by another worker. Has to be called with m_mutex held.
+    bool TryOpenWrittenByOtherWorker();
+
+    // Writes the header of the CBF format (stream descriptions and the chunk table).
+    bool TryWriteHeader(FileWrapper& file, const std::vector<ChunkLocation>& locations);
+
+    // Writes the cached chunks in order to the final cache file, and switches to it.
+    void Finalize();
+
+    // Loads all chunks in order, writes them to the final cache file, and switches to it.
+    void WriteAllChunks();
+
+    // Writes the final cache file, with the data of each chunk given by 'getChunkData', and switches to it.
+    bool TryWriteCacheFile(const std::function<bool(ChunkIdType, std::vector<char>&)>& getChunkData);
+
+    // Stops writing the cache, after an I/O error.
+    void DisableWriting(const char* reason);
+
+    // Serializes the chunk in the CBF format:
+    //  uint32_t: the number of samples of each sequence, followed by the data of each stream,
+    //  dense: for each sequence, uint32_t number of samples, followed by the values
+    //  sparse: for each sequence, uint32_t number of samples, int32_t nnz count, the values,
+    //  the int32_t indices and the int32_t nnz count of each sample.
+    std::vector<char> Serialize(const ChunkPtr& chunk, const std::vector<SequenceInfo>& sequences);
+
+    ChunkPtr Deserialize(ChunkIdType chunkId, std::shared_ptr<std::vector<char>> buffer);
+
+    DataDeserializerPtr m_deserializer;
+    std::vector<StreamInformation> m_streams;
+    std::vector<ChunkInfo> m_chunks;
+
+    std::wstring m_inputFilename;
+    std::wstring m_filename;
+    std::wstring m_tempFilename; // chunks, in the order they were first requested
+
+    std::mutex m_mutex;
+    std::unique_ptr<FileWrapper> m_file;
+    std::vector<ChunkLocation> m_locations;
+    size_t m_numCachedChunks;
+    int64_t m_fileSize;
+    bool m_isComplete;
+    bool m_isWritable;
+    bool m_isWrittenByOtherWorker;
+
+    DISABLE_COPY_AND_MOVE(BinaryChunkCache);
+};
+
+}
@@ -24,7 +24,8 @@ BlockRandomizer::BlockRandomizer(
     bool multithreadedGetNextSequence,
     size_t maxNumberOfInvalidSequences,
     bool sampleBasedRandomizationWindow,
-    size_t seedOffset)
+    size_t seedOffset,
+    const ChunkPrefetchConfiguration& prefetchConfig)
     : m_verbosity(verbosity),
       m_deserializer(deserializer),
       m_sweep(SIZE_MAX),
@@ -34,13 +35,13 @@ BlockRandomizer::BlockRandomizer(
       m_sweepSizeInSamples(0),
       m_chunkRandomizer(std::make_shared<ChunkRandomizer>(deserializer, randomizationRange, sampleBasedRandomizationWindow)),
       m_multithreadedGetNextSequences(multithreadedGetNextSequence),
-      m_prefetchedChunk(ChunkIdMax),
+      m_prefetchConfig(prefetchConfig),
       m_cleaner(maxNumberOfInvalidSequences),
       m_seedOffset(seedOffset)
 {
     assert(deserializer != nullptr);
 
-    m_launchType = shouldPrefetch ? launch::async : launch::deferred;
+    m_prefetcher = std::make_unique<ChunkPrefetcher>(deserializer, shouldPrefetch && m_prefetchConfig.m_depth > 0, m_prefetchConfig.m_numThreads);
 
     m_streams = m_deserializer->StreamInfos();
     m_sequenceRandomizer = std::make_shared<SequenceRandomizer>(verbosity, m_deserializer, m_chunkRandomizer);
@@ -234,8 +235,7 @@ std::pair<size_t, size_t> BlockRandomizer::LoadSequenceData(size_t globalSampleC
     }
 
     // Now it is safe to start the new chunk prefetch.
-    ChunkIdType chunkToPrefetchNext = GetChunkToPrefetch(windowRange);
-    Prefetch(chunkToPrefetchNext);
+    m_prefetcher->Prefetch(GetChunksToPrefetch(windowRange));
 
     return { numGlobalSamples, numLocalSamples };
 }
@@ -395,77 +395,46 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
         }
 
         auto const& chunk = m_chunkRandomizer->GetRandomizedChunks()[i];
-        if (chunk.m_original->m_id == m_prefetchedChunk && m_prefetch.valid())
-        {
-            // Taking prefetched chunk.
-            m_chunks[chunk.m_original->m_id] = m_prefetch.get();
-            if (m_verbosity >= Information)
-                fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in prefetched chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
-                chunk.m_chunkId,
-                chunk.m_original->m_id,
-                ++numLoadedChunks);
-        }
-        else
-        {
-            // Make sure we have no outstanding prefetches.
-            if (m_prefetch.valid())
-            {
-                m_prefetch.wait();
-            }
-
-            m_chunks[chunk.m_original->m_id] = m_deserializer->GetChunk(chunk.m_original->m_id);
-            if (m_verbosity >= Information)
-                fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in randomized chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
-                chunk.m_chunkId,
-                chunk.m_original->m_id,
-                ++numLoadedChunks);
-        }
+        bool prefetched = m_prefetcher->IsPrefetched(chunk.m_original->m_id);
+        m_chunks[chunk.m_original->m_id] = m_prefetcher->GetChunk(chunk.m_original->m_id);
+        if (m_verbosity >= Information)
+            fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in %s chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
+            prefetched ? "prefetched" : "randomized",
+            chunk.m_chunkId,
+            chunk.m_original->m_id,
+            ++numLoadedChunks);
     }
 
     if (m_verbosity >= Notification)
-        fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: %" PRIu64 " chunks paged-in from chunk window [%u..%u]\n",
+        fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: %" PRIu64 " chunks paged-in from chunk window [%u..%u], %" PRIu64 " prefetch hits, %" PRIu64 " misses so far\n",
                 m_chunks.size(),
                 m_chunkRandomizer->GetRandomizedChunks()[windowRange.m_begin].m_chunkId,
-                m_chunkRandomizer->GetRandomizedChunks()[windowRange.m_end - 1].m_chunkId);
+                m_chunkRandomizer->GetRandomizedChunks()[windowRange.m_end - 1].m_chunkId,
+                m_prefetcher->NumHits(),
+                m_prefetcher->NumMisses());
 }
 
-// Identifies chunk id that should be prefetched.
-ChunkIdType BlockRandomizer::GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange)
+// Identifies the chunks that should be prefetched: the next ones of this worker that are not loaded yet,
+// up to the prefetch depth and memory budget.
+std::vector<ChunkIdType> BlockRandomizer::GetChunksToPrefetch(const ClosedOpenChunkInterval& windowRange)
 {
-    ChunkIdType toBePrefetched = ChunkIdMax;
-    auto current = windowRange.m_end;
-    while (current < m_chunkRandomizer->GetRandomizedChunks().size())
+    std::vector<ChunkIdType> toBePrefetched;
+    size_t numSamples = 0;
+    const auto& chunks = m_chunkRandomizer->GetRandomizedChunks();
+    for (auto current = windowRange.m_end; current < chunks.size() && toBePrefetched.size() < m_prefetchConfig.m_depth; ++current)
     {
-        const auto& chunk = m_chunkRandomizer->GetRandomizedChunks()[current];
-        if (chunk.m_chunkId % m_config.m_numberOfWorkers == m_config.m_workerRank &&
-            m_chunks.find(chunk.m_original->m_id) == m_chunks.end())
-        {
-            toBePrefetched = chunk.m_original->m_id;
-            break;
-        }
-        ++current;
-    }
-    return toBePrefetched;
-}
-
-// Performs io prefetch of the specified chunk if needed.
-void BlockRandomizer::Prefetch(ChunkIdType chunkId)
-{
-    // Start new prefetch if necessary.
-    if (m_prefetchedChunk != chunkId && chunkId != ChunkIdMax)
-    {
-        // Wait to make sure there is no outstanding prefetches.
-        if (m_prefetch.valid())
-        {
-            m_prefetch.wait();
-        }
+        const auto& chunk = chunks[current];
+        if (chunk.m_chunkId % m_config.m_numberOfWorkers != m_config.m_workerRank ||
+            m_chunks.find(chunk.m_original->m_id) != m_chunks.end())
+            continue;
 
-        m_prefetchedChunk = chunkId;
-        m_prefetch = std::async(m_launchType, [this, chunkId]() { return m_deserializer->GetChunk(chunkId); });
+        numSamples += chunk.m_original->m_numberOfSamples;
+        if (!toBePrefetched.empty() && numSamples > m_prefetchConfig.m_maxSamples)
+            break;
 
-        if (m_verbosity >= Debug)
-            fprintf(stderr, "BlockRandomizer::Prefetch: prefetching original chunk: %u\n", chunkId);
+        toBePrefetched.push_back(chunk.m_original->m_id);
     }
+    return toBePrefetched;
 }
 
 void BlockRandomizer::SetState(const std::map<std::wstring, size_t>& state)
@@ -12,7 +12,7 @@
 #include "ChunkRandomizer.h"
 #include "SequenceRandomizer.h"
 #include "ReaderUtil.h"
-#include <future>
+#include "ChunkPrefetcher.h"
 
 namespace CNTK {
 
@@ -32,6 +32,7 @@ namespace CNTK {
 //
 // This class is responsible for decimation and loading the data chunks in to memory.
 // Actual randomization happens in ChunkRandomizer and SequenceRandomizer.
+// Chunks following the current window are loaded ahead of time by a ChunkPrefetcher, as configured by ChunkPrefetchConfiguration.
 // TODO: The behavior can be simplified by only randomizing sequences forward.
 class BlockRandomizer : public SequenceEnumerator
 {
@@ -44,7 +45,8 @@ public:
         bool multithreadedGetNextSequences = false,
         size_t maxNumberOfInvalidSequences = 0, // per worker
         bool sampleBasedRandomizationWindow = true,
-        size_t seedOffset = 0);
+        size_t seedOffset = 0,
+        const ChunkPrefetchConfiguration& prefetchConfig = ChunkPrefetchConfiguration());
 
     // Starts a new epoch.
     virtual void StartEpoch(const EpochConfiguration& config) override;
@@ -63,18 +65,15 @@ public:
     // Returns current position in the global timeline. The returned value is in samples.
     std::map<std::wstring, size_t> GetState() override;
 
-    ~BlockRandomizer()
-    {
-        if (m_prefetch.valid())
-        {
-            m_prefetch.wait();
-        }
-    }
-
     void SetState(const std::map<std::wstring, size_t>& state) override;
 
     void SetConfiguration(const ReaderConfiguration& config) override;
 
+    // Number of chunks that were prefetched by the time they were needed (or at least were being loaded),
+    // and number of chunks that had to be loaded on demand.
+    size_t NumPrefetchHits() const { return m_prefetcher->NumHits(); }
+    size_t NumPrefetchMisses() const { return m_prefetcher->NumMisses(); }
+
 private:
     // Load data for chunks if needed.
     void LoadDataChunks(const ClosedOpenChunkInterval& windowRange);
@@ -97,11 +96,8 @@ private:
     // Prepares a new sweep if needed.
     void PrepareNewSweepIfNeeded(size_t samplePosition);
 
-    // Performs io prefetch of the specified chunk if needed.
-    void Prefetch(ChunkIdType chunkId);
-
-    // Returns next candidate for the prefetch in the given range.
-    ChunkIdType GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange);
+    // Returns the original ids of the chunks to prefetch after the given range, in the order they will be needed.
+    std::vector<ChunkIdType> GetChunksToPrefetch(const ClosedOpenChunkInterval& windowRange);
 
     // Global sample position on the timeline.
     size_t m_globalSamplePosition;
@@ -153,12 +149,9 @@ private:
 
     int m_verbosity;
 
-    // Prefetch future.
-    std::future<ChunkPtr> m_prefetch;
-    // Whether to have async or deferred prefetch.
-    launch m_launchType;
-    // Prefetched original chunk id.
-    ChunkIdType m_prefetchedChunk;
+    // Prefetch of the chunks following the current window.
+    ChunkPrefetchConfiguration m_prefetchConfig;
+    std::unique_ptr<ChunkPrefetcher> m_prefetcher;
 
     // Current loaded chunks.
     ClosedOpenChunkInterval m_currentWindowRange;
@@ -9,18 +9,129 @@
 
 namespace CNTK {
 
+// An estimate, so any element type other than double counts as float.
+static size_t ElementSize(const StreamInformation& stream)
+{
+    return stream.m_elementType == DataType::Double ? sizeof(double) : sizeof(float);
+}
+
+ChunkCache::ChunkCache(DataDeserializerPtr deserializer, size_t maxSizeInBytes)
+    : m_deserializer(deserializer),
+      m_streams(deserializer->StreamInfos()),
+      m_maxSizeInBytes(maxSizeInBytes),
+      m_hasVariableSampleSize(false),
+      m_sizeInBytes(0),
+      m_numHits(0),
+      m_numMisses(0),
+      m_numEvictions(0)
+{
+    for (const auto& stream : m_streams)
+    {
+        size_t bytesPerSample = 0;
+        if (stream.m_storageFormat == StorageFormat::Dense && !stream.m_sampleLayout.IsUnknown() && !stream.m_sampleLayout.HasUnboundDimension())
+            bytesPerSample = stream.m_sampleLayout.TotalSize() * ElementSize(stream);
+        m_hasVariableSampleSize |= bytesPerSample == 0;
+        m_bytesPerSample.push_back(bytesPerSample);
+    }
+    m_seenBytes.resize(m_streams.size(), 0);
+    m_seenSamples.resize(m_streams.size(), 0);
+}
+
 ChunkPtr ChunkCache::GetChunk(ChunkIdType chunkId)
 {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_chunkMap.find(chunkId);
+        if (it != m_chunkMap.end())
+        {
+            m_numHits++;
+            m_recency.splice(m_recency.begin(), m_recency, it->second.m_position);
+            return it->second.m_chunk;
+        }
+        m_numMisses++;
+    }
+
+    // Loading happens outside of the lock, so that other chunks can be served meanwhile.
+    ChunkPtr chunk = m_deserializer->GetChunk(chunkId);
+
+    // The size is estimated from the number of samples of the chunk, so that its sequences do not have to be decoded.
+    // Only the first sequence is, if some streams have no fixed sample size.
+    size_t numberOfSamples = 0;
+    std::vector<SequenceDataPtr> firstSequence;
+    if (m_maxSizeInBytes != SIZE_MAX)
+    {
+        std::vector<SequenceInfo> sequences;
+        m_deserializer->SequenceInfosForChunk(chunkId, sequences);
+        for (const auto& sequence : sequences)
+            numberOfSamples += sequence.m_numberOfSamples;
+        if (m_hasVariableSampleSize && !sequences.empty())
+            chunk->GetSequence(sequences.front().m_indexInChunk, firstSequence);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
     auto it = m_chunkMap.find(chunkId);
     if (it != m_chunkMap.end())
     {
-        return it->second;
+        // Loaded concurrently by another thread, keep the cached one.
+        m_recency.splice(m_recency.begin(), m_recency, it->second.m_position);
+        return it->second.m_chunk;
     }
- 
-    ChunkPtr chunk = m_deserializer->GetChunk(chunkId);
-    m_chunkMap[chunkId] = chunk;
- 
+
+    size_t sizeInBytes = m_maxSizeInBytes == SIZE_MAX ? 0 : EstimateSizeInBytes(numberOfSamples, firstSequence);
+    m_recency.push_front(chunkId);
+    m_chunkMap[chunkId] = CachedChunk{ chunk, sizeInBytes, m_recency.begin() };
+    m_sizeInBytes += sizeInBytes;
+    EvictIfNeeded();
+
     return chunk;
 }
 
+void ChunkCache::EvictIfNeeded()
+{
+    while (m_sizeInBytes > m_maxSizeInBytes && m_recency.size() > 1)
+    {
+        auto it = m_chunkMap.find(m_recency.back());
+        assert(it != m_chunkMap.end());
+        m_sizeInBytes -= it->second.m_sizeInBytes;
+        m_chunkMap.erase(it);
+        m_recency.pop_back();
+        m_numEvictions++;
+    }
+}
+
+size_t ChunkCache::EstimateSizeInBytes(size_t numberOfSamples, const std::vector<SequenceDataPtr>& firstSequence)
+{
+    size_t result = 0;
+    for (size_t i = 0; i < m_streams.size(); ++i)
+    {
+        if (m_bytesPerSample[i] != 0)
+        {
+            result += numberOfSamples * m_bytesPerSample[i];
+            continue;
+        }
+
+        if (i < firstSequence.size() && firstSequence[i]->m_numberOfSamples != 0)
+        {
+            auto& data = firstSequence[i];
+            size_t elementSize = ElementSize(m_streams[i]);
+            if (m_streams[i].m_storageFormat == StorageFormat::Dense)
+            {
+                m_seenBytes[i] += data->m_numberOfSamples * data->GetSampleShape().TotalSize() * elementSize;
+            }
+            else
+            {
+                auto sparse = static_cast<SparseSequenceData*>(data.get());
+                m_seenBytes[i] += sparse->m_totalNnzCount * (elementSize + sizeof(SparseIndexType)) +
+                                  sparse->m_nnzCounts.size() * sizeof(SparseIndexType);
+            }
+            m_seenSamples[i] += data->m_numberOfSamples;
+        }
+
+        if (m_seenSamples[i] != 0)
+            result += (size_t)((double)numberOfSamples * m_seenBytes[i] / m_seenSamples[i]);
+    }
+
+    return result;
+}
+
 }
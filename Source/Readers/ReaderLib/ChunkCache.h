@@ -5,22 +5,27 @@
 
 #pragma once
 
-#include <map>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include "DataDeserializer.h"
 
 namespace CNTK {
 
-// A cache to store the complete dataset (all chunks) in memory. The caching can
-// be switched on/off by a boolean flag in the reader config section, independent 
-// of the randomization and chunking parameters. The caching should only be enabled 
-// when the whole dataset fits in memory.
+// A cache to store chunks in memory. The caching can be switched on/off by a boolean
+// flag in the reader config section, independent of the randomization and chunking
+// parameters. By default, the cache is unbounded and stores the complete dataset,
+// so it should only be enabled when the whole dataset fits in memory. With a budget,
+// the least recently used chunks are evicted once the (estimated) size of the cached
+// chunks exceeds the budget.
 // Implemented as a wrapping proxy around a deserializer that stores pointers to
-// all chunks it sees in an internal map.
+// the chunks it sees. GetChunk() is thread safe.
 class ChunkCache : public DataDeserializer
 {
 public:
 
-    ChunkCache(DataDeserializerPtr deserializer) : m_deserializer(deserializer) { }
+    // 'maxSizeInBytes' is the memory budget of the cache, SIZE_MAX for an unbounded cache.
+    ChunkCache(DataDeserializerPtr deserializer, size_t maxSizeInBytes = SIZE_MAX);
 
     virtual std::vector<StreamInformation> StreamInfos() override
     {
@@ -43,12 +48,51 @@ public:
     }
 
     // Gets chunk data given its id.
-    virtual ChunkPtr GetChunk(ChunkIdType chunkId);
+    virtual ChunkPtr GetChunk(ChunkIdType chunkId) override;
+
+    // Statistics: number of requests served from the cache, number of chunks that had to be
+    // loaded, number of chunks evicted, and the estimated size of the cached chunks.
+    size_t NumHits() const { return m_numHits; }
+    size_t NumMisses() const { return m_numMisses; }
+    size_t NumEvictions() const { return m_numEvictions; }
+    size_t SizeInBytes() const { return m_sizeInBytes; }
 
 private:
-    // A map of currently loaded chunks
-    std::map<size_t, ChunkPtr> m_chunkMap;
+    struct CachedChunk
+    {
+        ChunkPtr m_chunk;
+        size_t m_sizeInBytes;
+        std::list<ChunkIdType>::iterator m_position; // position in the recency list
+    };
+
+    // Estimates the memory taken by the data of a chunk of 'numberOfSamples' samples, whose first sequence
+    // is 'firstSequence' (only decoded if some streams have no fixed sample size). Has to be called with m_mutex held.
+    size_t EstimateSizeInBytes(size_t numberOfSamples, const std::vector<SequenceDataPtr>& firstSequence);
+
+    // Evicts least recently used chunks until the cache fits in the budget,
+    // never evicting the most recently used one. Has to be called with m_mutex held.
+    void EvictIfNeeded();
+
     DataDeserializerPtr m_deserializer;
+    std::vector<StreamInformation> m_streams;
+    size_t m_maxSizeInBytes;
+
+    // Size of a sample of each stream, or 0 for the sparse streams and the ones of variable shape, whose size
+    // is estimated from the average size of the samples seen so far.
+    std::vector<size_t> m_bytesPerSample;
+    bool m_hasVariableSampleSize;
+    std::vector<size_t> m_seenBytes;
+    std::vector<size_t> m_seenSamples;
+
+    std::mutex m_mutex;
+    // Currently cached chunks, and their ids from the most to the least recently used.
+    std::unordered_map<ChunkIdType, CachedChunk> m_chunkMap;
+    std::list<ChunkIdType> m_recency;
+    size_t m_sizeInBytes;
+
+    size_t m_numHits;
+    size_t m_numMisses;
+    size_t m_numEvictions;
 
     DISABLE_COPY_AND_MOVE(ChunkCache);
 };
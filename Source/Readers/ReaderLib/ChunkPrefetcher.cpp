@@ -0,0 +1,156 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "ChunkPrefetcher.h"
+#include <algorithm>
+#include <set>
+
+namespace CNTK {
+
+ChunkPrefetcher::ChunkPrefetcher(DataDeserializerPtr deserializer, bool async, size_t numThreads)
+    : m_deserializer(deserializer),
+      m_stopping(false),
+      m_numHits(0),
+      m_numMisses(0)
+{
+    assert(deserializer != nullptr);
+
+    if (async)
+    {
+        for (size_t i = 0; i < std::max<size_t>(numThreads, 1); ++i)
+            m_threads.push_back(std::thread([this]() { IOThread(); }));
+    }
+}
+
+ChunkPrefetcher::~ChunkPrefetcher()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queue.clear();
+        m_stopping = true;
+    }
+    m_queueChanged.notify_all();
+
+    // Loads in progress are completed, their results are dropped.
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void ChunkPrefetcher::IOThread()
+{
+    for (;;)
+    {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queueChanged.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_stopping)
+                return;
+
+            request = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        try
+        {
+            request.m_result->set_value(m_deserializer->GetChunk(request.m_chunkId));
+        }
+        catch (...)
+        {
+            // Rethrown to whoever takes the chunk.
+            request.m_result->set_exception(std::current_exception());
+        }
+    }
+}
+
+std::future<ChunkPtr> ChunkPrefetcher::Enqueue(ChunkIdType chunkId, bool urgent)
+{
+    LoadRequest request{ chunkId, std::make_shared<std::promise<ChunkPtr>>() };
+    auto result = request.m_result->get_future();
+    if (urgent)
+        m_queue.push_front(request);
+    else
+        m_queue.push_back(request);
+    m_queueChanged.notify_one();
+    return result;
+}
+
+void ChunkPrefetcher::Prefetch(const std::vector<ChunkIdType>& chunkIds)
+{
+    if (m_threads.empty())
+        return;
+
+    std::set<ChunkIdType> wanted(chunkIds.begin(), chunkIds.end());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Loads that have not started yet are cancelled, running ones complete and are dropped.
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(),
+                                 [&wanted](const LoadRequest& r) { return wanted.find(r.m_chunkId) == wanted.end(); }),
+                  m_queue.end());
+    for (auto it = m_prefetched.begin(); it != m_prefetched.end();)
+    {
+        if (wanted.find(it->first) == wanted.end())
+            it = m_prefetched.erase(it);
+        else
+            ++it;
+    }
+
+    for (auto chunkId : chunkIds)
+    {
+        if (m_prefetched.find(chunkId) == m_prefetched.end())
+            m_prefetched[chunkId] = Enqueue(chunkId, /*urgent=*/false);
+    }
+}
+
+ChunkPtr ChunkPrefetcher::GetChunk(ChunkIdType chunkId)
+{
+    if (m_threads.empty())
+    {
+        m_numMisses++;
+        return m_deserializer->GetChunk(chunkId);
+    }
+
+    std::future<ChunkPtr> result;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_prefetched.find(chunkId);
+        if (it != m_prefetched.end())
+        {
+            m_numHits++;
+            result = std::move(it->second);
+            m_prefetched.erase(it);
+
+            // If the load has not started yet, it is next.
+            auto queued = std::find_if(m_queue.begin(), m_queue.end(), [chunkId](const LoadRequest& r) { return r.m_chunkId == chunkId; });
+            if (queued != m_queue.end() && queued != m_queue.begin())
+            {
+                LoadRequest request = *queued;
+                m_queue.erase(queued);
+                m_queue.push_front(request);
+            }
+        }
+        else
+        {
+            m_numMisses++;
+            result = Enqueue(chunkId, /*urgent=*/true);
+        }
+    }
+    return result.get();
+}
+
+void ChunkPrefetcher::Clear()
+{
+    Prefetch(std::vector<ChunkIdType>());
+}
+
+bool ChunkPrefetcher::IsPrefetched(ChunkIdType chunkId) const
+{
+    return m_prefetched.find(chunkId) != m_prefetched.end();
+}
+
+}
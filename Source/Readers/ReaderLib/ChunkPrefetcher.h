@@ -0,0 +1,93 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DataDeserializer.h"
+
+namespace CNTK {
+
+// How far ahead a randomizer loads chunks.
+struct ChunkPrefetchConfiguration
+{
+    ChunkPrefetchConfiguration()
+        : m_depth(1), m_numThreads(1), m_maxSamples(SIZE_MAX)
+    {}
+
+    size_t m_depth;      // Maximum number of chunks loaded ahead of time.
+    size_t m_numThreads; // Number of I/O threads. More than one requires a deserializer whose GetChunk() is thread safe.
+    size_t m_maxSamples; // Memory budget: maximum number of samples in prefetched chunks that were not taken yet.
+                         // The first chunk is prefetched regardless of its size.
+};
+
+// Loads chunks of a deserializer ahead of time on a bounded pool of I/O threads.
+// Requests are served in order. A chunk that is needed before its load has started
+// moves to the head of the queue. All loads, including those of chunks that were not
+// prefetched, run on the I/O threads, so the deserializer never sees more concurrent
+// calls than there are threads.
+// Without threads (async == false), nothing is loaded ahead of time and every chunk is
+// loaded on the calling thread when it is taken.
+class ChunkPrefetcher
+{
+public:
+    ChunkPrefetcher(DataDeserializerPtr deserializer, bool async, size_t numThreads);
+    ~ChunkPrefetcher();
+
+    // Makes 'chunkIds' (original chunk ids, in the order they will be needed) the set of prefetched chunks:
+    // starts loading the ones that are new, and forgets all others, including loaded ones.
+    void Prefetch(const std::vector<ChunkIdType>& chunkIds);
+
+    // Returns the chunk, waiting for it if it is still being prefetched, or loading it if it was not prefetched.
+    ChunkPtr GetChunk(ChunkIdType chunkId);
+
+    // Forgets all prefetched chunks.
+    void Clear();
+
+    bool IsPrefetched(ChunkIdType chunkId) const;
+
+    // Number of GetChunk() calls served by a prefetch (even one that was still in progress),
+    // and number of calls that had to load the chunk.
+    size_t NumHits() const { return m_numHits; }
+    size_t NumMisses() const { return m_numMisses; }
+
+private:
+    struct LoadRequest
+    {
+        ChunkIdType m_chunkId;
+        std::shared_ptr<std::promise<ChunkPtr>> m_result;
+    };
+
+    // Queues the load of the chunk, at the back or at the front of the queue.
+    // Has to be called with m_mutex held.
+    std::future<ChunkPtr> Enqueue(ChunkIdType chunkId, bool urgent);
+
+    void IOThread();
+
+    DataDeserializerPtr m_deserializer;
+
+    // Prefetched chunks, by original chunk id. Only used by the thread that owns the prefetcher.
+    std::map<ChunkIdType, std::future<ChunkPtr>> m_prefetched;
+
+    // Loads not started yet, and the threads that run them.
+    std::mutex m_mutex;
+    std::condition_variable m_queueChanged;
+    std::deque<LoadRequest> m_queue;
+    std::vector<std::thread> m_threads;
+    bool m_stopping;
+
+    size_t m_numHits;
+    size_t m_numMisses;
+
+    DISABLE_COPY_AND_MOVE(ChunkPrefetcher);
+};
+
+}
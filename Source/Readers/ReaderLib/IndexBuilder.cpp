@@ -68,7 +68,7 @@ void IndexBuilder::WriteIndexCacheAsync(shared_ptr<Index>& index)
     if (!m_isCacheEnabled)
         return;
 
-    if (Microsoft::MSR::CNTK::EnvironmentUtil::GetLocalMPINodeRank() != 0)
+    if (Microsoft::MSR::CNTK::EnvironmentUtil::GetGlobalMPINodeRank() != 0)
         return; // only the main node should write the cache file.
     
     auto cacheFilename = GetCacheFilename();
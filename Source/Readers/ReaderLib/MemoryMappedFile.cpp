@@ -0,0 +1,69 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define _CRT_SECURE_NO_WARNINGS
+#include "MemoryMappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace CNTK {
+
+MemoryMappedFile::MemoryMappedFile(const FileWrapper& file)
+    : m_filename(file.Filename()), m_data(nullptr), m_size(0)
+{
+    file.CheckIsOpenOrDie();
+    m_size = file.Filesize();
+
+#ifdef _WIN32
+    m_mapping = nullptr;
+    if (m_size == 0) // empty files cannot be mapped
+        return;
+
+    HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file.File()));
+    m_mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mapping == NULL)
+        RuntimeError("Unable to map file '%ls', error 0x%x.", m_filename.c_str(), GetLastError());
+
+    m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == NULL)
+    {
+        CloseHandle(m_mapping);
+        RuntimeError("Unable to map a view of file '%ls', error 0x%x.", m_filename.c_str(), GetLastError());
+    }
+#else
+    if (m_size == 0)
+        return;
+
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fileno(file.File()), 0);
+    if (data == MAP_FAILED)
+        RuntimeError("Unable to map file '%ls': %s.", m_filename.c_str(), strerror(errno));
+
+    // The file is parsed front to back within a chunk, but chunks are visited in random order.
+    madvise(data, m_size, MADV_WILLNEED);
+    m_data = (const char*)data;
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (m_data == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+#else
+    munmap((void*)m_data, m_size);
+#endif
+}
+
+}
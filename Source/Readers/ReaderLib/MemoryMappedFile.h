@@ -0,0 +1,76 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include "FileWrapper.h"
+
+namespace CNTK {
+
+// A read-only view of a whole file, mapped into the address space of the process.
+// Pages are read in by the OS on first access, and several threads can read the view at once.
+class MemoryMappedFile
+{
+public:
+    explicit MemoryMappedFile(const FileWrapper& file);
+    ~MemoryMappedFile();
+
+    inline const char* Data() const { return m_data; }
+    inline size_t Size() const { return m_size; }
+    inline const std::wstring& Filename() const { return m_filename; }
+
+private:
+    std::wstring m_filename;
+    const char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_mapping; // the handle of the file mapping object
+#endif
+
+    DISABLE_COPY_AND_MOVE(MemoryMappedFile);
+};
+
+// A cursor over a range of a memory mapped file, with the interface of BufferedFileReader
+// that parsers use, so that they can be written once for both kinds of input.
+class MemoryBufferReader
+{
+public:
+    // Reads the file from 'fileOffset' on.
+    MemoryBufferReader(const MemoryMappedFile& file, size_t fileOffset)
+        : m_data(file.Data()), m_position(fileOffset), m_size(file.Size())
+    {}
+
+    // File offset that correspond to the current position.
+    inline size_t GetFileOffset() const { return m_position; }
+
+    // Returns the character at the current position.
+    inline char Peek() const
+    {
+        if (Empty())
+            RuntimeError("Buffer is empty.");
+
+        return m_data[m_position];
+    }
+
+    // Advances the current position to the next character.
+    // Returns true, unless the end of the file has been reached.
+    inline bool Pop()
+    {
+        if (Empty())
+            return false;
+
+        return ++m_position < m_size;
+    }
+
+    // Returns true if no more data is available (reached EOF).
+    inline bool Empty() const { return m_position >= m_size; }
+
+private:
+    const char* m_data;
+    size_t m_position;
+    size_t m_size;
+};
+
+}
@@ -6,6 +6,7 @@
 #define _CRT_SECURE_NO_WARNINGS
 #define _SCL_SECURE_NO_WARNINGS
 
+#include <algorithm>
 #include <numeric>
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
@@ -38,9 +39,87 @@ MBLayoutPtr SequencePacker::CreateMBLayout(const StreamBatch& batch)
     return pMBLayout;
 }
 
+Sequences SequencePacker::GetNextSequences()
+{
+    if (m_bucketingWindow == 0)
+        return m_sequenceEnumerator->GetNextSequences(m_globalMinibatchSizeInSamples, m_localMinibatchSizeInSamples);
+
+    if (m_bucketedMinibatches.empty())
+        FillBucketingWindow();
+
+    auto sequences = std::move(m_bucketedMinibatches.front());
+    m_bucketedMinibatches.pop_front();
+    return sequences;
+}
+
+void SequencePacker::FillBucketingWindow()
+{
+    assert(m_bucketedMinibatches.empty());
+
+    // The window is read with a single call, because the sequence data is only guaranteed
+    // to stay valid until the next call to the sequence enumerator.
+    auto windowSize = [this](size_t minibatchSize)
+    {
+        return minibatchSize > SIZE_MAX / m_bucketingWindow ? SIZE_MAX : minibatchSize * m_bucketingWindow;
+    };
+
+    auto sequences = m_sequenceEnumerator->GetNextSequences(windowSize(m_globalMinibatchSizeInSamples), windowSize(m_localMinibatchSizeInSamples));
+    const auto& window = sequences.m_data;
+    size_t numberOfStreams = window.size();
+    size_t numberOfSequences = window.empty() ? 0 : window.front().size();
+
+    // For multiple streams the longest one defines the length of the sequence.
+    vector<size_t> lengths(numberOfSequences, 0);
+    for (const auto& stream : window)
+    {
+        for (size_t i = 0; i < numberOfSequences; ++i)
+            lengths[i] = max(lengths[i], (size_t)stream[i]->m_numberOfSamples);
+    }
+
+    vector<size_t> order(numberOfSequences);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&lengths](size_t a, size_t b) { return lengths[a] < lengths[b]; });
+
+    // Cut the sorted sequences into minibatches of at most the requested size
+    // (a single sequence that is longer than that forms its own minibatch).
+    vector<Sequences> minibatches;
+    size_t minibatchSize = 0;
+    for (auto index : order)
+    {
+        if (minibatches.empty() || (minibatchSize > 0 && minibatchSize + lengths[index] > m_localMinibatchSizeInSamples))
+        {
+            minibatches.push_back(Sequences());
+            minibatches.back().m_data.resize(numberOfStreams);
+            minibatchSize = 0;
+        }
+
+        for (size_t streamIndex = 0; streamIndex < numberOfStreams; ++streamIndex)
+            minibatches.back().m_data[streamIndex].push_back(window[streamIndex][index]);
+        minibatchSize += lengths[index];
+    }
+
+    // Do not let the network see the minibatches ordered by length.
+    shuffle(minibatches.begin(), minibatches.end(), m_rng);
+
+    if (minibatches.empty())
+        minibatches.push_back(Sequences());
+
+    // The sweep and epoch boundaries are reported with the last minibatch of the window.
+    minibatches.back().m_endOfSweep = sequences.m_endOfSweep;
+    minibatches.back().m_endOfEpoch = sequences.m_endOfEpoch;
+
+    for (auto& m : minibatches)
+        m_bucketedMinibatches.push_back(move(m));
+}
+
+void SequencePacker::Reset()
+{
+    m_bucketedMinibatches.clear();
+}
+
 Minibatch SequencePacker::ReadMinibatch()
 {
-    auto sequences = m_sequenceEnumerator->GetNextSequences(m_globalMinibatchSizeInSamples, m_localMinibatchSizeInSamples);
+    auto sequences = GetNextSequences();
     const auto& batch = sequences.m_data;
 
     Minibatch minibatch(sequences.m_endOfSweep, sequences.m_endOfEpoch);
@@ -71,8 +150,15 @@ Minibatch SequencePacker::ReadMinibatch()
         streamMinibatch->m_sampleShape = m_outputStreamDescriptions[streamIndex].m_sampleLayout;
 
         minibatch.m_data.push_back(streamMinibatch);
+
+        m_numberOfSamples += pMBLayout->GetActualNumSamples();
+        m_numberOfLayoutSamples += pMBLayout->GetNumCols();
     }
 
+    if (m_verbosity > 0 && minibatch.m_endOfEpoch)
+        fprintf(stderr, "SequencePacker::ReadMinibatch: padding efficiency %.2f%% (%" PRIu64 " samples in %" PRIu64 " layout columns) so far\n",
+            100.0 * PaddingEfficiency(), m_numberOfSamples, m_numberOfLayoutSamples);
+
     EstablishIdToKey(minibatch, sequences);
 
     m_currentBufferIndex = (m_currentBufferIndex + 1) % m_numberOfBuffers;
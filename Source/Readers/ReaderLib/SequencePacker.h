@@ -5,12 +5,20 @@
 
 #pragma once
 
+#include <deque>
+#include <random>
 #include "PackerBase.h"
 
 namespace CNTK {
 
 // This packer generates minibatches containing full sequences packed for 
 // efficient (concurrent) consumption on a GPU.
+//
+// With a non-zero bucketing window, the packer reads that many minibatches ahead,
+// sorts the sequences of the window by length and regroups them into minibatches of
+// similar lengths (shuffled among each other), which reduces the number of gap
+// frames in the layout. Similar to the truncated BPTT packer, sequences still
+// pending in the window are dropped on Reset(), i.e. when the reader state is restored.
 class SequencePacker : public PackerBase
 {
 public:
@@ -19,17 +27,33 @@ public:
         const std::vector<StreamInformation>& streams,
         size_t numberOfBuffers = 2,
         bool useLocalTimeline = false,
-        CorpusDescriptorPtr corpus = nullptr) :
+        CorpusDescriptorPtr corpus = nullptr,
+        size_t bucketingWindow = 0,
+        int verbosity = 0) :
         PackerBase(corpus, sequenceEnumerator, streams, numberOfBuffers),
         m_useLocalTimeline(useLocalTimeline),
         m_globalMinibatchSizeInSamples(0),
-        m_localMinibatchSizeInSamples(0)
+        m_localMinibatchSizeInSamples(0),
+        m_bucketingWindow(bucketingWindow),
+        m_verbosity(verbosity),
+        m_numberOfSamples(0),
+        m_numberOfLayoutSamples(0)
     {}
 
     virtual Minibatch ReadMinibatch() override;
 
     void SetConfiguration(const ReaderConfiguration& config, const std::vector<MemoryProviderPtr>& memoryProviders) override;
 
+    // Drops the sequences pending in the bucketing window.
+    void Reset() override;
+
+    // Fraction of the packed layout cells (over all streams and minibatches so far)
+    // that carry actual samples rather than gaps.
+    double PaddingEfficiency() const
+    {
+        return m_numberOfLayoutSamples == 0 ? 1.0 : (double)m_numberOfSamples / m_numberOfLayoutSamples;
+    }
+
 protected:
     virtual MBLayoutPtr PackDenseStream(const StreamBatch& batch, size_t streamIndex);
 
@@ -51,6 +75,29 @@ protected:
     // A minibatch size for this worker in global samples.
     size_t m_globalMinibatchSizeInSamples;
 
+private:
+    // Returns the next set of sequences, either directly from the sequence enumerator
+    // or from the bucketing window.
+    Sequences GetNextSequences();
+
+    // Reads up to m_bucketingWindow minibatches from the sequence enumerator and
+    // regroups their sequences by length into m_bucketedMinibatches.
+    void FillBucketingWindow();
+
+    // Number of minibatches to read ahead for bucketing, 0 disables bucketing.
+    size_t m_bucketingWindow;
+
+    // Minibatches regrouped by length that have not been packed yet.
+    std::deque<Sequences> m_bucketedMinibatches;
+
+    // Used to shuffle the order of the regrouped minibatches.
+    std::mt19937_64 m_rng;
+
+    int m_verbosity;
+
+    // Number of actual samples and of all layout cells (including gaps) packed so far.
+    size_t m_numberOfSamples;
+    size_t m_numberOfLayoutSamples;
 };
 
 typedef std::shared_ptr<SequencePacker> SequencePackerPtr;
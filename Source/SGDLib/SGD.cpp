@@ -31,10 +31,12 @@
 #include "ASGDHelper.h"
 
 #include "CNTKLibraryInternals.h"
+#include "CheckpointWriter.h"
 #include "SimpleDistGradAggregator.h"
 #include "V2SimpleDistGradAggregator.h"
 #include "ProgressTracing.h"
 #include "PerformanceProfiler.h"
+#include "NodeProfiler.h"
 
 #include <map>
 #include <set>
@@ -515,6 +517,7 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         if (i > startEpoch)
         {
             ProfilerEnable(true);
+            NodeProfilerEnable(true);
         }
 
         // Synchronize all ranks before proceeding to ensure that
@@ -782,6 +785,7 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
                     // roll back
                     auto bestModelPath = GetModelNameForEpoch(i - m_learnRateAdjustInterval);
                     LOGPRINTF(stderr, "Loading (rolling back to) previous model with best training-criterion value: %ls.\n", bestModelPath.c_str());
+                    WaitForCheckPointWrites();
                     net->RereadPersistableParameters<ElemType>(bestModelPath);
                     LoadCheckPointInfo(i - m_learnRateAdjustInterval,
                                        /*out*/ totalTrainingSamplesSeen,
@@ -897,7 +901,7 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
                 auto modelName = GetModelNameForEpoch(i);
                 if (m_traceLevel > 0)
                     LOGPRINTF(stderr, "SGD: Saving checkpoint model '%ls'\n", modelName.c_str());
-                net->Save(modelName);
+                SaveCheckPointModel(net, modelName);
                 if (!m_keepCheckPointFiles)
                 {
                     // delete previous checkpoint file to save space
@@ -936,6 +940,13 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
     }
     // --- END OF MAIN EPOCH LOOP
 
+    // Synchronize all ranks before proceeding to ensure that
+    // rank 0 has finished writing the model files and the checkpoint info
+    // TODO[DataASGD]: should othet other rank waiting in async-mode
+    WaitForCheckPointWrites();
+    if (m_traceLevel > 0 && ((m_mpi == nullptr) || m_mpi->IsMainNode()))
+        LOGPRINTF(stderr, "SGD: Saving checkpoints blocked training for %.3f seconds\n", m_checkPointBlockingSeconds);
+
     // Check if we need to save best model per criterion and this is the main node as well.
     if (m_saveBestModelPerCriterion && ((m_mpi == nullptr) || m_mpi->IsMainNode()))
     {
@@ -943,11 +954,6 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         CopyBestEpochs(m_criteriaBestEpoch, *this, m_maxEpochs - 1);
     }
 
-    // Synchronize all ranks before proceeding to ensure that
-    // rank 0 has finished writing the model file
-    // TODO[DataASGD]: should othet other rank waiting in async-mode
-    SynchronizeWorkers();
-
     // progress tracing for compute cluster management
     ProgressTracing::TraceProgressPercentage(m_maxEpochs, 0.0, true);
     ProgressTracing::TraceTrainLoss(m_lastFinishedEpochTrainLoss);
@@ -1183,6 +1189,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         {
             actualMBSize = 0; // (undefined if !wasDataRead)
             ProfilerEnable(false); // Profiler will be enabled at the beginning of the next epoch.
+            NodeProfilerEnable(false);
         }
 
         ProfilerTimeEnd(profGetMinibatch, profilerEvtMainGetMinibatch);
@@ -1828,6 +1835,7 @@ double SGD<ElemType>::SearchForBestLearnRate(ComputationNetworkPtr net,
     }
 
     int baseModelEpoch = epochNumber - 1;
+    WaitForCheckPointWrites();
     net->RereadPersistableParameters<ElemType>(GetModelNameForEpoch(baseModelEpoch));
 
     double learnRate = learnRatePerSample;
@@ -2207,6 +2215,7 @@ void SGD<ElemType>::TrainOneMiniEpochAndReloadModel(ComputationNetworkPtr net,
     int baseModelEpoch = epochNumber - 1;
     let path = GetModelNameForEpoch(baseModelEpoch);
     //fprintf(stderr, "Reverting parameters back to %ls\n", path.c_str());
+    WaitForCheckPointWrites();
     net->RereadPersistableParameters<ElemType>(path);
 
     double dummyLearnRate;
@@ -2459,6 +2468,78 @@ void SGD<ElemType>::ClipGradient(Matrix<ElemType>& gradient, const size_t actual
     }
 }
 
+// writes the checkpoint info of an epoch, either from the training state or from a snapshot of it
+template <class ElemType>
+static void WriteCheckPointInfo(const wstring& checkPointFileName, const size_t totalSamplesSeen,
+                                const double learnRatePerSample,
+                                const std::list<Matrix<ElemType>>& smoothedGradients,
+                                const std::vector<double>& smoothedCounts,
+                                const double prevCriterion,
+                                const size_t minibatchSize,
+                                const std::map<std::wstring, BestEpoch>* criteriaBestEpoch, // null if not saved
+                                IMASGD<ElemType>* pMASGDHelper)
+{
+    // Saving into temporary file and then renaming it to the checkPointFileName
+    // This is a standard trick to avoid havign corrupted checkpoints files if process dies during writing
+    wstring tempFileName = checkPointFileName + L".tmp";
+
+    {
+        File fstream(tempFileName, FileOptions::fileOptionsBinary | FileOptions::fileOptionsWrite);
+        // Buffer writes in memory then flush to filesystem, which reduces number of small writes
+        fstream.Setvbuf();
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BVersion"); 
+        fstream << (size_t)CURRENT_CNTK_CHECKPOINT_VERSION; 
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EVersion");
+
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCKP");
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BLearnRate");
+        fstream << totalSamplesSeen << learnRatePerSample << prevCriterion;
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ELearnRate");
+
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BMinibatchSize");
+        fstream << minibatchSize;
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EMinibatchSize");
+
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BGradient");
+
+        for (auto smoothedGradientIter = smoothedGradients.begin(); smoothedGradientIter != smoothedGradients.end(); smoothedGradientIter++)
+        {
+            const Matrix<ElemType>& smoothedGradientValues = *smoothedGradientIter;
+            fstream << smoothedGradientValues;
+        }
+
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EGradient");
+
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"BCount");
+
+        for (auto sc : smoothedCounts)
+            fstream << sc;
+
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECount");
+
+        if (criteriaBestEpoch)
+        {
+            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCriteria");
+            const int32_t criteriaSize = static_cast<int32_t>(criteriaBestEpoch->size());
+            fstream << criteriaSize;
+            for (const auto& criterion : *criteriaBestEpoch)
+            {
+                fstream << criterion.second.criterionMinValue << criterion.second.epochIndex;
+            }
+            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECriteria");
+        }
+
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECKP");
+        if (pMASGDHelper)
+            pMASGDHelper->SaveToCheckPoint(fstream);
+        // Ensuring that data is written
+        fstream.Flush();
+    }
+
+    _wunlink(checkPointFileName.c_str());
+    renameOrDie(tempFileName, checkPointFileName);
+}
+
 template <class ElemType>
 void SGD<ElemType>::SaveCheckPointInfo(const size_t epoch, const size_t totalSamplesSeen,
                                        const double learnRatePerSample,
@@ -2471,67 +2552,77 @@ void SGD<ElemType>::SaveCheckPointInfo(const size_t epoch, const size_t totalSam
     // the parallel training nodes from colliding to write the same file
     if ((m_mpi == nullptr) || m_mpi->IsMainNode())
     {
+        Timer timer;
+        timer.Start();
         wstring checkPointFileName = GetCheckPointFileNameForEpoch(int(epoch));
-        // Saving into temporary file and then renaming it to the checkPointFileName
-        // This is a standard trick to avoid havign corrupted checkpoints files if process dies during writing
-        wstring tempFileName = checkPointFileName + L".tmp";
 
+        // The state of model averaging is written by its helper, straight from the training state.
+        if (m_pMASGDHelper)
         {
-            File fstream(tempFileName, FileOptions::fileOptionsBinary | FileOptions::fileOptionsWrite);
-            // Buffer writes in memory then flush to filesystem, which reduces number of small writes
-            fstream.Setvbuf();
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BVersion"); 
-            fstream << (size_t)CURRENT_CNTK_CHECKPOINT_VERSION; 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EVersion");
-
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCKP");
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BLearnRate");
-            fstream << totalSamplesSeen << learnRatePerSample << prevCriterion;
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ELearnRate");
-
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BMinibatchSize");
-            fstream << minibatchSize;
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EMinibatchSize");
-
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BGradient");
-
-            for (auto smoothedGradientIter = smoothedGradients.begin(); smoothedGradientIter != smoothedGradients.end(); smoothedGradientIter++)
-            {
-                const Matrix<ElemType>& smoothedGradientValues = *smoothedGradientIter;
-                fstream << smoothedGradientValues;
-            }
-
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EGradient");
+            if (m_checkPointWriter)
+                m_checkPointWriter->Wait();
+            WriteCheckPointInfo(checkPointFileName, totalSamplesSeen, learnRatePerSample, smoothedGradients, smoothedCounts, prevCriterion, minibatchSize,
+                                m_saveBestModelPerCriterion ? &m_criteriaBestEpoch : nullptr, m_pMASGDHelper.get());
+            timer.Stop();
+            m_checkPointBlockingSeconds += timer.ElapsedSeconds();
+            return;
+        }
 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"BCount");
+        // Otherwise it is written on a background thread from a snapshot in host memory, while training continues.
+        // A write waits for the previous ones, so that the earlier checkpoint files are complete once it is queued.
+        auto gradients = make_shared<std::list<Matrix<ElemType>>>();
+        for (const auto& smoothedGradient : smoothedGradients)
+        {
+            gradients->emplace_back(CPUDEVICE);
+            gradients->back().AssignValuesOf(smoothedGradient);
+        }
+        auto counts = make_shared<std::vector<double>>(smoothedCounts);
+        auto criteriaBestEpoch = m_saveBestModelPerCriterion ? make_shared<std::map<std::wstring, BestEpoch>>(m_criteriaBestEpoch) : nullptr;
 
-            for (auto sc : smoothedCounts)
-                fstream << sc;
+        if (!m_checkPointWriter)
+            m_checkPointWriter = make_shared<::CNTK::CheckpointWriter>();
+        m_checkPointWriter->Enqueue([=]()
+        {
+            WriteCheckPointInfo(checkPointFileName, totalSamplesSeen, learnRatePerSample, *gradients, *counts, prevCriterion, minibatchSize,
+                                criteriaBestEpoch.get(), (IMASGD<ElemType>*)nullptr);
+        }, /*maxPendingWrites=*/1);
+        timer.Stop();
+        m_checkPointBlockingSeconds += timer.ElapsedSeconds();
+    }
+}
 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECount");
+template <class ElemType>
+void SGD<ElemType>::SaveCheckPointModel(const ComputationNetworkPtr& net, const wstring& modelName)
+{
+    Timer timer;
+    timer.Start();
 
-            if (m_saveBestModelPerCriterion)
-            {
-                fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCriteria");
-                const int32_t criteriaSize = static_cast<int32_t>(m_criteriaBestEpoch.size());
-                fstream << criteriaSize;
-                for (const auto& criterion : m_criteriaBestEpoch)
-                {
-                    fstream << criterion.second.criterionMinValue << criterion.second.epochIndex;
-                }
-                fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECriteria");
-            }
+    // The model is saved like ComputationNetwork::Save() does it, to a temporary file that is renamed when complete.
+    // At most the checkpoint info written before it may still be pending, so only one snapshot of the model is kept.
+    auto snapshot = net->CloneModelToHost();
+    if (!m_checkPointWriter)
+        m_checkPointWriter = make_shared<::CNTK::CheckpointWriter>();
+    m_checkPointWriter->Enqueue([snapshot, modelName]()
+    {
+        snapshot->Save(modelName);
+    }, /*maxPendingWrites=*/2);
 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECKP");
-            if (m_pMASGDHelper)
-                m_pMASGDHelper->SaveToCheckPoint(fstream);
-            // Ensuring that data is written
-            fstream.Flush();
-        }
+    timer.Stop();
+    m_checkPointBlockingSeconds += timer.ElapsedSeconds();
+}
 
-        _wunlink(checkPointFileName.c_str());
-        renameOrDie(tempFileName, checkPointFileName);
+template <class ElemType>
+void SGD<ElemType>::WaitForCheckPointWrites()
+{
+    if (m_checkPointWriter)
+    {
+        Timer timer;
+        timer.Start();
+        m_checkPointWriter->Wait();
+        timer.Stop();
+        m_checkPointBlockingSeconds += timer.ElapsedSeconds();
     }
+    SynchronizeWorkers();
 }
 
 template <class ElemType>
@@ -27,8 +27,10 @@ using namespace std; // ugh! TODO: get rid of this from .h files!!!
 #define CNTK_CHECKPOINT_VERSION_2 2      
 #define CURRENT_CNTK_CHECKPOINT_VERSION CNTK_CHECKPOINT_VERSION_2
 
-namespace CNTK { namespace Internal {
+namespace CNTK {
     // Forward declarations.
+    class CheckpointWriter;
+namespace Internal {
     class TensorBoardFileWriter;
     typedef std::shared_ptr<TensorBoardFileWriter> TensorBoardFileWriterPtr;
 }}
@@ -362,7 +364,8 @@ public:
           m_prevChosenMinibatchSize(0),
           m_lastFinishedEpochTrainLoss(0.0),
           m_distGradAgg(nullptr),
-          m_gradHeader(nullptr)
+          m_gradHeader(nullptr),
+          m_checkPointBlockingSeconds(0.0)
     {
         msra::files::make_intermediate_dirs(m_modelPath);
     }
@@ -537,6 +540,8 @@ protected:
                             const std::vector<double>& smoothedCounts,
                             const double prevCriterion,
                             const size_t minibatchSize);
+    // Saves the model of a checkpoint on the background thread that writes the checkpoint info, from a copy in host memory.
+    void SaveCheckPointModel(const ComputationNetworkPtr& net, const std::wstring& modelName);
 
     bool TryLoadCheckPointInfo(const size_t epochNumber,
                                /*out*/ size_t& totalSamplesSeen,
@@ -545,6 +550,9 @@ protected:
                                std::vector<double>& smoothedCounts,
                                /*out*/ double& prevCriterion,
                                /*out*/ size_t& minibatchSize);
+    // Waits until the checkpoint models and infos that the main node writes in the background are written, and synchronizes
+    // the workers, so that all of them can read them. Has to be called by all workers.
+    void WaitForCheckPointWrites();
     void LoadCheckPointInfo(const size_t epochNumber,
                             /*out*/ size_t& totalSamplesSeen,
                             /*out*/ double& learnRatePerSample,
@@ -595,6 +603,11 @@ protected:
 
     shared_ptr<IMASGD<ElemType>> m_pMASGDHelper;
 
+    // writes the checkpoint models and infos on a background thread of the main node
+    std::shared_ptr<::CNTK::CheckpointWriter> m_checkPointWriter;
+    // time the training thread spent taking the snapshots of checkpoints and waiting for their writes
+    double m_checkPointBlockingSeconds;
+
 private:
     void MarkDropoutNodesEvalTimeStampAsOutdated(const ComputationNetworkPtr& net, const ComputationNodeBasePtr& criterionNode);
     std::shared_ptr<ASGDHelper<ElemType>> m_pASGDHelper;
@@ -13,6 +13,7 @@
 #include <future>
 #include "GPUDataTransferer.h"
 #include "TimerUtility.h"
+#include "PerformanceProfiler.h"
 #include "MatrixQuantizerImpl.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
@@ -38,6 +39,7 @@ public:
     }
 
     // Aggregate the gradient matrices across all nodes
+    // This runs after backprop; overlapping the aggregation with backprop in gradient buckets is only done by the V2 DataParallelDistributedLearner.
     bool AggregateGradients(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool resetState) override
     {
         ResetState(gradients, headerCPU->numEvalNode, resetState);
@@ -55,7 +57,10 @@ public:
                 if (showSyncPerfStats)
                     aggregationTimer.Start();
 
-                m_pendingAsyncAggregation.get();
+                {
+                    PROFILE_SCOPE(profilerEvtAsyncGradientWait);
+                    m_pendingAsyncAggregation.get();
+                }
 
                 if (showSyncPerfStats)
                 {
@@ -110,6 +115,7 @@ public:
                     mainStreamSyncEvent->SynchronizeDataTransferFetchStreamWithEvent<ElemType>();
                     delete mainStreamSyncEvent;
 
+                    PROFILE_SCOPE(profilerEvtAsyncGradientAggregation);
                     AggregateGradientsImpl(newGradients, newGradHeader, showSyncPerfStats);
                 });
 
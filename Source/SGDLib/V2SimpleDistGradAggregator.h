@@ -12,6 +12,7 @@
 #include "CNTKLibrary.h"
 #include "IDistGradAggregator.h"
 #include "TimerUtility.h"
+#include "PerformanceProfiler.h"
 #include "MatrixQuantizerImpl.h"
 #include "Utils.h"
 #include "NcclComm.h"
@@ -63,7 +64,10 @@ public:
             if (showSyncPerfStats)
                 aggregationTimer.Start();
 
-            m_pendingAsyncAggregation.get();
+            {
+                PROFILE_SCOPE(profilerEvtAsyncGradientWait);
+                m_pendingAsyncAggregation.get();
+            }
 
             if (showSyncPerfStats)
             {
@@ -112,6 +116,7 @@ public:
                 mainStreamSyncEvent->SynchronizeDataTransferFetchStreamWithEvent<ElemType>();
                 delete mainStreamSyncEvent;
 
+                PROFILE_SCOPE(profilerEvtAsyncGradientAggregation);
                 AggregateGradientsImpl(newGradients, newGradHeader, showSyncPerfStats);
             });
 
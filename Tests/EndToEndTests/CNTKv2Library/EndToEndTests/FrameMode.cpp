@@ -112,6 +112,7 @@ void TestFrameMode()
     // Create a set of trainers.
     std::map<std::wstring, std::function<DistributedLearnerPtr(LearnerPtr)>> learners;
     learners[L"simple"] = [](LearnerPtr l) { return CreateDataParallelDistributedLearner(MPICommunicator(), l, 0); };
+    learners[L"bucketed"] = [](LearnerPtr l) { return CreateDataParallelDistributedLearner(MPICommunicator(), l, 0, false, /*gradientBucketSizeInBytes =*/ 4096); };
 
     if (Is1bitSGDAvailable())
     {
@@ -148,6 +149,61 @@ void TestFrameMode()
 }
 
 
+
+// Trains the same model with and without gradient buckets and checks that the parameters end up the same:
+// the buckets change when, and in which groups, the gradients are aggregated, but not what they sum up to.
+void TestGradientBuckets()
+{
+    if (!ShouldRunOnCpu())
+        return;
+
+    auto device = DeviceDescriptor::CPUDevice();
+    auto sync = MPICommunicator();
+    auto numWorkers = sync->Workers().size();
+    auto workerRank = sync->CurrentWorker().m_globalRank;
+    const size_t numMinibatches = 20;
+
+    auto train = [&](size_t gradientBucketSizeInBytes) {
+        auto classifier = BuildFeedForwardClassifier(device);
+        auto learner = SGDLearner(classifier.output->Parameters(), LearningRatePerSampleSchedule(0.02));
+        auto distributedLearner = CreateDataParallelDistributedLearner(MPICommunicator(), learner, 0, false, gradientBucketSizeInBytes);
+        auto trainer = CreateTrainer(classifier.output, classifier.trainingLoss, classifier.prediction, { distributedLearner });
+
+        auto minibatchSource = GetMinibatchSource(classifier);
+        auto featureStreamInfo = minibatchSource->StreamInfo(g_featureStreamName);
+        auto labelStreamInfo = minibatchSource->StreamInfo(g_labelsStreamName);
+        for (size_t i = 0; i < numMinibatches; i++)
+        {
+            auto minibatchData = minibatchSource->GetNextMinibatch(0, minibatchSize, numWorkers, workerRank, device);
+            unordered_map<Variable, MinibatchData> minibatch = { { classifier.features, minibatchData[featureStreamInfo] }, { classifier.labels, minibatchData[labelStreamInfo] } };
+            trainer->TrainMinibatch(minibatch, device);
+        }
+
+        return classifier.output->Parameters();
+    };
+
+    sync->Barrier();
+    auto expectedParameters = train(0);
+
+    // every parameter in a bucket of its own, and several parameters in a bucket
+    for (size_t gradientBucketSizeInBytes : { 4, 4096 })
+    {
+        sync->Barrier();
+        auto parameters = train(gradientBucketSizeInBytes);
+        if (parameters.size() != expectedParameters.size())
+            ReportFailure("Unexpected number of parameters trained with gradient buckets of %d bytes", (int)gradientBucketSizeInBytes);
+
+        for (size_t i = 0; i < parameters.size(); i++)
+        {
+            if (!Internal::AreEqual(*parameters[i].Value(), *expectedParameters[i].Value(), relativeTolerance, absoluteTolerance))
+                ReportFailure("Parameter '%ls' trained with gradient buckets of %d bytes does not match the one trained without them",
+                              parameters[i].AsString().c_str(), (int)gradientBucketSizeInBytes);
+        }
+    }
+
+    sync->Barrier();
+}
+
 void TestDistributedCheckpointing()
 {
     std::vector<DeviceDescriptor> devices;
@@ -21,6 +21,7 @@ void MNISTClassifierTests();
 void TrainSequenceToSequenceTranslator();
 void TrainTruncatedLSTMAcousticModelClassifier();
 void TestFrameMode();
+void TestGradientBuckets();
 void TestDistributedCheckpointing();
 
 int main(int argc, char *argv[])
@@ -59,6 +60,8 @@ int main(int argc, char *argv[])
 
             TestFrameMode();
 
+            TestGradientBuckets();
+
             TestDistributedCheckpointing();
 
             std::string testsPassedMsg = "\nCNTKv2Library-Distribution tests: Passed\n";
@@ -7,6 +7,7 @@
 #include "ComputationNode.h"
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
+#include <thread>
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -227,6 +228,128 @@ BOOST_AUTO_TEST_CASE(EvalDenseTimesTest)
     eval->Destroy();
 }
 
+BOOST_AUTO_TEST_CASE(EvalSharingParametersTest)
+{
+    std::string modelDefinition =
+        "deviceId = -1 \n"
+        "precision = \"float\" \n"
+        "traceLevel = 1 \n"
+        "run=NDLNetworkBuilder \n"
+        "NDLNetworkBuilder=[ \n"
+        "i1 = Input(4) \n"
+        "W = Parameter(3, 4, init = \"uniform\", initValueScale = 1) \n"
+        "o1 = Plus(Times(W, i1), i1, tag=\"output\") \n"
+        "FeatureNodes = (i1) \n"
+        "] \n";
+
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float> *eval;
+    eval = SetupNetworkAndGetLayouts(modelDefinition, inputLayouts, outputLayouts);
+
+    // Evaluators that share the parameters, which are created before the first pass of the model
+    const size_t numEvaluators = 4;
+    std::vector<IEvaluateModelExtended<float>*> evals(numEvaluators);
+    for (auto& e : evals)
+    {
+        GetEvalExtendedSharingParametersF(eval, &e);
+        e->StartForwardEvaluation({ outputLayouts[0].m_name });
+    }
+
+    // Each evaluator gets its own input, and the outputs are compared with those of the model
+    std::vector<Values<float>> inputBuffers(numEvaluators, Values<float>(1));
+    std::vector<Values<float>> expected(numEvaluators);
+    for (size_t e = 0; e < numEvaluators; e++)
+    {
+        inputBuffers[e][0].m_buffer = { (float)e, 1, 2, -3 };
+        expected[e] = outputLayouts.CreateBuffers<float>({ 1 });
+        eval->ForwardPass(inputBuffers[e], expected[e]);
+    }
+
+    // The model can go away while the parameters are still in use
+    eval->Destroy();
+
+    std::vector<Values<float>> outputBuffers(numEvaluators);
+    for (auto& outputBuffer : outputBuffers)
+        outputBuffer = outputLayouts.CreateBuffers<float>({ 1 });
+    std::vector<std::thread> threads;
+    for (size_t e = 0; e < numEvaluators; e++)
+    {
+        threads.push_back(std::thread([&, e]()
+        {
+            for (size_t i = 0; i < 100; i++)
+                evals[e]->ForwardPass(inputBuffers[e], outputBuffers[e]);
+        }));
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t e = 0; e < numEvaluators; e++)
+    {
+        auto& buf = outputBuffers[e][0].m_buffer;
+        auto& exp = expected[e][0].m_buffer;
+        BOOST_CHECK_EQUAL_COLLECTIONS(buf.begin(), buf.end(), exp.begin(), exp.end());
+        evals[e]->Destroy();
+    }
+}
+
+// Evaluators that share the parameters can be created from a model while it is evaluated on another thread.
+BOOST_AUTO_TEST_CASE(EvalSharingParametersWhileEvaluatingTest)
+{
+    std::string modelDefinition =
+        "deviceId = -1 \n"
+        "precision = \"float\" \n"
+        "traceLevel = 1 \n"
+        "run=NDLNetworkBuilder \n"
+        "NDLNetworkBuilder=[ \n"
+        "i1 = Input(4) \n"
+        "W = Parameter(3, 4, init = \"uniform\", initValueScale = 1) \n"
+        "o1 = Plus(Times(W, i1), i1, tag=\"output\") \n"
+        "FeatureNodes = (i1) \n"
+        "] \n";
+
+    VariableSchema inputLayouts;
+    VariableSchema outputLayouts;
+    IEvaluateModelExtended<float> *eval;
+    eval = SetupNetworkAndGetLayouts(modelDefinition, inputLayouts, outputLayouts);
+    eval->StartForwardEvaluation({ outputLayouts[0].m_name });
+
+    Values<float> input(1);
+    input[0].m_buffer = { 1, 2, 3, 4 };
+    auto expected = outputLayouts.CreateBuffers<float>({ 1 });
+    eval->ForwardPass(input, expected);
+
+    auto modelOutput = outputLayouts.CreateBuffers<float>({ 1 });
+    std::thread modelThread([&]()
+    {
+        for (size_t i = 0; i < 100; i++)
+            eval->ForwardPass(input, modelOutput);
+    });
+
+    std::vector<IEvaluateModelExtended<float>*> evals(4);
+    for (auto& e : evals)
+    {
+        GetEvalExtendedSharingParametersF(eval, &e);
+        e->StartForwardEvaluation({ outputLayouts[0].m_name });
+    }
+    modelThread.join();
+
+    for (auto e : evals)
+    {
+        auto output = outputLayouts.CreateBuffers<float>({ 1 });
+        e->ForwardPass(input, output);
+        auto& buf = output[0].m_buffer;
+        auto& exp = expected[0].m_buffer;
+        BOOST_CHECK_EQUAL_COLLECTIONS(buf.begin(), buf.end(), exp.begin(), exp.end());
+        e->Destroy();
+    }
+
+    auto& buf = modelOutput[0].m_buffer;
+    auto& exp = expected[0].m_buffer;
+    BOOST_CHECK_EQUAL_COLLECTIONS(buf.begin(), buf.end(), exp.begin(), exp.end());
+    eval->Destroy();
+}
+
 BOOST_AUTO_TEST_CASE(EvalSparseTimesTest)
 {
     std::string modelDefinition =
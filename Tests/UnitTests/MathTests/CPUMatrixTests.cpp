@@ -4,6 +4,7 @@
 //
 #include "stdafx.h"
 #include "../../../Source/Math/CPUMatrix.h"
+#include "../../../Source/Math/RNNCommon.h"
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -1127,6 +1128,204 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrixGatherFromTarget, RandomSeedFixture)
     BOOST_CHECK(m2.IsEqualTo(expect, 1e-6));
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUMatrixResizeReusesArenaMemory, RandomSeedFixture)
+{
+    auto& arena = CPUArenaAllocator::Instance();
+    {
+        SMatrix m(100, 37);
+        m.SetValue(1.0f);
+    }
+    const auto before = arena.GetStats();
+
+    // a matrix of the same size class must come from the cache, and must still be zero-initialized
+    SMatrix m(100, 37);
+    const auto after = arena.GetStats();
+    BOOST_CHECK_EQUAL(after.numMallocs, before.numMallocs + 1);
+    BOOST_CHECK_EQUAL(after.numThreadCacheHits + after.numCentralCacheHits, before.numThreadCacheHits + before.numCentralCacheHits + 1);
+    BOOST_CHECK_EQUAL(after.bytesReservedFromOS, before.bytesReservedFromOS);
+    foreach_coord (i, j, m)
+        BOOST_CHECK_EQUAL(m(i, j), 0.0f);
+
+    // growing and shrinking with growOnly == false goes through the arena as well
+    m.Resize(1000, 37, /*growOnly=*/false);
+    m.Resize(10, 37, /*growOnly=*/false);
+    BOOST_CHECK_EQUAL(arena.GetStats().numFrees, after.numFrees + 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUArenaBoundsAndTrimsLargeBlocksInThreadCache, RandomSeedFixture)
+{
+    auto& arena = CPUArenaAllocator::Instance();
+    const size_t largeBytes = 256 * 1024; // above the slab classes, but still cached per thread
+    arena.Trim();
+
+    // a freed large block stays mapped in this thread's cache until Trim() gives it back
+    const auto before = arena.GetStats();
+    arena.Free(arena.Malloc(largeBytes));
+    BOOST_CHECK_EQUAL(arena.GetStats().numLargeMappings, before.numLargeMappings + 1);
+    arena.Trim();
+    BOOST_CHECK_EQUAL(arena.GetStats().numLargeMappings, before.numLargeMappings);
+    BOOST_CHECK_EQUAL(arena.GetStats().bytesReservedFromOS, before.bytesReservedFromOS);
+
+    // the thread cache counts toward the budget, so without one the block is unmapped right away
+    const size_t maxCachedBytes = arena.GetMaxCachedBytes();
+    arena.SetMaxCachedBytes(0);
+    arena.Free(arena.Malloc(largeBytes));
+    BOOST_CHECK_EQUAL(arena.GetStats().numLargeMappings, before.numLargeMappings);
+    arena.SetMaxCachedBytes(maxCachedBytes);
+}
+
+// Runs a single sequence through an OptimizedRNNStack, computing the cells straight from their definitions.
+// 'x' holds the input frames of the sequence, the result the output frames.
+static vector<vector<double>> ReferenceRNNForward(const vector<double>& w, const vector<vector<double>>& x, size_t xDim, const RnnAttributes& attributes)
+{
+    const wstring& op = attributes.m_recurrentOp;
+    const size_t numGates = op == L"lstm" ? 4 : op == L"gru" ? 3 : 1;
+    const size_t numDirections = attributes.m_bidirectional ? 2 : 1;
+    const size_t H = attributes.m_hiddenSize;
+    const size_t T = x.size();
+    auto sigmoid = [](double v) { return 1 / (1 + exp(-v)); };
+
+    size_t biasOffset = 0;
+    for (size_t layer = 0, inDim = xDim; layer < attributes.m_numLayers; layer++, inDim = numDirections * H)
+        biasOffset += numDirections * (inDim + H) * numGates * H;
+
+    size_t weightOffset = 0;
+    vector<vector<double>> in = x;
+    size_t inDim = xDim;
+    for (size_t layer = 0; layer < attributes.m_numLayers; layer++)
+    {
+        vector<vector<double>> out(T, vector<double>(numDirections * H));
+        for (size_t dir = 0; dir < numDirections; dir++)
+        {
+            const double* W = &w[weightOffset];
+            const double* R = W + inDim * numGates * H;
+            const double* b1 = &w[biasOffset];
+            const double* b2 = b1 + numGates * H;
+            weightOffset += (inDim + H) * numGates * H;
+            biasOffset += 2 * numGates * H;
+
+            vector<double> h(H, 0), c(H, 0), input(numGates * H), recurrent(numGates * H);
+            for (size_t i = 0; i < T; i++)
+            {
+                const size_t t = dir == 0 ? i : T - 1 - i;
+                for (size_t j = 0; j < numGates * H; j++)
+                {
+                    input[j] = b1[j];
+                    for (size_t k = 0; k < inDim; k++)
+                        input[j] += W[j * inDim + k] * in[t][k];
+                    recurrent[j] = b2[j];
+                    for (size_t k = 0; k < H; k++)
+                        recurrent[j] += R[j * H + k] * h[k];
+                }
+                for (size_t j = 0; j < H; j++)
+                {
+                    if (op == L"lstm")
+                    {
+                        c[j] = sigmoid(input[H + j] + recurrent[H + j]) * c[j] + sigmoid(input[j] + recurrent[j]) * tanh(input[2 * H + j] + recurrent[2 * H + j]);
+                        h[j] = sigmoid(input[3 * H + j] + recurrent[3 * H + j]) * tanh(c[j]);
+                    }
+                    else if (op == L"gru")
+                    {
+                        double r = sigmoid(input[j] + recurrent[j]);
+                        double z = sigmoid(input[H + j] + recurrent[H + j]);
+                        double n = tanh(input[2 * H + j] + r * recurrent[2 * H + j]);
+                        h[j] = (1 - z) * n + z * h[j];
+                    }
+                    else if (op == L"rnnTanh")
+                        h[j] = tanh(input[j] + recurrent[j]);
+                    else
+                        h[j] = max(input[j] + recurrent[j], 0.0);
+                }
+                copy(h.begin(), h.end(), out[t].begin() + dir * H);
+            }
+        }
+        in = out;
+        inDim = numDirections * H;
+    }
+    return in;
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixRNNForwardTanh, RandomSeedFixture)
+{
+    // a single unit, a single sequence of two steps: y0 = tanh(w x0 + b), y1 = tanh(w x1 + r y0 + b)
+    RnnAttributes attributes(false, 1, 1, L"rnnTanh", -1);
+    double wData[] = { 0.5, -0.25, 0.125, 0.0625 }; // W, R, b1, b2
+    double xData[] = { 1.0, 2.0 };
+    DMatrix w(4, 1, wData, matrixFlagNormal);
+    DMatrix x(1, 2, xData, matrixFlagNormal);
+    DMatrix y(1, 2);
+    DMatrix workspace;
+
+    y.RNNForward(x, w, 1, 1, vector<size_t>{ 1, 1 }, attributes, workspace);
+
+    const double y0 = tanh(0.5 * 1.0 + 0.1875);
+    const double y1 = tanh(0.5 * 2.0 - 0.25 * y0 + 0.1875);
+    BOOST_CHECK_CLOSE(y(0, 0), y0, 1e-10);
+    BOOST_CHECK_CLOSE(y(0, 1), y1, 1e-10);
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixRNNForward, RandomSeedFixture)
+{
+    // sequences of different lengths in the packing that OptimizedRNNStackNode passes to RNNForward()
+    const vector<size_t> sequenceLengths = { 5, 3, 3, 1 };
+    const vector<size_t> numSequencesForFrame = { 4, 3, 3, 1, 1 };
+    vector<size_t> frameStart = { 0 };
+    for (auto n : numSequencesForFrame)
+        frameStart.push_back(frameStart.back() + n);
+    const size_t numFrames = frameStart.back();
+    const size_t xDim = 3, hiddenSize = 4;
+
+    const RnnAttributes configs[] = {
+        RnnAttributes(false, 1, hiddenSize, L"lstm", -1),
+        RnnAttributes(true, 2, hiddenSize, L"lstm", -1),
+        RnnAttributes(true, 3, hiddenSize, L"gru", -1),
+        RnnAttributes(false, 2, hiddenSize, L"rnnTanh", -1),
+        RnnAttributes(true, 1, hiddenSize, L"rnnReLU", -1),
+    };
+    for (const auto& attributes : configs)
+    {
+        const size_t yDim = (attributes.m_bidirectional ? 2 : 1) * hiddenSize;
+        const auto numParameters = attributes.GetNumParameters(xDim);
+        SMatrix w = SMatrix::RandomUniform(numParameters.first, numParameters.second, -0.5f, 0.5f, IncrementCounter());
+        SMatrix x = SMatrix::RandomUniform(xDim, numFrames, -1, 1, IncrementCounter());
+        SMatrix y(yDim, numFrames);
+        SMatrix workspace;
+
+        y.RNNForward(x, w, xDim, yDim, numSequencesForFrame, attributes, workspace);
+
+        const vector<double> wRef(w.Data(), w.Data() + w.GetNumElements());
+        for (size_t s = 0; s < sequenceLengths.size(); s++)
+        {
+            vector<vector<double>> xRef;
+            for (size_t t = 0; t < sequenceLengths[s]; t++)
+                xRef.push_back(vector<double>(x.Data() + (frameStart[t] + s) * xDim, x.Data() + (frameStart[t] + s + 1) * xDim));
+
+            auto yRef = ReferenceRNNForward(wRef, xRef, xDim, attributes);
+            for (size_t t = 0; t < sequenceLengths[s]; t++)
+                for (size_t i = 0; i < yDim; i++)
+                    BOOST_CHECK_SMALL(y(i, frameStart[t] + s) - yRef[t][i], 1e-5);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixRNNForwardInvalidAttributes, RandomSeedFixture)
+{
+    const size_t xDim = 3, hiddenSize = 4;
+    SMatrix x(xDim, 2);
+    SMatrix workspace;
+
+    // an empty stack
+    RnnAttributes noLayers(false, 0, hiddenSize, L"lstm", -1);
+    SMatrix w(noLayers.GetNumParameters(xDim).first, noLayers.GetNumParameters(xDim).second);
+    SMatrix y(hiddenSize, 2);
+    BOOST_CHECK_THROW(y.RNNForward(x, w, xDim, hiddenSize, vector<size_t>{ 1, 1 }, noLayers, workspace), std::invalid_argument);
+
+    // the output of a bidirectional network has twice the hidden size
+    RnnAttributes bidirectional(true, 1, hiddenSize, L"lstm", -1);
+    SMatrix wBidirectional(bidirectional.GetNumParameters(xDim).first, bidirectional.GetNumParameters(xDim).second);
+    BOOST_CHECK_THROW(y.RNNForward(x, wBidirectional, xDim, hiddenSize, vector<size_t>{ 1, 1 }, bidirectional, workspace), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
 } } }
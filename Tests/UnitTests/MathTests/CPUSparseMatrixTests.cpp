@@ -116,6 +116,83 @@ BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixMultiplyAndAdd, RandomSeedFixture)
     }
 }
 
+// Sets sm to the nonzeros of dm, in the order that the format of sm stores them.
+static void AssignNonzeros(const DenseMatrix& dm, SparseMatrix& sm)
+{
+    bool isCSR = sm.GetFormat() == MatrixFormat::matrixFormatSparseCSR;
+    size_t numOuter = isCSR ? dm.GetNumRows() : dm.GetNumCols();
+    size_t numInner = isCSR ? dm.GetNumCols() : dm.GetNumRows();
+    for (size_t outer = 0; outer < numOuter; outer++)
+    {
+        for (size_t inner = 0; inner < numInner; inner++)
+        {
+            size_t row = isCSR ? outer : inner;
+            size_t col = isCSR ? inner : outer;
+            if (dm(row, col) != 0)
+                sm.SetValue(row, col, dm(row, col));
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixMultiplyAndWeightedAdd, RandomSeedFixture)
+{
+    // large enough for the products to run in parallel, and not a multiple of the blocking
+    const size_t m = 301;
+    const size_t k = 200;
+    const size_t n = 70;
+
+    for (auto format : { MatrixFormat::matrixFormatSparseCSC, MatrixFormat::matrixFormatSparseCSR })
+    {
+        for (int transposeSparse = 0; transposeSparse < 2; transposeSparse++)
+        {
+            for (int transposeDense = 0; transposeDense < 2; transposeDense++)
+            {
+                // sparse * dense
+                DenseMatrix dmA(transposeSparse ? k : m, transposeSparse ? m : k);
+                dmA.SetUniformRandomValue(-3, 1, IncrementCounter());
+                dmA.InplaceTruncateBottom(0);
+                SparseMatrix smA(format, dmA.GetNumRows(), dmA.GetNumCols(), 0);
+                AssignNonzeros(dmA, smA);
+
+                DenseMatrix dmB(transposeDense ? n : k, transposeDense ? k : n);
+                dmB.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+                DenseMatrix expected(m, n);
+                expected.SetUniformRandomValue(-1, 1, IncrementCounter());
+                DenseMatrix actual(expected);
+                DenseMatrix::MultiplyAndWeightedAdd(2, dmA, transposeSparse != 0, dmB, transposeDense != 0, 0.5, expected);
+                SparseMatrix::MultiplyAndWeightedAdd(2, smA, transposeSparse != 0, dmB, transposeDense != 0, 0.5, actual);
+                BOOST_CHECK(actual.IsEqualTo(expected, c_epsilonFloatE4));
+
+                // dense * sparse
+                DenseMatrix dmC(transposeDense ? k : m, transposeDense ? m : k);
+                dmC.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+                DenseMatrix dmD(transposeSparse ? n : k, transposeSparse ? k : n);
+                dmD.SetUniformRandomValue(-3, 1, IncrementCounter());
+                dmD.InplaceTruncateBottom(0);
+                SparseMatrix smD(format, dmD.GetNumRows(), dmD.GetNumCols(), 0);
+                AssignNonzeros(dmD, smD);
+
+                DenseMatrix::MultiplyAndWeightedAdd(1, dmC, transposeDense != 0, dmD, transposeSparse != 0, 0, expected);
+                SparseMatrix::MultiplyAndWeightedAdd(1, dmC, transposeDense != 0, smD, transposeSparse != 0, 0, actual);
+                BOOST_CHECK(actual.IsEqualTo(expected, c_epsilonFloatE4));
+
+                // dense * sparse -> SparseBlockCol, accumulated over two products
+                SparseMatrix smMul(MatrixFormat::matrixFormatSparseBlockCol, m, n, 0);
+                SparseMatrix::MultiplyAndAdd(1, dmC, transposeDense != 0, smD, transposeSparse != 0, smMul);
+                SparseMatrix::MultiplyAndAdd(1, dmC, transposeDense != 0, smD, transposeSparse != 0, smMul);
+                expected.SetValue(0);
+                DenseMatrix::MultiplyAndWeightedAdd(2, dmC, transposeDense != 0, dmD, transposeSparse != 0, 0, expected);
+                foreach_coord(row, col, expected)
+                {
+                    BOOST_CHECK(abs(smMul(row, col) - expected(row, col)) < c_epsilonFloatE4);
+                }
+            }
+        }
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixDoGatherColumnsOf, RandomSeedFixture)
 {
     const size_t m = 100;
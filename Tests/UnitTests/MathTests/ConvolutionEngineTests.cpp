@@ -124,6 +124,52 @@ std::vector<ConvolveGeometryPtr> GenerateConvTestConfigs()
     return res;
 }
 
+// Geometries handled by the direct convolution engine: 3x3 with stride 1 (Winograd), 1x1 and depthwise.
+std::vector<ConvolveGeometryPtr> GenerateDirectConvTestConfigs()
+{
+    std::vector<ConvolveGeometryPtr> res;
+    for (size_t inW : {3, 4, 7, 16})
+    {
+        for (size_t inC : {1, 3})
+        {
+            for (size_t mapCount : {1, 5})
+            {
+                for (bool autoPad : {false, true})
+                {
+                    res.push_back(std::make_shared<ConvolveGeometry>(TensorShape(inW, inW + 1, inC),
+                        TensorShape(3, 3, inC), TensorShape(mapCount), TensorShape(1, 1, inC),
+                        ConvolveGeometry::BoolVec{true}, ConvolveGeometry::BoolVec{autoPad, autoPad, false},
+                        TensorShape(0), TensorShape(0)));
+                }
+                for (size_t stride : {1, 2})
+                {
+                    res.push_back(std::make_shared<ConvolveGeometry>(TensorShape(inW, inW + 1, inC),
+                        TensorShape(1, 1, inC), TensorShape(mapCount), TensorShape(stride, stride, inC),
+                        ConvolveGeometry::BoolVec{true}, ConvolveGeometry::BoolVec{false},
+                        TensorShape(0), TensorShape(0)));
+                }
+            }
+        }
+        // Depthwise, with a channel multiplier of 1 and 2.
+        for (size_t mapCount : {1, 2})
+        {
+            for (size_t stride : {1, 2})
+            {
+                res.push_back(std::make_shared<ConvolveGeometry>(TensorShape(inW, inW + 1, 4),
+                    TensorShape(3, 3, 1), TensorShape(mapCount), TensorShape(stride, stride, 1),
+                    ConvolveGeometry::BoolVec{true, true, false}, ConvolveGeometry::BoolVec{true, true, false},
+                    TensorShape(0), TensorShape(0)));
+            }
+        }
+    }
+    // Explicit padding.
+    res.push_back(std::make_shared<ConvolveGeometry>(TensorShape(6, 6, 2),
+        TensorShape(3, 3, 2), TensorShape(4), TensorShape(1, 1, 2),
+        ConvolveGeometry::BoolVec{true}, ConvolveGeometry::BoolVec{false},
+        TensorShape(1, 1, 0), TensorShape(1, 1, 0)));
+    return res;
+}
+
 std::vector<ConvolveGeometryPtr> GeneratePoolTestConfigs()
 {
     std::vector<ConvolveGeometryPtr> res;
@@ -371,6 +417,66 @@ BOOST_AUTO_TEST_CASE(ConvolutionBackwardKernel)
     }
 }
 
+BOOST_AUTO_TEST_CASE(DirectConvolutionEngine)
+{
+    std::mt19937 rng(0);
+    boost::random::uniform_int_distribution<> batchSizeG(1, 8);
+    boost::random::normal_distribution<float> nd;
+
+    int deviceId = -1;
+    for (const auto& g : GenerateDirectConvTestConfigs())
+    {
+        auto baseEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, 0, PoolKind::None, ConvolutionEngineKind::Reference);
+        auto testEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, 0, PoolKind::None, ConvolutionEngineKind::Direct);
+
+        size_t n = batchSizeG(rng);
+        size_t crowIn = g->InputShape().GetNumElements();
+        size_t crowOut = g->OutputShape().GetNumElements();
+        vec buf(crowIn * n);
+        std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+        SingleMatrix in(crowIn, n, buf.data(), deviceId, matrixFlagNormal);
+        SingleMatrix gradIn(crowIn, n, buf.data(), deviceId, matrixFlagNormal);
+        SingleMatrix gradInB(crowIn, n, buf.data(), deviceId, matrixFlagNormal);
+
+        buf.resize(crowOut * n);
+        std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+        SingleMatrix srcGrad(crowOut, n, buf.data(), deviceId, matrixFlagNormal);
+
+        // Depthwise convolutions have one kernel per output map rather than per map count.
+        size_t kernelCount = g->KernelCount();
+        buf.resize(g->KernelShape().GetNumElements() * kernelCount);
+        std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+        SingleMatrix kernel(kernelCount, g->KernelShape().GetNumElements(), buf.data(), deviceId, matrixFlagNormal);
+        SingleMatrix gradKernel(kernelCount, g->KernelShape().GetNumElements(), buf.data(), deviceId, matrixFlagNormal);
+        SingleMatrix gradKernelB(kernelCount, g->KernelShape().GetNumElements(), buf.data(), deviceId, matrixFlagNormal);
+
+        SingleMatrix out(crowOut, n, deviceId);
+        SingleMatrix outB(crowOut, n, deviceId);
+        SingleMatrix workspace(deviceId);
+        SingleMatrix workspaceB(deviceId);
+
+        testEng->Forward(in, kernel, out, workspace);
+        baseEng->Forward(in, kernel, outB, workspaceB);
+        testEng->BackwardData(srcGrad, kernel, gradIn, true, workspace);
+        baseEng->BackwardData(srcGrad, kernel, gradInB, true, workspaceB);
+        testEng->BackwardKernel(srcGrad, in, gradKernel, true, false, workspace);
+        baseEng->BackwardKernel(srcGrad, in, gradKernelB, true, false, workspaceB);
+
+        std::stringstream tmsg;
+        tmsg << "Geometry: " << (std::string)(*g) << ", Batch: " << n;
+        std::string msg = " are not equal, " + tmsg.str();
+
+        // Winograd transforms lose a few bits compared to direct summation.
+        float relErr = 1e-3f;
+        float absErr = 5e-4f;
+        std::string emsg;
+
+        BOOST_REQUIRE_MESSAGE(CheckEqual(out, outB, emsg, relErr, absErr), "out" << msg << ". " << emsg);
+        BOOST_REQUIRE_MESSAGE(CheckEqual(gradIn, gradInB, emsg, relErr, absErr), "gradIn" << msg << ". " << emsg);
+        BOOST_REQUIRE_MESSAGE(CheckEqual(gradKernel, gradKernelB, emsg, relErr, absErr), "gradKernel" << msg << ". " << emsg);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(PoolingForward)
 {
     std::mt19937 rng(0);
@@ -80,13 +80,33 @@ BOOST_AUTO_TEST_SUITE(MatrixLearnerSuite)
 BOOST_FIXTURE_TEST_CASE(FSAdagradSparse, MatrixLearnerFixture)
 {
     // run learner
-    double targetAdagradAvDenom_x_sqrtAdagradSqrFrames = 0.5;
-    matSG.FSAdagradUpdate(matG, matM, targetAdagradAvDenom_x_sqrtAdagradSqrFrames, 0.0001, 1.0, 0.9, false);
+    RunOnDevices([this]()
+    {
+        double targetAdagradAvDenom_x_sqrtAdagradSqrFrames = 0.5;
+        matSG.FSAdagradUpdate(matG, matM, targetAdagradAvDenom_x_sqrtAdagradSqrFrames, 0.0001, 1.0, 0.9, false);
 
-    matSGsparse.FSAdagradUpdate(matGsparseBSC, matMsparse, targetAdagradAvDenom_x_sqrtAdagradSqrFrames, 0.0001, 1.0, 0.9, false);
+        matSGsparse.FSAdagradUpdate(matGsparseBSC, matMsparse, targetAdagradAvDenom_x_sqrtAdagradSqrFrames, 0.0001, 1.0, 0.9, false);
 
-    BOOST_CHECK(matSG.IsEqualTo(matSGsparse, c_epsilonFloatE5));
-    BOOST_CHECK(matM.IsEqualTo(matMsparse, c_epsilonFloatE5));
+        BOOST_CHECK(matSG.IsEqualTo(matSGsparse, c_epsilonFloatE5));
+        BOOST_CHECK(matM.IsEqualTo(matMsparse, c_epsilonFloatE5));
+    });
+}
+
+// tests Adam and AdaMax sparse vs. dense
+BOOST_FIXTURE_TEST_CASE(AdamSparse, MatrixLearnerFixture)
+{
+    // run learner
+    RunOnDevices([this]()
+    {
+        for (bool adamax : { false, true })
+        {
+            matSG.AdamUpdate(matG, matM, 1, 0.0001, 0.9, 0.999, 1e-8, true, adamax);
+            matSGsparse.AdamUpdate(matGsparseBSC, matMsparse, 1, 0.0001, 0.9, 0.999, 1e-8, true, adamax);
+
+            BOOST_CHECK(matSG.IsEqualTo(matSGsparse, c_epsilonFloatE5));
+            BOOST_CHECK(matM.IsEqualTo(matMsparse, c_epsilonFloatE5));
+        }
+    });
 }
 
 // tests RmsProp sparse vs. dense
@@ -100,6 +120,27 @@ BOOST_FIXTURE_TEST_CASE(RmsPropSparse, MatrixLearnerFixture)
     BOOST_CHECK(fabsf(avg - avgSparse) < c_epsilonFloatE5);
 }
 
+// tests RmsProp sparse vs. dense on the CPU, where the sparse version only updates the smoothed gradients
+// of the columns in the gradient, so only the scaled gradients are the same
+BOOST_FIXTURE_TEST_CASE(RmsPropSparseCPU, MatrixLearnerFixture)
+{
+    RunOnDevices([this]()
+    {
+        if (matG.GetDeviceId() != CPUDEVICE)
+            return;
+
+        for (bool initialized : { false, true })
+        {
+            matSG.RmsProp(matG, 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, false, initialized);
+            matSGsparse.RmsProp(matGsparseBSC, 0.99f, 1.2f, 10.0f, 0.75f, 0.1f, false, initialized);
+
+            SingleMatrix::ScaleAndAdd(-1.0f, matG, matM);
+            SingleMatrix::ScaleAndAdd(-1.0f, matGsparseBSC, matMsparse);
+            BOOST_CHECK(matM.IsEqualTo(matMsparse, c_epsilonFloatE4));
+        }
+    });
+}
+
 // tests AdaDelta sparse vs. dense
 BOOST_FIXTURE_TEST_CASE(AdaDeltaSparse, MatrixLearnerFixture)
 {
@@ -719,6 +719,41 @@ BOOST_FIXTURE_TEST_CASE(MatrixColumnElementMultiply, RandomSeedFixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(MatrixFusedElementwiseOf, RandomSeedFixture)
+{
+    // result = s - ReLU(x + b) .* w, with b a column vector and s a scalar
+    Matrix<float> x = Matrix<float>::RandomUniform(1029, 7, CPUDEVICE, -1, 1, IncrementCounter());
+    Matrix<float> b = Matrix<float>::RandomUniform(1029, 1, CPUDEVICE, -1, 1, IncrementCounter());
+    Matrix<float> w = Matrix<float>::RandomUniform(1029, 7, CPUDEVICE, -2, 2, IncrementCounter());
+    Matrix<float> s(1, 1, CPUDEVICE);
+    s.SetValue(0.5f);
+    Matrix<float> result(1029, 7, CPUDEVICE);
+
+    std::vector<const Matrix<float>*> operands = { &x, &b, &w, &s };
+    std::vector<FusedElementwiseStep> steps = {
+        FusedElementwiseStep(opSum, 1),
+        FusedElementwiseStep(opLinearRectifier),
+        FusedElementwiseStep(opElementwiseProduct, 2),
+        FusedElementwiseStep(opDifference, 3, /*runningValueFirst=*/false)
+    };
+    BOOST_CHECK(Matrix<float>::FusedElementwiseOf(result, operands, steps));
+
+    foreach_coord (i, j, result)
+    {
+        float expected = 0.5f - std::max(0.0f, x(i, j) + b(i, 0)) * w(i, j);
+        BOOST_CHECK_LT(fabs(result(i, j) - expected), c_epsilonFloatE5);
+    }
+
+    // in place, as it happens when the result shares its buffer with the first operand
+    Matrix<float> y(x.DeepClone());
+    BOOST_CHECK(Matrix<float>::FusedElementwiseOf(y, { &y, &b, &w, &s }, steps));
+    BOOST_CHECK(y.IsEqualTo(result, c_epsilonFloatE5));
+
+    // operands that cannot be broadcast are declined
+    Matrix<float> row = Matrix<float>::RandomUniform(1, 7, CPUDEVICE, -1, 1, IncrementCounter());
+    BOOST_CHECK(!Matrix<float>::FusedElementwiseOf(result, { &x, &row }, { FusedElementwiseStep(opSum, 1) }));
+}
+
 BOOST_FIXTURE_TEST_CASE(MatrixAssignXOf, RandomSeedFixture)
 {
     // AssignDifferenceOf
@@ -50,6 +50,117 @@ BOOST_FIXTURE_TEST_CASE(MultiplyIntToShort, RandomSeedFixture)
         BOOST_CHECK_EQUAL(round(C_upd[i]), C_expected_upd[i]);
 }
 
+BOOST_AUTO_TEST_CASE(BFloat16Conversion)
+{
+    // exactly representable values round trip, others are rounded to nearest even
+    BOOST_CHECK_EQUAL((float)bfloat16(1.5f), 1.5f);
+    BOOST_CHECK_EQUAL((float)bfloat16(-256.0f), -256.0f);
+    BOOST_CHECK_EQUAL((float)bfloat16(1.0f + 1.0f / 256), 1.0f);              // tie, rounds down to even
+    BOOST_CHECK_EQUAL((float)bfloat16(1.0f + 3.0f / 256), 1.0f + 1.0f / 64);  // tie, rounds up to even
+    BOOST_CHECK(std::isnan((float)bfloat16(std::numeric_limits<float>::quiet_NaN())));
+    BOOST_CHECK(std::isinf((float)bfloat16(std::numeric_limits<float>::infinity())));
+
+    std::vector<float> values = { 0.1f, -2.75f, 1000.0f, 3.0e-20f };
+    std::vector<bfloat16> stored(values.size());
+    std::vector<float> restored(values.size());
+    ConvertToBFloat16(values.data(), stored.data(), values.size());
+    ConvertFromBFloat16(stored.data(), restored.data(), values.size());
+    for (size_t i = 0; i < values.size(); i++)
+        BOOST_CHECK_CLOSE(restored[i], values[i], 0.4f);
+}
+
+BOOST_FIXTURE_TEST_CASE(MultiplyBFloat16, RandomSeedFixture)
+{
+    // A[m,k]*B[k,n] = C[m,n], with m and n that are not multiples of the kernel block, and k larger than one depth block
+    int m = 37, n = 5, k = 300;
+    std::vector<float> A(m * k), B(k * n), C(m * n), C_expected(m * n, 0);
+    for (size_t i = 0; i < A.size(); i++)
+        A[i] = (float)((i * 7) % 13) - 6; // integers are exact in bfloat16
+    for (size_t i = 0; i < B.size(); i++)
+        B[i] = (float)((i * 5) % 11) - 5;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            for (int l = 0; l < k; l++)
+                C_expected[i + j * m] += A[i + l * m] * B[l + j * k];
+
+    // A - is constant, so it is converted on the first pass only
+    BFloat16Multiplier<float> mult(true);
+    mult.Multiply(m, n, k, A.data(), B.data(), C.data());
+    for (size_t i = 0; i < m * n; i++)
+        BOOST_CHECK_EQUAL(C[i], C_expected[i]);
+
+    // changes of A are not seen until the converted copy is invalidated
+    std::vector<float> A_upd(m * k, 1);
+    mult.Multiply(m, n, k, A_upd.data(), B.data(), C.data());
+    for (size_t i = 0; i < m * n; i++)
+        BOOST_CHECK_EQUAL(C[i], C_expected[i]);
+
+    mult.Invalidate();
+    mult.Multiply(m, n, k, A_upd.data(), B.data(), C.data());
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+        {
+            float sum = 0;
+            for (int l = 0; l < k; l++)
+                sum += B[l + j * k];
+            BOOST_CHECK_EQUAL(C[i + j * m], sum);
+        }
+}
+BOOST_FIXTURE_TEST_CASE(MultiplyInt8, RandomSeedFixture)
+{
+    // A[m,k]*B[k,n] = C[m,n], with rows of A of very different magnitude (per-row scales) and B of mixed sign (zero points)
+    int m = 6, n = 4, k = 64;
+    std::vector<float> A(m * k), B(k * n), C(m * n), C_expected(m * n, 0);
+    for (int i = 0; i < m; i++)
+        for (int l = 0; l < k; l++)
+            A[i + l * m] = (float)(((i + 3 * l) % 17) - 8) * powf(10.0f, (float)(i - 3));
+    for (size_t i = 0; i < B.size(); i++)
+        B[i] = (float)((i * 5) % 23) / 4 - 2;
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            for (int l = 0; l < k; l++)
+                C_expected[i + j * m] += A[i + l * m] * B[l + j * k];
+
+    Int8Multiplier<float> mult(true);
+    mult.PrepareA(m, k, A.data());
+    mult.Multiply(m, n, k, A.data(), B.data(), C.data());
+    for (int i = 0; i < m; i++)
+    {
+        // the error of each row is relative to the magnitude of that row
+        float tolerance = 0.02f * powf(10.0f, (float)(i - 3)) * k;
+        for (int j = 0; j < n; j++)
+            BOOST_CHECK_SMALL(C[i + j * m] - C_expected[i + j * m], tolerance);
+    }
+
+    // zero activations are quantized exactly
+    std::vector<float> B_zero(k * n, 0);
+    mult.Multiply(m, n, k, A.data(), B_zero.data(), C.data());
+    for (size_t i = 0; i < m * n; i++)
+        BOOST_CHECK_EQUAL(C[i], 0);
+}
+
+BOOST_AUTO_TEST_CASE(MultiplyInt8AtMaxInnerDimension)
+{
+    // The largest inner dimension with the largest quantized values: A quantizes to 127, and B to 255 with zero point 0
+    // in the first column, and to 0 with zero point 255 in the second, so both the dot products and their corrections by
+    // the zero points are 127 * 255 * k, just below the int32 limit.
+    int m = 1, n = 2, k = maxInt8InnerDimension;
+    std::vector<float> A(k, 1), B(k * n), C(m * n);
+    std::fill(B.begin(), B.begin() + k, 1.0f);
+    std::fill(B.begin() + k, B.end(), -1.0f);
+
+    Int8Multiplier<float> mult(true);
+    mult.PrepareA(m, k, A.data());
+    mult.Multiply(m, n, k, A.data(), B.data(), C.data());
+    BOOST_CHECK_CLOSE(C[0], (float)k, 1e-3);
+    BOOST_CHECK_CLOSE(C[1], -(float)k, 1e-3);
+
+    // one more and the product is rejected
+    k++;
+    A.resize(k, 1);
+    Int8Multiplier<float> tooLarge(true);
+    BOOST_CHECK_THROW(tooLarge.PrepareA(m, k, A.data()), std::invalid_argument);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -7,6 +7,7 @@
 #include "TensorView.h"
 #include "Sequences.h"
 #include "TensorTestsHelper.h"
+#include "CPUTensorKernels.h"
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -85,6 +86,33 @@ BOOST_AUTO_TEST_CASE(BiasGradient2)
     });
 }
 
+BOOST_AUTO_TEST_CASE(CPUVectorizedTensorKernels)
+{
+    Test::TensorTest<float> tensorTester;
+
+    // bias addition, bias gradient, and a max over the inner dimension, computed with the given instruction set extensions
+    auto compute = [&tensorTester](CPUVectorExtension maxExtension)
+    {
+        SetMaxCPUVectorExtension(maxExtension);
+        int randomSeed = 1;
+        let  input        = tensorTester.CreateTensor(TensorShape{ 517, 64 }, randomSeed++, CPUDEVICE);
+        let  bias         = tensorTester.CreateTensor(TensorShape{ 517 },     randomSeed++, CPUDEVICE);
+        auto sum          = tensorTester.CreateTensor(TensorShape{ 517, 64 }, randomSeed++, CPUDEVICE, true);
+        auto biasGradient = tensorTester.CreateTensor(TensorShape{ 517 },     randomSeed++, CPUDEVICE, true);
+        auto columnMax    = tensorTester.CreateTensor(TensorShape{ 1, 64 },   randomSeed++, CPUDEVICE, true);
+        sum.AssignSumOf(input, bias);
+        biasGradient.DoCopyOf(1, sum, 0.5f);
+        columnMax.DoUnaryOpOf(0, sum, 1, opCopy, opMax);
+        return std::vector<TensorView<float>>{ sum, biasGradient, columnMax };
+    };
+
+    // the vectorized kernels (if the CPU supports any) must agree with the generic loops
+    let generic = compute(CPUVectorExtension::None);
+    let vectorized = compute(CPUVectorExtension::AVX512);
+    for (size_t i = 0; i < generic.size(); i++)
+        BOOST_CHECK(generic[i].GetSOB().IsEqualTo(vectorized[i].GetSOB(), 1e-5f));
+}
+
 BOOST_AUTO_TEST_CASE(ColumnSliceMultAndAdd)
 {
     ColumnSliceMultAndAddTest<float>(2048, 2048, 256, 0);
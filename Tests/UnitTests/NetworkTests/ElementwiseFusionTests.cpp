@@ -0,0 +1,100 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "ComputationNetwork.h"
+#include "ComputationNetworkBuilder.h"
+#include "Globals.h"
+#include "TestHelpers.h"
+
+using namespace Microsoft::MSR::CNTK;
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+BOOST_AUTO_TEST_SUITE(ElementwiseFusionTests)
+
+// Evaluates
+//   p = Exp(x)
+//   d = Sigmoid(x + y) .* p + Tanh(Sigmoid(p))
+// on a few minibatches, with or without fusing the chains of elementwise nodes. With fusion, a + b + c + d is one chain
+// whose operands x and p have other consumers: p is last read by Sigmoid(p), so that without the fused chain keeping it
+// alive, the memory sharing would hand its buffer to Tanh(...) before the chain reads it.
+template <class ElemType>
+vector<vector<ElemType>> EvaluateChainNetwork(bool fuseElementwiseChains, const vector<size_t>& minibatchSizes, size_t dim)
+{
+    const bool fusedBefore = Globals::ShouldFuseElementwiseChains();
+    Globals::SetFuseElementwiseChains(fuseElementwiseChains);
+
+    auto net = make_shared<ComputationNetwork>(CPUDEVICE);
+    ComputationNetworkBuilder<ElemType> builder(*net);
+    auto x = builder.CreateInputNode(L"x", dim);
+    auto y = builder.CreateInputNode(L"y", dim);
+    auto p = builder.Exp(x, L"p");
+    auto a = builder.Plus(x, y, L"a");
+    auto b = builder.Sigmoid(a, L"b");
+    auto c = builder.ElementTimes(b, p, L"c");
+    auto q = builder.Sigmoid(p, L"q");
+    auto r = builder.Tanh(q, L"r");
+    auto d = builder.Plus(c, r, L"d");
+    net->AddToNodeGroup(L"output", d);
+    net->CompileNetwork();
+
+    ScopedNetworkOperationMode modeGuard(net, NetworkOperationMode::inferring);
+    net->AllocateAllMatrices({}, { d }, nullptr);
+    Globals::SetFuseElementwiseChains(fusedBefore);
+
+    // the nodes inside the chain get no buffer
+    if (fuseElementwiseChains)
+    {
+        BOOST_TEST(!a->IsValueSharable());
+        BOOST_TEST(!c->IsValueSharable());
+    }
+
+    vector<vector<ElemType>> results;
+    size_t seed = 1;
+    for (auto numCols : minibatchSizes)
+    {
+        vector<ElemType> xData(dim * numCols), yData(dim * numCols);
+        for (size_t i = 0; i < xData.size(); i++)
+        {
+            xData[i] = (ElemType)((seed * 37 + i * 11) % 19) / 10 - 1;
+            yData[i] = (ElemType)((seed * 13 + i * 7) % 23) / 10 - 1;
+        }
+        seed++;
+
+        x->GetMBLayout()->Init(1, numCols);
+        x->GetMBLayout()->AddSequence(0, 0, 0, numCols);
+        x->Value().SetValue(dim, numCols, CPUDEVICE, xData.data(), matrixFlagNormal);
+        y->Value().SetValue(dim, numCols, CPUDEVICE, yData.data(), matrixFlagNormal);
+        ComputationNetwork::BumpEvalTimeStamp({ x, y });
+        net->ForwardProp(ComputationNodeBasePtr(d));
+
+        const auto& value = d->Value();
+        BOOST_REQUIRE(value.GetNumRows() == dim && value.GetNumCols() == numCols);
+        vector<ElemType> result;
+        for (size_t j = 0; j < numCols; j++)
+            for (size_t i = 0; i < dim; i++)
+                result.push_back(value(i, j));
+        results.push_back(result);
+    }
+    return results;
+}
+
+BOOST_AUTO_TEST_CASE(FusedChainMatchesUnfusedEvaluation)
+{
+    const vector<size_t> minibatchSizes = { 5, 17, 3 };
+    const size_t dim = 6;
+    auto unfused = EvaluateChainNetwork<float>(false, minibatchSizes, dim);
+    auto fused = EvaluateChainNetwork<float>(true, minibatchSizes, dim);
+
+    BOOST_REQUIRE(fused.size() == unfused.size());
+    for (size_t i = 0; i < fused.size(); i++)
+    {
+        BOOST_REQUIRE(fused[i].size() == unfused[i].size());
+        BOOST_TEST(AreEqual(fused[i].data(), unfused[i].data(), fused[i].size(), 1e-5f));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
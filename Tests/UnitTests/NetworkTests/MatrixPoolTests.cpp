@@ -0,0 +1,83 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "ComputationNode.h"
+
+using namespace Microsoft::MSR::CNTK;
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+BOOST_AUTO_TEST_SUITE(MatrixPoolTests)
+
+// Each request and release is one step of the pool:
+//   step:  0       1       2       3       4       5       6       7
+//          alloc a alloc b rel. a  alloc c rel. b  rel. c  alloc d rel. d
+// a and b, and b and c, are live at the same time; a and c, and d and all others, are not.
+BOOST_AUTO_TEST_CASE(SizeAwarePlanReusesBuffersOfDisjointLifetimes)
+{
+    MatrixPool pool;
+    shared_ptr<Matrix<float>> a, b, c, d;
+    pool.RequestAllocate<float>(CPUDEVICE, &a, 10, true, false);
+    pool.RequestAllocate<float>(CPUDEVICE, &b, 20, true, false);
+    pool.RequestRelease<float>(&a);
+    pool.RequestAllocate<float>(CPUDEVICE, &c, 10, true, false);
+    pool.RequestRelease<float>(&b);
+    pool.RequestRelease<float>(&c);
+    pool.RequestAllocate<float>(CPUDEVICE, &d, 5, true, false);
+    pool.RequestRelease<float>(&d);
+
+    BOOST_REQUIRE(pool.OptimizedMemoryAllocationForMinibatchSize(8));
+
+    BOOST_TEST(a.get() != b.get());
+    BOOST_TEST(b.get() != c.get());
+    BOOST_TEST(a.get() == c.get());
+    BOOST_TEST((d.get() == a.get() || d.get() == b.get()));
+
+    // the plan holds a and b, and later b and c, which is also the most that is live at once
+    const auto& stats = pool.GetMemoryPlanStats();
+    BOOST_TEST(stats.numColumns == 8);
+    BOOST_TEST(stats.numRequests == 4);
+    BOOST_TEST(stats.numBuffers == 2);
+    BOOST_TEST(stats.plannedBytes == (10 + 20) * 8 * sizeof(float));
+    BOOST_TEST(stats.lowerBoundBytes == stats.plannedBytes);
+}
+
+BOOST_AUTO_TEST_CASE(SizeAwarePlanKeepsOverlappingLifetimesApart)
+{
+    // a is never released, so it overlaps with all others
+    MatrixPool pool;
+    shared_ptr<Matrix<float>> a, b, c;
+    pool.RequestAllocate<float>(CPUDEVICE, &a, 10, true, false);
+    pool.RequestAllocate<float>(CPUDEVICE, &b, 10, false, false);
+    pool.RequestRelease<float>(&b);
+    pool.RequestAllocate<float>(CPUDEVICE, &c, 10, true, false);
+    pool.RequestRelease<float>(&c);
+
+    BOOST_REQUIRE(pool.OptimizedMemoryAllocationForMinibatchSize(3));
+
+    BOOST_TEST(a.get() != b.get());
+    BOOST_TEST(a.get() != c.get());
+    BOOST_TEST(b.get() == c.get());
+    BOOST_TEST(pool.GetMemoryPlanStats().numColumns == 4);
+}
+
+BOOST_AUTO_TEST_CASE(SizeAwarePlanIsOnlyRedoneForDifferentMinibatchSizes)
+{
+    MatrixPool pool;
+    shared_ptr<Matrix<double>> a;
+    pool.RequestAllocate<double>(CPUDEVICE, &a, 10, true, false);
+    pool.RequestRelease<double>(&a);
+
+    BOOST_TEST(pool.OptimizedMemoryAllocationForMinibatchSize(64));
+    BOOST_TEST(!pool.OptimizedMemoryAllocationForMinibatchSize(64));
+    BOOST_TEST(!pool.OptimizedMemoryAllocationForMinibatchSize(17)); // still within a quarter of the planned 64
+    BOOST_TEST(pool.OptimizedMemoryAllocationForMinibatchSize(16));
+    BOOST_TEST(pool.OptimizedMemoryAllocationForMinibatchSize(100));
+    BOOST_TEST(pool.GetMemoryPlanStats().numColumns == 128);
+    BOOST_TEST(!pool.OptimizedMemoryAllocationForMinibatchSize(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
@@ -0,0 +1,48 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "ComputationNetwork.h"
+#include "ComputationNetworkBuilder.h"
+
+using namespace Microsoft::MSR::CNTK;
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+BOOST_AUTO_TEST_SUITE(ModelSnapshotTests)
+
+// The copy made by CloneModelToHost() keeps the values of the parameters at the time it was made, and saves them.
+BOOST_AUTO_TEST_CASE(SavedSnapshotKeepsParameterValues)
+{
+    const size_t m = 4, k = 3;
+    auto net = make_shared<ComputationNetwork>(CPUDEVICE);
+    ComputationNetworkBuilder<float> builder(*net);
+    auto w = builder.CreateLearnableParameter(L"W", m, k);
+    auto x = builder.CreateInputNode(L"x", k);
+    auto y = builder.Times(w, x, 1, L"y");
+    net->AddToNodeGroup(L"output", y);
+    net->CompileNetwork();
+
+    vector<float> wData(m * k);
+    for (size_t i = 0; i < wData.size(); i++)
+        wData[i] = (float)i - 5;
+    w->Value().SetValue(m, k, CPUDEVICE, wData.data(), matrixFlagNormal);
+
+    auto snapshot = net->CloneModelToHost();
+    w->Value().SetValue(1.0f); // training continues
+
+    const wstring modelName = L"ModelSnapshotTests.model";
+    snapshot->Save(modelName);
+    auto loaded = ComputationNetwork::CreateFromFile<float>(CPUDEVICE, modelName);
+    _wunlink(modelName.c_str());
+
+    const auto& value = dynamic_pointer_cast<ComputationNode<float>>(loaded->GetNodeFromName(L"W"))->Value();
+    BOOST_REQUIRE(value.GetNumRows() == m && value.GetNumCols() == k);
+    for (size_t j = 0; j < k; j++)
+        for (size_t i = 0; i < m; i++)
+            BOOST_TEST(value(i, j) == wData[i + j * m]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
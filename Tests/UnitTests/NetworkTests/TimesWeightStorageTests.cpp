@@ -0,0 +1,121 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "ComputationNetwork.h"
+#include "ComputationNetworkBuilder.h"
+#include "LinearAlgebraNodes.h"
+
+using namespace Microsoft::MSR::CNTK;
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+BOOST_AUTO_TEST_SUITE(TimesWeightStorageTests)
+
+// Evaluates y = W * x, and with sharedWeights also y2 = W * x, with bfloat16 weights whose float values are released
+// where possible. W and x hold small integers, which bfloat16 represents exactly, so the products are exact.
+static void TestReleasedFloatWeights(bool sharedWeights)
+{
+    const size_t m = 20, k = 37, numCols = 6;
+    auto net = make_shared<ComputationNetwork>(CPUDEVICE);
+    ComputationNetworkBuilder<float> builder(*net);
+    auto w = builder.CreateLearnableParameter(L"W", m, k);
+    auto x = builder.CreateInputNode(L"x", k);
+    auto y = builder.Times(w, x, 1, L"y");
+    net->AddToNodeGroup(L"output", y);
+    ComputationNodeBasePtr y2;
+    if (sharedWeights)
+    {
+        y2 = builder.Times(w, x, 1, L"y2");
+        net->AddToNodeGroup(L"output", y2);
+    }
+    net->CompileNetwork();
+
+    vector<float> wData(m * k), xData(k * numCols);
+    for (size_t i = 0; i < wData.size(); i++)
+        wData[i] = (float)((i * 7) % 9) - 4;
+    for (size_t i = 0; i < xData.size(); i++)
+        xData[i] = (float)((i * 5) % 7) - 3;
+    w->Value().SetValue(m, k, CPUDEVICE, wData.data(), matrixFlagNormal);
+
+    ComputationNetwork::SetTimesWeightStorage(net, nullptr, TimesWeightStorage::BFloat16, vector<wstring>(), /*releaseFloatWeights=*/true);
+    // the float weights are kept if another node reads them
+    BOOST_TEST(dynamic_pointer_cast<TimesNode<float>>(y)->FloatWeightsReleased() == !sharedWeights);
+    BOOST_TEST(w->Value().GetNumElements() == (sharedWeights ? m * k : 0));
+
+    ScopedNetworkOperationMode modeGuard(net, NetworkOperationMode::inferring);
+    vector<ComputationNodeBasePtr> outputs = { y };
+    if (sharedWeights)
+        outputs.push_back(y2);
+    net->AllocateAllMatrices({}, outputs, nullptr);
+
+    x->GetMBLayout()->Init(1, numCols);
+    x->GetMBLayout()->AddSequence(0, 0, 0, numCols);
+    x->Value().SetValue(k, numCols, CPUDEVICE, xData.data(), matrixFlagNormal);
+    ComputationNetwork::BumpEvalTimeStamp({ x });
+    net->ForwardProp(outputs);
+
+    for (const auto& output : outputs)
+    {
+        const auto& value = dynamic_pointer_cast<ComputationNode<float>>(output)->Value();
+        BOOST_REQUIRE(value.GetNumRows() == m && value.GetNumCols() == numCols);
+        for (size_t j = 0; j < numCols; j++)
+            for (size_t i = 0; i < m; i++)
+            {
+                float expected = 0;
+                for (size_t l = 0; l < k; l++)
+                    expected += wData[i + l * m] * xData[l + j * k];
+                BOOST_TEST(value(i, j) == expected);
+            }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ReleasedFloatWeights)
+{
+    TestReleasedFloatWeights(/*sharedWeights=*/false);
+}
+
+BOOST_AUTO_TEST_CASE(SharedWeightsAreNotReleased)
+{
+    TestReleasedFloatWeights(/*sharedWeights=*/true);
+}
+
+// An int8 product whose inner dimension exceeds maxInt8InnerDimension keeps its float weights and is computed in float.
+BOOST_AUTO_TEST_CASE(Int8FallsBackBeyondMaxInnerDimension)
+{
+    const size_t k = maxInt8InnerDimension + 1;
+    auto net = make_shared<ComputationNetwork>(CPUDEVICE);
+    ComputationNetworkBuilder<float> builder(*net);
+    auto w = builder.CreateLearnableParameter(L"W", 1, k);
+    auto x = builder.CreateInputNode(L"x", k);
+    auto y = builder.Times(w, x, 1, L"y");
+    net->AddToNodeGroup(L"output", y);
+    net->CompileNetwork();
+
+    vector<float> wData(k), xData(k, 1);
+    for (size_t i = 0; i < k; i++)
+        wData[i] = (float)(i % 3) - 1;
+    w->Value().SetValue(1, k, CPUDEVICE, wData.data(), matrixFlagNormal);
+
+    ComputationNetwork::SetTimesWeightStorage(net, nullptr, TimesWeightStorage::Int8, vector<wstring>(), /*releaseFloatWeights=*/true);
+    BOOST_TEST(!dynamic_pointer_cast<TimesNode<float>>(y)->FloatWeightsReleased());
+    BOOST_TEST(w->Value().GetNumElements() == k);
+
+    ScopedNetworkOperationMode modeGuard(net, NetworkOperationMode::inferring);
+    vector<ComputationNodeBasePtr> outputs = { y };
+    net->AllocateAllMatrices({}, outputs, nullptr);
+    x->GetMBLayout()->Init(1, 1);
+    x->GetMBLayout()->AddSequence(0, 0, 0, 1);
+    x->Value().SetValue(k, 1, CPUDEVICE, xData.data(), matrixFlagNormal);
+    ComputationNetwork::BumpEvalTimeStamp({ x });
+    net->ForwardProp(outputs);
+
+    float expected = 0;
+    for (size_t i = 0; i < k; i++)
+        expected += wData[i];
+    BOOST_TEST(dynamic_pointer_cast<ComputationNode<float>>(y)->Value()(0, 0) == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
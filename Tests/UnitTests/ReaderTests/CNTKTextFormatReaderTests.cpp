@@ -934,6 +934,16 @@ BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_100x100x3)
 
     test({});
     test({ L"defMBSize=true" });
+    test({ L"memoryMapping=true" });
+
+    // The first run writes the binary chunk cache, the second one reads all chunks from it.
+    test({ L"binaryCache=true" });
+    test({ L"binaryCache=true" });
+    for (const auto& entry : boost::filesystem::directory_iterator("."))
+    {
+        if (entry.path().extension() == ".cbf")
+            boost::filesystem::remove(entry.path());
+    }
 };
 
 // 200 sequences with N samples in an input, 
@@ -17,12 +17,15 @@
 #include "CudaMemoryProvider.h"
 #include "HeapMemoryProvider.h"
 #include "BufferedFileReader.h"
+#include "ChunkCache.h"
+#include "BinaryChunkCache.h"
 
 #pragma warning(push)
 // disable warning about possible mod 0 operation in uniform_int_distribution
 #pragma warning(disable:4724)
 #include <boost/random/uniform_int_distribution.hpp>
 #pragma warning(pop)
+#include <boost/filesystem.hpp>
 
 #include "SequentialDeserializer.h"
 
@@ -380,6 +383,151 @@ BOOST_AUTO_TEST_CASE(RandRollbackToSameEpochInBigRandomizationWindow)
 }
 
 
+BOOST_AUTO_TEST_CASE(BlockRandomizerPrefetchDepth)
+{
+    size_t chunkSizeInSamples = 1000;
+    size_t sweepNumberOfSamples = 50000;
+    uint32_t maxSequenceLength = 10;
+    size_t randomizationWindow = chunkSizeInSamples * 3;
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, maxSequenceLength);
+
+    auto baseline = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true, false);
+    std::vector<float> expected = Concat(std::vector<vector<float>>{
+        ReadFullSweep(baseline, 0, sweepNumberOfSamples),
+        ReadFullSweep(baseline, 1, sweepNumberOfSamples) });
+
+    auto test = [&](bool shouldPrefetch, size_t depth, size_t numThreads, size_t maxSamples)
+    {
+        ChunkPrefetchConfiguration prefetchConfig;
+        prefetchConfig.m_depth = depth;
+        prefetchConfig.m_numThreads = numThreads;
+        prefetchConfig.m_maxSamples = maxSamples;
+        auto randomizer = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, shouldPrefetch, false, 0, true, 0, prefetchConfig);
+
+        // Prefetching does not change the order of the data.
+        std::vector<float> actual = Concat(std::vector<vector<float>>{
+            ReadFullSweep(randomizer, 0, sweepNumberOfSamples),
+            ReadFullSweep(randomizer, 1, sweepNumberOfSamples) });
+        BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+
+        if (shouldPrefetch)
+            BOOST_CHECK(randomizer->NumPrefetchHits() > randomizer->NumPrefetchMisses());
+        else
+            BOOST_CHECK_EQUAL(randomizer->NumPrefetchHits(), 0);
+    };
+
+    test(true, 1, 1, SIZE_MAX);
+    test(true, 4, 2, SIZE_MAX);
+    test(true, 8, 3, 2 * chunkSizeInSamples); // at most two chunks because of the memory budget
+    test(true, 8, 1, 1);                      // the first chunk is prefetched regardless of the budget
+    test(false, 4, 2, SIZE_MAX);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkCacheLeastRecentlyUsedEviction)
+{
+    // Sequences of a single sample, so that each chunk has exactly 100 samples.
+    size_t chunkSizeInSamples = 100;
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, 10 * chunkSizeInSamples, 1);
+    size_t chunkSizeInBytes = chunkSizeInSamples * sizeof(float);
+
+    // Room for two chunks only.
+    ChunkCache cache(deserializer, 2 * chunkSizeInBytes);
+
+    auto chunk0 = cache.GetChunk(0);
+    cache.GetChunk(1);
+    BOOST_CHECK(cache.GetChunk(0) == chunk0);
+    BOOST_CHECK_EQUAL(cache.NumHits(), 1);
+    BOOST_CHECK_EQUAL(cache.NumMisses(), 2);
+    BOOST_CHECK_EQUAL(cache.SizeInBytes(), 2 * chunkSizeInBytes);
+
+    // Chunk 1 is the least recently used one.
+    cache.GetChunk(2);
+    BOOST_CHECK_EQUAL(cache.NumEvictions(), 1);
+    BOOST_CHECK(cache.GetChunk(0) == chunk0);
+    auto chunk1 = cache.GetChunk(1);
+    BOOST_CHECK(chunk1 != nullptr);
+    BOOST_CHECK_EQUAL(cache.NumHits(), 2);
+    BOOST_CHECK_EQUAL(cache.NumMisses(), 4);
+    BOOST_CHECK_EQUAL(cache.NumEvictions(), 2);
+    BOOST_CHECK_EQUAL(cache.SizeInBytes(), 2 * chunkSizeInBytes);
+
+    // The evicted chunk is reloaded with the same data.
+    vector<SequenceDataPtr> data;
+    chunk1->GetSequence(0, data);
+    BOOST_CHECK_EQUAL(*reinterpret_cast<const float*>(data[0]->GetDataBuffer()), (float)chunkSizeInSamples);
+
+    // A budget smaller than a chunk still keeps the most recently used chunk.
+    ChunkCache small(deserializer, 1);
+    auto chunk = small.GetChunk(3);
+    BOOST_CHECK(small.GetChunk(3) == chunk);
+    small.GetChunk(4);
+    BOOST_CHECK_EQUAL(small.NumEvictions(), 1);
+
+    // The unbounded cache never evicts.
+    ChunkCache unbounded(deserializer);
+    for (ChunkIdType i = 0; i < 10; ++i)
+        unbounded.GetChunk(i);
+    for (ChunkIdType i = 0; i < 10; ++i)
+        unbounded.GetChunk(i);
+    BOOST_CHECK_EQUAL(unbounded.NumHits(), 10);
+    BOOST_CHECK_EQUAL(unbounded.NumEvictions(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(BinaryChunkCacheWithTwoWorkers)
+{
+    wstring inputFilename = L"binary_chunk_cache_input.txt";
+    {
+        std::ofstream input(boost::filesystem::path(inputFilename).string());
+        input << "input";
+    }
+
+    auto deserializer = make_shared<SequentialDeserializer>(0, 10, 100, 3);
+    auto numberOfChunks = (ChunkIdType)deserializer->ChunkInfos().size();
+    BOOST_REQUIRE(numberOfChunks > 2);
+
+    // Compares the chunk served by the cache with the one of the deserializer.
+    auto check = [&](BinaryChunkCache& cache, ChunkIdType chunkId)
+    {
+        auto chunk = cache.GetChunk(chunkId);
+        auto expectedChunk = deserializer->GetChunk(chunkId);
+        vector<SequenceInfo> sequences;
+        deserializer->SequenceInfosForChunk(chunkId, sequences);
+        for (const auto& sequence : sequences)
+        {
+            vector<SequenceDataPtr> data, expected;
+            chunk->GetSequence(sequence.m_indexInChunk, data);
+            expectedChunk->GetSequence(sequence.m_indexInChunk, expected);
+            BOOST_REQUIRE_EQUAL(data.size(), 1);
+            BOOST_REQUIRE_EQUAL(data[0]->m_numberOfSamples, expected[0]->m_numberOfSamples);
+            auto values = reinterpret_cast<const float*>(data[0]->GetDataBuffer());
+            auto expectedValues = reinterpret_cast<const float*>(expected[0]->GetDataBuffer());
+            BOOST_CHECK(equal(values, values + data[0]->m_numberOfSamples, expectedValues));
+        }
+    };
+
+    // Each worker only requests its share of the chunks, so the main worker writes all of them up front,
+    // and the other one switches to the cache once it is written.
+    BinaryChunkCache worker1(deserializer, inputFilename, true, 2, 1);
+    BOOST_CHECK(!worker1.IsComplete());
+    check(worker1, 1);
+    BOOST_CHECK(!worker1.IsComplete());
+
+    BinaryChunkCache worker0(deserializer, inputFilename, true, 2, 0);
+    BOOST_CHECK(worker0.IsComplete());
+    for (ChunkIdType i = 0; i < numberOfChunks; i += 2)
+        check(worker0, i);
+    for (ChunkIdType i = 1; i < numberOfChunks; i += 2)
+        check(worker1, i);
+    BOOST_CHECK(worker1.IsComplete());
+
+    // A later run of either worker uses the cache right away.
+    BinaryChunkCache rerun(deserializer, inputFilename, true, 2, 1);
+    BOOST_CHECK(rerun.IsComplete());
+
+    boost::filesystem::remove(worker0.Filename());
+    boost::filesystem::remove(inputFilename);
+}
+
 BOOST_AUTO_TEST_CASE(BlockRandomizerInstantiate)
 {
     BlockRandomizerInstantiateTest(false);
@@ -1759,6 +1907,28 @@ BOOST_AUTO_TEST_CASE(SequencePackerSmallChunksWithSequences)
     }
 }
 
+BOOST_AUTO_TEST_CASE(SequencePackerBucketing)
+{
+    size_t chunkSizeInSamples = 1000;
+    size_t sweepNumberOfSamples = 20000;
+    uint32_t maxSequenceLength = 100;
+    size_t randomizationWindow = chunkSizeInSamples * 5;
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, maxSequenceLength);
+
+    auto blockRandomizer = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true);
+    auto packer = std::make_shared<SequencePacker>(blockRandomizer, deserializer->StreamInfos(), 1, true, nullptr, 10);
+
+    // Regrouping by length still delivers every sequence exactly once.
+    CheckPackerOnSweep(packer, blockRandomizer, deserializer, 1, 2000, false, true);
+    CheckPackerOnSweep(packer, blockRandomizer, deserializer, 3, 2000, false, true);
+
+    auto randomizer = make_shared<BlockRandomizer>(0, randomizationWindow, deserializer, true);
+    auto withoutBucketing = std::make_shared<SequencePacker>(randomizer, deserializer->StreamInfos(), 1, true);
+    CheckPackerOnSweep(withoutBucketing, randomizer, deserializer, 1, 2000, false, true);
+
+    BOOST_CHECK_LT(withoutBucketing->PaddingEfficiency(), packer->PaddingEfficiency());
+}
+
 BOOST_AUTO_TEST_CASE(TestTruncatedBpttPacker)
 {
     size_t chunkSizeInSamples = 100;
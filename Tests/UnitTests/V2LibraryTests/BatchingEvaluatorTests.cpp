@@ -0,0 +1,125 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include <exception>
+#include <thread>
+#include "Common.h"
+
+using namespace CNTK;
+
+namespace CNTK { namespace Test {
+
+// Concurrent requests through a BatchingEvaluator give the same outputs as evaluating each request on its own.
+// PastValue() makes the outputs depend on the sequences staying intact when requests are coalesced.
+template <typename ElementType>
+void TestBatchingEvaluator(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 16;
+    const size_t numThreads = 8;
+    const size_t numRequestsPerThread = 25;
+    const size_t maxNumSequencesPerRequest = 2;
+    const size_t maxSequenceLength = 5;
+    const size_t maxBatchSize = 8;
+    const size_t maxLatencyInMicroseconds = 2000;
+
+    auto input = InputVariable({ inputDim }, AsDataType<ElementType>(), L"features");
+    auto W = Parameter({ inputDim, inputDim }, AsDataType<ElementType>(), GlorotUniformInitializer(), device);
+    auto model = Plus(Times(W, input), PastValue(input), L"output");
+    Variable output = model->Output();
+
+    const size_t numRequests = numThreads * numRequestsPerThread;
+    std::vector<ValuePtr> requests(numRequests);
+    std::vector<std::vector<std::vector<ElementType>>> expected(numRequests);
+    size_t numSequences = 0;
+    for (size_t i = 0; i < numRequests; i++)
+    {
+        auto sequenceLengths = GenerateSequenceLengths(1 + i % maxNumSequencesPerRequest, maxSequenceLength);
+        numSequences += sequenceLengths.size();
+        requests[i] = GenerateSequences<ElementType>(sequenceLengths, { inputDim }, device, false);
+
+        std::unordered_map<Variable, ValuePtr> outputs = { { output, nullptr } };
+        model->Evaluate({ { input, requests[i] } }, outputs, device);
+        outputs[output]->CopyVariableValueTo(output, expected[i]);
+    }
+
+    auto evaluator = CreateBatchingEvaluator(model, maxBatchSize, maxLatencyInMicroseconds, device);
+
+    std::vector<std::vector<std::vector<ElementType>>> actual(numRequests);
+    std::vector<std::exception_ptr> errors(numThreads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; t++)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            try
+            {
+                for (size_t i = t; i < numRequests; i += numThreads)
+                {
+                    std::unordered_map<Variable, ValuePtr> outputs = { { output, nullptr } };
+                    evaluator->Evaluate({ { input, requests[i] } }, outputs);
+                    outputs[output]->CopyVariableValueTo(output, actual[i]);
+                }
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        }));
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (const auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    for (size_t i = 0; i < numRequests; i++)
+    {
+        BOOST_TEST(actual[i].size() == expected[i].size());
+        for (size_t s = 0; s < expected[i].size(); s++)
+            FloatingPointVectorCompare(actual[i][s], expected[i][s], "BatchingEvaluator output does not match the output of Function::Evaluate");
+    }
+
+    auto statistics = evaluator->Statistics();
+    BOOST_TEST(statistics.numRequests == numRequests);
+    BOOST_TEST(statistics.numSequences == numSequences);
+    BOOST_TEST(statistics.numBatches <= numRequests);
+    BOOST_TEST(statistics.AverageBatchSize() <= maxBatchSize);
+    BOOST_TEST(statistics.p50LatencyInMs > 0);
+    BOOST_TEST(statistics.p50LatencyInMs <= statistics.p99LatencyInMs);
+
+    evaluator->ResetStatistics();
+    BOOST_TEST(evaluator->Statistics().numRequests == 0);
+
+    // malformed requests fail in the calling thread
+    std::unordered_map<Variable, ValuePtr> outputs = { { output, nullptr } };
+    BOOST_CHECK_THROW(evaluator->Evaluate({}, outputs), std::exception);
+    std::unordered_map<Variable, ValuePtr> wrongOutputs = { { input, nullptr } };
+    BOOST_CHECK_THROW(evaluator->Evaluate({ { input, requests[0] } }, wrongOutputs), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE(BatchingEvaluatorSuite)
+
+BOOST_AUTO_TEST_CASE(BatchingEvaluatorInCPU)
+{
+    if (ShouldRunOnCpu())
+    {
+        TestBatchingEvaluator<float>(DeviceDescriptor::CPUDevice());
+        TestBatchingEvaluator<double>(DeviceDescriptor::CPUDevice());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BatchingEvaluatorInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestBatchingEvaluator<float>(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}
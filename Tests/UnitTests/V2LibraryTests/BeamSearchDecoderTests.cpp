@@ -0,0 +1,226 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "CNTKLibrary.h"
+#include <cmath>
+#include "Common.h"
+
+using namespace CNTK;
+
+namespace CNTK { namespace Test {
+
+// A step of a small recurrent decoder: the next state is tanh(W token + U state + context), and the scores are the log-softmax of O state.
+template <typename ElementType>
+struct DecoderStep
+{
+    static const size_t vocabularySize = 8;
+    static const size_t stateDim = 6;
+    static const size_t startToken = 0;
+    static const size_t endToken = 1;
+
+    DecoderStep(bool sparseTokens, const DeviceDescriptor& device)
+        : m_sparseTokens(sparseTokens), m_device(device)
+    {
+        token = InputVariable({ vocabularySize }, sparseTokens, AsDataType<ElementType>(), L"token", { Axis::DefaultBatchAxis() });
+        state = InputVariable({ stateDim }, AsDataType<ElementType>(), L"state", { Axis::DefaultBatchAxis() });
+        context = InputVariable({ stateDim }, AsDataType<ElementType>(), L"context", { Axis::DefaultBatchAxis() });
+
+        auto W = Parameter({ stateDim, vocabularySize }, AsDataType<ElementType>(), GlorotUniformInitializer(2), device);
+        auto U = Parameter({ stateDim, stateDim }, AsDataType<ElementType>(), GlorotUniformInitializer(), device);
+        auto O = Parameter({ vocabularySize, stateDim }, AsDataType<ElementType>(), GlorotUniformInitializer(4), device);
+        auto newState = Tanh(Plus(Plus(Times(W, token), Times(U, state)), context), L"newState");
+        auto logits = Times(O, newState);
+        auto logProbabilities = Minus(logits, ReduceLogSum(logits, Axis(0)), L"scores");
+        function = Combine({ logProbabilities, newState });
+        scores = logProbabilities->Output();
+        stateOutput = newState->Output();
+    }
+
+    // Evaluates the step Function for a single hypothesis.
+    std::vector<ElementType> Evaluate(const std::vector<ElementType>& contextSample, std::vector<ElementType>& stateSample, size_t previousToken) const
+    {
+        ValuePtr tokenValue;
+        if (m_sparseTokens)
+            tokenValue = Value::CreateBatch<ElementType>(vocabularySize, std::vector<size_t>{ previousToken }, m_device);
+        else
+        {
+            std::vector<ElementType> oneHot(vocabularySize, 0);
+            oneHot[previousToken] = 1;
+            tokenValue = Value::CreateBatch({ vocabularySize }, oneHot, m_device);
+        }
+
+        std::unordered_map<Variable, ValuePtr> outputs = { { scores, nullptr }, { stateOutput, nullptr } };
+        function->Evaluate({ { token, tokenValue },
+                             { state, Value::CreateBatch({ stateDim }, stateSample, m_device) },
+                             { context, Value::CreateBatch({ stateDim }, contextSample, m_device) } },
+                           outputs, m_device);
+
+        std::vector<std::vector<ElementType>> logProbabilities, newState;
+        outputs[scores]->CopyVariableValueTo(scores, logProbabilities);
+        outputs[stateOutput]->CopyVariableValueTo(stateOutput, newState);
+        stateSample = newState[0];
+        return logProbabilities[0];
+    }
+
+    BeamSearchDecoderPtr CreateDecoder(size_t beamWidth, size_t maxLength, double lengthNormalizationExponent) const
+    {
+        return CreateBeamSearchDecoder(function, token, scores, { { state, stateOutput } }, startToken, endToken, beamWidth, maxLength,
+                                       lengthNormalizationExponent, std::numeric_limits<double>::infinity(), m_device);
+    }
+
+    Variable token, state, context, scores, stateOutput;
+    FunctionPtr function;
+
+private:
+    bool m_sparseTokens;
+    DeviceDescriptor m_device;
+};
+
+// With a beam of 1, the decoder picks the most probable token in each step.
+template <typename ElementType>
+void TestGreedyDecoding(bool sparseTokens, const DeviceDescriptor& device)
+{
+    typedef DecoderStep<ElementType> Step;
+    const size_t numSources = 3;
+    const size_t maxLength = 10;
+
+    Step step(sparseTokens, device);
+    auto contexts = GenerateSequences<ElementType>(std::vector<size_t>(numSources, 1), { Step::stateDim });
+    std::vector<ElementType> contextData;
+    for (const auto& context : contexts)
+        contextData.insert(contextData.end(), context.begin(), context.end());
+
+    auto decoder = step.CreateDecoder(/*beamWidth =*/ 1, maxLength, /*lengthNormalizationExponent =*/ 0);
+    auto results = decoder->Decode({ { step.context, Value::CreateBatch({ Step::stateDim }, contextData, device) } });
+    BOOST_TEST(results.size() == numSources);
+
+    for (size_t source = 0; source < numSources; source++)
+    {
+        std::vector<size_t> expectedTokens;
+        std::vector<ElementType> state(Step::stateDim, 0);
+        double expectedScore = 0;
+        size_t token = Step::startToken;
+        while (expectedTokens.size() < maxLength && token != Step::endToken)
+        {
+            auto logProbabilities = step.Evaluate(contexts[source], state, token);
+            token = std::max_element(logProbabilities.begin(), logProbabilities.end()) - logProbabilities.begin();
+            expectedScore += logProbabilities[token];
+            expectedTokens.push_back(token);
+        }
+
+        BOOST_TEST(results[source].size() == 1);
+        BOOST_TEST(results[source][0].tokens == expectedTokens);
+        FloatingPointCompare(results[source][0].score, expectedScore, "Greedy decoding score does not match");
+        BOOST_TEST(results[source][0].normalizedScore == results[source][0].score);
+    }
+}
+
+// The hypotheses of a wider beam have the scores of their tokens, which depend on the states having followed their hypotheses.
+template <typename ElementType>
+void TestBeamSearchDecoding(bool sparseTokens, const DeviceDescriptor& device)
+{
+    typedef DecoderStep<ElementType> Step;
+    const size_t numSources = 4;
+    const size_t beamWidth = 3;
+    const size_t maxLength = 6;
+    const double lengthNormalizationExponent = 1;
+
+    Step step(sparseTokens, device);
+    auto contexts = GenerateSequences<ElementType>(std::vector<size_t>(numSources, 1), { Step::stateDim });
+    auto initialStates = GenerateSequences<ElementType>(std::vector<size_t>(numSources, 1), { Step::stateDim });
+    std::vector<ElementType> contextData, initialStateData;
+    for (size_t source = 0; source < numSources; source++)
+    {
+        contextData.insert(contextData.end(), contexts[source].begin(), contexts[source].end());
+        initialStateData.insert(initialStateData.end(), initialStates[source].begin(), initialStates[source].end());
+    }
+
+    auto decoder = step.CreateDecoder(beamWidth, maxLength, lengthNormalizationExponent);
+    std::unordered_map<Variable, ValuePtr> arguments = { { step.context, Value::CreateBatch({ Step::stateDim }, contextData, device) },
+                                                         { step.state, Value::CreateBatch({ Step::stateDim }, initialStateData, device) } };
+    auto results = decoder->Decode(arguments);
+    BOOST_TEST(results.size() == numSources);
+
+    for (size_t source = 0; source < numSources; source++)
+    {
+        const auto& hypotheses = results[source];
+        BOOST_TEST(!hypotheses.empty());
+        BOOST_TEST(hypotheses.size() <= beamWidth);
+        for (size_t i = 0; i < hypotheses.size(); i++)
+        {
+            const auto& tokens = hypotheses[i].tokens;
+            BOOST_TEST(!tokens.empty());
+            BOOST_TEST(tokens.size() <= maxLength);
+            BOOST_TEST((tokens.back() == Step::endToken || tokens.size() == maxLength));
+            BOOST_TEST((std::find(tokens.begin(), tokens.end() - 1, Step::endToken) == tokens.end() - 1));
+            if (i > 0)
+                BOOST_TEST(hypotheses[i - 1].normalizedScore >= hypotheses[i].normalizedScore);
+
+            std::vector<ElementType> state = initialStates[source];
+            double expectedScore = 0;
+            size_t previousToken = Step::startToken;
+            for (auto token : tokens)
+            {
+                expectedScore += step.Evaluate(contexts[source], state, previousToken)[token];
+                previousToken = token;
+            }
+            FloatingPointCompare(hypotheses[i].score, expectedScore, "Beam search hypothesis score does not match its tokens");
+            FloatingPointCompare(hypotheses[i].normalizedScore, expectedScore / std::pow((double)tokens.size(), lengthNormalizationExponent),
+                                 "Beam search hypothesis normalized score does not match its score");
+        }
+    }
+
+    // the Values of the steps are reallocated for a different number of sources
+    auto singleSource = decoder->Decode({ { step.context, Value::CreateBatch({ Step::stateDim }, contexts[1], device) },
+                                          { step.state, Value::CreateBatch({ Step::stateDim }, initialStates[1], device) } });
+    BOOST_TEST(singleSource.size() == 1);
+    BOOST_TEST(singleSource[0].size() == results[1].size());
+    for (size_t i = 0; i < singleSource[0].size(); i++)
+        BOOST_TEST(singleSource[0][i].tokens == results[1][i].tokens);
+
+    // malformed arguments
+    BOOST_CHECK_THROW(decoder->Decode({}), std::exception);
+    BOOST_CHECK_THROW(decoder->Decode({ { step.token, Value::CreateBatch({ Step::stateDim }, contextData, device) } }), std::exception);
+    BOOST_CHECK_THROW(CreateBeamSearchDecoder(step.function, step.token, step.stateOutput, { { step.state, step.stateOutput } }, Step::startToken, Step::endToken, beamWidth, maxLength), std::exception);
+    BOOST_CHECK_THROW(CreateBeamSearchDecoder(step.function, step.token, step.scores, { { step.state, step.stateOutput } }, Step::startToken, Step::vocabularySize, beamWidth, maxLength), std::exception);
+    BOOST_CHECK_THROW(CreateBeamSearchDecoder(step.function, step.token, step.scores, { { step.context, step.scores } }, Step::startToken, Step::endToken, beamWidth, maxLength), std::exception);
+}
+
+// Token indices pass through the compute device as float values, which represent them exactly only up to 2^24.
+void TestVocabularyBeyondExactFloatIndices()
+{
+    const size_t vocabularySize = ((size_t)1 << 24) + 1;
+    auto token = InputVariable({ vocabularySize }, true, DataType::Float, L"token", { Axis::DefaultBatchAxis() });
+    auto scores = Negate(token, L"scores");
+    BOOST_CHECK_THROW(CreateBeamSearchDecoder(scores, token, scores->Output(), {}, 0, 1, 1, 1), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE(BeamSearchDecoderSuite)
+
+BOOST_AUTO_TEST_CASE(BeamSearchDecoderInCPU)
+{
+    if (ShouldRunOnCpu())
+    {
+        TestGreedyDecoding<float>(false, DeviceDescriptor::CPUDevice());
+        TestGreedyDecoding<double>(true, DeviceDescriptor::CPUDevice());
+        TestBeamSearchDecoding<float>(true, DeviceDescriptor::CPUDevice());
+        TestBeamSearchDecoding<double>(false, DeviceDescriptor::CPUDevice());
+        TestVocabularyBeyondExactFloatIndices();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BeamSearchDecoderInGPU)
+{
+    if (ShouldRunOnGpu())
+    {
+        TestGreedyDecoding<float>(true, DeviceDescriptor::GPUDevice(0));
+        TestBeamSearchDecoding<float>(false, DeviceDescriptor::GPUDevice(0));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}
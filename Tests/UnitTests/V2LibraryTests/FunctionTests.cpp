@@ -1096,6 +1096,40 @@ void SetRandomSeed(const DeviceDescriptor& device)
     FloatingPointVectorCompare(result2, result4, "SetRandomSeed: output does match the expected after resetting the dropout seed.");
 }
 
+// W holds small integers, which bfloat16 represents exactly, so the product with the bfloat16 Constant matches the float one.
+void TestTimesWithBFloat16Constant(const DeviceDescriptor& device)
+{
+    const size_t outputDim = 5, inputDim = 7, numSamples = 3;
+    std::vector<float> weightData(outputDim * inputDim), inputData(inputDim * numSamples);
+    for (size_t i = 0; i < weightData.size(); ++i)
+        weightData[i] = (float)((i * 7) % 9) - 4;
+    for (size_t i = 0; i < inputData.size(); ++i)
+        inputData[i] = (float)((i * 5) % 7) - 3;
+
+    auto floatWeights = MakeSharedObject<NDArrayView>(NDShape({ outputDim, inputDim }), weightData.data(), weightData.size(), device, true);
+    auto bfloat16Weights = MakeSharedObject<NDArrayView>(DataType::BFloat16, NDShape({ outputDim, inputDim }), device);
+    bfloat16Weights->CopyFrom(*floatWeights);
+
+    auto input = InputVariable(NDShape({ inputDim }), DataType::Float);
+    auto times = Times(Constant(bfloat16Weights), input);
+    BOOST_TEST((times->Output().GetDataType() == DataType::Float), "Times with a bfloat16 Constant must compute in float.");
+
+    auto inputValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(NDShape({ inputDim, numSamples }), inputData.data(), inputData.size(), device, true));
+    std::vector<float> outputData(outputDim * numSamples);
+    ValuePtr outputValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(NDShape({ outputDim, numSamples }), outputData, false));
+    std::unordered_map<Variable, ValuePtr> outputs = { { times->Output(), outputValue } };
+    times->Forward({ { input, inputValue } }, outputs, device);
+
+    for (size_t j = 0; j < numSamples; ++j)
+        for (size_t i = 0; i < outputDim; ++i)
+        {
+            float expected = 0;
+            for (size_t l = 0; l < inputDim; ++l)
+                expected += weightData[i + l * outputDim] * inputData[l + j * inputDim];
+            BOOST_TEST(outputData[i + j * outputDim] == expected, "Times with a bfloat16 Constant does not match the float product.");
+        }
+}
+
 BOOST_AUTO_TEST_SUITE(FunctionSuite)
 
 BOOST_AUTO_TEST_CASE(FindNameInCPU)
@@ -1204,6 +1238,12 @@ BOOST_AUTO_TEST_CASE(TimesIndirectSparseGradType)
 }
 
 
+BOOST_AUTO_TEST_CASE(TimesWithBFloat16ConstantInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestTimesWithBFloat16Constant(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_CASE(TestSettingDropoutRate)
 {
     if (ShouldRunOnCpu())
@@ -139,6 +139,97 @@ void TestUniversalLearner(size_t numParameters, size_t numMinibatches, const Dev
 
 }
 
+typedef std::function<LearnerPtr(const vector<Parameter>&, const AdditionalLearningOptions&)> LearnerFactory;
+
+// A learner with multiTensorUpdate updates the parameters as one without it does.
+template <typename ElementType>
+void TestMultiTensorUpdate(const LearnerFactory& createLearner, const DeviceDescriptor& device)
+{
+    // many small parameters and one that spans several chunks of the sweep
+    vector<NDShape> shapes = { { 150, 120 }, { 1 }, { 3, 2 } };
+    for (size_t i = 0; i < 20; i++)
+        shapes.push_back(CreateShape(rng() % maxNumAxes + 1, maxDimSize));
+
+    for (bool truncation : { true, false })
+    {
+        AdditionalLearningOptions options;
+        options.l2RegularizationWeight = 0.01;
+        options.gradientClippingThresholdPerSample = 0.05;
+        options.gradientClippingWithTruncation = truncation;
+
+        vector<Parameter> parameters, sweptParameters;
+        for (size_t i = 0; i < shapes.size(); i++)
+        {
+            auto value = NDArrayView::RandomUniform<ElementType>(shapes[i], -1.0, 1.0, i, device);
+            parameters.push_back(Parameter(value->DeepClone(), L"parameter_" + to_wstring(i)));
+            sweptParameters.push_back(Parameter(value->DeepClone(), L"parameter_" + to_wstring(i)));
+        }
+
+        auto learner = createLearner(parameters, options);
+        options.multiTensorUpdate = true;
+        auto sweptLearner = createLearner(sweptParameters, options);
+
+        auto seed = (unsigned long)rng();
+        auto update = [&](size_t minibatch)
+        {
+            unordered_map<Parameter, NDArrayViewPtr> gradientValues, sweptGradientValues;
+            for (size_t i = 0; i < shapes.size(); i++)
+            {
+                // the learners overwrite the gradients
+                auto gradientValue = NDArrayView::RandomUniform<ElementType>(shapes[i], -1.0, 1.0, seed + minibatch * shapes.size() + i, device);
+                gradientValues[parameters[i]] = gradientValue->DeepClone();
+                sweptGradientValues[sweptParameters[i]] = gradientValue->DeepClone();
+            }
+
+            learner->Update(gradientValues, 4);
+            sweptLearner->Update(sweptGradientValues, 4);
+        };
+        auto checkParameters = [&](const char* when)
+        {
+            for (size_t i = 0; i < shapes.size(); i++)
+            {
+                if (!Internal::AreEqual(*parameters[i].Value(), *sweptParameters[i].Value(), relativeTolerance, absoluteTolerance))
+                    ReportFailure("Parameter %d updated with multiTensorUpdate does not match the one updated without it %s.", (int)i, when);
+            }
+        };
+        auto checkSmoothedGradients = [&](const Dictionary& expected, const Dictionary& actual, const char* what)
+        {
+            const auto& expectedValues = expected[L"smoothed_gradients"].Value<vector<DictionaryValue>>();
+            const auto& actualValues = actual[L"smoothed_gradients"].Value<vector<DictionaryValue>>();
+            if (expectedValues.size() != shapes.size() || actualValues.size() != shapes.size())
+                ReportFailure("The checkpoint %s has %d smoothed gradients instead of %d.", what, (int)actualValues.size(), (int)shapes.size());
+            for (size_t i = 0; i < shapes.size(); i++)
+            {
+                if (!Internal::AreEqual(expectedValues[i].Value<NDArrayView>(), actualValues[i].Value<NDArrayView>(), relativeTolerance, absoluteTolerance))
+                    ReportFailure("Smoothed gradient %d of the checkpoint %s does not match.", (int)i, what);
+            }
+        };
+
+        for (size_t minibatch = 0; minibatch < 4; minibatch++)
+            update(minibatch);
+        checkParameters("");
+
+        // the packed smoothed gradients are checkpointed like the others
+        auto checkpoint = learner->CreateCheckpoint();
+        auto sweptCheckpoint = sweptLearner->CreateCheckpoint();
+        checkSmoothedGradients(checkpoint, sweptCheckpoint, "with multiTensorUpdate");
+
+        // and restored like the others: after a few more updates, each learner is restored from the checkpoint of the other one
+        for (size_t minibatch = 4; minibatch < 6; minibatch++)
+            update(minibatch);
+        for (size_t i = 0; i < shapes.size(); i++)
+            sweptParameters[i].SetValue(parameters[i].Value()->DeepClone());
+        learner->RestoreFromCheckpoint(sweptCheckpoint);
+        sweptLearner->RestoreFromCheckpoint(checkpoint);
+        checkSmoothedGradients(checkpoint, learner->CreateCheckpoint(), "restored without multiTensorUpdate");
+        checkSmoothedGradients(checkpoint, sweptLearner->CreateCheckpoint(), "restored with multiTensorUpdate");
+
+        // the restored state is the one that the updates continue from
+        update(6);
+        checkParameters("after restoring the checkpoints");
+    }
+}
+
 void TestTrainingParametersSchedule()
 {
     LearningRatePerSampleSchedule schedule1 = 0.5;
@@ -462,6 +553,59 @@ BOOST_AUTO_TEST_CASE(CreateAndUpdateAdamaxLearner)
     }
 }
 
+BOOST_AUTO_TEST_CASE(MultiTensorUpdateInCPU)
+{
+    if (!ShouldRunOnCpu())
+        return;
+
+    auto device = DeviceDescriptor::CPUDevice();
+    for (auto gain : unitGain)
+    {
+        TestMultiTensorUpdate<double>([gain](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+        {
+            return MomentumSGDLearner(parameters, LearningRatePerSampleSchedule(0.1), MomentumAsTimeConstantSchedule(100), gain, options);
+        }, device);
+
+        TestMultiTensorUpdate<double>([gain](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+        {
+            return NesterovLearner(parameters, LearningRatePerSampleSchedule(0.1), MomentumAsTimeConstantSchedule(100), gain, options);
+        }, device);
+
+        TestMultiTensorUpdate<double>([gain](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+        {
+            return FSAdaGradLearner(parameters, LearningRatePerSampleSchedule(0.1), MomentumAsTimeConstantSchedule(100), gain, MomentumPerSampleSchedule(0.9999), options);
+        }, device);
+
+        TestMultiTensorUpdate<double>([gain](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+        {
+            return AdamLearner(parameters, LearningRatePerSampleSchedule(0.1), MomentumAsTimeConstantSchedule(100), gain, MomentumPerSampleSchedule(0.99), 1e-8, false, options);
+        }, device);
+    }
+
+    for (auto needAveMultiplier : { true, false })
+    {
+        TestMultiTensorUpdate<double>([needAveMultiplier](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+        {
+            return AdaGradLearner(parameters, LearningRatePerSampleSchedule(0.1), needAveMultiplier, options);
+        }, device);
+
+        TestMultiTensorUpdate<double>([needAveMultiplier](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+        {
+            return RMSPropLearner(parameters, LearningRatePerSampleSchedule(0.1), 0.95, 1.2, 0.7, 10.0, 0.001, needAveMultiplier, options);
+        }, device);
+    }
+
+    TestMultiTensorUpdate<float>([](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+    {
+        return SGDLearner(parameters, LearningRatePerSampleSchedule(0.1), options);
+    }, device);
+
+    TestMultiTensorUpdate<float>([](const vector<Parameter>& parameters, const AdditionalLearningOptions& options)
+    {
+        return AdamLearner(parameters, LearningRatePerSampleSchedule(0.1), MomentumAsTimeConstantSchedule(100), true, MomentumPerSampleSchedule(0.99), 1e-8, true, options);
+    }, device);
+}
+
 BOOST_AUTO_TEST_CASE(TestResettingLearningRate)
 {
     NDShape shape = { 1 };
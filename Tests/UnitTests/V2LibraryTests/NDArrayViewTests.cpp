@@ -308,6 +308,50 @@ void TestDataBuffer(size_t numAxes, const DeviceDescriptor& device)
     }
 }
 
+// The values are small multiples of 1/4, which bfloat16 represents exactly, so the round trips through it are exact.
+void TestBFloat16NDArrayView(const DeviceDescriptor& device)
+{
+    NDShape viewShape({ 3, 4 });
+    std::vector<float> data(viewShape.TotalSize());
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = ((float)(i * 5 % 11) - 5) / 4;
+
+    NDArrayView floatView(viewShape, data.data(), data.size(), device);
+    auto bfloat16View = MakeSharedObject<NDArrayView>(DataType::BFloat16, viewShape, device);
+    bfloat16View->CopyFrom(floatView);
+    BOOST_TEST((bfloat16View->GetDataType() == DataType::BFloat16), "The data type of the NDArrayView must be BFloat16");
+
+    const bfloat16* dataBuffer = bfloat16View->DataBuffer<bfloat16>();
+    for (size_t i = 0; i < data.size(); ++i)
+        BOOST_TEST((float)dataBuffer[i] == data[i], "The bfloat16 DataBuffer does not match the source data.");
+
+    std::vector<double> widenedData(data.size());
+    NDArrayView widenedView(viewShape, widenedData.data(), widenedData.size(), device);
+    widenedView.CopyFrom(*bfloat16View);
+    for (size_t i = 0; i < data.size(); ++i)
+        BOOST_TEST(widenedData[i] == (double)data[i], "The values widened from bfloat16 do not match the source data.");
+
+    // the views share the storage of bfloat16View
+    auto aliasView = bfloat16View->Alias();
+    BOOST_TEST(aliasView->DataBuffer<bfloat16>() == dataBuffer, "The alias of a bfloat16 NDArrayView does not share its buffer.");
+    auto reshapedView = bfloat16View->AsShape(NDShape({ 2, 6 }));
+    BOOST_TEST(reshapedView->DataBuffer<bfloat16>() == dataBuffer, "The reshaped bfloat16 NDArrayView does not share its buffer.");
+    auto columnView = bfloat16View->SliceView({ 0, 1 }, { 3, 2 });
+    BOOST_TEST(columnView->DataBuffer<bfloat16>() == dataBuffer + 3, "The sliced bfloat16 NDArrayView does not start at the expected element.");
+    columnView->SetValue(0.5f);
+    for (size_t i = 0; i < data.size(); ++i)
+        BOOST_TEST((float)dataBuffer[i] == ((i >= 3 && i < 9) ? 0.5f : data[i]), "SetValue on a slice of a bfloat16 NDArrayView changed the wrong elements.");
+
+    auto clonedView = bfloat16View->DeepClone();
+    BOOST_TEST(clonedView->DataBuffer<bfloat16>() != dataBuffer, "The clone of a bfloat16 NDArrayView shares its buffer.");
+    BOOST_TEST(memcmp(clonedView->DataBuffer<bfloat16>(), dataBuffer, data.size() * sizeof(bfloat16)) == 0, "The clone of a bfloat16 NDArrayView does not match the source.");
+
+    // bfloat16 is a dense CPU storage type only
+    VerifyException([&viewShape, &device]() {
+        NDArrayView sparseView(DataType::BFloat16, StorageFormat::SparseCSC, viewShape, device);
+    }, "Was able to create a sparse bfloat16 NDArrayView.");
+}
+
 struct NDArrayViewFixture
 {
     NDArrayViewFixture()
@@ -384,6 +428,12 @@ BOOST_AUTO_TEST_CASE(CheckDataBufferInGpu)
     }
 }
 
+BOOST_AUTO_TEST_CASE(CheckBFloat16NDArrayViewInCpu)
+{
+    if (ShouldRunOnCpu())
+        TestBFloat16NDArrayView(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}
@@ -842,6 +842,97 @@ void TestCheckpointingWithStatefulNodes(const DeviceDescriptor& device)
 }
 
 
+// Training continues while the checkpoints are written, which must not change what is written.
+void TestAsyncCheckpointing(const DeviceDescriptor& device)
+{
+    auto featureStreamName = L"features";
+    auto labelsStreamName = L"labels";
+
+    size_t inputDim = 784;
+    size_t numOutputClasses = 10;
+    auto features = InputVariable({ inputDim }, false /*isSparse*/, DataType::Float, featureStreamName);
+    auto labels = InputVariable({ numOutputClasses }, DataType::Float, labelsStreamName);
+    auto net = BuildFFClassifierNet(features, numOutputClasses, device, 1);
+
+    auto trainer = BuildTrainer(net, labels);
+
+    const size_t minibatchSize = 50;
+    const size_t epochSize = 150;
+    auto minibatchSource = TextFormatMinibatchSource(L"Train-28x28_cntk_text.txt", { { featureStreamName, inputDim }, { labelsStreamName, numOutputClasses } },  epochSize, false);
+    auto minibatchData = minibatchSource->GetNextMinibatch(minibatchSize, device);
+    auto featureStreamInfo = minibatchSource->StreamInfo(features);
+    auto labelStreamInfo = minibatchSource->StreamInfo(labels);
+
+    trainer->TrainMinibatch({ { features, minibatchData[featureStreamInfo] }, { labels, minibatchData[labelStreamInfo] } }, device);
+
+    vector<double> expectedLoss;
+    for (int i = 0; i < epochSize / minibatchSize; i++)
+    {
+        trainer->SaveCheckpointAsync(L"async_checkpoint.model" + std::to_wstring(i), Dictionary(), /*maxPendingCheckpoints =*/ 2);
+        trainer->TrainMinibatch({ { features, minibatchData[featureStreamInfo] }, { labels, minibatchData[labelStreamInfo] } }, device);
+        expectedLoss.push_back(trainer->PreviousMinibatchLossAverage());
+    }
+    BOOST_TEST(trainer->CheckpointBlockingTimeInSeconds() > 0);
+
+    for (int i = 0; i < epochSize / minibatchSize; i++)
+    {
+        trainer->RestoreFromCheckpoint(L"async_checkpoint.model" + std::to_wstring(i));
+        trainer->TrainMinibatch({ { features, minibatchData[featureStreamInfo] }, { labels, minibatchData[labelStreamInfo] } }, device);
+        double loss = trainer->PreviousMinibatchLossAverage();
+        FloatingPointCompare(loss, expectedLoss[i], "Post checkpoint restoration training loss does not match expectation");
+    }
+
+    // a failed write is reported to the training thread; the directory of this one is a file
+    trainer->SaveCheckpointAsync(L"async_checkpoint.model0/async_checkpoint.model");
+    BOOST_CHECK_THROW(trainer->WaitForPendingCheckpoints(), std::exception);
+    trainer->WaitForPendingCheckpoints();
+}
+
+
+// The values of a model saved by SaveMappable are mapped into memory, and writes to them never reach the file.
+void TestMappableModelSaving(const DeviceDescriptor& device)
+{
+    auto file = L"TestMappableModelSaving.out";
+    const size_t inputDim = 20;
+    auto inputVar = InputVariable({ inputDim }, true /*isSparse*/, DataType::Float, L"input_variable");
+    auto function = BuildLSTMClassifierNet(inputVar, 5, device);
+    function->SaveMappable(file);
+
+    auto reloadedFunction = Function::Load(file, device);
+    if (!AreEqual(function, reloadedFunction))
+        BOOST_ERROR("TestMappableModelSaving: original and reloaded functions are not identical.");
+
+    // the values outlive the Function that they were loaded with
+    auto parameter = function->Parameters()[0];
+    auto reloadedValue = reloadedFunction->Parameters()[0].Value();
+    reloadedFunction = nullptr;
+    BOOST_TEST(AreEqual(parameter.Value(), reloadedValue));
+
+    reloadedValue->SetValue(0.5f);
+    reloadedFunction = Function::Load(file, device);
+    if (!AreEqual(function, reloadedFunction))
+        BOOST_ERROR("TestMappableModelSaving: writing to the values of a mapped model changed its file.");
+
+    for (auto& reloadedParameter : reloadedFunction->Parameters())
+        reloadedParameter.Value()->SetValue(0.5f);
+    reloadedFunction->Restore(file);
+    if (!AreEqual(function, reloadedFunction))
+        BOOST_ERROR("TestMappableModelSaving: restoring a function from the mapped model did not restore its values.");
+
+    std::vector<char> buffer;
+    {
+        auto stream = GetFstream(file, true);
+        stream->seekg(0, stream->end);
+        buffer.resize((size_t)stream->tellg());
+        stream->seekg(0, stream->beg);
+        stream->read(buffer.data(), buffer.size());
+    }
+    reloadedFunction = Function::Load(buffer.data(), buffer.size(), device);
+    buffer.clear();
+    if (!AreEqual(function, reloadedFunction))
+        BOOST_ERROR("TestMappableModelSaving: original and reloaded functions are not identical when loaded from a buffer.");
+}
+
 void TestCheckpointingWithStatefulNodesAndExplicitSeeds(const DeviceDescriptor& device)
 {
     auto featureStreamName = L"features";
@@ -1090,6 +1181,28 @@ BOOST_AUTO_TEST_CASE(CheckpointingWithStatefulNodesInGPU)
         TestCheckpointingWithStatefulNodes(DeviceDescriptor::GPUDevice(0));
 }
 
+BOOST_AUTO_TEST_CASE(AsyncCheckpointingInCPU)
+{
+    TestAsyncCheckpointing(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(AsyncCheckpointingInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestAsyncCheckpointing(DeviceDescriptor::GPUDevice(0));
+}
+
+
+BOOST_AUTO_TEST_CASE(MappableModelSavingInCPU)
+{
+    TestMappableModelSaving(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(MappableModelSavingInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestMappableModelSaving(DeviceDescriptor::GPUDevice(0));
+}
 
 BOOST_AUTO_TEST_CASE(CheckpointingWithStatefulNodesAndExplicitSeedsOnCPU)
 {
@@ -1192,6 +1192,112 @@ void CreateSequenceTestSparse(const DeviceDescriptor device, bool readOnly)
     CheckSparseValueEqualToDenseValue(sparseValue, denseValue, device);
 }
 
+// Evaluates 'model' on a Value over a caller-owned buffer and checks that the outputs, which are written into a caller-owned
+// buffer too, match the 'expected' ones.
+template <typename ElementType>
+void CheckEvaluationFromBuffers(const FunctionPtr& model, const Variable& input, const ValuePtr& inputValue, const std::vector<std::vector<ElementType>>& expected,
+                                const std::vector<size_t>& sequenceLengths, const DeviceDescriptor& device)
+{
+    Variable output = model->Output();
+    size_t outputDim = output.Shape().TotalSize();
+    size_t maxSequenceLength = *std::max_element(sequenceLengths.begin(), sequenceLengths.end());
+
+    std::vector<ElementType> outputBuffer(outputDim * maxSequenceLength * sequenceLengths.size());
+    auto outputValue = Value::CreateFromBuffer<ElementType>({ outputDim }, sequenceLengths, {}, outputBuffer.data(), outputBuffer.size(), device);
+    std::unordered_map<Variable, ValuePtr> outputs = { { output, outputValue } };
+    model->Evaluate({ { input, inputValue } }, outputs, device);
+    BOOST_TEST((outputs[output] == outputValue), "The output Value over the caller's buffer was replaced");
+
+    for (size_t i = 0; i < sequenceLengths.size(); i++)
+    {
+        auto first = outputBuffer.begin() + i * outputDim * maxSequenceLength;
+        std::vector<ElementType> actual(first, first + outputDim * sequenceLengths[i]);
+        FloatingPointVectorCompare(actual, expected[i], "The output written into the caller's buffer does not match the output of a Value holding a copy");
+    }
+}
+
+template <typename ElementType>
+void CreateFromBufferTest(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 10;
+    const size_t outputDim = 4;
+    const size_t maxAllowedSequenceLength = 6;
+
+    auto denseInput = InputVariable({ inputDim }, AsDataType<ElementType>(), L"features");
+    auto sparseInput = InputVariable({ inputDim }, /*isSparse =*/ true, AsDataType<ElementType>(), L"sparseFeatures");
+    auto W = Parameter({ outputDim, inputDim }, AsDataType<ElementType>(), GlorotUniformInitializer(), device);
+    auto denseModel = Times(W, denseInput);
+    auto sparseModel = Times(W, sparseInput);
+
+    // A single sequence is used in place, several are rearranged into the network's layout
+    for (size_t numSequences : { 1, 3 })
+    {
+        auto sequenceLengths = GenerateSequenceLengths(numSequences, maxAllowedSequenceLength);
+        auto sequences = GenerateSequences<ElementType>(sequenceLengths, { inputDim });
+        auto referenceInputValue = Value::Create({ inputDim }, sequences, device, /*readOnly =*/ true);
+        std::unordered_map<Variable, ValuePtr> referenceOutputs = { { denseModel->Output(), nullptr } };
+        denseModel->Evaluate({ { denseInput, referenceInputValue } }, referenceOutputs, device);
+        std::vector<std::vector<ElementType>> expected;
+        referenceOutputs[denseModel->Output()]->CopyVariableValueTo(denseModel->Output(), expected);
+
+        // pad the sequences to the length of the longest one, and convert that to CSC
+        size_t maxSequenceLength = *std::max_element(sequenceLengths.begin(), sequenceLengths.end());
+        std::vector<ElementType> inputBuffer(inputDim * maxSequenceLength * numSequences, 0);
+        for (size_t i = 0; i < numSequences; i++)
+            std::copy(sequences[i].begin(), sequences[i].end(), inputBuffer.begin() + i * inputDim * maxSequenceLength);
+
+        std::vector<SparseIndexType> colStarts = { 0 };
+        std::vector<SparseIndexType> rowIndices;
+        std::vector<ElementType> nonZeroValues;
+        for (size_t j = 0; j < maxSequenceLength * numSequences; j++)
+        {
+            for (size_t k = 0; k < inputDim; k++)
+            {
+                if (inputBuffer[j * inputDim + k] != 0)
+                {
+                    rowIndices.push_back((SparseIndexType)k);
+                    nonZeroValues.push_back(inputBuffer[j * inputDim + k]);
+                }
+            }
+            colStarts.push_back((SparseIndexType)nonZeroValues.size());
+        }
+
+        auto inputBufferBefore = inputBuffer;
+        auto denseInputValue = Value::CreateFromBuffer<ElementType>({ inputDim }, sequenceLengths, {}, (const ElementType*)inputBuffer.data(), inputBuffer.size(), device);
+        BOOST_TEST(denseInputValue->IsReadOnly());
+        CheckValue(denseInputValue, { inputDim }, sequences, sequenceLengths);
+        CheckEvaluationFromBuffers<ElementType>(denseModel, denseInput, denseInputValue, expected, sequenceLengths, device);
+
+        auto sparseInputValue = Value::CreateFromBuffer<ElementType>({ inputDim }, sequenceLengths, {}, colStarts.data(), rowIndices.data(), nonZeroValues.data(), nonZeroValues.size());
+        BOOST_TEST(sparseInputValue->IsSparse());
+        CheckEvaluationFromBuffers<ElementType>(sparseModel, sparseInput, sparseInputValue, expected, sequenceLengths, device);
+
+        BOOST_TEST((inputBuffer == inputBufferBefore), "The caller's input buffer was modified");
+
+        // The gaps of a writable buffer are not masked in place either, since the Value is copied if it has gaps
+        std::vector<ElementType> writableBuffer(inputBuffer.size(), (ElementType)7);
+        for (size_t i = 0; i < numSequences; i++)
+            std::copy(sequences[i].begin(), sequences[i].end(), writableBuffer.begin() + i * inputDim * maxSequenceLength);
+        auto writableBufferBefore = writableBuffer;
+        auto writableInputValue = Value::CreateFromBuffer<ElementType>({ inputDim }, sequenceLengths, {}, writableBuffer.data(), writableBuffer.size(), device);
+        CheckEvaluationFromBuffers<ElementType>(denseModel, denseInput, writableInputValue, expected, sequenceLengths, device);
+        BOOST_TEST((writableBuffer == writableBufferBefore), "The gaps of the caller's writable input buffer were modified");
+    }
+
+    // The buffers must be large enough and consistent with the sequence lengths
+    std::vector<ElementType> smallBuffer(inputDim);
+    VerifyException([&]() {
+        Value::CreateFromBuffer<ElementType>({ inputDim }, { 2 }, {}, smallBuffer.data(), smallBuffer.size(), device);
+    }, "Was able to create a Value over a buffer that is too small.");
+
+    std::vector<SparseIndexType> colStarts = { 0, 1, 2 };
+    std::vector<SparseIndexType> rowIndices = { 0, 1 };
+    std::vector<ElementType> nonZeroValues = { 1, 2 };
+    VerifyException([&]() {
+        Value::CreateFromBuffer<ElementType>({ inputDim }, { 2 }, {}, colStarts.data(), rowIndices.data(), nonZeroValues.data(), 1);
+    }, "Was able to create a Value over CSC buffers whose column starts do not match the number of non-zero values.");
+}
+
 struct ValueFixture
 {
     ValueFixture()
@@ -1485,6 +1591,15 @@ BOOST_AUTO_TEST_CASE(ValueCopyToSparseCSCInGPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(CreateFromBufferInCPU)
+{
+    if (!ShouldRunOnCpu())
+        return;
+
+    CreateFromBufferTest<float>(DeviceDescriptor::CPUDevice());
+    CreateFromBufferTest<double>(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_CASE(ValueCopyToExceptionsInCPU)
 {
     if (!ShouldRunOnCpu())
@@ -6,7 +6,7 @@
 from .. import cntk_py
 
 
-def start_profiler(dir='profiler', sync_gpu=True, reserve_mem=cntk_py.default_profiler_buffer_size):
+def start_profiler(dir='profiler', sync_gpu=True, reserve_mem=cntk_py.default_profiler_buffer_size, profile_nodes=False):
     '''
     Start profiler to prepare performance statistics gathering. Note that
     the profiler is not enabled after start
@@ -16,8 +16,10 @@ def start_profiler(dir='profiler', sync_gpu=True, reserve_mem=cntk_py.default_pr
         dir: directory for profiler output
         sync_gpu: whether profiler syncs CPU with GPU when timing
         reserve_mem: size in byte for profiler memory reserved
+        profile_nodes: whether to also record the forward and backward time
+         of each node, reported per node and per node type
     '''
-    cntk_py.start_profiler(dir, sync_gpu, reserve_mem)
+    cntk_py.start_profiler(dir, sync_gpu, reserve_mem, profile_nodes)
 
 
 def stop_profiler():
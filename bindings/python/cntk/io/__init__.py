@@ -110,7 +110,7 @@ class MinibatchData(cntk_py.MinibatchData, ArrayMixin):
 
 class MinibatchSource(cntk_py.MinibatchSource):
     '''
-    MinibatchSource(deserializers, max_samples=cntk.io.INFINITELY_REPEAT, max_sweeps=cntk.io.INFINITELY_REPEAT, randomization_window_in_chunks=cntk.io.DEFAULT_RANDOMIZATION_WINDOW, randomization_window_in_samples=0, randomization_seed=0, trace_level=cntk.logging.get_trace_level(), multithreaded_deserializer=None, frame_mode=False, truncation_length=0, randomize=True)
+    MinibatchSource(deserializers, max_samples=cntk.io.INFINITELY_REPEAT, max_sweeps=cntk.io.INFINITELY_REPEAT, randomization_window_in_chunks=cntk.io.DEFAULT_RANDOMIZATION_WINDOW, randomization_window_in_samples=0, randomization_seed=0, trace_level=cntk.logging.get_trace_level(), multithreaded_deserializer=None, frame_mode=False, truncation_length=0, randomize=True, bucketing_window_in_minibatches=0)
 
     Args:
         deserializers (a single deserializer or a `list`): deserializers to be used in the composite reader
@@ -150,6 +150,9 @@ class MinibatchSource(cntk_py.MinibatchSource):
           if frame mode is enabled and the truncation length is non-zero).
         randomize (`bool`, defaults to `True`): Enables or disables randomization; use randomization_window_in_chunks or
           randomization_window_in_samples to specify the randomization range
+        bucketing_window_in_minibatches (`int`, defaults to `0`): number of minibatches to read ahead and
+          regroup by sequence length, so that sequences of similar lengths end up in the same minibatch and
+          less padding is needed. Zero disables bucketing (cannot be used in frame mode or with truncation).
     '''
     _runtime_deserializer_table = {}
     _deserializer_factory = None
@@ -191,7 +194,8 @@ class MinibatchSource(cntk_py.MinibatchSource):
         multithreaded_deserializer=None,
         frame_mode=False,
         truncation_length=0,
-        randomize=True):
+        randomize=True,
+        bucketing_window_in_minibatches=0):
 
         if not isinstance(deserializers, (list,tuple)):
             deserializers = [ deserializers ]
@@ -213,6 +217,7 @@ class MinibatchSource(cntk_py.MinibatchSource):
 
         config.is_frame_mode_enabled = frame_mode
         config.truncation_length = truncation_length
+        config.bucketing_window_in_minibatches = bucketing_window_in_minibatches
 
         if isinstance(trace_level, TraceLevel):
             trace_level = trace_level.value
@@ -120,7 +120,7 @@ class DistributedLearner(cntk_py.DistributedLearner):
         return super(DistributedLearner, self).total_number_of_samples_seen()
 
 @typemap
-def data_parallel_distributed_learner(learner, distributed_after=0, num_quantization_bits=32, use_async_buffered_parameter_update=False):
+def data_parallel_distributed_learner(learner, distributed_after=0, num_quantization_bits=32, use_async_buffered_parameter_update=False, gradient_bucket_size_in_bytes=0):
     '''
     Creates a data parallel distributed learner
 
@@ -129,6 +129,9 @@ def data_parallel_distributed_learner(learner, distributed_after=0, num_quantiza
         distributed_after (int): number of samples after which distributed training starts
         num_quantization_bits (int): number of bits for quantization (1 to 32)
         use_async_buffered_parameter_update (bool): use async buffered parameter update
+        gradient_bucket_size_in_bytes (int): if positive, the gradients of the parameters on the CPU are
+         aggregated in buckets of about this size, which start to aggregate during backpropagation
+         (not used with quantization, nor for parameters with sparse gradients)
     Returns:
         a distributed learner instance
     '''
@@ -143,7 +146,8 @@ def data_parallel_distributed_learner(learner, distributed_after=0, num_quantiza
             cntk_py.mpicommunicator(),
             learner,
             distributed_after,
-            use_async_buffered_parameter_update)
+            use_async_buffered_parameter_update,
+            gradient_bucket_size_in_bytes)
 
 @typemap
 def block_momentum_distributed_learner(learner, block_size, block_momentum_as_time_constant=None, use_nestrov_momentum=True, reset_sgd_momentum_after_aggregation=True, block_learning_rate=1.0, distributed_after=0):